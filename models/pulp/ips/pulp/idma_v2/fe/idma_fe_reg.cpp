@@ -31,6 +31,8 @@ IDmaFeReg::IDmaFeReg(vp::Component *idma, IdmaTransferConsumer *me)
     src_stride(*this, "src_stride", 32),
     dst_stride(*this, "dst_stride", 32),
     reps(*this, "reps", 32),
+    desc_addr(*this, "desc_addr", 32),
+    desc_config(*this, "desc_config", 32),
     next_transfer_id(*this, "next_transfer_id", 32, true, 1),
     completed_id(*this, "completed_id", 32, true, 0),
     do_transfer_grant(*this, "do_transfer_grant", 1),
@@ -41,7 +43,8 @@ IDmaFeReg::IDmaFeReg(vp::Component *idma, IdmaTransferConsumer *me)
     trace_src_stride(*this, "src_stride", 32, vp::SignalCommon::ResetKind::HighZ),
     trace_dst_stride(*this, "dst_stride", 32, vp::SignalCommon::ResetKind::HighZ),
     trace_reps(*this, "reps", 32, vp::SignalCommon::ResetKind::HighZ),
-    trace_id(*this, "id", 1, vp::SignalCommon::ResetKind::HighZ)
+    trace_id(*this, "id", 1, vp::SignalCommon::ResetKind::HighZ),
+    desc_event(this, &IDmaFeReg::desc_event_handler)
 {
     // Middle-end will be used later for interaction
     this->me = me;
@@ -53,6 +56,14 @@ IDmaFeReg::IDmaFeReg(vp::Component *idma, IdmaTransferConsumer *me)
     idma->new_slave_port("input", &this->input_itf, this);
 
     idma->new_master_port("irq", &this->irq_itf, this);
+
+    // Declare the master interface used for reading chain descriptors
+    idma->new_master_port("desc", &this->desc_itf, this);
+
+    this->chain = NULL;
+    this->desc_transfer = NULL;
+    this->desc_fetching = false;
+    this->desc_denied = false;
 }
 
 
@@ -92,6 +103,33 @@ vp::IoReqStatus IDmaFeReg::req(vp::Block *__this, vp::IoReq *req)
             *(uint32_t *)req->get_data() = _this->completed_id.get();
             break;
 
+        case 0x20:
+            _this->trace.msg(vp::Trace::LEVEL_TRACE, "Received descriptor address (addr: 0x%llx)\n",
+                value);
+            _this->desc_addr.set(value);
+            break;
+
+        case 0x28:
+            _this->trace.msg(vp::Trace::LEVEL_TRACE, "Received descriptor config (config: 0x%lx)\n",
+                value);
+            _this->desc_config.set(value);
+            break;
+
+        case 0x30:
+        {
+            bool granted;
+            _this->trace.msg(vp::Trace::LEVEL_TRACE, "Trigger descriptor chain\n");
+            *(uint32_t *)req->get_data() = _this->enqueue_chain(granted);
+            // Only one chain can be executed at a time, it is up to the SW to wait for the end
+            // of the previous one
+            if (!granted)
+            {
+                _this->trace.force_warning("Pushing descriptor chain while one is already active "
+                    "or without descriptor port");
+            }
+            break;
+        }
+
         case 0xd0:
             _this->trace.msg(vp::Trace::LEVEL_TRACE, "Received dst address (addr: 0x%llx)\n",
                 value);
@@ -139,6 +177,7 @@ uint32_t IDmaFeReg::enqueue_copy(bool &granted)
 
     // Allocate a new transfer and fill it from registers
     IdmaTransfer *transfer = new IdmaTransfer();
+    this->transfer_ids[transfer] = transfer_id;
     transfer->src = this->src.get();
     transfer->dst = this->dst.get();
     transfer->size = this->length.get();
@@ -195,11 +234,224 @@ uint32_t IDmaFeReg::enqueue_copy(bool &granted)
 
 
 
-// Called by middle-end when a transfer is done
-void IDmaFeReg::ack_transfer(IdmaTransfer *transfer)
+uint32_t IDmaFeReg::enqueue_chain(bool &granted)
 {
-    this->completed_id.inc(1);
-    delete transfer;
+    if (this->chain != NULL || !this->desc_itf.is_bound())
+    {
+        granted = false;
+        return 0;
+    }
+
+    granted = true;
+
+    // The whole chain gets a single transfer ID
+    uint32_t transfer_id = this->next_transfer_id.get();
+    this->next_transfer_id.set(transfer_id + 1);
+
+    this->trace.msg(vp::Trace::LEVEL_INFO, "Starting descriptor chain (id: %d, head: 0x%llx, "
+        "config: 0x%x)\n", transfer_id, this->desc_addr.get(), this->desc_config.get());
+
+    this->trace_id.set_and_release(transfer_id);
+    this->trace_busy = true;
+
+    this->chain = new IdmaTransfer();
+    this->chain_id = transfer_id;
+    this->chain->nb_bursts = 0;
+    this->chain->bursts_sent = false;
+    this->chain_irq_at_end = this->desc_config.get() & 1;
+    this->desc_next = this->desc_addr.get();
+
+    if (this->desc_next == IDMA_FE_REG_DESC_END)
+    {
+        this->chain->bursts_sent = true;
+        this->chain_end();
+    }
+    else
+    {
+        this->desc_fetch();
+    }
+
+    return transfer_id;
+}
+
+
+
+void IDmaFeReg::desc_fetch()
+{
+    this->trace.msg(vp::Trace::LEVEL_TRACE, "Reading descriptor (addr: 0x%llx)\n", this->desc_next);
+
+    this->desc_fetching = true;
+    this->desc_req.prepare();
+    this->desc_req.set_addr(this->desc_next);
+    this->desc_req.set_size(IDMA_FE_REG_DESC_SIZE);
+    this->desc_req.set_is_write(false);
+    this->desc_req.set_data(this->desc_data);
+    this->desc_req.is_first = true;
+    this->desc_req.is_last = true;
+    this->desc_req.burst_id = -1;
+    this->desc_req.set_resp_status(vp::IO_RESP_OK);
+
+    this->desc_send();
+}
+
+
+
+void IDmaFeReg::desc_send()
+{
+    this->desc_denied = false;
+
+    vp::IoReqStatus status = this->desc_itf.req(&this->desc_req);
+    if (status == vp::IO_REQ_DONE)
+    {
+        this->desc_read_done();
+    }
+    else if (status == vp::IO_REQ_DENIED)
+    {
+        // Sent again from desc_retry
+        this->desc_denied = true;
+    }
+    // IO_REQ_GRANTED: the response is received through desc_resp
+}
+
+
+
+void IDmaFeReg::desc_read_done()
+{
+    if (this->desc_req.get_resp_status() != vp::IO_RESP_OK)
+    {
+        this->trace.force_warning("Invalid access while reading descriptor (addr: 0x%llx)\n",
+            this->desc_next);
+        // Terminate the chain with the descriptors already read
+        this->desc_fetching = false;
+        this->chain->bursts_sent = true;
+        this->desc_push();
+        return;
+    }
+
+    // Descriptors are handled in the next cycle, like the transfers pushed through registers
+    this->desc_event.enqueue();
+}
+
+
+
+vp::IoRespAck IDmaFeReg::desc_resp(vp::Block *__this, vp::IoReq *req)
+{
+    IDmaFeReg *_this = (IDmaFeReg *)__this;
+    if (_this->chain != NULL)
+    {
+        _this->desc_read_done();
+    }
+    return vp::IO_RESP_ACCEPTED;
+}
+
+
+
+void IDmaFeReg::desc_retry(vp::Block *__this, vp::IoRetryChannel)
+{
+    IDmaFeReg *_this = (IDmaFeReg *)__this;
+    if (_this->desc_denied && _this->chain != NULL)
+    {
+        _this->desc_send();
+    }
+}
+
+
+
+void IDmaFeReg::desc_handle()
+{
+    uint64_t *fields = (uint64_t *)this->desc_data;
+
+    this->desc_fetching = false;
+    this->desc_next = fields[0];
+
+    IdmaTransfer *transfer = new IdmaTransfer();
+    transfer->src = fields[1];
+    transfer->dst = fields[2];
+    transfer->size = fields[3];
+    transfer->src_stride = fields[4];
+    transfer->dst_stride = fields[5];
+    transfer->reps = fields[6];
+    transfer->config = 1 << 1;
+    transfer->parent = this->chain;
+
+    this->trace.msg(vp::Trace::LEVEL_INFO, "Enqueuing descriptor (src: %llx, dst: %llx, "
+        "size: %llx, src_stride: %llx, dst_stride: %llx, reps: %llx, next: %llx)\n",
+        transfer->src, transfer->dst, transfer->size, transfer->src_stride,
+        transfer->dst_stride, transfer->reps, this->desc_next);
+
+    if (this->desc_next == IDMA_FE_REG_DESC_END)
+    {
+        this->chain->bursts_sent = true;
+    }
+
+    // Empty descriptors have nothing to move, skip them
+    if (transfer->size == 0 || transfer->reps == 0)
+    {
+        delete transfer;
+    }
+    else
+    {
+        this->chain->nb_bursts++;
+        this->desc_transfer = transfer;
+    }
+
+    this->desc_push();
+}
+
+
+
+void IDmaFeReg::desc_push()
+{
+    if (this->desc_transfer != NULL)
+    {
+        if (!this->me->can_accept_transfer())
+        {
+            // The middle-end will call update once it can accept it
+            return;
+        }
+
+        this->me->enqueue_transfer(this->desc_transfer);
+        this->desc_transfer = NULL;
+    }
+
+    if (this->chain->bursts_sent)
+    {
+        if (this->chain->nb_bursts == 0)
+        {
+            this->chain_end();
+        }
+    }
+    else if (!this->desc_fetching)
+    {
+        // The next descriptor is read while the middle-end is busy with the previous ones
+        this->desc_fetch();
+    }
+}
+
+
+
+void IDmaFeReg::chain_end()
+{
+    this->trace.msg(vp::Trace::LEVEL_TRACE, "Descriptor chain completed\n");
+
+    delete this->chain;
+    this->chain = NULL;
+
+    this->transfer_done(this->chain_id);
+}
+
+
+
+void IDmaFeReg::transfer_done(uint32_t transfer_id)
+{
+    this->done_ids.insert(transfer_id);
+
+    // Register transfers pushed while a chain is active may complete before it, the completed
+    // ID must not go past the chain until it is done
+    while (this->done_ids.erase(this->completed_id.get() + 1))
+    {
+        this->completed_id.inc(1);
+    }
 
     if (this->completed_id == this->next_transfer_id - 1)
     {
@@ -214,6 +466,47 @@ void IDmaFeReg::ack_transfer(IdmaTransfer *transfer)
 
 
 
+void IDmaFeReg::desc_event_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    IDmaFeReg *_this = (IDmaFeReg *)__this;
+    // The chain may have been dropped by a reset while the descriptor was being read
+    if (_this->chain != NULL)
+    {
+        _this->desc_handle();
+    }
+}
+
+
+
+// Called by middle-end when a transfer is done
+void IDmaFeReg::ack_transfer(IdmaTransfer *transfer)
+{
+    if (this->chain != NULL && transfer->parent == this->chain)
+    {
+        delete transfer;
+        this->chain->nb_bursts--;
+
+        if (this->chain->bursts_sent && this->chain->nb_bursts == 0)
+        {
+            this->chain_end();
+        }
+        else if (!this->chain_irq_at_end && this->irq_itf.is_bound())
+        {
+            this->irq_itf.sync(true);
+        }
+        return;
+    }
+
+    auto it = this->transfer_ids.find(transfer);
+    uint32_t transfer_id = it->second;
+    this->transfer_ids.erase(it);
+    delete transfer;
+
+    this->transfer_done(transfer_id);
+}
+
+
+
 // Called by middle-end when something has been updated to check if we must take any action
 void IDmaFeReg::update()
 {
@@ -229,10 +522,28 @@ void IDmaFeReg::update()
 
         this->me->enqueue_transfer(transfer);
     }
+
+    // Then the descriptor chain, in case its last descriptor is waiting for the middle-end
+    if (this->desc_transfer != NULL)
+    {
+        this->desc_push();
+    }
 }
 
 
 
 void IDmaFeReg::reset(bool active)
 {
+    if (active)
+    {
+        // Drop the chain, its transfers are dropped by the middle-end
+        delete this->chain;
+        delete this->desc_transfer;
+        this->chain = NULL;
+        this->desc_transfer = NULL;
+        this->desc_fetching = false;
+        this->transfer_ids.clear();
+        this->done_ids.clear();
+        this->desc_denied = false;
+    }
 }
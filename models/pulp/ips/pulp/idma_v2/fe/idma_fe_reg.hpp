@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <map>
+#include <set>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/itf/wire.hpp>
@@ -27,10 +29,30 @@
 #include <vp/signal.hpp>
 #include "../idma.hpp"
 
+// Size of a chain descriptor in memory
+#define IDMA_FE_REG_DESC_SIZE 64
+// Value of the next field marking the last descriptor of a chain
+#define IDMA_FE_REG_DESC_END ((uint64_t)-1)
+
 /**
  * @brief XDma front-end
  *
  * This front-end can be used to expose a register-mapped interface on a bus
+ *
+ * Besides the transfers programmed through the registers, it can execute a chain of descriptors
+ * read from memory through the desc port. A descriptor is made of 64-bit little-endian fields:
+ *   - 0x00: address of the next descriptor, IDMA_FE_REG_DESC_END for the last one
+ *   - 0x08: source address
+ *   - 0x10: destination address
+ *   - 0x18: length
+ *   - 0x20: source stride
+ *   - 0x28: destination stride
+ *   - 0x30: number of repetitions, at least 1
+ *   - 0x38: reserved
+ * The whole chain gets a single transfer ID, completed once all its descriptors are done.
+ * Register transfers can still be pushed while a chain is active. Since they can then
+ * complete before the chain, the completed ID register only moves to an ID once all the
+ * transfers up to this one are done.
  */
 class IDmaFeReg : public vp::Block, public IdmaTransferProducer
 {
@@ -51,8 +73,28 @@ public:
 private:
     // Handle register accesses here
     static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
+    // Descriptor read responses and retries
+    static vp::IoRespAck desc_resp(vp::Block *__this, vp::IoReq *req);
+    static void desc_retry(vp::Block *__this, vp::IoRetryChannel);
+    static void desc_event_handler(vp::Block *__this, vp::ClockEvent *event);
     // Enqueue a transfer using the current values of the registers
     uint32_t enqueue_copy(bool &granted);
+    // Start the descriptor chain whose head is in the desc_addr register
+    uint32_t enqueue_chain(bool &granted);
+    // Read the next descriptor of the chain
+    void desc_fetch();
+    // Send the descriptor read request, again after a denial
+    void desc_send();
+    // Called once the descriptor read request is done
+    void desc_read_done();
+    // Turn the descriptor which has been read into a transfer
+    void desc_handle();
+    // Push the pending descriptor transfer to the middle-end and fetch the next one
+    void desc_push();
+    // Terminate the chain once all its transfers are done
+    void chain_end();
+    // Mark a transfer ID as done, and advance the completed ID over all the IDs done in order
+    void transfer_done(uint32_t transfer_id);
 
     // Pointer to middle-end
     IdmaTransferConsumer *me;
@@ -62,6 +104,8 @@ private:
     vp::IoSlave input_itf{&IDmaFeReg::req};
     // Output interrupt triggered each time a transfer is finished
     vp::WireMaster<bool> irq_itf;
+    // Output interface for reading chain descriptors
+    vp::IoMaster desc_itf{&IDmaFeReg::desc_retry, &IDmaFeReg::desc_resp};
     // Register holding source address
     vp::Register<uint64_t> src;
     // Register holding destination address
@@ -73,15 +117,44 @@ private:
     vp::Register<uint64_t> dst_stride;
     // Register holding replication
     vp::Register<uint32_t> reps;
+    // Register holding the address of the first descriptor of a chain
+    vp::Register<uint64_t> desc_addr;
+    // Register holding the chain configuration, bit 0 raises the interrupt only at the end of
+    // the chain instead of once per descriptor
+    vp::Register<uint32_t> desc_config;
     // Transfer ID of the next transfer
     vp::Register<uint32_t> next_transfer_id;
     // Transfer ID of the last completed ID
     vp::Register<uint32_t> completed_id;
+    // Transfer IDs of the register transfers pending in the middle-end
+    std::map<IdmaTransfer *, uint32_t> transfer_ids;
+    // Transfer IDs which are done while an older one is still pending
+    std::set<uint32_t> done_ids;
     // When a transfer is blocked, once the middle-end is ready to accept transfer,
     // send a grant to the core to unblock it
     vp::Signal<bool> do_transfer_grant;
     // In case a transfer was blocked, gives the transfer which was blocked
     IdmaTransfer *stalled_transfer;
+    // Chain being executed, NULL if none. It is the parent of the transfers of its descriptors,
+    // which are counted in nb_bursts, and bursts_sent is set once the last descriptor is read.
+    IdmaTransfer *chain;
+    // Transfer ID of the current chain
+    uint32_t chain_id;
+    // Interrupt only at the end of the current chain
+    bool chain_irq_at_end;
+    // Address of the next descriptor to read
+    uint64_t desc_next;
+    // True while a descriptor read is in flight
+    bool desc_fetching;
+    // True when the descriptor read was denied and must be sent again on retry
+    bool desc_denied;
+    // Transfer of the last descriptor read, waiting for the middle-end to accept it
+    IdmaTransfer *desc_transfer;
+    // Request and buffer used for reading descriptors
+    vp::IoReq desc_req;
+    uint8_t desc_data[IDMA_FE_REG_DESC_SIZE];
+    // Event for handling the descriptor once its read latency has elapsed
+    vp::ClockEvent desc_event;
     // Signals for VCD tracing
     vp::Signal<bool> trace_busy;
     vp::Signal<uint32_t> trace_src;
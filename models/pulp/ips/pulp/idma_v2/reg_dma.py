@@ -80,6 +80,10 @@ class RegDmaV2(gvsoc.systree.Component):
       :meth:`o_AXI` if a single sync-only router is upstream).
     - **irq** (master, ``wire<bool>``) — pulsed high on transfer
       completion (one pulse per descriptor).
+    - **desc** (master, ``io_v2``) — reads the 64-byte descriptors of
+      a chain started through the ``desc_addr`` (0x20), ``desc_config``
+      (0x28) and trigger (0x30) registers. Optional, chains are refused
+      when it is not bound.
 
     Configuration fields (:class:`RegDmaConfig`)
     ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -215,10 +219,21 @@ class RegDmaV2(gvsoc.systree.Component):
     def o_IRQ(self, itf: gvsoc.systree.SlaveItf):
         """Binds the completion interrupt wire to ``itf``.
 
-        One pulse per descriptor completion.
+        One pulse per descriptor completion. For descriptor chains
+        started with bit 0 of ``desc_config`` set, a single pulse is
+        sent once the whole chain is done.
         """
         self.itf_bind('irq', itf, signature='wire<bool>')
 
+    def o_DESC(self, itf: gvsoc.systree.SlaveItf):
+        """Binds the descriptor read master to ``itf``.
+
+        Each descriptor of a chain is read with one 64-byte io_v2 req,
+        the next one being read once the previous one has been handed
+        to the middle-end.
+        """
+        self.itf_bind('desc', itf, signature='io_v2')
+
     @override
     def gen_gui(self, parent_signal: Signal):
         active = Signal(self, parent_signal, name=self.name, path='fe/busy', groups='regmap',
@@ -23,6 +23,7 @@
 #include <vp/itf/io.hpp>
 #include <stdio.h>
 #include <math.h>
+#include "pulp/common/bank_profiler.hpp"
 
 class hbm_ctrl : public vp::Component
 {
@@ -31,6 +32,8 @@ public:
 
   hbm_ctrl(vp::ComponentConf &config);
 
+  void stop() override;
+
   static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
   static vp::IoReqStatus req_muxed(vp::Block *__this, vp::IoReq *req, int mux_id);
   static vp::IoReqStatus req_ts(vp::Block *__this, vp::IoReq *req);
@@ -55,6 +58,7 @@ private:
   uint64_t hbm_node_aliase;
   uint64_t xor_scrambling;
   uint64_t red_scrambling;
+  BankProfiler *profiler;
 };
 
 hbm_ctrl::hbm_ctrl(vp::ComponentConf &config)
@@ -101,7 +105,12 @@ hbm_ctrl::hbm_ctrl(vp::ComponentConf &config)
     new_slave_port("ts_in_" + std::to_string(i), masters_ts_in[i]);
   }
 
+  profiler = new BankProfiler(this, nb_slaves);
+}
 
+void hbm_ctrl::stop()
+{
+  this->profiler->dump_report();
 }
 
 vp::IoReqStatus hbm_ctrl::req(vp::Block *__this, vp::IoReq *req)
@@ -117,6 +126,8 @@ vp::IoReqStatus hbm_ctrl::req(vp::Block *__this, vp::IoReq *req)
   int bank_id = (offset >> _this->interleaving_bits) & _this->bank_mask;
   uint64_t bank_offset = ((offset >> (_this->stage_bits + _this->interleaving_bits)) << _this->interleaving_bits) + (offset & ((1<<_this->interleaving_bits)-1));
 
+  _this->profiler->access(bank_id, offset);
+
   req->set_addr(bank_offset);
   return _this->out[bank_id]->req_forward(req);
 }
@@ -163,6 +174,8 @@ vp::IoReqStatus hbm_ctrl::req_muxed(vp::Block *__this, vp::IoReq *req, int mux_i
       bank_offset = (tmp << _this->interleaving_bits) + (offset & ((1<<_this->interleaving_bits)-1));
   }
 
+  _this->profiler->access(bank_id, offset);
+
   req->set_addr(bank_offset);
   return _this->out[bank_id]->req_forward(req);
 }
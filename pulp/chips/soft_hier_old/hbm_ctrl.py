@@ -18,7 +18,7 @@ import gvsoc.systree as st
 
 class hbm_ctrl(st.Component):
 
-    def __init__(self, parent, slave, nb_slaves=0, nb_masters=0, stage_bits=0, interleaving_bits=2, node_addr_offset=0, hbm_node_aliase=0, xor_scrambling=0, red_scrambling=0):
+    def __init__(self, parent, slave, nb_slaves=0, nb_masters=0, stage_bits=0, interleaving_bits=2, node_addr_offset=0, hbm_node_aliase=0, xor_scrambling=0, red_scrambling=0, bank_conflicts=False, bank_profiler=False, bank_profiler_file='', bank_profiler_top=16):
 
         super(hbm_ctrl, self).__init__(parent, slave)
 
@@ -32,5 +32,9 @@ class hbm_ctrl(st.Component):
             'node_addr_offset': node_addr_offset,
             'hbm_node_aliase': hbm_node_aliase,
             'xor_scrambling': xor_scrambling,
-            'red_scrambling': red_scrambling
+            'red_scrambling': red_scrambling,
+            'bank_conflicts': bank_conflicts,
+            'bank_profiler': bank_profiler,
+            'bank_profiler_file': bank_profiler_file,
+            'bank_profiler_top': bank_profiler_top,
         })
@@ -31,10 +31,13 @@
 #include <vector>
 #include <list>
 #include <queue>
+#include <algorithm>
 #include <stdint.h>
 #include <stdio.h>
 #include <math.h>
 
+#include "transpose_engine_kernels.hpp"
+
 /****************************************************
 *                   Type Definition                 *
 ****************************************************/
@@ -63,6 +66,8 @@ public:
     static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
     void tranposition();
     uint32_t next_iteration();
+    void send_tile_reqs(bool is_write);
+    uint32_t next_event_delay();
 
     vp::Trace           trace;
     vp::IoSlave         input_itf;
@@ -77,6 +82,7 @@ public:
     uint32_t            n_col_per_tile;
     uint32_t            fsm_counter;
     uint32_t            fsm_timestamp;
+    uint32_t            fsm_delay;
     std::queue<uint32_t> pending_req_queue;
 
     //transpose_engine configuration
@@ -84,6 +90,7 @@ public:
     uint32_t            tcdm_bank_number;
     uint32_t            queue_depth;
     uint32_t            buffer_dim;
+    uint32_t            nb_ports;
     uint32_t            bandwidth;
     uint32_t            m_size;
     uint32_t            n_size;
@@ -121,6 +128,7 @@ TransposeEngine::TransposeEngine(vp::ComponentConf &config)
     this->tcdm_bank_number  = get_js_config()->get("tcdm_bank_number")->get_int();
     this->queue_depth       = get_js_config()->get("queue_depth")->get_int();
     this->buffer_dim        = get_js_config()->get("buffer_dim")->get_int();
+    this->nb_ports          = get_js_config()->get("nb_ports")->get_int();
     this->bandwidth         = this->tcdm_bank_width * this->tcdm_bank_number;
     this->m_size            = 0;
     this->n_size            = 0;
@@ -147,6 +155,7 @@ TransposeEngine::TransposeEngine(vp::ComponentConf &config)
     this->n_col_per_tile    = 0;
     this->fsm_counter       = 0;
     this->fsm_timestamp     = 0;
+    this->fsm_delay         = 1;
 
     this->trace.msg("[TransposeEngine] Model Initialization Done!\n");
 }
@@ -155,27 +164,15 @@ void TransposeEngine::tranposition()
 {
     if (this->elem_size == 1)
     {
-        uint8_t * src_buf = (uint8_t *) this->scratch_buffer;
-        uint8_t * dst_buf = (uint8_t *) this->transposed_buffer;
-        for (int i = 0; i < this->tile_dim; ++i)
-        {
-            for (int j = 0; j < this->tile_dim; ++j)
-            {
-                dst_buf[i*this->tile_dim + j] = src_buf[j*this->tile_dim + i];
-            }
-        }
+        transpose_matrix<uint8_t, 8>(this->scratch_buffer, this->transposed_buffer, this->tile_dim);
     } else
     if (this->elem_size == 2)
     {
-        uint16_t * src_buf = (uint16_t *) this->scratch_buffer;
-        uint16_t * dst_buf = (uint16_t *) this->transposed_buffer;
-        for (int i = 0; i < this->tile_dim; ++i)
-        {
-            for (int j = 0; j < this->tile_dim; ++j)
-            {
-                dst_buf[i*this->tile_dim + j] = src_buf[j*this->tile_dim + i];
-            }
-        }
+        transpose_matrix<uint16_t, 8>(this->scratch_buffer, this->transposed_buffer, this->tile_dim);
+    } else
+    if (this->elem_size == 4)
+    {
+        transpose_matrix<uint32_t, 4>(this->scratch_buffer, this->transposed_buffer, this->tile_dim);
     } else {
         this->trace.fatal("[TransposeEngine][tranposition] Not support for elem_size of %d\n", this->elem_size);
     }
@@ -196,6 +193,83 @@ uint32_t TransposeEngine::next_iteration()
     return 1;
 }
 
+// Send the next rows of the tile, up to one per port, as long as the
+// pending request queue has room
+void TransposeEngine::send_tile_reqs(bool is_write)
+{
+    for (uint32_t port = 0; port < this->nb_ports; port++)
+    {
+        if ((this->fsm_counter >= this->n_row_per_tile) || (this->pending_req_queue.size() > this->queue_depth))
+        {
+            break;
+        }
+
+        //Form request
+        this->tcdm_req->init();
+        if (is_write)
+        {
+            this->tcdm_req->set_addr(this->y_addr
+                + this->col_iter * this->tile_dim * this->m_size * this->elem_size /*row tile offset*/
+                + this->row_iter * this->tile_dim                * this->elem_size /*col tile offset*/
+                + this->fsm_counter               * this->m_size * this->elem_size /*row cntr offset*/);
+        } else {
+            this->tcdm_req->set_addr(this->x_addr
+                + this->row_iter * this->tile_dim * this->n_size * this->elem_size /*row tile offset*/
+                + this->col_iter * this->tile_dim                * this->elem_size /*col tile offset*/
+                + this->fsm_counter               * this->n_size * this->elem_size /*row cntr offset*/);
+        }
+        this->tcdm_req->set_data(this->access_buffer);
+        this->tcdm_req->set_is_write(is_write);
+        this->tcdm_req->set_size(this->n_col_per_tile * this->elem_size);
+
+        //Process Data
+        if (is_write)
+        {
+            std::memcpy(this->access_buffer, &(this->transposed_buffer[this->tile_dim * this->fsm_counter * this->elem_size]), this->n_col_per_tile * this->elem_size);
+        }
+
+        //Send request
+        vp::IoReqStatus err = this->tcdm_itf.req(this->tcdm_req);
+        this->trace.msg(vp::Trace::LEVEL_TRACE,"[TransposeEngine][%s-ij: %0d-%0d] --- Send TCDM req #%d\n", is_write ? "STORETILE" : "LOADTILE", this->row_iter, this->col_iter, this->fsm_counter);
+
+        //Check error
+        if (err != vp::IO_REQ_OK) {
+            this->trace.fatal("[TransposeEngine][%s] There was an error while reading/writing data\n", is_write ? "STORETILE" : "LOADTILE");
+            return;
+        }
+
+        //Process Data
+        if (!is_write)
+        {
+            std::memcpy(&(this->scratch_buffer[this->tile_dim * this->fsm_counter * this->elem_size]), this->access_buffer, this->n_col_per_tile * this->elem_size);
+        }
+
+        //Counte on receiving cycle
+        uint32_t receive_stamp = this->tcdm_req->get_latency() + this->fsm_timestamp;
+
+        //Push pending request queue
+        this->pending_req_queue.push(receive_stamp);
+
+        //Add counter
+        this->fsm_counter += 1;
+    }
+}
+
+// Cycles until the FSM has something to do: the next cycle if it can still
+// send, otherwise the cycle at which the oldest pending response arrives, so
+// that the cycles spent waiting are skipped.
+uint32_t TransposeEngine::next_event_delay()
+{
+    if (((this->fsm_counter < this->n_row_per_tile) && (this->pending_req_queue.size() <= this->queue_depth))
+        || this->pending_req_queue.empty())
+    {
+        return 1;
+    }
+
+    uint32_t receive_stamp = this->pending_req_queue.front();
+    return receive_stamp > this->fsm_timestamp ? receive_stamp - this->fsm_timestamp : 1;
+}
+
 vp::IoReqStatus TransposeEngine::req(vp::Block *__this, vp::IoReq *req)
 {
     TransposeEngine *_this = (TransposeEngine *)__this;
@@ -265,7 +339,8 @@ void TransposeEngine::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
 {
     TransposeEngine *_this = (TransposeEngine *)__this;
 
-    _this->fsm_timestamp += 1;
+    _this->fsm_timestamp += _this->fsm_delay;
+    _this->fsm_delay      = 1;
 
     switch (_this->state.get()) {
         case IDLE:
@@ -286,40 +361,7 @@ void TransposeEngine::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
 
         case LOADTILE:
             //Send Request Process
-            if ((_this->fsm_counter < _this->n_row_per_tile) && (_this->pending_req_queue.size() <= _this->queue_depth))
-            {
-                //Form request
-                _this->tcdm_req->init();
-                _this->tcdm_req->set_addr(_this->x_addr
-                    + _this->row_iter * _this->tile_dim * _this->n_size * _this->elem_size /*row tile offset*/
-                    + _this->col_iter * _this->tile_dim                 * _this->elem_size /*col tile offset*/
-                    + _this->fsm_counter                * _this->n_size * _this->elem_size /*row cntr offset*/);
-                _this->tcdm_req->set_data(_this->access_buffer);
-                _this->tcdm_req->set_is_write(0);
-                _this->tcdm_req->set_size(_this->n_col_per_tile * _this->elem_size);
-
-                //Send request
-                vp::IoReqStatus err = _this->tcdm_itf.req(_this->tcdm_req);
-                _this->trace.msg(vp::Trace::LEVEL_TRACE,"[TransposeEngine][LOADTILE-ij: %0d-%0d] --- Send TCDM req #%d\n", _this->row_iter, _this->col_iter, _this->fsm_counter);
-
-                //Check error
-                if (err != vp::IO_REQ_OK) {
-                    _this->trace.fatal("[TransposeEngine][LOADTILE] There was an error while reading/writing data\n");
-                    return;
-                }
-
-                //Process Data
-                std::memcpy(&(_this->scratch_buffer[_this->tile_dim * _this->fsm_counter * _this->elem_size]), _this->access_buffer, _this->n_col_per_tile * _this->elem_size);
-
-                //Counte on receiving cycle
-                uint32_t receive_stamp = _this->tcdm_req->get_latency() + _this->fsm_timestamp;
-
-                //Push pending request queue
-                _this->pending_req_queue.push(receive_stamp);
-
-                //Add counter
-                _this->fsm_counter += 1;
-            }
+            _this->send_tile_reqs(false);
 
             //Recieve Process
             while((_this->pending_req_queue.size()!= 0) && (_this->pending_req_queue.front() <= _this->fsm_timestamp) ){
@@ -339,47 +381,15 @@ void TransposeEngine::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
                 _this->state.set(STORETILE);
             } else {
                 _this->state.set(LOADTILE);
+                _this->fsm_delay        = _this->next_event_delay();
             }
 
-            _this->event_enqueue(_this->fsm_event, 1);
+            _this->event_enqueue(_this->fsm_event, _this->fsm_delay);
             break;
 
         case STORETILE:
             //Send Request Process
-            if ((_this->fsm_counter < _this->n_row_per_tile) && (_this->pending_req_queue.size() <= _this->queue_depth))
-            {
-                //Form request
-                _this->tcdm_req->init();
-                _this->tcdm_req->set_addr(_this->y_addr
-                    + _this->col_iter * _this->tile_dim * _this->m_size * _this->elem_size /*row tile offset*/
-                    + _this->row_iter * _this->tile_dim                 * _this->elem_size /*col tile offset*/
-                    + _this->fsm_counter                * _this->m_size * _this->elem_size /*row cntr offset*/);
-                _this->tcdm_req->set_data(_this->access_buffer);
-                _this->tcdm_req->set_is_write(1);
-                _this->tcdm_req->set_size(_this->n_col_per_tile * _this->elem_size);
-
-                //Process Data
-                std::memcpy(_this->access_buffer, &(_this->transposed_buffer[_this->tile_dim * _this->fsm_counter * _this->elem_size]), _this->n_col_per_tile * _this->elem_size);
-
-                //Send request
-                vp::IoReqStatus err = _this->tcdm_itf.req(_this->tcdm_req);
-                _this->trace.msg(vp::Trace::LEVEL_TRACE,"[TransposeEngine][STORETILE-ij: %0d-%0d] --- Send TCDM req #%d\n", _this->row_iter, _this->col_iter, _this->fsm_counter);
-
-                //Check error
-                if (err != vp::IO_REQ_OK) {
-                    _this->trace.fatal("[TransposeEngine][STORETILE] There was an error while reading/writing data\n");
-                    return;
-                }
-
-                //Counte on receiving cycle
-                uint32_t receive_stamp = _this->tcdm_req->get_latency() + _this->fsm_timestamp;
-
-                //Push pending request queue
-                _this->pending_req_queue.push(receive_stamp);
-
-                //Add counter
-                _this->fsm_counter += 1;
-            }
+            _this->send_tile_reqs(true);
 
             //Recieve Process
             while((_this->pending_req_queue.size()!= 0) && (_this->pending_req_queue.front() <= _this->fsm_timestamp) ){
@@ -406,9 +416,10 @@ void TransposeEngine::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
                 }
             } else {
                 _this->state.set(STORETILE);
+                _this->fsm_delay        = _this->next_event_delay();
             }
 
-            _this->event_enqueue(_this->fsm_event, 1);
+            _this->event_enqueue(_this->fsm_event, _this->fsm_delay);
             break;
 
         case FINISHED:
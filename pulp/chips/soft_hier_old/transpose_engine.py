@@ -26,7 +26,8 @@ class TransposeEngine(gvsoc.systree.Component):
                 tcdm_bank_width: int,
                 tcdm_bank_number: int,
                 queue_depth: int=16,
-                buffer_dim: int=32):
+                buffer_dim: int=32,
+                nb_ports: int=1):
 
         super().__init__(parent, name)
 
@@ -37,6 +38,7 @@ class TransposeEngine(gvsoc.systree.Component):
             'tcdm_bank_number'  : tcdm_bank_number,
             'queue_depth'       : queue_depth,
             'buffer_dim'        : buffer_dim,
+            'nb_ports'          : nb_ports,
         })
 
     def i_INPUT(self) -> gvsoc.systree.SlaveItf:
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Tile transpose kernels of the TransposeEngine, kept apart from the model so
+ * that they can be checked without gvsoc (tests/transpose_engine).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define TRANSPOSE_ENGINE_SSE2
+#endif
+
+// Transpose the S x S square of T elements at src into dst, both with rows of stride bytes
+template<typename T, int S>
+inline void transpose_square(const uint8_t *src, uint8_t *dst, int stride)
+{
+    for (int i = 0; i < S; ++i)
+    {
+        for (int j = 0; j < S; ++j)
+        {
+            *(T *)(dst + i*stride + j*sizeof(T)) = *(const T *)(src + j*stride + i*sizeof(T));
+        }
+    }
+}
+
+#ifdef TRANSPOSE_ENGINE_SSE2
+template<>
+inline void transpose_square<uint8_t, 8>(const uint8_t *src, uint8_t *dst, int stride)
+{
+    __m128i r[8];
+    for (int k = 0; k < 8; ++k) r[k] = _mm_loadl_epi64((const __m128i *)(src + k*stride));
+
+    __m128i a0 = _mm_unpacklo_epi8(r[0], r[1]);
+    __m128i a1 = _mm_unpacklo_epi8(r[2], r[3]);
+    __m128i a2 = _mm_unpacklo_epi8(r[4], r[5]);
+    __m128i a3 = _mm_unpacklo_epi8(r[6], r[7]);
+    __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+    __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+    __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+    __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+    __m128i o[4] = {
+        _mm_unpacklo_epi32(b0, b2), _mm_unpackhi_epi32(b0, b2),
+        _mm_unpacklo_epi32(b1, b3), _mm_unpackhi_epi32(b1, b3)
+    };
+
+    for (int k = 0; k < 4; ++k)
+    {
+        _mm_storel_epi64((__m128i *)(dst + (2*k)*stride), o[k]);
+        _mm_storel_epi64((__m128i *)(dst + (2*k + 1)*stride), _mm_srli_si128(o[k], 8));
+    }
+}
+
+template<>
+inline void transpose_square<uint16_t, 8>(const uint8_t *src, uint8_t *dst, int stride)
+{
+    __m128i r[8];
+    for (int k = 0; k < 8; ++k) r[k] = _mm_loadu_si128((const __m128i *)(src + k*stride));
+
+    __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+    __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+    __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+    __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+    __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+    __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+    __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+    __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+    __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+    __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+    __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+    __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+    __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+    __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+    __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+    __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+    __m128i o[8] = {
+        _mm_unpacklo_epi64(b0, b4), _mm_unpackhi_epi64(b0, b4),
+        _mm_unpacklo_epi64(b1, b5), _mm_unpackhi_epi64(b1, b5),
+        _mm_unpacklo_epi64(b2, b6), _mm_unpackhi_epi64(b2, b6),
+        _mm_unpacklo_epi64(b3, b7), _mm_unpackhi_epi64(b3, b7)
+    };
+
+    for (int k = 0; k < 8; ++k) _mm_storeu_si128((__m128i *)(dst + k*stride), o[k]);
+}
+
+template<>
+inline void transpose_square<uint32_t, 4>(const uint8_t *src, uint8_t *dst, int stride)
+{
+    __m128i r[4];
+    for (int k = 0; k < 4; ++k) r[k] = _mm_loadu_si128((const __m128i *)(src + k*stride));
+
+    __m128i a0 = _mm_unpacklo_epi32(r[0], r[1]);
+    __m128i a1 = _mm_unpackhi_epi32(r[0], r[1]);
+    __m128i a2 = _mm_unpacklo_epi32(r[2], r[3]);
+    __m128i a3 = _mm_unpackhi_epi32(r[2], r[3]);
+
+    _mm_storeu_si128((__m128i *)(dst + 0*stride), _mm_unpacklo_epi64(a0, a2));
+    _mm_storeu_si128((__m128i *)(dst + 1*stride), _mm_unpackhi_epi64(a0, a2));
+    _mm_storeu_si128((__m128i *)(dst + 2*stride), _mm_unpacklo_epi64(a1, a3));
+    _mm_storeu_si128((__m128i *)(dst + 3*stride), _mm_unpackhi_epi64(a1, a3));
+}
+#endif
+
+// Transpose the dim x dim matrix of T elements, by blocks of BLOCK x BLOCK
+// elements to stay in the host cache, each block being done by S x S squares.
+// Rows and columns not covered by the squares are done element by element.
+template<typename T, int S>
+inline void transpose_matrix(const uint8_t *src, uint8_t *dst, int dim)
+{
+    const int BLOCK  = 64;
+    const int stride = dim * sizeof(T);
+    const int dim_s  = dim - dim % S;
+
+    for (int bi = 0; bi < dim_s; bi += BLOCK)
+    {
+        for (int bj = 0; bj < dim_s; bj += BLOCK)
+        {
+            int i_end = std::min(bi + BLOCK, dim_s);
+            int j_end = std::min(bj + BLOCK, dim_s);
+            for (int i = bi; i < i_end; i += S)
+            {
+                for (int j = bj; j < j_end; j += S)
+                {
+                    transpose_square<T, S>(src + j*stride + i*sizeof(T), dst + i*stride + j*sizeof(T), stride);
+                }
+            }
+        }
+    }
+
+    T * src_buf = (T *) src;
+    T * dst_buf = (T *) dst;
+    for (int i = 0; i < dim; ++i)
+    {
+        for (int j = (i < dim_s ? dim_s : 0); j < dim; ++j)
+        {
+            dst_buf[i*dim + j] = src_buf[j*dim + i];
+        }
+    }
+}
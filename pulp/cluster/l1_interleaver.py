@@ -19,7 +19,8 @@ import gvsoc.systree as st
 class L1_interleaver(st.Component):
 
     def __init__(self, parent, slave, nb_slaves=0, nb_masters=0, stage_bits=0, interleaving_bits=2,
-            offset_mask=0):
+            offset_mask=0, bank_conflicts=False, bank_profiler=False, bank_profiler_file='',
+            bank_profiler_top=16):
 
         super(L1_interleaver, self).__init__(parent, slave)
 
@@ -31,4 +32,8 @@ class L1_interleaver(st.Component):
             'stage_bits': stage_bits,
             'interleaving_bits': interleaving_bits,
             'offset_mask': offset_mask,
+            'bank_conflicts': bank_conflicts,
+            'bank_profiler': bank_profiler,
+            'bank_profiler_file': bank_profiler_file,
+            'bank_profiler_top': bank_profiler_top,
         })
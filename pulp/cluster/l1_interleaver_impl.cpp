@@ -22,9 +22,11 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
 #include <vp/debug_mem.hpp>
+#include "pulp/common/bank_profiler.hpp"
 #include <stdio.h>
 #include <math.h>
 #include <vector>
+#include <algorithm>
 
 class interleaver : public vp::Component, public vp::DebugMemIf
 {
@@ -33,6 +35,8 @@ public:
 
   interleaver(vp::ComponentConf &config);
 
+  void stop() override;
+
   static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
   static vp::IoReqStatus req_ts(vp::Block *__this, vp::IoReq *req);
 
@@ -46,6 +50,30 @@ public:
 
 
 private:
+  // Request crossing interleaving granules, split into one part per granule
+  struct SplitReq
+  {
+    vp::IoReq *req;
+    // Parts not yet answered, plus one while parts are being sent
+    int remaining;
+    // Latency of the slowest part
+    int64_t latency;
+    bool invalid;
+  };
+
+  // Part of a split request, sent to a single bank
+  struct SubReq : public vp::IoReq
+  {
+    SplitReq *split;
+  };
+
+  static void bank_resp(vp::Block *__this, vp::IoReq *req);
+  static void bank_grant(vp::Block *__this, vp::IoReq *req);
+  vp::IoReqStatus split_req(vp::IoReq *req);
+  void split_part_done(SplitReq *split, vp::IoReq *part);
+  // Report an access to a bank to the profiler, addr is the address received by the interleaver
+  inline void account_access(int bank_id, uint64_t addr);
+
   vp::Trace     trace;
 
   vp::IoMaster **out;
@@ -63,6 +91,9 @@ private:
   uint64_t offset_mask;
   std::vector<vp::DebugMemIf *> bank_debug_mem;
   bool bank_debug_mem_resolved = false;
+
+  std::vector<SubReq *> free_sub_reqs;
+  BankProfiler *profiler;
 };
 
 interleaver::interleaver(vp::ComponentConf &config)
@@ -95,9 +126,13 @@ interleaver::interleaver(vp::ComponentConf &config)
   for (int i=0; i<nb_slaves; i++)
   {
     out[i] = new vp::IoMaster();
+    out[i]->set_resp_meth(&interleaver::bank_resp);
+    out[i]->set_grant_meth(&interleaver::bank_grant);
     new_master_port("out_" + std::to_string(i), out[i]);
   }
 
+  profiler = new BankProfiler(this, nb_slaves);
+
   masters_in = new vp::IoSlave *[nb_masters];
   masters_ts_in = new vp::IoSlave *[nb_masters];
   for (int i=0; i<nb_masters; i++)
@@ -161,6 +196,16 @@ int interleaver::debug_mem_access(uint64_t addr, uint8_t *data, uint64_t size,
   return 0;
 }
 
+void interleaver::stop()
+{
+  this->profiler->dump_report();
+}
+
+inline void interleaver::account_access(int bank_id, uint64_t addr)
+{
+  this->profiler->access(bank_id, addr);
+}
+
 vp::IoReqStatus interleaver::req(vp::Block *__this, vp::IoReq *req)
 {
   interleaver *_this = (interleaver *)__this;
@@ -171,16 +216,149 @@ vp::IoReqStatus interleaver::req(vp::Block *__this, vp::IoReq *req)
 
   _this->trace.msg("Received IO req (offset: 0x%llx, size: 0x%llx, is_write: %d)\n", offset, size, is_write);
 
+  uint64_t granule_mask = (1ULL << _this->interleaving_bits) - 1;
+  if ((offset & granule_mask) + size > granule_mask + 1)
+  {
+    return _this->split_req(req);
+  }
+
   int bank_id = (offset >> _this->interleaving_bits) & _this->bank_mask;
   offset &= _this->offset_mask;
   uint64_t bank_offset = ((offset >> (_this->stage_bits + _this->interleaving_bits)) << _this->interleaving_bits) + (offset & ((1<<_this->interleaving_bits)-1));
 
   _this->trace.msg("Forwarding interleaved packet (port: %d, offset: 0x%x, size: 0x%x)\n", bank_id, bank_offset, size);
 
+  _this->account_access(bank_id, req->get_addr());
+
   req->set_addr(bank_offset);
   return _this->out[bank_id]->req_forward(req);
 }
 
+vp::IoReqStatus interleaver::split_req(vp::IoReq *req)
+{
+  // The request is sent to all the banks it touches in the same cycle, one part per granule,
+  // and its latency is the one of the slowest part
+  uint64_t addr = req->get_addr();
+  uint64_t size = req->get_size();
+  uint8_t *data = req->get_data();
+  uint64_t granule = 1ULL << this->interleaving_bits;
+  SplitReq local_split = { req, 1, 0, false };
+  SplitReq *split = &local_split;
+
+  while (size > 0)
+  {
+    int bank_id = (addr >> this->interleaving_bits) & this->bank_mask;
+    uint64_t offset = addr & this->offset_mask;
+    uint64_t bank_offset = ((offset >> (this->stage_bits + this->interleaving_bits)) << this->interleaving_bits)
+      + (offset & (granule - 1));
+
+    uint64_t chunk = granule - (addr & (granule - 1));
+    if (chunk > size)
+    {
+      chunk = size;
+    }
+
+    this->trace.msg("Forwarding split packet part (port: %d, offset: 0x%x, size: 0x%x)\n", bank_id, bank_offset, chunk);
+
+    SubReq *part;
+    if (this->free_sub_reqs.empty())
+    {
+      part = new SubReq();
+    }
+    else
+    {
+      part = this->free_sub_reqs.back();
+      this->free_sub_reqs.pop_back();
+    }
+
+    part->init();
+    part->set_addr(bank_offset);
+    part->set_size(chunk);
+    part->set_is_write(req->get_is_write());
+    part->set_data(data);
+
+    this->account_access(bank_id, addr);
+
+    vp::IoReqStatus status = this->out[bank_id]->req(part);
+    if (status == vp::IO_REQ_OK || status == vp::IO_REQ_INVALID)
+    {
+      split->invalid |= status == vp::IO_REQ_INVALID;
+      split->latency = std::max(split->latency, (int64_t)part->get_latency());
+      this->free_sub_reqs.push_back(part);
+    }
+    else
+    {
+      // Answered later, the split state must outlive this call
+      if (split == &local_split)
+      {
+        split = new SplitReq(local_split);
+      }
+      split->remaining++;
+      part->split = split;
+    }
+
+    addr += chunk;
+    data += chunk;
+    size -= chunk;
+  }
+
+  if (split == &local_split)
+  {
+    req->inc_latency(split->latency);
+    return split->invalid ? vp::IO_REQ_INVALID : vp::IO_REQ_OK;
+  }
+
+  // Release the sending reference, the last part response will answer the request
+  split->remaining--;
+  if (split->remaining == 0)
+  {
+    // All parts were already answered while sending
+    this->split_part_done(split, NULL);
+    return req->status;
+  }
+  return vp::IO_REQ_PENDING;
+}
+
+void interleaver::split_part_done(SplitReq *split, vp::IoReq *part)
+{
+  if (part)
+  {
+    split->invalid |= part->status == vp::IO_REQ_INVALID;
+    split->latency = std::max(split->latency, (int64_t)part->get_latency());
+    this->free_sub_reqs.push_back((SubReq *)part);
+    split->remaining--;
+  }
+
+  if (split->remaining == 0)
+  {
+    vp::IoReq *req = split->req;
+    req->inc_latency(split->latency);
+    req->status = split->invalid ? vp::IO_REQ_INVALID : vp::IO_REQ_OK;
+    // Only reply when the request went pending, otherwise split_req returns its status
+    if (part)
+    {
+      req->get_resp_port()->resp(req);
+    }
+    delete split;
+  }
+}
+
+void interleaver::bank_resp(vp::Block *__this, vp::IoReq *req)
+{
+  interleaver *_this = (interleaver *)__this;
+
+  // Only the parts of split requests come back here, other requests are forwarded
+  if (req != &_this->ts_req)
+  {
+    _this->split_part_done(((SubReq *)req)->split, req);
+  }
+}
+
+void interleaver::bank_grant(vp::Block *__this, vp::IoReq *req)
+{
+  // Nothing to do, the part is complete once its response is received
+}
+
 vp::IoReqStatus interleaver::req_ts(vp::Block *__this, vp::IoReq *req)
 {
   interleaver *_this = (interleaver *)__this;
@@ -196,6 +374,9 @@ vp::IoReqStatus interleaver::req_ts(vp::Block *__this, vp::IoReq *req)
 
   bank_offset &= ~(1<<(20 - _this->stage_bits));
 
+  // The read and the set are a single access to the bank
+  _this->account_access(bank_id, offset);
+
   if (!is_write)
   {
     req->set_addr(bank_offset);
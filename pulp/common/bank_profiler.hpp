@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vp/vp.hpp>
+#include <vp/itf/wire.hpp>
+#include <vp/signal.hpp>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Bank conflict profiler of interleaved memories.
+ *
+ * The interleaver reports each bank access with access(). A conflict is an access to a bank
+ * already accessed in the same cycle. With the bank_conflicts property of the interleaver, the
+ * conflicts of each bank are counted in its bank_<i>/conflicts signal.
+ *
+ * While sampling is enabled, the profiler also counts the accesses and conflicts of each bank,
+ * how many cycles saw a given number of conflicts, and the accesses and conflicts of each
+ * address. Sampling starts enabled if the bank_profiler property is true, and can be switched at
+ * runtime through the bank_profiler wire port. When neither is enabled, access() is a single
+ * test.
+ *
+ * dump_report() writes, if anything was sampled, a JSON report with the bank_profiler_top
+ * hottest addresses to bank_profiler_file, or to a file named after the interleaver path if it
+ * is empty. The interleaver calls it at the end of the simulation, and it is also called each
+ * time sampling is switched off, so that the report of a window can be read right away.
+ */
+class BankProfiler : public vp::Block
+{
+public:
+    BankProfiler(vp::Component *top, int nb_banks)
+    : vp::Block(top, "bank_profiler"), top(top)
+    {
+        this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+        this->counting = top->get_js_config()->get_child_bool("bank_conflicts");
+        this->enabled = top->get_js_config()->get_child_bool("bank_profiler");
+        this->active = this->counting || this->enabled;
+        this->file = top->get_js_config()->get_child_str("bank_profiler_file");
+        this->nb_top = top->get_js_config()->get_child_int("bank_profiler_top");
+
+        this->bank_accesses.resize(nb_banks);
+        this->bank_conflicts.resize(nb_banks);
+        this->bank_cycle.assign(nb_banks, -1);
+
+        for (int i = 0; i < nb_banks; i++)
+        {
+            this->bank_conflict_signals.push_back(new vp::Signal<uint64_t>(*top,
+                "bank_" + std::to_string(i) + "/conflicts", 64, vp::SignalCommon::ResetKind::Value, 0));
+        }
+
+        this->enable_itf.set_sync_meth(&BankProfiler::enable_sync);
+        top->new_slave_port("bank_profiler", &this->enable_itf, this);
+    }
+
+    // Report an access to a bank, addr is the address seen by the interleaver
+    inline void access(int bank_id, uint64_t addr)
+    {
+        if (this->active)
+        {
+            this->sample(bank_id, addr);
+        }
+    }
+
+    void dump_report()
+    {
+        this->end_cycle();
+
+        if (this->nb_accesses == 0)
+        {
+            return;
+        }
+
+        std::string path = this->file;
+        if (path.empty())
+        {
+            path = "bank_profile" + this->top->get_path() + ".json";
+            std::replace(path.begin() + 12, path.end() - 5, '/', '.');
+        }
+
+        FILE *out = fopen(path.c_str(), "w");
+        if (out == NULL)
+        {
+            this->trace.force_warning("Unable to open bank profile report (path: %s)\n", path.c_str());
+            return;
+        }
+
+        fprintf(out, "{\n  \"component\": \"%s\",\n", this->top->get_path().c_str());
+        fprintf(out, "  \"nb_banks\": %zu,\n", this->bank_accesses.size());
+        fprintf(out, "  \"active_cycles\": %lu,\n", this->nb_active_cycles);
+        fprintf(out, "  \"accesses\": %lu,\n", this->nb_accesses);
+        fprintf(out, "  \"conflicts\": %lu,\n", this->nb_conflicts);
+
+        fprintf(out, "  \"banks\": [");
+        for (size_t i = 0; i < this->bank_accesses.size(); i++)
+        {
+            fprintf(out, "%s\n    { \"bank\": %zu, \"accesses\": %lu, \"conflicts\": %lu }",
+                i ? "," : "", i, this->bank_accesses[i], this->bank_conflicts[i]);
+        }
+        fprintf(out, "\n  ],\n");
+
+        // Number of cycles with accesses which had 0, 1, 2... conflicts
+        fprintf(out, "  \"conflicts_per_cycle\": [");
+        for (size_t i = 0; i < this->cycle_histogram.size(); i++)
+        {
+            fprintf(out, "%s%lu", i ? ", " : "", this->cycle_histogram[i]);
+        }
+        fprintf(out, "],\n");
+
+        std::vector<std::pair<uint64_t, AddrStats>> hottest(this->addr_stats.begin(),
+            this->addr_stats.end());
+        size_t nb_top = std::min(hottest.size(), (size_t)std::max(this->nb_top, 0));
+        std::partial_sort(hottest.begin(), hottest.begin() + nb_top, hottest.end(),
+            [](const std::pair<uint64_t, AddrStats> &a, const std::pair<uint64_t, AddrStats> &b) {
+                if (a.second.conflicts != b.second.conflicts) return a.second.conflicts > b.second.conflicts;
+                if (a.second.accesses != b.second.accesses) return a.second.accesses > b.second.accesses;
+                return a.first < b.first;
+            });
+
+        fprintf(out, "  \"hottest\": [");
+        for (size_t i = 0; i < nb_top; i++)
+        {
+            fprintf(out, "%s\n    { \"addr\": \"0x%lx\", \"bank\": %d, \"accesses\": %lu, \"conflicts\": %lu }",
+                i ? "," : "", hottest[i].first, hottest[i].second.bank, hottest[i].second.accesses,
+                hottest[i].second.conflicts);
+        }
+        fprintf(out, "\n  ]\n}\n");
+
+        fclose(out);
+    }
+
+private:
+    struct AddrStats
+    {
+        int bank;
+        uint64_t accesses;
+        uint64_t conflicts;
+    };
+
+    void sample(int bank_id, uint64_t addr)
+    {
+        int64_t cycles = this->top->clock.get_cycles();
+        bool conflict = this->bank_cycle[bank_id] == cycles;
+        this->bank_cycle[bank_id] = cycles;
+
+        if (conflict && this->counting)
+        {
+            vp::Signal<uint64_t> *signal = this->bank_conflict_signals[bank_id];
+            *signal = signal->get() + 1;
+        }
+
+        if (!this->enabled)
+        {
+            return;
+        }
+
+        if (cycles != this->cycle)
+        {
+            this->end_cycle();
+            this->cycle = cycles;
+        }
+
+        AddrStats &stats = this->addr_stats.emplace(addr, AddrStats{ bank_id, 0, 0 }).first->second;
+
+        this->nb_accesses++;
+        this->bank_accesses[bank_id]++;
+        stats.accesses++;
+
+        if (conflict)
+        {
+            this->nb_conflicts++;
+            this->cycle_conflicts++;
+            this->bank_conflicts[bank_id]++;
+            stats.conflicts++;
+        }
+        this->cycle_accessed = true;
+    }
+
+    // Account the conflicts of the current cycle in the histogram
+    void end_cycle()
+    {
+        if (this->cycle_accessed)
+        {
+            if (this->cycle_histogram.size() <= this->cycle_conflicts)
+            {
+                this->cycle_histogram.resize(this->cycle_conflicts + 1);
+            }
+            this->cycle_histogram[this->cycle_conflicts]++;
+            this->nb_active_cycles++;
+        }
+        this->cycle_accessed = false;
+        this->cycle_conflicts = 0;
+    }
+
+    static void enable_sync(vp::Block *__this, bool active)
+    {
+        BankProfiler *_this = (BankProfiler *)__this;
+        _this->trace.msg(vp::Trace::LEVEL_INFO, "%s bank profiler\n", active ? "Enabling" : "Disabling");
+        bool was_enabled = _this->enabled;
+        _this->enabled = active;
+        _this->active = _this->counting || _this->enabled;
+
+        if (was_enabled && !active)
+        {
+            _this->dump_report();
+        }
+    }
+
+    vp::Component *top;
+    vp::Trace trace;
+    vp::WireSlave<bool> enable_itf;
+    // Conflicts counted in the signals, sampling enabled, and any of both
+    bool counting;
+    bool enabled;
+    bool active;
+    std::string file;
+    int nb_top;
+
+    uint64_t nb_accesses = 0;
+    uint64_t nb_conflicts = 0;
+    uint64_t nb_active_cycles = 0;
+    std::vector<uint64_t> bank_accesses;
+    std::vector<uint64_t> bank_conflicts;
+    std::vector<vp::Signal<uint64_t> *> bank_conflict_signals;
+    // Last cycle where each bank was accessed
+    std::vector<int64_t> bank_cycle;
+    // Cycle being sampled, and its conflicts so far
+    int64_t cycle = -1;
+    size_t cycle_conflicts = 0;
+    bool cycle_accessed = false;
+    std::vector<uint64_t> cycle_histogram;
+    std::unordered_map<uint64_t, AddrStats> addr_stats;
+};
@@ -25,6 +25,7 @@
 #include <vp/itf/io.hpp>
 
 #include "datamover_streamer.hpp"
+#include "datamover_transpose.hpp"
 
 // MASKS
 #define L1_MASK                         0x0003FFFF
@@ -88,6 +89,9 @@ class Datamover : public vp::Component
         void unpack_config_from_reg();
         void update_streamer_config();
         void fill_elem_matrix(int num_rows);
+        void store_rows(const uint8_t (*tile)[DATAMOVER_BANDWIDTH_ELEMS], int first_row, int num_rows, int size);
+        void skip_rows(int num_rows);
+        void copy_tiles(const char *name);
         void copy();
         void transpose(uint8_t transpose_mode);
         void cim_layout_conversion();
@@ -152,13 +156,36 @@ class Datamover : public vp::Component
         //=========================================================
         void load_from_memory_functional(uint32_t addr, uint8_t *data, uint32_t size, uint32_t skip_prefix_bytes = 0, int64_t *latency_out = nullptr);
         void store_to_memory_functional(uint32_t addr, uint8_t *data, uint32_t size, int64_t *latency_out = nullptr);
+        bool l1_row_access(uint32_t addr, uint8_t *data, uint32_t size, bool is_write, int64_t *latency);
+
+        //=========================================================
+        // TILE PIPELINE
+        // Tiles go through load -> transpose -> store. The data is moved
+        // functionally, one tile after the other, while the timing assumes
+        // two tile buffers: tile N+1 is loaded while tile N is stored. Rows
+        // are streamed at one per cycle, plus the memory latency.
+        //=========================================================
+        void pipeline_start();
+        void pipeline_tile(const char *name);
+        void pipeline_end(const char *name);
+
+        int     pipeline_tiles;       // Tiles done in the current job
+        int64_t tile_load_cycles;     // Load stage of the current tile
+        int64_t tile_store_cycles;    // Store stage of the current tile
+        int64_t tile_load_latency;    // Max memory latency seen by the current tile loads
+        int64_t tile_store_latency;   // Max memory latency seen by the current tile stores
+        int64_t load_end;             // Cycle at which the last tile load is done
+        int64_t store_end;            // Cycle at which the last tile store is done
+        int64_t prev_store_end;       // Same for the tile before, which frees the buffer for the next load
+        int64_t serial_cycles;        // Same job without any overlap between the stages
 
         // CONFIG and IRQ
         vp::IoSlave cfg_port;
         vp::WireMaster<bool> irq;
 
-        // Internal Buffer
+        // Internal Buffers
         uint8_t elem_matrix[DATAMOVER_BANDWIDTH_ELEMS][DATAMOVER_BANDWIDTH_ELEMS];
+        uint8_t transposed_matrix[DATAMOVER_BANDWIDTH_ELEMS][DATAMOVER_BANDWIDTH_ELEMS];
 
         // STREAMERS
         HWPEStreamer<Datamover, uint8_t> streamer_in;
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 ETH Zurich, University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DATAMOVER_TRANSPOSE_HPP__
+#define __DATAMOVER_TRANSPOSE_HPP__
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define DATAMOVER_TRANSPOSE_SSE2
+#endif
+
+//========================================
+// Tile transposer
+//
+// The tile is TILE x TILE bytes. In mode m (1, 2 or 4 bytes per element), it
+// is seen as m blocks of R = TILE/m rows, each row holding R elements of m
+// bytes, and each block is transposed on its own:
+//
+//   out[c*R + i][m*j + e] = in[c*R + j][m*i + e]
+//
+// which is the order in which the engine emits the output rows. The
+// transposition is done on 8x8 (1 and 2 bytes) or 4x4 (4 bytes) element
+// squares, with SSE2 on x86 hosts.
+//========================================
+
+template<int TILE>
+class DatamoverTransposer {
+    static_assert(TILE % 32 == 0, "Tile size must be a multiple of 32 bytes");
+
+public:
+    static void transpose(const uint8_t (*in)[TILE], uint8_t (*out)[TILE], int mode) {
+        switch (mode) {
+            case 1: transpose_blocks<uint8_t, 8>(in, out, square_8x8_u8); break;
+            case 2: transpose_blocks<uint16_t, 8>(in, out, square_8x8_u16); break;
+            case 4: transpose_blocks<uint32_t, 4>(in, out, square_4x4_u32); break;
+        }
+    }
+
+    // Element by element version, used as reference
+    static void transpose_scalar(const uint8_t (*in)[TILE], uint8_t (*out)[TILE], int mode) {
+        const int R = TILE / mode;
+        for (int c = 0; c < mode; c++) {
+            for (int i = 0; i < R; i++) {
+                for (int j = 0; j < R; j++) {
+                    for (int e = 0; e < mode; e++) {
+                        out[c*R + i][mode*j + e] = in[c*R + j][mode*i + e];
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    // Transpose the S x S square of T elements at src into dst, rows being TILE bytes apart
+    typedef void (*square_fn)(const uint8_t *src, uint8_t *dst);
+
+    template<typename T, int S>
+    static void transpose_blocks(const uint8_t (*in)[TILE], uint8_t (*out)[TILE], square_fn square) {
+        const int m = sizeof(T);
+        const int R = TILE / m;
+        for (int c = 0; c < m; c++) {
+            for (int bi = 0; bi < R; bi += S) {
+                for (int bj = 0; bj < R; bj += S) {
+                    square(&in[c*R + bj][m*bi], &out[c*R + bi][m*bj]);
+                }
+            }
+        }
+    }
+
+#ifdef DATAMOVER_TRANSPOSE_SSE2
+    static void square_8x8_u8(const uint8_t *src, uint8_t *dst) {
+        __m128i r[8];
+        for (int k = 0; k < 8; k++) {
+            r[k] = _mm_loadl_epi64((const __m128i *)(src + k*TILE));
+        }
+
+        __m128i a0 = _mm_unpacklo_epi8(r[0], r[1]);
+        __m128i a1 = _mm_unpacklo_epi8(r[2], r[3]);
+        __m128i a2 = _mm_unpacklo_epi8(r[4], r[5]);
+        __m128i a3 = _mm_unpacklo_epi8(r[6], r[7]);
+
+        __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+        __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+        __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+        __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+
+        // Each of these holds two output rows
+        __m128i o[4] = {
+            _mm_unpacklo_epi32(b0, b2), _mm_unpackhi_epi32(b0, b2),
+            _mm_unpacklo_epi32(b1, b3), _mm_unpackhi_epi32(b1, b3)
+        };
+
+        for (int k = 0; k < 4; k++) {
+            _mm_storel_epi64((__m128i *)(dst + (2*k)*TILE), o[k]);
+            _mm_storel_epi64((__m128i *)(dst + (2*k + 1)*TILE), _mm_srli_si128(o[k], 8));
+        }
+    }
+
+    static void square_8x8_u16(const uint8_t *src, uint8_t *dst) {
+        __m128i r[8];
+        for (int k = 0; k < 8; k++) {
+            r[k] = _mm_loadu_si128((const __m128i *)(src + k*TILE));
+        }
+
+        __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+        __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+        __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+        __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+        __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+        __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+        __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+        __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+        __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+        __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+        __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+        __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+        __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+        __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+        __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+        __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+        __m128i o[8] = {
+            _mm_unpacklo_epi64(b0, b4), _mm_unpackhi_epi64(b0, b4),
+            _mm_unpacklo_epi64(b1, b5), _mm_unpackhi_epi64(b1, b5),
+            _mm_unpacklo_epi64(b2, b6), _mm_unpackhi_epi64(b2, b6),
+            _mm_unpacklo_epi64(b3, b7), _mm_unpackhi_epi64(b3, b7)
+        };
+
+        for (int k = 0; k < 8; k++) {
+            _mm_storeu_si128((__m128i *)(dst + k*TILE), o[k]);
+        }
+    }
+
+    static void square_4x4_u32(const uint8_t *src, uint8_t *dst) {
+        __m128i r[4];
+        for (int k = 0; k < 4; k++) {
+            r[k] = _mm_loadu_si128((const __m128i *)(src + k*TILE));
+        }
+
+        __m128i a0 = _mm_unpacklo_epi32(r[0], r[1]);
+        __m128i a1 = _mm_unpackhi_epi32(r[0], r[1]);
+        __m128i a2 = _mm_unpacklo_epi32(r[2], r[3]);
+        __m128i a3 = _mm_unpackhi_epi32(r[2], r[3]);
+
+        _mm_storeu_si128((__m128i *)(dst + 0*TILE), _mm_unpacklo_epi64(a0, a2));
+        _mm_storeu_si128((__m128i *)(dst + 1*TILE), _mm_unpackhi_epi64(a0, a2));
+        _mm_storeu_si128((__m128i *)(dst + 2*TILE), _mm_unpacklo_epi64(a1, a3));
+        _mm_storeu_si128((__m128i *)(dst + 3*TILE), _mm_unpackhi_epi64(a1, a3));
+    }
+#else
+    template<typename T, int S>
+    static void square_scalar(const uint8_t *src, uint8_t *dst) {
+        for (int i = 0; i < S; i++) {
+            for (int j = 0; j < S; j++) {
+                memcpy(dst + i*TILE + j*sizeof(T), src + j*TILE + i*sizeof(T), sizeof(T));
+            }
+        }
+    }
+
+    static void square_8x8_u8(const uint8_t *src, uint8_t *dst) { square_scalar<uint8_t, 8>(src, dst); }
+    static void square_8x8_u16(const uint8_t *src, uint8_t *dst) { square_scalar<uint16_t, 8>(src, dst); }
+    static void square_4x4_u32(const uint8_t *src, uint8_t *dst) { square_scalar<uint32_t, 4>(src, dst); }
+#endif
+};
+
+#endif
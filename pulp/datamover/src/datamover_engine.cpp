@@ -18,6 +18,7 @@
  * Authors: Cyrill Durrer, ETH Zurich (cdurrer@iis.ee.ethz.ch)
  */
 
+#include <algorithm>
 #include <datamover.hpp>
 
 void Datamover::unpack_config_from_reg() {
@@ -84,53 +85,126 @@ void Datamover::update_streamer_config() {
   );
   this->streamer_out.print_config();
 }
-
 void Datamover::fill_elem_matrix(int num_rows) {
   for(int i = 0; i < num_rows; i++) {
-    // this->streamer_in.print_state();
+    int64_t latency;
     uint32_t in_addr = this->streamer_in.iterate();
-    this->load_from_memory_functional(in_addr, elem_matrix[i], DATAMOVER_BANDWIDTH_ELEMS, 0, nullptr);
-    this->trace.msg(vp::Trace::LEVEL_INFO, "fill_elem_matrix(): read row %d: 0x...%08x from in_addr(%p)\n", i, *(uint64_t*)elem_matrix[i], in_addr);
+    this->load_from_memory_functional(in_addr, elem_matrix[i], DATAMOVER_BANDWIDTH_ELEMS, 0, &latency);
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "fill_elem_matrix(): read row %d: 0x...%08x from in_addr(%p)\n", i, *(uint64_t*)elem_matrix[i], in_addr);
+
+    this->tile_load_cycles++;
+    if(latency - 1 > this->tile_load_latency) {
+      this->tile_load_latency = latency - 1;
+    }
   }
 }
 
-void Datamover::copy() {
-  this->trace.msg(vp::Trace::LEVEL_INFO, "copy(): Starting data copy from %p to %p, length %d bytes\n", this->in_ptr, this->out_ptr, this->tot_len);
+// Store rows [first_row, first_row + num_rows) of the tile, size bytes each, at the next output addresses
+void Datamover::store_rows(const uint8_t (*tile)[DATAMOVER_BANDWIDTH_ELEMS], int first_row, int num_rows, int size) {
+  for(int i = first_row; i < first_row + num_rows; i++) {
+    int64_t latency;
+    uint32_t out_addr = this->streamer_out.iterate();
+    this->store_to_memory_functional(out_addr, (uint8_t *)tile[i], size, &latency);
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "store_rows(): wrote row %d (%d elems): 0x...%08x to out_addr(%p)\n", i, size, *(uint64_t*)tile[i], out_addr);
+
+    this->tile_store_cycles++;
+    if(latency - 1 > this->tile_store_latency) {
+      this->tile_store_latency = latency - 1;
+    }
+  }
+}
+
+// Advance the output streamer without writing, still takes one cycle per row
+void Datamover::skip_rows(int num_rows) {
+  for(int i = 0; i < num_rows; i++) {
+    this->streamer_out.iterate();   // ToDo: optimize in RTL if possible
+  }
+  this->tile_store_cycles += num_rows;
+  if(num_rows > 0) {
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "skip_rows(): skipped writing %d rows\n", num_rows);
+  }
+}
+
+void Datamover::pipeline_start() {
+  this->pipeline_tiles = 0;
+  this->tile_load_cycles = 0;
+  this->tile_store_cycles = 0;
+  this->tile_load_latency = 0;
+  this->tile_store_latency = 0;
+  this->load_end = 0;
+  this->store_end = 0;
+  this->prev_store_end = 0;
+  this->serial_cycles = 0;
+}
+
+// Account the tile which has just been loaded and stored. Its load can start
+// once the previous load is done and the tile before has left the buffer, its
+// store once it is loaded and the previous store is done.
+void Datamover::pipeline_tile(const char *name) {
+  int64_t load_cycles = this->tile_load_cycles + this->tile_load_latency;
+  int64_t store_cycles = this->tile_store_cycles + this->tile_store_latency;
+
+  int64_t load_start = std::max(this->load_end, this->prev_store_end);
+  this->load_end = load_start + load_cycles;
+
+  int64_t store_start = std::max(this->load_end, this->store_end);
+  this->prev_store_end = this->store_end;
+  this->store_end = store_start + store_cycles;
+
+  this->serial_cycles += load_cycles + store_cycles;
+
+  this->trace.msg(vp::Trace::LEVEL_INFO, "%s(): tile %d: load %ld -> %ld, store %ld -> %ld\n",
+    name, this->pipeline_tiles, load_start, this->load_end, store_start, this->store_end);
+
+  this->pipeline_tiles++;
+  this->tile_load_cycles = 0;
+  this->tile_store_cycles = 0;
+  this->tile_load_latency = 0;
+  this->tile_store_latency = 0;
+}
+
+void Datamover::pipeline_end(const char *name) {
+  this->trace.msg(vp::Trace::LEVEL_INFO, "%s(): %d tiles done in %ld cycles (%ld cycles without overlap)\n",
+    name, this->pipeline_tiles, this->store_end, this->serial_cycles);
+}
 
+// Rows are stored as they are loaded, used by copy and by the CIM layout conversion placeholder
+void Datamover::copy_tiles(const char *name) {
   update_streamer_config();
+  pipeline_start();
 
   int num_tiles = this->tot_len / DATAMOVER_BANDWIDTH_ELEMS;
   int leftover_rows = this->tot_len % DATAMOVER_BANDWIDTH_ELEMS;
   int leftover_elems = this->total_elements % DATAMOVER_BANDWIDTH_ELEMS;
 
   for(int tile_counter = 0; tile_counter < num_tiles; tile_counter++) {
-    this->trace.msg(vp::Trace::LEVEL_INFO, "copy(): Processing tile %d\n", tile_counter);
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "%s(): Processing tile %d\n", name, tile_counter);
     fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-    for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-      this->streamer_out.print_state();
-      uint32_t out_addr = this->streamer_out.iterate();
-      this->store_to_memory_functional(out_addr, elem_matrix[i], DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-      this->trace.msg(vp::Trace::LEVEL_INFO, "copy(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)elem_matrix[i], out_addr);
-    }
+    store_rows(elem_matrix, 0, DATAMOVER_BANDWIDTH_ELEMS, DATAMOVER_BANDWIDTH_ELEMS);
+    pipeline_tile(name);
   }
 
   if(leftover_rows > 0) {
-    this->trace.msg(vp::Trace::LEVEL_INFO, "copy(): Processing leftover rows, count: %d\n", leftover_rows);
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "%s(): Processing leftover rows, count: %d, leftover elems: %d\n", name, leftover_rows, leftover_elems);
     fill_elem_matrix(leftover_rows);
-    for(int i = 0; i < leftover_rows; i++) {
-      this->streamer_out.print_state();
-      uint32_t out_addr = this->streamer_out.iterate();
-      if(i == leftover_rows - 1 && leftover_elems > 0) {  // last row with leftover elements
-        this->store_to_memory_functional(out_addr, elem_matrix[i], leftover_elems, nullptr);
-        this->trace.msg(vp::Trace::LEVEL_INFO, "copy(): wrote leftover row %d with leftover elems %d: 0x...%08x to out_addr(%p)\n", i+1, leftover_elems, *(uint64_t*)elem_matrix[i], out_addr);
-      }
-      else {
-        this->store_to_memory_functional(out_addr, elem_matrix[i], DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-        this->trace.msg(vp::Trace::LEVEL_INFO, "copy(): wrote leftover row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)elem_matrix[i], out_addr);
-      }
+    if(leftover_elems > 0) {  // last row with leftover elements
+      store_rows(elem_matrix, 0, leftover_rows - 1, DATAMOVER_BANDWIDTH_ELEMS);
+      store_rows(elem_matrix, leftover_rows - 1, 1, leftover_elems);
     }
+    else {
+      store_rows(elem_matrix, 0, leftover_rows, DATAMOVER_BANDWIDTH_ELEMS);
+    }
+    pipeline_tile(name);
   }
 
+  pipeline_end(name);
+}
+
+void Datamover::copy() {
+  this->trace.msg(vp::Trace::LEVEL_INFO, "copy(): Starting data copy from %p to %p, length %d bytes\n", this->in_ptr, this->out_ptr, this->tot_len);
+
+  copy_tiles("copy");
+
   // Write to HWPE register to indicate completion
   this->trace.msg(vp::Trace::LEVEL_INFO, "copy(): Data copy completed, writing to finished register\n");
   this->datamover_finished = 1;
@@ -143,6 +217,7 @@ void Datamover::transpose(uint8_t transpose_mode) {
   }
 
   update_streamer_config();
+  pipeline_start();
 
   this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): Starting matrix (dim_m=%d, dim_n=%d) transpose with mode %d\n", this->matrix_dim_m, this->matrix_dim_n, transpose_mode);
 
@@ -150,121 +225,53 @@ void Datamover::transpose(uint8_t transpose_mode) {
   int n_tiles = (this->matrix_dim_n + DATAMOVER_BANDWIDTH_ELEMS - 1) / DATAMOVER_BANDWIDTH_ELEMS;   // including partial tiles
   int leftover_rows = this->matrix_dim_m % DATAMOVER_BANDWIDTH_ELEMS;
   int leftover_cols = this->matrix_dim_n % DATAMOVER_BANDWIDTH_ELEMS;
-  uint8_t out_row[DATAMOVER_BANDWIDTH_ELEMS];
+
+  // The tile is transposed as transpose_mode blocks of block_rows rows, each
+  // giving block_rows output rows (see DatamoverTransposer)
+  int block_rows = DATAMOVER_BANDWIDTH_ELEMS / transpose_mode;
+  int subtiles = (leftover_rows + block_rows - 1) / block_rows; // number of subtiles needed to cover leftover rows (ceil division)
 
   this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): matrix_dim_m=%d, matrix_dim_n=%d, leftover_rows=%d, leftover_cols=%d\n",
     this->matrix_dim_m, this->matrix_dim_n, leftover_rows, leftover_cols);
 
   for(int n_tile_counter = 0; n_tile_counter < n_tiles; n_tile_counter++) {
     for(int m_tile_counter = 0; m_tile_counter < m_tiles; m_tile_counter++) {
-      this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): Processing tile (m_tile_counter = %d / %d, n_tile_counter = %d / %d)\n", m_tile_counter+1, m_tiles, n_tile_counter+1, n_tiles);
-      if((m_tile_counter == m_tiles - 1 && leftover_rows > 0) && (n_tile_counter == n_tiles - 1 && leftover_cols > 0)) {
-        this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): Processing last tile with leftover rows and cols (m_tile=%d / %d, n_tile=%d / %d, leftover_rows=%d, leftover_cols=%d)\n", m_tile_counter+1, m_tiles, n_tile_counter+1, n_tiles, leftover_rows, leftover_cols);
-        fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);  // Note: fill_elem_matrix(leftover_rows) would be sufficient, but that would introduce problems with the streamer configuration
-        int subtiles = (leftover_rows + (DATAMOVER_BANDWIDTH_ELEMS / transpose_mode) - 1) / (DATAMOVER_BANDWIDTH_ELEMS / transpose_mode); // number of subtiles needed to cover leftover rows (ceil division)
-        int j_max, write_elems;
-        for(int c = 0; c < subtiles; c++) {
-          for(int i = 0; i < leftover_cols; i+=transpose_mode) {
-            if((c == subtiles - 1) && (leftover_rows % (DATAMOVER_BANDWIDTH_ELEMS / transpose_mode) != 0)) {
-              j_max = leftover_rows % (DATAMOVER_BANDWIDTH_ELEMS / transpose_mode);
-              write_elems = j_max * transpose_mode;
-            }
-            else {
-              j_max = DATAMOVER_BANDWIDTH_ELEMS / transpose_mode;
-              write_elems = DATAMOVER_BANDWIDTH_ELEMS;
-            }
-            for(int j = 0; j < j_max; j++) {
-              for(int elem_cnt = 0; elem_cnt < transpose_mode; elem_cnt++) {
-                out_row[transpose_mode*j + elem_cnt] = elem_matrix[c*(DATAMOVER_BANDWIDTH_ELEMS / transpose_mode) + j][i + elem_cnt];
-              }
-            }
-            this->streamer_out.print_state();
-            uint32_t out_addr = this->streamer_out.iterate();
-            this->store_to_memory_functional(out_addr, out_row, write_elems, nullptr);
-            this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-          }
-          for(int i = leftover_cols; i < DATAMOVER_BANDWIDTH_ELEMS; i+=transpose_mode) {
-            this->streamer_out.iterate();  // skip writing remaining rows of the tile     ToDo: optimize in RTL if possible
-            this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): skipped writing row %d\n", i+1);
-          }
-        }
-      }
-      else if(m_tile_counter == m_tiles - 1 && leftover_rows > 0) {  // last tiles in m-dimension with leftover rows
-        this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): Processing last M-tile (%d / %d) with leftover rows (%d)\n", m_tile_counter+1, m_tiles, leftover_rows);
-        fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);    // Note: fill_elem_matrix(leftover_rows) would be sufficient, but that would introduce problems with the streamer configuration
-        int subtiles = (leftover_rows + (DATAMOVER_BANDWIDTH_ELEMS / transpose_mode) - 1) / (DATAMOVER_BANDWIDTH_ELEMS / transpose_mode); // number of subtiles needed to cover leftover rows (ceil division)
-        int j_max, write_elems;
-        for(int c = 0; c < subtiles; c++) {
-          for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i+=transpose_mode) {
-            if((c == subtiles - 1) && (leftover_rows % (DATAMOVER_BANDWIDTH_ELEMS / transpose_mode) != 0)) {
-              j_max = leftover_rows % (DATAMOVER_BANDWIDTH_ELEMS / transpose_mode);
-              write_elems = j_max * transpose_mode;
-            }
-            else {
-              j_max = DATAMOVER_BANDWIDTH_ELEMS / transpose_mode;
-              write_elems = DATAMOVER_BANDWIDTH_ELEMS;
-            }
-            for(int j = 0; j < j_max; j++) {
-              for(int elem_cnt = 0; elem_cnt < transpose_mode; elem_cnt++) {
-                out_row[transpose_mode*j + elem_cnt] = elem_matrix[c*(DATAMOVER_BANDWIDTH_ELEMS / transpose_mode) + j][i + elem_cnt];
-              }
-            }
-            this->streamer_out.print_state();
-            uint32_t out_addr = this->streamer_out.iterate();
-            this->store_to_memory_functional(out_addr, out_row, write_elems, nullptr);
-            this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-          }
-        }
-        if(subtiles < transpose_mode) {  // if we have fewer subtiles than the transpose mode, we need to skip writing remaining rows of the tile
-          for(int c = subtiles; c < transpose_mode; c++) {
-            for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i+=transpose_mode) {
-              this->streamer_out.iterate();  // skip writing remaining rows of the tile     ToDo: optimize in RTL if possible
-              this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): skipped writing row %d\n", i+1);
-            }
-          }
+      bool last_m = m_tile_counter == m_tiles - 1 && leftover_rows > 0;   // last tiles in m-dimension with leftover rows
+      bool last_n = n_tile_counter == n_tiles - 1 && leftover_cols > 0;   // last tiles in n-dimension with leftover cols
+
+      this->trace.msg(vp::Trace::LEVEL_DEBUG, "transpose(): Processing tile (m_tile_counter = %d / %d, n_tile_counter = %d / %d, leftover rows: %d, leftover cols: %d)\n",
+        m_tile_counter+1, m_tiles, n_tile_counter+1, n_tiles, last_m ? leftover_rows : 0, last_n ? leftover_cols : 0);
+
+      // Note: fill_elem_matrix(leftover_rows) would be sufficient for the last M-tiles, but that would introduce problems with the streamer configuration
+      fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
+      DatamoverTransposer<DATAMOVER_BANDWIDTH_ELEMS>::transpose(elem_matrix, transposed_matrix, transpose_mode);
+
+      // Leftover rows only fill the first subtiles blocks, the last one partially.
+      // Leftover cols only give the first output rows of each block, the
+      // remaining ones are skipped.
+      int blocks = last_m ? subtiles : transpose_mode;
+      int rows = last_n ? (leftover_cols + transpose_mode - 1) / transpose_mode : block_rows;
+      int skipped_rows = last_n ? (DATAMOVER_BANDWIDTH_ELEMS - leftover_cols + transpose_mode - 1) / transpose_mode : 0;
+
+      for(int c = 0; c < blocks; c++) {
+        int write_elems = DATAMOVER_BANDWIDTH_ELEMS;
+        if(last_m && (c == subtiles - 1) && (leftover_rows % block_rows != 0)) {
+          write_elems = (leftover_rows % block_rows) * transpose_mode;
         }
+        store_rows(transposed_matrix, c*block_rows, rows, write_elems);
+        skip_rows(skipped_rows);
       }
-      else if(n_tile_counter == n_tiles - 1 && leftover_cols > 0) {  // last tiles in n-dimension with leftover cols
-        this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): Processing last N-tile (%d / %d) with leftover cols (%d)\n", n_tile_counter+1, n_tiles, leftover_cols);
-        fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-        for(int c = 0; c < transpose_mode; c++) {
-          for(int i = 0; i < leftover_cols; i+=transpose_mode) {
-            for(int j = 0; j < DATAMOVER_BANDWIDTH_ELEMS / transpose_mode; j++) {
-              for(int elem_cnt = 0; elem_cnt < transpose_mode; elem_cnt++) {
-                out_row[transpose_mode*j + elem_cnt] = elem_matrix[c*(DATAMOVER_BANDWIDTH_ELEMS / transpose_mode) + j][i + elem_cnt];
-              }
-            }
-            this->streamer_out.print_state();
-            uint32_t out_addr = this->streamer_out.iterate();
-            this->store_to_memory_functional(out_addr, out_row, DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-            this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-          }
-          for(int i = leftover_cols; i < DATAMOVER_BANDWIDTH_ELEMS; i+=transpose_mode) {
-            this->streamer_out.iterate();  // skip writing remaining rows of the tile     ToDo: optimize in RTL if possible
-            this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): skipped writing row %d\n", i+1);
-          }
-        }
-      }
-      else {  // complete tiles
-        this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): Processing complete tile (m_tile=%d, n_tile=%d)\n", m_tile_counter+1, n_tile_counter+1);
-        fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-        for(int c = 0; c < transpose_mode; c++) {
-          for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i+=transpose_mode) {
-            for(int j = 0; j < DATAMOVER_BANDWIDTH_ELEMS / transpose_mode; j++) {
-              for(int elem_cnt = 0; elem_cnt < transpose_mode; elem_cnt++) {
-                out_row[transpose_mode*j + elem_cnt] = elem_matrix[c*(DATAMOVER_BANDWIDTH_ELEMS / transpose_mode) + j][i + elem_cnt];
-              }
-            }
-            this->streamer_out.print_state();
-            uint32_t out_addr = this->streamer_out.iterate();
-            this->store_to_memory_functional(out_addr, out_row, DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-            this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-          }
-        }
+
+      if(last_m && !last_n) {  // if we have fewer subtiles than the transpose mode, we need to skip writing remaining rows of the tile
+        skip_rows((transpose_mode - subtiles) * block_rows);
       }
+
+      pipeline_tile("transpose");
     }
   }
 
+  pipeline_end("transpose");
+
   // Write to HWPE register to indicate completion
   this->trace.msg(vp::Trace::LEVEL_INFO, "transpose(): Data transpose completed, writing to finished register\n");
   this->datamover_finished = 1;
@@ -273,43 +280,10 @@ void Datamover::transpose(uint8_t transpose_mode) {
 void Datamover::cim_layout_conversion() {
   this->trace.msg(vp::Trace::LEVEL_INFO, "cim_layout_conversion(): Starting data conversion from %p to %p, length %d bytes\n", this->in_ptr, this->out_ptr, this->tot_len);
 
-  update_streamer_config();
-
   // ToDo: implement CIM layout conversion
 
-  // Same as copy() - placeholder (works for 64-aligned matrices, but no partial tile handling) ------------------------------
-  int num_tiles = this->tot_len / DATAMOVER_BANDWIDTH_ELEMS;
-  int leftover_rows = this->tot_len % DATAMOVER_BANDWIDTH_ELEMS;
-  int leftover_elems = this->total_elements % DATAMOVER_BANDWIDTH_ELEMS;
-
-  for(int tile_counter = 0; tile_counter < num_tiles; tile_counter++) {
-    this->trace.msg(vp::Trace::LEVEL_INFO, "cim_layout_conversion(): Processing tile %d\n", tile_counter);
-    fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-    for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-      this->streamer_out.print_state();
-      uint32_t out_addr = this->streamer_out.iterate();
-      this->store_to_memory_functional(out_addr, elem_matrix[i], DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-      this->trace.msg(vp::Trace::LEVEL_INFO, "cim_layout_conversion(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)elem_matrix[i], out_addr);
-    }
-  }
-
-  if(leftover_rows > 0) {
-    this->trace.msg(vp::Trace::LEVEL_INFO, "cim_layout_conversion(): Processing leftover rows, count: %d\n", leftover_rows);
-    fill_elem_matrix(leftover_rows);
-    for(int i = 0; i < leftover_rows; i++) {
-      this->streamer_out.print_state();
-      uint32_t out_addr = this->streamer_out.iterate();
-      if(i == leftover_rows - 1 && leftover_elems > 0) {  // last row with leftover elements
-        this->store_to_memory_functional(out_addr, elem_matrix[i], leftover_elems, nullptr);
-        this->trace.msg(vp::Trace::LEVEL_INFO, "cim_layout_conversion(): wrote leftover row %d with leftover elems %d: 0x...%08x to out_addr(%p)\n", i+1, leftover_elems, *(uint64_t*)elem_matrix[i], out_addr);
-      }
-      else {
-        this->store_to_memory_functional(out_addr, elem_matrix[i], DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-        this->trace.msg(vp::Trace::LEVEL_INFO, "cim_layout_conversion(): wrote leftover row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)elem_matrix[i], out_addr);
-      }
-    }
-  }
-  // --------------------------------------------
+  // Same as copy() - placeholder (works for 64-aligned matrices, but no partial tile handling)
+  copy_tiles("cim_layout_conversion");
 
   // Write to HWPE register to indicate completion
   this->trace.msg(vp::Trace::LEVEL_INFO, "cim_layout_conversion(): Data conversion completed, writing to finished register\n");
@@ -318,6 +292,7 @@ void Datamover::cim_layout_conversion() {
 
 void Datamover::unfold() {
   update_streamer_config();
+  pipeline_start();
 
   int dim_h = this->matrix_dim_m;   // height of the input matrix corresponds to the M dimension
   int dim_w = this->matrix_dim_n;   // width of the input matrix corresponds to the N dimension
@@ -328,7 +303,6 @@ void Datamover::unfold() {
   int w_tiles = (dim_w + DATAMOVER_BANDWIDTH_ELEMS - 1) / DATAMOVER_BANDWIDTH_ELEMS;   // including partial tiles
   int leftover_rows_c = this->num_channels % DATAMOVER_BANDWIDTH_ELEMS;
   int leftover_cols_w = dim_w % DATAMOVER_BANDWIDTH_ELEMS;
-  uint8_t out_row[DATAMOVER_BANDWIDTH_ELEMS];
 
   this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): num_channels = %d, matrix_dim_h=%d, matrix_dim_w=%d, leftover_rows_c=%d, leftover_cols_w=%d\n",
     this->num_channels, dim_h, dim_w, leftover_rows_c, leftover_cols_w);
@@ -336,95 +310,27 @@ void Datamover::unfold() {
   for(int h_counter = 0; h_counter < dim_h; h_counter++) {
     for(int w_tile_counter = 0; w_tile_counter < w_tiles; w_tile_counter++) {
       for(int c_tile_counter = 0; c_tile_counter < c_tiles; c_tile_counter++) {
-        this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): Processing tile (h_counter = %d / %d, w_tile_counter = %d / %d, c_tile_counter = %d / %d)\n", h_counter+1, dim_h, w_tile_counter+1, w_tiles, c_tile_counter+1, c_tiles);
-        if((c_tile_counter == c_tiles - 1 && leftover_rows_c > 0) && (w_tile_counter == w_tiles - 1 && leftover_cols_w > 0)) {
-          this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): Processing last tile of h = %u / %u with leftover rows and cols (c_tile = %d / %d, w_tile = %d / %d, leftover_rows_c = %d, leftover_cols_w = %d)\n", h_counter+1, dim_h, c_tile_counter+1, c_tiles, w_tile_counter+1, w_tiles, leftover_rows_c, leftover_cols_w);
-          fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);  // Note: fill_elem_matrix(leftover_rows_c) would be sufficient, but that would introduce problems with the streamer configuration
-          int subtiles = (leftover_rows_c + DATAMOVER_BANDWIDTH_ELEMS - 1) / DATAMOVER_BANDWIDTH_ELEMS; // number of subtiles needed to cover leftover rows (ceil division)
-          int j_max, write_elems;
-          for(int c = 0; c < subtiles; c++) {
-            for(int i = 0; i < leftover_cols_w; i++) {
-              if((c == subtiles - 1) && (leftover_rows_c % DATAMOVER_BANDWIDTH_ELEMS != 0)) {
-                j_max = leftover_rows_c % DATAMOVER_BANDWIDTH_ELEMS;
-                write_elems = j_max;
-              }
-              else {
-                j_max = DATAMOVER_BANDWIDTH_ELEMS;
-                write_elems = DATAMOVER_BANDWIDTH_ELEMS;
-              }
-              for(int j = 0; j < j_max; j++) {
-                out_row[j] = elem_matrix[c*DATAMOVER_BANDWIDTH_ELEMS + j][i];
-              }
-              this->streamer_out.print_state();
-              uint32_t out_addr = this->streamer_out.iterate();
-              this->store_to_memory_functional(out_addr, out_row, write_elems, nullptr);
-              this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-            }
-            for(int i = leftover_cols_w; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-              this->streamer_out.iterate();  // skip writing remaining rows of the tile     ToDo: optimize in RTL if possible
-              this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): skipped writing row %d\n", i+1);
-            }
-          }
-        }
-        else if(c_tile_counter == c_tiles - 1 && leftover_rows_c > 0) {  // last tiles in c-dimension with leftover rows
-          this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): Processing last C-tile (%d / %d) with leftover rows (%d)\n", c_tile_counter+1, c_tiles, leftover_rows_c);
-          fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);    // Note: fill_elem_matrix(leftover_rows_c) would be sufficient, but that would introduce problems with the streamer configuration
-          int subtiles = (leftover_rows_c + DATAMOVER_BANDWIDTH_ELEMS - 1) / DATAMOVER_BANDWIDTH_ELEMS; // number of subtiles needed to cover leftover rows (ceil division)
-          int j_max, write_elems;
-          for(int c = 0; c < subtiles; c++) {
-            for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-              if((c == subtiles - 1) && (leftover_rows_c % DATAMOVER_BANDWIDTH_ELEMS != 0)) {
-                j_max = leftover_rows_c % DATAMOVER_BANDWIDTH_ELEMS;
-                write_elems = j_max;
-              }
-              else {
-                j_max = DATAMOVER_BANDWIDTH_ELEMS;
-                write_elems = DATAMOVER_BANDWIDTH_ELEMS;
-              }
-              for(int j = 0; j < j_max; j++) {
-                out_row[j] = elem_matrix[c*DATAMOVER_BANDWIDTH_ELEMS + j][i];
-              }
-              this->streamer_out.print_state();
-              uint32_t out_addr = this->streamer_out.iterate();
-              this->store_to_memory_functional(out_addr, out_row, write_elems, nullptr);
-              this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-            }
-          }
-        }
-        else if(w_tile_counter == w_tiles - 1 && leftover_cols_w > 0) {  // last tiles in w-dimension with leftover cols
-          this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): Processing last W-tile (%d / %d) with leftover cols (%d)\n", w_tile_counter+1, w_tiles, leftover_cols_w);
-          fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-          for(int i = 0; i < leftover_cols_w; i++) {
-            for(int j = 0; j < DATAMOVER_BANDWIDTH_ELEMS; j++) {
-              out_row[j] = elem_matrix[j][i];
-            }
-            this->streamer_out.print_state();
-            uint32_t out_addr = this->streamer_out.iterate();
-            this->store_to_memory_functional(out_addr, out_row, DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-            this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-          }
-          for(int i = leftover_cols_w; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-            this->streamer_out.iterate();  // skip writing remaining rows of the tile     ToDo: optimize in RTL if possible
-            this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): skipped writing row %d\n", i+1);
-          }
-        }
-        else {  // complete tiles
-          this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): Processing complete tile (c_tile = %d / %d, w_tile = %d / %d, h_counter = %u / %u)\n", c_tile_counter+1, c_tiles, w_tile_counter+1, w_tiles, h_counter+1, dim_h);
-          fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-          for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-            for(int j = 0; j < DATAMOVER_BANDWIDTH_ELEMS; j++) {
-              out_row[j] = elem_matrix[j][i];
-            }
-            this->streamer_out.print_state();
-            uint32_t out_addr = this->streamer_out.iterate();
-            this->store_to_memory_functional(out_addr, out_row, DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-            this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-          }
-        }
+        bool last_c = c_tile_counter == c_tiles - 1 && leftover_rows_c > 0;   // last tiles in c-dimension with leftover rows
+        bool last_w = w_tile_counter == w_tiles - 1 && leftover_cols_w > 0;   // last tiles in w-dimension with leftover cols
+
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "unfold(): Processing tile (h_counter = %d / %d, w_tile_counter = %d / %d, c_tile_counter = %d / %d)\n", h_counter+1, dim_h, w_tile_counter+1, w_tiles, c_tile_counter+1, c_tiles);
+
+        // Note: fill_elem_matrix(leftover_rows_c) would be sufficient for the last C-tiles, but that would introduce problems with the streamer configuration
+        fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
+        DatamoverTransposer<DATAMOVER_BANDWIDTH_ELEMS>::transpose(elem_matrix, transposed_matrix, 1);
+
+        // One output row per W column, holding the channels of the tile
+        int rows = last_w ? leftover_cols_w : DATAMOVER_BANDWIDTH_ELEMS;
+        store_rows(transposed_matrix, 0, rows, last_c ? leftover_rows_c : DATAMOVER_BANDWIDTH_ELEMS);
+        skip_rows(DATAMOVER_BANDWIDTH_ELEMS - rows);
+
+        pipeline_tile("unfold");
       }
     }
   }
 
+  pipeline_end("unfold");
+
   // Write to HWPE register to indicate completion
   this->trace.msg(vp::Trace::LEVEL_INFO, "unfold(): Unfolding completed, writing to finished register\n");
   this->datamover_finished = 1;
@@ -432,6 +338,7 @@ void Datamover::unfold() {
 
 void Datamover::fold() {
   update_streamer_config();
+  pipeline_start();
 
   int dim_h = this->matrix_dim_m;   // height of the output matrix corresponds to the M dimension
   int dim_w = this->matrix_dim_n;   // width of the output matrix corresponds to the N dimension
@@ -442,7 +349,6 @@ void Datamover::fold() {
   int w_tiles = (dim_w + DATAMOVER_BANDWIDTH_ELEMS - 1) / DATAMOVER_BANDWIDTH_ELEMS;   // including partial tiles
   int leftover_rows_c = this->num_channels % DATAMOVER_BANDWIDTH_ELEMS;
   int leftover_cols_w = dim_w % DATAMOVER_BANDWIDTH_ELEMS;
-  uint8_t out_row[DATAMOVER_BANDWIDTH_ELEMS];
 
   this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): num_channels = %d, matrix_dim_h=%d, matrix_dim_w=%d, leftover_rows_c=%d, leftover_cols_w=%d\n",
     this->num_channels, dim_h, dim_w, leftover_rows_c, leftover_cols_w);
@@ -450,95 +356,26 @@ void Datamover::fold() {
   for(int h_counter = 0; h_counter < dim_h; h_counter++) {
     for(int w_tile_counter = 0; w_tile_counter < w_tiles; w_tile_counter++) {
       for(int c_tile_counter = 0; c_tile_counter < c_tiles; c_tile_counter++) {
-        this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): Processing tile (h_counter = %d / %d, w_tile_counter = %d / %d, c_tile_counter = %d / %d)\n", h_counter+1, dim_h, w_tile_counter+1, w_tiles, c_tile_counter+1, c_tiles);
-        if((c_tile_counter == c_tiles - 1 && leftover_rows_c > 0) && (w_tile_counter == w_tiles - 1 && leftover_cols_w > 0)) {
-          this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): Processing last tile of h = %u / %u with leftover rows and cols (c_tile = %d / %d, w_tile = %d / %d, leftover_rows_c = %d, leftover_cols_w = %d)\n", h_counter+1, dim_h, c_tile_counter+1, c_tiles, w_tile_counter+1, w_tiles, leftover_rows_c, leftover_cols_w);
-          fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-          int subtiles = (leftover_cols_w + DATAMOVER_BANDWIDTH_ELEMS - 1) / DATAMOVER_BANDWIDTH_ELEMS;
-          int j_max, write_elems;
-          for(int c = 0; c < subtiles; c++) {
-            for(int i = 0; i < leftover_rows_c; i++) {
-              if((c == subtiles - 1) && (leftover_cols_w % DATAMOVER_BANDWIDTH_ELEMS != 0)) {
-                j_max = leftover_cols_w % DATAMOVER_BANDWIDTH_ELEMS;
-                write_elems = j_max;
-              }
-              else {
-                j_max = DATAMOVER_BANDWIDTH_ELEMS;
-                write_elems = DATAMOVER_BANDWIDTH_ELEMS;
-              }
-              for(int j = 0; j < j_max; j++) {
-                out_row[j] = elem_matrix[c*DATAMOVER_BANDWIDTH_ELEMS + j][i];
-              }
-              this->streamer_out.print_state();
-              uint32_t out_addr = this->streamer_out.iterate();
-              this->store_to_memory_functional(out_addr, out_row, write_elems, nullptr);
-              this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-            }
-            for(int i = leftover_rows_c; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-              this->streamer_out.iterate();  // skip writing remaining rows of the tile
-              this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): skipped writing row %d\n", i+1);
-            }
-          }
-        }
-        else if(w_tile_counter == w_tiles - 1 && leftover_cols_w > 0) {  // last tiles in w-dimension with leftover cols
-          this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): Processing last W-tile (%d / %d) with leftover cols (%d)\n", w_tile_counter+1, w_tiles, leftover_cols_w);
-          fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-          int subtiles = (leftover_cols_w + DATAMOVER_BANDWIDTH_ELEMS - 1) / DATAMOVER_BANDWIDTH_ELEMS;
-          int j_max, write_elems;
-          for(int c = 0; c < subtiles; c++) {
-            for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-              if((c == subtiles - 1) && (leftover_cols_w % DATAMOVER_BANDWIDTH_ELEMS != 0)) {
-                j_max = leftover_cols_w % DATAMOVER_BANDWIDTH_ELEMS;
-                write_elems = j_max;
-              }
-              else {
-                j_max = DATAMOVER_BANDWIDTH_ELEMS;
-                write_elems = DATAMOVER_BANDWIDTH_ELEMS;
-              }
-              for(int j = 0; j < j_max; j++) {
-                out_row[j] = elem_matrix[c*DATAMOVER_BANDWIDTH_ELEMS + j][i];
-              }
-              this->streamer_out.print_state();
-              uint32_t out_addr = this->streamer_out.iterate();
-              this->store_to_memory_functional(out_addr, out_row, write_elems, nullptr);
-              this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-            }
-          }
-        }
-        else if(c_tile_counter == c_tiles - 1 && leftover_rows_c > 0) {  // last tiles in c-dimension with leftover rows
-          this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): Processing last C-tile (%d / %d) with leftover rows (%d)\n", c_tile_counter+1, c_tiles, leftover_rows_c);
-          fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-          for(int i = 0; i < leftover_rows_c; i++) {
-            for(int j = 0; j < DATAMOVER_BANDWIDTH_ELEMS; j++) {
-              out_row[j] = elem_matrix[j][i];
-            }
-            this->streamer_out.print_state();
-            uint32_t out_addr = this->streamer_out.iterate();
-            this->store_to_memory_functional(out_addr, out_row, DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-            this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-          }
-          for(int i = leftover_rows_c; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-            this->streamer_out.iterate();  // skip writing remaining rows of the tile
-            this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): skipped writing row %d\n", i+1);
-          }
-        }
-        else {  // complete tiles
-          this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): Processing complete tile (c_tile = %d / %d, w_tile = %d / %d, h_counter = %u / %u)\n", c_tile_counter+1, c_tiles, w_tile_counter+1, w_tiles, h_counter+1, dim_h);
-          fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
-          for(int i = 0; i < DATAMOVER_BANDWIDTH_ELEMS; i++) {
-            for(int j = 0; j < DATAMOVER_BANDWIDTH_ELEMS; j++) {
-              out_row[j] = elem_matrix[j][i];
-            }
-            this->streamer_out.print_state();
-            uint32_t out_addr = this->streamer_out.iterate();
-            this->store_to_memory_functional(out_addr, out_row, DATAMOVER_BANDWIDTH_ELEMS, nullptr);
-            this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): wrote row %d: 0x...%08x to out_addr(%p)\n", i+1, *(uint64_t*)out_row, out_addr);
-          }
-        }
+        bool last_c = c_tile_counter == c_tiles - 1 && leftover_rows_c > 0;   // last tiles in c-dimension with leftover rows
+        bool last_w = w_tile_counter == w_tiles - 1 && leftover_cols_w > 0;   // last tiles in w-dimension with leftover cols
+
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "fold(): Processing tile (h_counter = %d / %d, w_tile_counter = %d / %d, c_tile_counter = %d / %d)\n", h_counter+1, dim_h, w_tile_counter+1, w_tiles, c_tile_counter+1, c_tiles);
+
+        fill_elem_matrix(DATAMOVER_BANDWIDTH_ELEMS);
+        DatamoverTransposer<DATAMOVER_BANDWIDTH_ELEMS>::transpose(elem_matrix, transposed_matrix, 1);
+
+        // One output row per channel, holding the W columns of the tile
+        int rows = last_c ? leftover_rows_c : DATAMOVER_BANDWIDTH_ELEMS;
+        store_rows(transposed_matrix, 0, rows, last_w ? leftover_cols_w : DATAMOVER_BANDWIDTH_ELEMS);
+        skip_rows(DATAMOVER_BANDWIDTH_ELEMS - rows);
+
+        pipeline_tile("fold");
       }
     }
   }
 
+  pipeline_end("fold");
+
   // Write to HWPE register to indicate completion
   this->trace.msg(vp::Trace::LEVEL_INFO, "fold(): Folding completed, writing to finished register\n");
   this->datamover_finished = 1;
@@ -24,6 +24,29 @@
 #include <vector>
 #include <datamover.hpp>
 
+// Move a whole row with a single request instead of one transaction at a time.
+// The l1_interleaver splits it over the banks and returns the latency of the
+// slowest one. Returns false when the target refuses a request spanning several
+// transactions, in which case the caller goes through them one at a time.
+bool Datamover::l1_row_access(uint32_t addr, uint8_t *data, uint32_t size, bool is_write, int64_t *latency) {
+    this->io_req.init();
+    this->io_req.set_addr(addr);
+    this->io_req.set_size(size);
+    this->io_req.set_data(data);
+    this->io_req.set_is_write(is_write);
+
+    const int err = this->l1.req(&this->io_req);
+    if (err == vp::IO_REQ_INVALID && size > L1_TRANSACTION_SIZE) {
+        return false;
+    }
+    if (err != vp::IO_REQ_OK) {
+        this->trace.fatal("Functional memory %s failed at 0x%08x\n", is_write ? "write" : "read", addr);
+    }
+
+    *latency = this->io_req.get_latency();
+    return true;
+}
+
 // Functional read helper for activation/weight paths.
 // If skip_prefix_bytes==0: direct read into destination.
 // If skip_prefix_bytes>0: read [prefix + payload] into temp, then copy payload.
@@ -34,6 +57,11 @@ void Datamover::load_from_memory_functional(uint32_t addr, uint8_t *data, uint32
 
     auto run_reads = [&](uint8_t *dst, uint32_t total_size) {
         uint32_t offset = 0;
+
+        if (total_size != 0 && this->l1_row_access(masked_addr, dst, total_size, false, &max_latency)) {
+            return;
+        }
+
         const uint32_t transactions = (total_size + L1_TRANSACTION_SIZE - 1) / L1_TRANSACTION_SIZE;
         for (uint32_t txn = 0; txn < transactions; txn++) {
             const uint32_t txn_size = ((total_size - offset) > L1_TRANSACTION_SIZE)
@@ -76,9 +104,14 @@ void Datamover::load_from_memory_functional(uint32_t addr, uint8_t *data, uint32
 void Datamover::store_to_memory_functional(uint32_t addr, uint8_t *data, uint32_t size, int64_t *latency_out) {
     const uint32_t masked_addr = addr & CLUSTER_MASK;
     uint32_t offset = 0;
-    const uint32_t transactions = (size + L1_TRANSACTION_SIZE - 1) / L1_TRANSACTION_SIZE;
     int64_t max_latency = 0;
 
+    if (size != 0 && this->l1_row_access(masked_addr, data, size, true, &max_latency)) {
+        size = 0;
+    }
+
+    const uint32_t transactions = (size + L1_TRANSACTION_SIZE - 1) / L1_TRANSACTION_SIZE;
+
     for (uint32_t txn = 0; txn < transactions; txn++) {
         const uint32_t txn_size = ((size - offset) > L1_TRANSACTION_SIZE)
                                 ? L1_TRANSACTION_SIZE : (size - offset);
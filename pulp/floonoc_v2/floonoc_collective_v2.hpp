@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+
+/**
+ * Collective operations supported by FlooNoC v2 and the kernels used by the
+ * routers to merge read responses of a reduction.
+ *
+ * Operation numbering is the same as the legacy SoftHier FlooNoC so that the
+ * same software can drive both models.
+ */
+class FloonocCollectiveV2
+{
+public:
+    static constexpr int NONE = 0;
+    // Write broadcast, or plain read for read requests
+    static constexpr int MULTICAST = 1;
+    static constexpr int ADD_UINT16 = 2;
+    static constexpr int ADD_INT16 = 3;
+    static constexpr int ADD_FP16 = 4;
+    static constexpr int MAX_UINT16 = 5;
+    static constexpr int MAX_INT16 = 6;
+    static constexpr int MAX_FP16 = 7;
+    static constexpr int NB_OPS = 8;
+
+    static bool is_reduction(int op) { return op >= ADD_UINT16 && op < NB_OPS; }
+
+    // Fill a buffer with the neutral element of the reduction
+    static void init(int op, uint8_t *dst, uint64_t size);
+    // Reduce src into dst, element-wise
+    static void reduce(int op, uint8_t *dst, const uint8_t *src, uint64_t size);
+
+    static float fp16_to_float(uint16_t value);
+    // Rounds to nearest even. Taking a double lets the sum of 2 fp16 values be
+    // rounded only once.
+    static uint16_t double_to_fp16(double value);
+
+private:
+    template<typename F> static void reduce_16(uint8_t *dst, const uint8_t *src, uint64_t size, F op);
+};
+
+
+inline float FloonocCollectiveV2::fp16_to_float(uint16_t value)
+{
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f)
+    {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+    else if (mantissa == 0)
+    {
+        bits = sign;
+    }
+    else
+    {
+        // Subnormal, normalize it as float has enough exponent range
+        exponent = 127 - 15 + 1;
+        while ((mantissa & 0x400) == 0)
+        {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+
+inline uint16_t FloonocCollectiveV2::double_to_fp16(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = (bits >> 48) & 0x8000;
+    int32_t exponent = (int32_t)((bits >> 52) & 0x7ff) - 1023 + 15;
+    uint64_t mantissa = bits & 0xfffffffffffffULL;
+
+    if (((bits >> 52) & 0x7ff) == 0x7ff)
+    {
+        // Inf or NaN, keep NaN quiet
+        return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+    }
+
+    if (exponent >= 0x1f)
+    {
+        return sign | 0x7c00;
+    }
+
+    int shift = 42;
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+        {
+            return sign;
+        }
+        // Subnormal result, shift the mantissa with its implicit bit
+        mantissa |= 1ULL << 52;
+        shift += 1 - exponent;
+        exponent = 0;
+    }
+
+    // Round to nearest even, a mantissa overflow correctly carries into the
+    // exponent, up to infinity
+    uint64_t half = ((uint64_t)exponent << 10) + (mantissa >> shift);
+    uint64_t rest = mantissa & ((1ULL << shift) - 1);
+    uint64_t halfway = 1ULL << (shift - 1);
+    if (rest > halfway || (rest == halfway && (half & 1)))
+    {
+        half++;
+    }
+    return sign | half;
+}
+
+
+template<typename F>
+inline void FloonocCollectiveV2::reduce_16(uint8_t *dst, const uint8_t *src, uint64_t size, F op)
+{
+    // Elements are copied in and out of local arrays so that the compiler can
+    // vectorize the loop whatever the alignment of the buffers.
+    constexpr int block = 16;
+    uint16_t a[block] = {0}, b[block] = {0};
+    uint64_t nb_elems = size / 2;
+
+    for (uint64_t i=0; i<nb_elems; i+=block)
+    {
+        int count = nb_elems - i < block ? nb_elems - i : block;
+        memcpy(a, dst + i*2, count*2);
+        memcpy(b, src + i*2, count*2);
+        for (int j=0; j<block; j++)
+        {
+            a[j] = op(a[j], b[j]);
+        }
+        memcpy(dst + i*2, a, count*2);
+    }
+}
+
+
+inline void FloonocCollectiveV2::init(int op, uint8_t *dst, uint64_t size)
+{
+    uint16_t neutral = 0;
+
+    switch (op)
+    {
+        case MAX_INT16: neutral = 0x8000; break;
+        // -inf
+        case MAX_FP16: neutral = 0xfc00; break;
+    }
+
+    for (uint64_t i=0; i<size/2; i++)
+    {
+        memcpy(dst + i*2, &neutral, 2);
+    }
+}
+
+
+inline void FloonocCollectiveV2::reduce(int op, uint8_t *dst, const uint8_t *src, uint64_t size)
+{
+    switch (op)
+    {
+        case ADD_UINT16:
+        case ADD_INT16:
+            // Same wrap-around arithmetic for both signednesses
+            reduce_16(dst, src, size, [](uint16_t a, uint16_t b) -> uint16_t {
+                return a + b;
+            });
+            break;
+
+        case MAX_UINT16:
+            reduce_16(dst, src, size, [](uint16_t a, uint16_t b) -> uint16_t {
+                return a > b ? a : b;
+            });
+            break;
+
+        case MAX_INT16:
+            reduce_16(dst, src, size, [](uint16_t a, uint16_t b) -> uint16_t {
+                return (int16_t)a > (int16_t)b ? a : b;
+            });
+            break;
+
+        case ADD_FP16:
+            reduce_16(dst, src, size, [](uint16_t a, uint16_t b) -> uint16_t {
+                return double_to_fp16((double)fp16_to_float(a) + fp16_to_float(b));
+            });
+            break;
+
+        case MAX_FP16:
+            reduce_16(dst, src, size, [](uint16_t a, uint16_t b) -> uint16_t {
+                return fp16_to_float(a) >= fp16_to_float(b) ? a : b;
+            });
+            break;
+    }
+}
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <string>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
@@ -22,8 +23,9 @@
 #include "floonoc_router_v2.hpp"
 #include "floonoc_network_interface_v2.hpp"
 
-NetworkQueueV2::NetworkQueueV2(NetworkInterfaceV2 &ni, std::string name, uint64_t width, bool is_wide)
-: FloonocNodeV2(&ni, name), ni(ni), width(width), is_wide(is_wide)
+NetworkQueueV2::NetworkQueueV2(NetworkInterfaceV2 &ni, std::string name, uint64_t width, bool is_wide,
+    int nb_vcs)
+: FloonocNodeV2(&ni, name), ni(ni), width(width), is_wide(is_wide), queues(nb_vcs)
 {
     this->traces.new_trace("trace", &trace, vp::DEBUG);
 }
@@ -32,26 +34,75 @@ void NetworkQueueV2::reset(bool active)
 {
     if (active)
     {
-        while (this->queue.size() > 0)
+        for (std::queue<FloonocReqV2 *> &queue: this->queues)
         {
-            this->queue.pop();
+            while (queue.size() > 0)
+            {
+                queue.pop();
+            }
         }
-        this->stalled = false;
+        this->stalled.assign(this->queues.size(), false);
     }
 }
 
+bool NetworkQueueV2::is_empty()
+{
+    for (std::queue<FloonocReqV2 *> &queue: this->queues)
+    {
+        if (!queue.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 void NetworkQueueV2::check()
 {
-    if (!this->stalled && this->queue.size() > 0)
+    // One request is sent per cycle, from the highest priority class which
+    // can send, or from the highest one whose head waited for too long, as
+    // in the routers.
+    int64_t cycles = this->ni.clock.get_cycles();
+    int max_wait = this->ni.noc->vc_max_wait;
+    int selected = -1;
+    bool selected_starved = false;
+    for (int vc = this->queues.size() - 1; vc >= 0; vc--)
+    {
+        if (this->queues[vc].empty() || this->stalled[vc])
+        {
+            continue;
+        }
+
+        bool starved = max_wait > 0 && cycles - this->queues[vc].front()->queue_cycle > max_wait;
+        if (selected == -1 || (starved && !selected_starved))
+        {
+            selected = vc;
+            selected_starved = starved;
+        }
+    }
+
+    if (selected != -1)
     {
-        this->send_router_req();
+        this->send_router_req(selected);
     }
 }
 
-void NetworkQueueV2::unstall_queue(int from_x, int from_y)
+void NetworkQueueV2::push(FloonocReqV2 *req)
 {
-    this->trace.msg(vp::Trace::LEVEL_TRACE, "Unstalling queue (position: (%d, %d))\n", from_x, from_y);
-    this->stalled = false;
+    req->queue_cycle = this->ni.clock.get_cycles();
+    this->queues[req->vc].push(req);
+}
+
+void NetworkQueueV2::unstall_queue(int from_x, int from_y, int vc)
+{
+    this->trace.msg(vp::Trace::LEVEL_TRACE, "Unstalling queue (position: (%d, %d), vc: %d)\n", from_x, from_y, vc);
+    for (int i = 0; i < this->queues.size(); i++)
+    {
+        if (vc == FlooNocV2::ALL_VCS || vc == i)
+        {
+            this->stalled[i] = false;
+        }
+    }
     this->ni.fsm_event.enqueue();
 }
 
@@ -65,7 +116,16 @@ void NetworkQueueV2::handle_req(vp::IoReq *req, bool wide)
     // router_reqs. The destination NI uses router_req->wide to pick which
     // target (wide_output_itf vs narrow_output_itf) to forward to, so it must
     // match the input port, not the carrier network.
-    this->enqueue_router_req(req, true, wide, true);
+    int coll_type, x_extent, y_extent;
+    this->ni.noc->get_collective(req->get_addr(), coll_type, x_extent, y_extent);
+
+    // Multicast writes are forked by the routers beat by beat, which would
+    // make a separate AW phase reach the targets out of order with their
+    // data, so they only send data beats.
+    if (!req->get_is_write() || coll_type == FloonocCollectiveV2::NONE)
+    {
+        this->enqueue_router_req(req, true, wide, true);
+    }
     if (req->get_is_write())
     {
         this->enqueue_router_req(req, false, wide, true);
@@ -99,7 +159,7 @@ void NetworkQueueV2::enqueue_router_req(vp::IoReq *req, bool is_address, bool wi
         // (each beat forwards as a partial response chunk; the FloonocReqV2
         // is only released on the last beat).
         uint64_t size = is_address ? burst_size : std::min(this->width, burst_size);
-        FloonocReqV2 *router_req = new FloonocReqV2();
+        FloonocReqV2 *router_req = this->ni.noc->alloc_req();
 
         router_req->prepare();
         router_req->src_ni = &this->ni;
@@ -112,6 +172,7 @@ void NetworkQueueV2::enqueue_router_req(vp::IoReq *req, bool is_address, bool wi
         router_req->set_is_write(req->get_is_write());
         router_req->set_opcode(req->get_opcode());
         router_req->set_second_data(req->get_second_data());
+        router_req->vc = this->ni.get_req_vc(req, wide);
 
         if (wide)
         {
@@ -124,7 +185,10 @@ void NetworkQueueV2::enqueue_router_req(vp::IoReq *req, bool is_address, bool wi
                 this->ni.narrow_read_pending_burst_nb_req++;
         }
 
-        EntryV2 *entry = this->ni.noc->get_entry(burst_base, size);
+        int coll_type, x_extent, y_extent;
+        uint64_t base = this->ni.noc->get_collective(burst_base, coll_type, x_extent, y_extent);
+
+        EntryV2 *entry = this->ni.noc->get_entry(base, size, this->ni.decode_cache);
 
         if (entry == NULL)
         {
@@ -133,7 +197,7 @@ void NetworkQueueV2::enqueue_router_req(vp::IoReq *req, bool is_address, bool wi
         }
         else
         {
-            uint64_t max_size = entry->base + entry->size - burst_base;
+            uint64_t max_size = entry->base + entry->size - base;
             size = std::min(max_size, size);
 
             this->trace.msg(vp::Trace::LEVEL_TRACE,
@@ -142,13 +206,18 @@ void NetworkQueueV2::enqueue_router_req(vp::IoReq *req, bool is_address, bool wi
                 router_req, burst_base, size, entry->x, entry->y);
 
             router_req->set_size(size);
-            router_req->set_addr(burst_base - entry->remove_offset);
-            router_req->initiator_addr = burst_base;
+            router_req->set_addr(base - entry->remove_offset);
+            router_req->initiator_addr = base;
             router_req->dest_x = entry->x;
             router_req->dest_y = entry->y;
+
+            if (coll_type != FloonocCollectiveV2::NONE)
+            {
+                this->init_collective(router_req, coll_type, x_extent, y_extent);
+            }
         }
 
-        this->queue.push(router_req);
+        this->push(router_req);
 
         burst_base += size;
         burst_data += size;
@@ -157,13 +226,41 @@ void NetworkQueueV2::enqueue_router_req(vp::IoReq *req, bool is_address, bool wi
     this->ni.fsm_event.enqueue();
 }
 
+void NetworkQueueV2::init_collective(FloonocReqV2 *req, int coll_type, int x_extent, int y_extent)
+{
+    if (!req->get_is_write() && !FloonocCollectiveV2::is_reduction(coll_type))
+    {
+        this->trace.force_warning("Multicast read is not supported, doing unicast (addr: 0x%lx)\n",
+            req->initiator_addr);
+        return;
+    }
+
+    if (!this->ni.noc->is_collective_node(req->dest_x, req->dest_y))
+    {
+        this->trace.force_warning("Collective targets a node without network interface, doing unicast "
+            "(addr: 0x%lx, position: (%d, %d))\n", req->initiator_addr, req->dest_x, req->dest_y);
+        return;
+    }
+
+    // The targets are the nodes of the rectangle whose lower-left corner is
+    // the decoded destination, clipped to the mesh. Each of them receives the
+    // request at the same local address, i.e. after its own mapping offset is
+    // removed.
+    req->coll_type = coll_type;
+    req->coll_x0 = req->dest_x;
+    req->coll_y0 = req->dest_y;
+    req->coll_x1 = std::min(req->dest_x + x_extent, this->ni.noc->dim_x - 1);
+    req->coll_y1 = std::min(req->dest_y + y_extent, this->ni.noc->dim_y - 1);
+    req->coll_momentum = FlooNocV2::DIR_LOCAL;
+}
+
 void NetworkQueueV2::enqueue_router_rsp(FloonocReqV2 *req, bool is_address)
 {
     // Allocate a fresh FloonocReqV2 for the response traversal, copying the
-    // metadata the router needs from the incoming request. The caller deletes
+    // metadata the router needs from the incoming request. The caller releases
     // the original after we return — mirrors the v1 enqueue_router_req
     // response-path branch.
-    FloonocReqV2 *router_req = new FloonocReqV2();
+    FloonocReqV2 *router_req = this->ni.noc->alloc_req();
 
     router_req->prepare();
     router_req->src_ni = NULL;
@@ -179,15 +276,18 @@ void NetworkQueueV2::enqueue_router_rsp(FloonocReqV2 *req, bool is_address)
     router_req->set_is_write(req->get_is_write());
     router_req->set_opcode(req->get_opcode());
     router_req->set_second_data(req->get_second_data());
+    router_req->vc = req->vc;
+    router_req->coll_type = req->coll_type;
+    router_req->coll_parent = req->coll_parent;
 
-    this->queue.push(router_req);
+    this->push(router_req);
     this->ni.fsm_event.enqueue();
 }
 
-void NetworkQueueV2::send_router_req()
+void NetworkQueueV2::send_router_req(int vc)
 {
-    FloonocReqV2 *req = this->queue.front();
-    this->queue.pop();
+    FloonocReqV2 *req = this->queues[vc].front();
+    this->queues[vc].pop();
     vp::IoReq *burst = req->burst;
 
     if (req->src_ni)
@@ -213,13 +313,14 @@ void NetworkQueueV2::send_router_req()
     this->trace.msg(vp::Trace::LEVEL_DEBUG, "Handling addr burst (burst: %p, offset: 0x%x, size: 0x%x, is_write: %d, op: %d)\n",
                     burst, burst->get_addr(), burst->get_size(), burst->get_is_write(), burst->get_opcode());
 
-    this->stalled = this->router->handle_request(this, req, this->ni.x, this->ni.y);
-    if (this->stalled)
+    req->route_src_x = this->router->x;
+    this->stalled[vc] = this->router->handle_request(this, req, this->ni.x, this->ni.y);
+    if (this->stalled[vc])
     {
-        this->trace.msg(vp::Trace::LEVEL_TRACE, "Stalling network interface (position: (%d, %d))\n", this->ni.x, this->ni.y);
+        this->trace.msg(vp::Trace::LEVEL_TRACE, "Stalling network interface (position: (%d, %d), vc: %d)\n", this->ni.x, this->ni.y, vc);
     }
 
-    if (this->queue.size() > 0)
+    if (!this->is_empty())
     {
         this->ni.fsm_event.enqueue();
     }
@@ -234,9 +335,9 @@ NetworkInterfaceV2::NetworkInterfaceV2(FlooNocV2 *noc, int x, int y, std::string
       fsm_event(this, &NetworkInterfaceV2::fsm_handler),
       signal_narrow_req(*this, "narrow_req", 64),
       signal_wide_req(*this, "wide_req", 64),
-      req_queue(*this, "narrow", noc->narrow_width, false),
-      rsp_queue(*this, "rsp", noc->narrow_width, false),
-      wide_queue(*this, "wide", noc->wide_width, true),
+      req_queue(*this, "narrow", noc->narrow_width, false, noc->nb_vcs),
+      rsp_queue(*this, "rsp", noc->narrow_width, false, noc->nb_vcs),
+      wide_queue(*this, "wide", noc->wide_width, true, noc->nb_vcs),
       response_queue(this, "response_queue", &this->fsm_event)
 {
     this->noc = noc;
@@ -337,7 +438,7 @@ void NetworkInterfaceV2::wide_retry(vp::Block *__this, vp::IoRetryChannel)
 
         if (_this->wide_routers_stalled)
         {
-            _this->wide_routers_stalled->unstall_queue(_this->x, _this->y);
+            _this->wide_routers_stalled->unstall_queue(_this->x, _this->y, FlooNocV2::ALL_VCS);
             _this->wide_routers_stalled = NULL;
         }
     }
@@ -381,7 +482,7 @@ void NetworkInterfaceV2::narrow_retry(vp::Block *__this, vp::IoRetryChannel)
 
         if (_this->narrow_routers_stalled)
         {
-            _this->narrow_routers_stalled->unstall_queue(_this->x, _this->y);
+            _this->narrow_routers_stalled->unstall_queue(_this->x, _this->y, FlooNocV2::ALL_VCS);
             _this->narrow_routers_stalled = NULL;
         }
     }
@@ -442,13 +543,35 @@ int NetworkInterfaceV2::get_y()
     return this->y;
 }
 
-void NetworkInterfaceV2::unstall_queue(int from_x, int from_y)
+void NetworkInterfaceV2::unstall_queue(int from_x, int from_y, int vc)
+{
+}
+
+bool NetworkInterfaceV2::is_idle()
 {
+    return this->nb_pending_bursts[0] == 0 && this->nb_pending_bursts[1] == 0 &&
+        this->wide_read_pending_burst == NULL && this->wide_write_pending_burst == NULL &&
+        this->narrow_read_pending_burst == NULL && this->narrow_write_pending_burst == NULL &&
+        !this->owes_retry_wide_input && !this->owes_retry_narrow_input &&
+        this->wide_target_stalled_req == NULL && this->narrow_target_stalled_req == NULL &&
+        this->routers_stalled == NULL && this->response_queue.empty() &&
+        this->req_queue.is_empty() && this->rsp_queue.is_empty() && this->wide_queue.is_empty();
+}
+
+bool NetworkInterfaceV2::cancel_fsm()
+{
+    if (this->fsm_event.is_enqueued())
+    {
+        this->fsm_event.cancel();
+        return true;
+    }
+    return false;
 }
 
 vp::IoReqStatus NetworkInterfaceV2::narrow_req(vp::Block *__this, vp::IoReq *req)
 {
     NetworkInterfaceV2 *_this = (NetworkInterfaceV2 *)__this;
+    _this->noc->exit_quiescence();
     _this->signal_narrow_req = req->get_addr();
     return _this->handle_req(req, /*wide=*/false);
 }
@@ -456,6 +579,7 @@ vp::IoReqStatus NetworkInterfaceV2::narrow_req(vp::Block *__this, vp::IoReq *req
 vp::IoReqStatus NetworkInterfaceV2::wide_req(vp::Block *__this, vp::IoReq *req)
 {
     NetworkInterfaceV2 *_this = (NetworkInterfaceV2 *)__this;
+    _this->noc->exit_quiescence();
     _this->signal_wide_req = req->get_addr();
     return _this->handle_req(req, /*wide=*/true);
 }
@@ -536,7 +660,8 @@ bool NetworkInterfaceV2::handle_request(FloonocNodeV2 *node, FloonocReqV2 *req,
         // master, e.g. the iDMA's BurstInfo*).
         vp::IoSlave *port = wide ? &this->wide_input_itf : &this->narrow_input_itf;
 
-        if (burst->get_is_write())
+        // Collective writes are acked per beat, like reads
+        if (burst->get_is_write() && req->coll_type == FloonocCollectiveV2::NONE)
         {
             this->trace.msg(vp::Trace::LEVEL_DEBUG, "Received write burst response (burst: %p)\n",
                 burst);
@@ -563,12 +688,14 @@ bool NetworkInterfaceV2::handle_request(FloonocNodeV2 *node, FloonocReqV2 *req,
 
         this->fsm_event.enqueue();
 
-        delete req;
+        this->noc->free_req(req);
     }
     else
     {
         // Request path: we are the destination NI. Forward to the local target
-        // via our external master port.
+        // via our external master port. A target bound to both networks sees
+        // the requests arriving in the same cycle in the order in which their
+        // routers run, which the router wakeup mode keeps.
         this->trace.msg(vp::Trace::LEVEL_DEBUG,
             "Received request from router (req: %p, base: 0x%x, size: 0x%x, isaddr: (%d), "
             "position: (%d, %d)) origin Ni: (%d, %d)\n",
@@ -629,7 +756,7 @@ bool NetworkInterfaceV2::handle_request(FloonocNodeV2 *node, FloonocReqV2 *req,
         else
         {
             // Address-only phase of a split write — no actual transfer to do.
-            delete req;
+            this->noc->free_req(req);
         }
     }
 
@@ -652,7 +779,7 @@ void NetworkInterfaceV2::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
 
     if (_this->routers_stalled && !_this->target_stalled)
     {
-        _this->routers_stalled->unstall_queue(_this->x, _this->y);
+        _this->routers_stalled->unstall_queue(_this->x, _this->y, FlooNocV2::ALL_VCS);
         _this->routers_stalled = NULL;
     }
 
@@ -701,6 +828,11 @@ void NetworkInterfaceV2::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
     }
 
     _this->response_queue.trigger_next();
+
+    if (_this->is_idle())
+    {
+        _this->noc->check_quiescence();
+    }
 }
 
 
@@ -722,10 +854,7 @@ void NetworkInterfaceV2::handle_response(FloonocReqV2 *req)
         // upstream master when it reaches zero. The FloonocReqV2 is only
         // released once the downstream slave signals is_last — until then
         // it must stay alive for the next beat to mutate.
-        NetworkInterfaceV2 *origin_ni = req->src_ni;
-
-        req->dest_x = origin_ni->x;
-        req->dest_y = origin_ni->y;
+        this->set_response_dest(req);
         if (req->wide)
         {
             this->wide_queue.handle_rsp(req, false);
@@ -735,6 +864,13 @@ void NetworkInterfaceV2::handle_response(FloonocReqV2 *req)
             this->rsp_queue.handle_rsp(req, false);
         }
     }
+    else if (req->coll_type != FloonocCollectiveV2::NONE)
+    {
+        // Collective write: the burst is shared by all the targets, so each
+        // beat is acked on its own and the acks are merged by the routers.
+        this->set_response_dest(req);
+        this->rsp_queue.handle_rsp(req, true);
+    }
     else
     {
         // Write response: only emit one ack through the mesh, after all
@@ -762,6 +898,43 @@ void NetworkInterfaceV2::handle_response(FloonocReqV2 *req)
     // immediately as before.
     if (req->is_last)
     {
-        delete req;
+        this->noc->free_req(req);
     }
 }
+
+
+void NetworkInterfaceV2::set_response_dest(FloonocReqV2 *req)
+{
+    // Responses to a forked collective go back to the router which forked it,
+    // to be merged with the other ones, instead of the originating NI.
+    if (req->coll_parent)
+    {
+        req->dest_x = req->coll_merge_x;
+        req->dest_y = req->coll_merge_y;
+    }
+    else
+    {
+        NetworkInterfaceV2 *origin_ni = req->src_ni;
+
+        req->dest_x = origin_ni->x;
+        req->dest_y = origin_ni->y;
+    }
+}
+
+
+int NetworkInterfaceV2::get_req_vc(vp::IoReq *req, bool wide)
+{
+    // Atomics are mostly used for synchronization, and narrow requests are
+    // latency-sensitive, give them precedence over wide bursts.
+    int req_class = FlooNocV2::CLASS_BULK;
+    if (req->get_opcode() != vp::IoReqOpcode::READ && req->get_opcode() != vp::IoReqOpcode::WRITE)
+    {
+        req_class = FlooNocV2::CLASS_SYNC;
+    }
+    else if (!wide)
+    {
+        req_class = FlooNocV2::CLASS_NARROW;
+    }
+
+    return std::min(req_class, this->noc->nb_vcs - 1);
+}
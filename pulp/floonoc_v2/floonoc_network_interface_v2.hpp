@@ -29,18 +29,22 @@ class NetworkQueueV2 : public FloonocNodeV2
 {
     friend class NetworkInterfaceV2;
 public:
-    NetworkQueueV2(NetworkInterfaceV2 &ni, std::string name, uint64_t width, bool is_wide);
+    NetworkQueueV2(NetworkInterfaceV2 &ni, std::string name, uint64_t width, bool is_wide, int nb_vcs);
     void reset(bool active) override;
 
     void check();
+    // True when no request is waiting in the queue
+    bool is_empty();
     void handle_req(vp::IoReq *req, bool wide);
     void handle_rsp(FloonocReqV2 *req, bool is_address);
 
 private:
     void enqueue_router_req(vp::IoReq *req, bool is_address, bool wide, bool is_req);
     void enqueue_router_rsp(FloonocReqV2 *req, bool is_address);
-    void send_router_req();
-    void unstall_queue(int from_x, int from_y) override;
+    void init_collective(FloonocReqV2 *req, int coll_type, int x_extent, int y_extent);
+    void push(FloonocReqV2 *req);
+    void send_router_req(int vc);
+    void unstall_queue(int from_x, int from_y, int vc) override;
     bool handle_request(FloonocNodeV2 *node, FloonocReqV2 *req, int from_x, int from_y) override;
 
     NetworkInterfaceV2 &ni;
@@ -48,8 +52,11 @@ private:
     uint64_t width;
     bool is_wide;
     vp::Trace trace;
-    std::queue<FloonocReqV2 *> queue;
-    bool stalled;
+    // One queue per virtual channel, so that a stalled priority class does
+    // not block the other ones
+    std::vector<std::queue<FloonocReqV2 *>> queues;
+    // Stall state per virtual channel
+    std::vector<bool> stalled;
 };
 
 /**
@@ -78,13 +85,19 @@ public:
     // request convention): folds a distinct beat's payload onto our request and
     // frees the beat; passes a round-tripped write ack through unchanged.
     FloonocReqV2 *unwrap_response(vp::IoReq *req);
-    void unstall_queue(int from_x, int from_y) override;
+    void unstall_queue(int from_x, int from_y, int vc) override;
 
     bool handle_request(FloonocNodeV2 *node, FloonocReqV2 *req, int from_x, int from_y) override;
     int get_x();
     int get_y();
     void set_router(int nw, RouterV2 *router);
+    // True when no burst or request is pending in the network interface
+    bool is_idle();
+    // Remove the pending FSM event, returns true if there was one
+    bool cancel_fsm();
 private:
+    void set_response_dest(FloonocReqV2 *req);
+    int get_req_vc(vp::IoReq *req, bool wide);
     static vp::IoRespAck wide_response(vp::Block *__this, vp::IoReq *req);
     static void wide_retry(vp::Block *__this, vp::IoRetryChannel);
     static vp::IoRespAck narrow_response(vp::Block *__this, vp::IoReq *req);
@@ -115,6 +128,9 @@ private:
     vp::Signal<uint64_t> signal_narrow_req;
     vp::Signal<uint64_t> signal_wide_req;
 
+    // Last route-table segment hit by this NI, shared by its 3 queues
+    RouteTableV2::Cache decode_cache;
+
     // True when a downstream target returned DENIED to one of our internal
     // requests; cleared by the corresponding retry callback.
     bool target_stalled;
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+
+/**
+ * Memory-map entry: range -> target position on the mesh.
+ */
+class EntryV2
+{
+public:
+    uint64_t base;
+    uint64_t size;
+    int x;
+    int y;
+    uint64_t remove_offset;
+};
+
+
+/**
+ * Compiled address decoder for the FlooNoC v2 memory map.
+ *
+ * The mapping list is flattened once at build time into sorted, disjoint
+ * segments, each one pointing to the entry which wins on that range. Mappings
+ * may overlap; the winner is the one appearing first in the mapping list, so
+ * that lookups return exactly what a linear walk of the list would return.
+ *
+ * This header does not depend on the vp framework so that the decoder can be
+ * exercised standalone (see tests/floonoc_v2/route_table_bench.cpp).
+ */
+class RouteTableV2
+{
+public:
+    /**
+     * Last decoded segment. Each lookup site (typically one per network
+     * interface) owns one, so that consecutive bursts to the same target skip
+     * the binary search.
+     */
+    class Cache
+    {
+    public:
+        uint64_t base = 1;
+        uint64_t end = 0;
+        EntryV2 *entry = NULL;
+        uint64_t nb_hits = 0;
+        uint64_t nb_misses = 0;
+    };
+
+    void build(std::vector<EntryV2> &entries);
+    EntryV2 *lookup(uint64_t addr) const;
+    EntryV2 *lookup(uint64_t addr, Cache &cache) const;
+    size_t get_nb_segments() const { return this->segments.size(); }
+
+private:
+    class Segment
+    {
+    public:
+        uint64_t base;
+        // Exclusive end of the segment
+        uint64_t end;
+        EntryV2 *entry;
+    };
+
+    const Segment *find(uint64_t addr) const;
+
+    std::vector<Segment> segments;
+};
+
+
+inline void RouteTableV2::build(std::vector<EntryV2> &entries)
+{
+    // Each valid entry opens at its base and closes at its end. Sweeping the
+    // sorted boundaries while keeping the set of open entries gives, for each
+    // elementary range, the lowest-index (i.e. first-listed) owner.
+    struct Event
+    {
+        uint64_t pos;
+        int index;
+        bool is_open;
+    };
+
+    std::vector<Event> events;
+    for (int i=0; i<(int)entries.size(); i++)
+    {
+        EntryV2 &entry = entries[i];
+        uint64_t end = entry.base + entry.size;
+        // Empty and wrapping entries never match the linear decode, skip them
+        if (end <= entry.base)
+        {
+            continue;
+        }
+        events.push_back({entry.base, i, true});
+        events.push_back({end, i, false});
+    }
+
+    std::sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+        return a.pos < b.pos;
+    });
+
+    this->segments.clear();
+
+    std::set<int> opened;
+    size_t event_index = 0;
+    while (event_index < events.size())
+    {
+        uint64_t pos = events[event_index].pos;
+        while (event_index < events.size() && events[event_index].pos == pos)
+        {
+            Event &event = events[event_index++];
+            if (event.is_open)
+            {
+                opened.insert(event.index);
+            }
+            else
+            {
+                opened.erase(event.index);
+            }
+        }
+
+        if (opened.empty() || event_index == events.size())
+        {
+            continue;
+        }
+
+        EntryV2 *entry = &entries[*opened.begin()];
+        uint64_t end = events[event_index].pos;
+
+        // Merge with the previous segment when it is contiguous and owned by
+        // the same entry, to keep the table as small as the real layout.
+        if (this->segments.size() > 0 && this->segments.back().end == pos &&
+            this->segments.back().entry == entry)
+        {
+            this->segments.back().end = end;
+        }
+        else
+        {
+            this->segments.push_back({pos, end, entry});
+        }
+    }
+}
+
+
+inline const RouteTableV2::Segment *RouteTableV2::find(uint64_t addr) const
+{
+    auto it = std::upper_bound(this->segments.begin(), this->segments.end(), addr,
+        [](uint64_t addr, const Segment &segment) {
+            return addr < segment.base;
+        });
+
+    if (it == this->segments.begin())
+    {
+        return NULL;
+    }
+
+    const Segment *segment = &*(it - 1);
+    if (addr >= segment->end)
+    {
+        return NULL;
+    }
+
+    return segment;
+}
+
+
+inline EntryV2 *RouteTableV2::lookup(uint64_t addr) const
+{
+    const Segment *segment = this->find(addr);
+    return segment ? segment->entry : NULL;
+}
+
+
+inline EntryV2 *RouteTableV2::lookup(uint64_t addr, Cache &cache) const
+{
+    if (addr >= cache.base && addr < cache.end)
+    {
+        cache.nb_hits++;
+        return cache.entry;
+    }
+
+    cache.nb_misses++;
+
+    const Segment *segment = this->find(addr);
+    if (segment == NULL)
+    {
+        return NULL;
+    }
+
+    cache.base = segment->base;
+    cache.end = segment->end;
+    cache.entry = segment->entry;
+
+    return segment->entry;
+}
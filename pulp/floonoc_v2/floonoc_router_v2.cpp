@@ -15,13 +15,16 @@
  * limitations under the License.
  */
 
+#include <limits.h>
+#include <algorithm>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include "floonoc_v2.hpp"
 #include "floonoc_router_v2.hpp"
 #include "floonoc_network_interface_v2.hpp"
 
-RouterV2::RouterV2(FlooNocV2 *noc, std::string name, int x, int y, int queue_size)
+RouterV2::RouterV2(FlooNocV2 *noc, std::string name, int x, int y, int queue_size,
+    bool wake_on_unstall, int routing, int nb_vcs)
     : FloonocNodeV2(noc, name + std::to_string(x) + "_" + std::to_string(y)),
       fsm_event(this, &RouterV2::fsm_handler),
       signal_req(*this, "req", 64, vp::SignalCommon::ResetKind::HighZ),
@@ -41,11 +44,31 @@ RouterV2::RouterV2(FlooNocV2 *noc, std::string name, int x, int y, int queue_siz
     this->x = x;
     this->y = y;
     this->queue_size = queue_size;
+    this->wake_on_unstall = wake_on_unstall;
+    this->routing = routing;
+    this->nb_vcs = nb_vcs;
+    this->current_queue.resize(nb_vcs);
+    this->vc_order.resize(nb_vcs);
+
+    const char *dir_names[] = { "right", "left", "up", "down", "local" };
 
     for (int i = 0; i < 5; i++)
     {
-        this->input_queues[i] = new RouterQueueV2(this, "input_queue_" + std::to_string(i),
-            &this->fsm_event);
+        // Virtual channel 0 keeps the names used before virtual channels were
+        // introduced
+        for (int vc = 0; vc < nb_vcs; vc++)
+        {
+            std::string suffix = vc == 0 ? "" : "_vc" + std::to_string(vc);
+            this->input_queues[i].push_back(new RouterQueueV2(this, "input_queue_" + std::to_string(i) + suffix,
+                &this->fsm_event, vc));
+            this->stalled_vcs[i].push_back(false);
+
+            if (nb_vcs > 1)
+            {
+                this->stalled_vc_signals[i].push_back(new vp::Signal<bool>(*this,
+                    std::string("stalled_queue_") + dir_names[i] + "_vc" + std::to_string(vc), 1));
+            }
+        }
 
         this->stalled_queues[i] = false;
     }
@@ -55,13 +78,55 @@ RouterV2::~RouterV2()
 {
     for (int i = 0; i < 5; i++)
     {
-        delete this->input_queues[i];
+        for (RouterQueueV2 *queue: this->input_queues[i])
+        {
+            delete queue;
+        }
+        for (vp::Signal<bool> *signal: this->stalled_vc_signals[i])
+        {
+            delete signal;
+        }
     }
 }
 
 void RouterV2::set_neighbour(int dir, FloonocNodeV2 *node)
 {
     this->output_nodes[dir] = node;
+    this->output_routers[dir] = dynamic_cast<RouterV2 *>(node);
+}
+
+int RouterV2::get_input_occupancy(int from_x, int from_y, int vc)
+{
+    return this->input_queues[this->get_req_queue(from_x, from_y)][vc]->queue.size();
+}
+
+bool RouterV2::is_idle()
+{
+    for (int i = 0; i < 5; i++)
+    {
+        if (!this->collective_queues[i].empty())
+        {
+            return false;
+        }
+        for (RouterQueueV2 *queue: this->input_queues[i])
+        {
+            if (!queue->queue.empty())
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool RouterV2::cancel_fsm()
+{
+    if (this->fsm_event.is_enqueued())
+    {
+        this->fsm_event.cancel();
+        return true;
+    }
+    return false;
 }
 
 bool RouterV2::handle_request(FloonocNodeV2 *node, FloonocReqV2 *req, int from_x, int from_y)
@@ -73,11 +138,17 @@ bool RouterV2::handle_request(FloonocNodeV2 *node, FloonocReqV2 *req, int from_x
     this->signal_req_is_write.set_and_release(req->get_is_write());
 
     int queue_index = this->get_req_queue(from_x, from_y);
+    this->ready_mask |= 1 << queue_index;
 
-    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Pushed request to input queue (req: %p, queue: %d)\n", req, queue_index);
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Pushed request to input queue (req: %p, queue: %d, vc: %d)\n", req, queue_index, req->vc);
 
-    RouterQueueV2 *queue = this->input_queues[queue_index];
+    // Each virtual channel has its own buffer of queue_size entries. As for
+    // the single queue before, the sender is stalled once it overflows by
+    // one, and unstalled when it drains back.
+    RouterQueueV2 *queue = this->input_queues[queue_index][req->vc];
     queue->queue.push_back(req, 1);
+    req->queue_cycle = this->clock.get_cycles();
+    queue->occupancy = queue->queue.size();
 
     bool stalled = queue->queue.size() > this->queue_size;
     if (stalled)
@@ -90,91 +161,632 @@ bool RouterV2::handle_request(FloonocNodeV2 *node, FloonocReqV2 *req, int from_x
 void RouterV2::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
 {
     RouterV2 *_this = (RouterV2 *)__this;
+
+    if (_this->wake_on_unstall && _this->ready_mask == 0)
+    {
+        // Nothing changed since the last invocation, which could not forward
+        // anything, so this one would not either. Only keep its rescheduling,
+        // so that the router runs in the same cycles as when polling.
+        if (_this->idle_reschedule)
+        {
+            _this->fsm_event.enqueue();
+        }
+        return;
+    }
+
     _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Checking pending requests\n");
-    _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Current queue: %d\n", _this->current_queue);
-    int in_queue_index = _this->current_queue;
 
+    // Each input and each output can forward one request per cycle. Virtual
+    // channels are served from the highest priority class down, starved ones
+    // first, and inputs are served round-robin within a virtual channel.
+    // Requests keep the virtual channel of their class along the whole path,
+    // so that each class behaves as a separate network.
     bool output_full[5] = {false};
-    for (int i = 0; i < 5; i++)
+    // Outputs on which a head was found stalled in this invocation
+    bool output_stalled[5] = {false};
+    bool input_busy[5] = {false};
+    bool progress = false;
+    _this->get_vc_order();
+    for (int vc: _this->vc_order)
     {
-        RouterQueueV2 *queue = _this->input_queues[in_queue_index];
-        _this->trace.msg(vp::Trace::LEVEL_TRACE, "Checking input queue (queue_index: %d, queue size: %d)\n", in_queue_index, queue->queue.size());
-        if (!queue->queue.empty())
+        _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Current queue (vc: %d, queue: %d)\n", vc, _this->current_queue[vc]);
+        int in_queue_index = _this->current_queue[vc];
+
+        for (int i = 0; i < 5; i++)
         {
-            FloonocReqV2 *req = (FloonocReqV2 *)queue->queue.head();
+            RouterQueueV2 *queue = _this->input_queues[in_queue_index][vc];
+            _this->trace.msg(vp::Trace::LEVEL_TRACE, "Checking input queue (queue_index: %d, vc: %d, queue size: %d)\n", in_queue_index, vc, queue->queue.size());
+            if (input_busy[in_queue_index])
+            {
+                if (queue->queue.size())
+                {
+                    _this->fsm_event.enqueue();
+                }
+            }
+            else if (!queue->queue.empty())
+            {
+                FloonocReqV2 *req = (FloonocReqV2 *)queue->queue.head();
 
-            int to_x = req->dest_x;
-            int to_y = req->dest_y;
+                int coll_status = req->coll_type ? _this->handle_collective(queue, req) :
+                    RouterV2::COLL_FORWARD;
+                if (coll_status != RouterV2::COLL_FORWARD)
+                {
+                    // The head was consumed, either forked into children
+                    // requests or merged into its parent, or is held until
+                    // the collective queues have room for the result
+                    if (coll_status == RouterV2::COLL_CONSUMED)
+                    {
+                        input_busy[in_queue_index] = true;
+                        progress = true;
+                    }
+                    _this->fsm_event.enqueue();
+                    in_queue_index += 1;
+                    if (in_queue_index == 5)
+                    {
+                        in_queue_index = 0;
+                    }
+                    continue;
+                }
 
-            int next_x, next_y;
-            _this->get_next_router_pos(to_x, to_y, next_x, next_y);
-            _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Resolved next position (req: %p, dest: (%d, %d), next_position: (%d, %d))\n",
-                             req, to_x, to_y, next_x, next_y);
+                int out_queue_id = _this->get_output_queue(req);
+                _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Resolved output queue (req: %p, dest: (%d, %d), out_queue: %d, vc: %d)\n",
+                                 req, req->dest_x, req->dest_y, out_queue_id, vc);
 
-            int out_queue_id = _this->get_req_queue(next_x, next_y);
+                // A stalled virtual channel must not prevent other ones from
+                // using the output, so check it before claiming the output
+                if (_this->stalled_vcs[out_queue_id][vc])
+                {
+                    _this->trace.msg(vp::Trace::LEVEL_TRACE, "Output queue is stalled, skipping (out queue: %d, vc: %d)\n", out_queue_id, vc);
+                    // As when a stalled head also claimed its output, the
+                    // next heads for it retry in the next cycle
+                    if (output_full[out_queue_id] || output_stalled[out_queue_id])
+                    {
+                        _this->fsm_event.enqueue();
+                    }
+                    output_stalled[out_queue_id] = true;
+                    in_queue_index += 1;
+                    if (in_queue_index == 5)
+                    {
+                        in_queue_index = 0;
+                    }
+                    continue;
+                }
+
+                if (output_full[out_queue_id])
+                {
+                    _this->trace.msg(vp::Trace::LEVEL_TRACE, "Output queue is full, skipping (out queue: %d)\n", out_queue_id);
+                    _this->fsm_event.enqueue();
+                    in_queue_index += 1;
+                    if (in_queue_index == 5)
+                    {
+                        in_queue_index = 0;
+                    }
+                    continue;
+                }
+                output_full[out_queue_id] = true;
+                input_busy[in_queue_index] = true;
+
+                _this->pop_input(queue);
+
+                if (req->coll_type && req->src_ni)
+                {
+                    req->coll_momentum = out_queue_id;
+                }
+
+                _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Forwarding request to next router (req: %p, base: 0x%x, size: 0x%x, out_queue: %d, in_queue: %d, vc: %d)\n",
+                                    req, req->get_addr(), req->get_size(), out_queue_id, in_queue_index, vc);
+                _this->forward(out_queue_id, req);
+                progress = true;
+
+                _this->current_queue[vc] = in_queue_index + 1;
+                if (_this->current_queue[vc] == 5)
+                {
+                    _this->current_queue[vc] = 0;
+                }
 
-            if (output_full[out_queue_id])
-            {
-                _this->trace.msg(vp::Trace::LEVEL_TRACE, "Output queue is full, skipping (out queue: %d)\n", out_queue_id);
                 _this->fsm_event.enqueue();
-                in_queue_index += 1;
-                if (in_queue_index == 5)
+            }
+            else
+            {
+                if (queue->queue.size())
                 {
-                    in_queue_index = 0;
+                   _this->fsm_event.enqueue();
                 }
-                continue;
             }
-            output_full[out_queue_id] = true;
 
-            if (_this->stalled_queues[out_queue_id])
+            in_queue_index += 1;
+            if (in_queue_index == 5)
             {
-                _this->trace.msg(vp::Trace::LEVEL_TRACE, "Output queue is stalled, skipping (out queue: %d)\n", out_queue_id);
-                in_queue_index += 1;
-                if (in_queue_index == 5)
+                in_queue_index = 0;
+            }
+        }
+    }
+
+    // Children of forked collective requests are sent once per cycle and per
+    // output, with lower priority than the input queues
+    for (int out = 0; out < 5; out++)
+    {
+        std::queue<FloonocReqV2 *> &pending = _this->collective_queues[out];
+        if (pending.empty() || _this->stalled_vcs[out][pending.front()->vc])
+        {
+            continue;
+        }
+
+        if (output_full[out])
+        {
+            _this->fsm_event.enqueue();
+            continue;
+        }
+        output_full[out] = true;
+
+        FloonocReqV2 *req = pending.front();
+        pending.pop();
+
+        _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Forwarding collective request (req: %p, base: 0x%x, size: 0x%x, out_queue: %d)\n",
+                            req, req->get_addr(), req->get_size(), out);
+        _this->forward(out, req);
+        progress = true;
+
+        _this->fsm_event.enqueue();
+    }
+
+    if (_this->wake_on_unstall)
+    {
+        _this->update_ready_mask(progress);
+    }
+}
+
+void RouterV2::get_vc_order()
+{
+    // Strict priority would let a busy high class starve the lower ones,
+    // so the channels whose oldest input head waited for more than
+    // vc_max_wait cycles are moved in front, still from the highest down.
+    int64_t cycles = this->clock.get_cycles();
+    int max_wait = this->noc->vc_max_wait;
+    int nb_starved = 0;
+
+    for (int vc = this->nb_vcs - 1; vc >= 0; vc--)
+    {
+        bool starved = false;
+        if (max_wait > 0 && this->nb_vcs > 1)
+        {
+            for (int i = 0; i < 5; i++)
+            {
+                vp::Queue &queue = this->input_queues[i][vc]->queue;
+                if (!queue.empty() && cycles - ((FloonocReqV2 *)queue.head())->queue_cycle > max_wait)
                 {
-                    in_queue_index = 0;
+                    starved = true;
+                    break;
                 }
-                continue;
             }
+        }
 
-            queue->queue.pop();
+        if (starved)
+        {
+            // Shift the non-starved channels already placed to make room
+            for (int i = this->nb_vcs - 1 - vc; i > nb_starved; i--)
+            {
+                this->vc_order[i] = this->vc_order[i - 1];
+            }
+            this->vc_order[nb_starved++] = vc;
+        }
+        else
+        {
+            this->vc_order[this->nb_vcs - 1 - vc] = vc;
+        }
+    }
+}
 
-            if (queue->queue.size() == _this->queue_size)
+void RouterV2::forward(int out, FloonocReqV2 *req)
+{
+    if (this->output_nodes[out]->handle_request(this, req, this->x, this->y))
+    {
+        // Routers report that the virtual channel of the request is full,
+        // network interfaces that they cannot accept anything anymore
+        int vc = this->output_routers[out] ? req->vc : FlooNocV2::ALL_VCS;
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Stalling queue (position: (%d, %d), queue: %d, vc: %d)\n", this->x, this->y, out, vc);
+        this->set_stalled(out, vc, true);
+    }
+}
+
+void RouterV2::set_stalled(int out, int vc, bool stalled)
+{
+    for (int i = 0; i < this->nb_vcs; i++)
+    {
+        if (vc == FlooNocV2::ALL_VCS || vc == i)
+        {
+            this->stalled_vcs[out][i] = stalled;
+            if (this->nb_vcs > 1)
             {
-                queue->stalled_node->unstall_queue(_this->x, _this->y);
+                *this->stalled_vc_signals[out][i] = stalled;
             }
+        }
+    }
+
+    // The legacy signal tells whether the output is stalled for all virtual
+    // channels, which is the same as before when there is only one.
+    bool all_stalled = true;
+    for (int i = 0; i < this->nb_vcs; i++)
+    {
+        all_stalled &= this->stalled_vcs[out][i];
+    }
+    this->stalled_queues[out] = all_stalled;
+}
+
+void RouterV2::pop_input(RouterQueueV2 *queue)
+{
+    queue->queue.pop();
+    queue->occupancy = queue->queue.size();
 
-            FloonocNodeV2 *node = _this->output_nodes[out_queue_id];
+    if (queue->queue.size() == this->queue_size)
+    {
+        queue->stalled_node->unstall_queue(this->x, this->y, queue->vc);
+    }
+}
 
-            _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Forwarding request to next router (req: %p, base: 0x%x, size: 0x%x, next_position: (%d, %d), in_queue: %d)\n",
-                                req, req->get_addr(), req->get_size(), next_x, next_y, in_queue_index);
-            if (node->handle_request(_this, req, _this->x, _this->y))
+bool RouterV2::collective_has_target(FloonocReqV2 *req, int x0, int x1, int y0, int y1)
+{
+    // Only look at the part of the region inside the targeted rectangle
+    x0 = std::max(x0, req->coll_x0);
+    x1 = std::min(x1, req->coll_x1);
+    y0 = std::max(y0, req->coll_y0);
+    y1 = std::min(y1, req->coll_y1);
+
+    for (int x = x0; x <= x1; x++)
+    {
+        for (int y = y0; y <= y1; y++)
+        {
+            if (this->noc->is_collective_node(x, y))
             {
-                _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Stalling queue (position: (%d, %d), queue: %d)\n", _this->x, _this->y, out_queue_id);
-                _this->stalled_queues[out_queue_id] = true;
+                return true;
             }
-            _this->current_queue = in_queue_index + 1;
-            if (_this->current_queue == 5)
+        }
+    }
+    return false;
+}
+
+int RouterV2::get_collective_outputs(FloonocReqV2 *req, int *outputs)
+{
+    // Requests are spread with a dimension-ordered tree: along the X axis on
+    // the row where the collective entered the mesh, then along the Y axis on
+    // each column. A request never turns back, and never goes from Y to X,
+    // which keeps the tree deadlock-free like XY routing.
+    int nb_outputs = 0;
+    int momentum = req->coll_momentum;
+    bool horizontal = momentum == FlooNocV2::DIR_LOCAL || momentum == FlooNocV2::DIR_RIGHT ||
+        momentum == FlooNocV2::DIR_LEFT;
+    int max_x = this->noc->dim_x - 1;
+    int max_y = this->noc->dim_y - 1;
+
+    if (this->collective_has_target(req, this->x, this->x, this->y, this->y))
+    {
+        outputs[nb_outputs++] = FlooNocV2::DIR_LOCAL;
+    }
+
+    if (horizontal && momentum != FlooNocV2::DIR_LEFT &&
+        this->collective_has_target(req, this->x + 1, max_x, 0, max_y))
+    {
+        outputs[nb_outputs++] = FlooNocV2::DIR_RIGHT;
+    }
+
+    if (horizontal && momentum != FlooNocV2::DIR_RIGHT &&
+        this->collective_has_target(req, 0, this->x - 1, 0, max_y))
+    {
+        outputs[nb_outputs++] = FlooNocV2::DIR_LEFT;
+    }
+
+    if ((horizontal || momentum == FlooNocV2::DIR_UP) &&
+        this->collective_has_target(req, this->x, this->x, this->y + 1, max_y))
+    {
+        outputs[nb_outputs++] = FlooNocV2::DIR_UP;
+    }
+
+    if ((horizontal || momentum == FlooNocV2::DIR_DOWN) &&
+        this->collective_has_target(req, this->x, this->x, 0, this->y - 1))
+    {
+        outputs[nb_outputs++] = FlooNocV2::DIR_DOWN;
+    }
+
+    return nb_outputs;
+}
+
+int RouterV2::handle_collective(RouterQueueV2 *queue, FloonocReqV2 *req)
+{
+    if (req->src_ni == NULL)
+    {
+        // Responses are routed as usual, except when they reach the router
+        // where their request was forked, where they are merged.
+        if (req->coll_parent && req->dest_x == this->x && req->dest_y == this->y)
+        {
+            // The last merge sends the parent back, which needs room on its
+            // output
+            FloonocReqV2 *parent = req->coll_parent;
+            if (parent->coll_remaining == req->get_size() &&
+                this->collective_queues[this->get_output_queue(parent)].size() >= this->queue_size)
             {
-                _this->current_queue = 0;
+                return RouterV2::COLL_BLOCKED;
             }
 
-            _this->fsm_event.enqueue();
+            this->pop_input(queue);
+            this->collective_merge(req);
+            return RouterV2::COLL_CONSUMED;
         }
-        else
+        return RouterV2::COLL_FORWARD;
+    }
+
+    int outputs[5];
+    int nb_outputs = this->get_collective_outputs(req, outputs);
+
+    if (nb_outputs == 0)
+    {
+        // Requests are only sent towards routers with targets on their side
+        this->trace.fatal("Collective request without target (req: %p)\n", req);
+    }
+
+    if (nb_outputs == 1)
+    {
+        req->coll_out = outputs[0];
+        return RouterV2::COLL_FORWARD;
+    }
+
+    // The head is only forked once all its children can be queued, so that
+    // the collective queues stay bounded like the input ones
+    for (int i = 0; i < nb_outputs; i++)
+    {
+        if (this->collective_queues[outputs[i]].size() >= this->queue_size)
+        {
+            return RouterV2::COLL_BLOCKED;
+        }
+    }
+
+    this->pop_input(queue);
+    this->collective_fork(req, outputs, nb_outputs);
+    return RouterV2::COLL_CONSUMED;
+}
+
+void RouterV2::collective_fork(FloonocReqV2 *req, int *outputs, int nb_outputs)
+{
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Forking collective request (req: %p, op: %d, nb_children: %d)\n",
+        req, req->coll_type, nb_outputs);
+
+    uint64_t size = req->get_size();
+    bool is_reduction = !req->get_is_write();
+
+    req->coll_remaining = size * nb_outputs;
+
+    if (is_reduction)
+    {
+        // Children read into their own part of a scratch buffer, which is
+        // reduced into the request data as responses come back
+        FloonocCollectiveV2::init(req->coll_type, req->get_data(), size);
+        req->coll_buffer_size = size * nb_outputs;
+        req->coll_buffer = this->noc->alloc_buffer(req->coll_buffer_size);
+    }
+
+    for (int i = 0; i < nb_outputs; i++)
+    {
+        FloonocReqV2 *child = this->noc->alloc_req();
+
+        child->prepare();
+        child->src_ni = req->src_ni;
+        child->burst = req->burst;
+        child->is_address = req->is_address;
+        child->wide = req->wide;
+        child->dest_x = req->dest_x;
+        child->dest_y = req->dest_y;
+        child->initiator_addr = req->initiator_addr;
+        child->set_size(size);
+        child->set_data(is_reduction ? req->coll_buffer + i * size : req->get_data());
+        child->set_addr(req->get_addr());
+        child->set_is_write(req->get_is_write());
+        child->set_opcode(req->get_opcode());
+        child->set_second_data(req->get_second_data());
+        child->vc = req->vc;
+        child->coll_type = req->coll_type;
+        child->coll_x0 = req->coll_x0;
+        child->coll_x1 = req->coll_x1;
+        child->coll_y0 = req->coll_y0;
+        child->coll_y1 = req->coll_y1;
+        child->coll_momentum = outputs[i];
+        child->coll_parent = req;
+        child->coll_merge_x = this->x;
+        child->coll_merge_y = this->y;
+
+        this->collective_queues[outputs[i]].push(child);
+    }
+
+    // The request now stays here until all children answered, and then
+    // travels back as a single response, either to the fork above it or to
+    // the initiator. Its route is set now so that the last merge can check
+    // that its output has room.
+    if (req->coll_parent)
+    {
+        req->dest_x = req->coll_merge_x;
+        req->dest_y = req->coll_merge_y;
+    }
+    else
+    {
+        req->dest_x = req->src_ni->get_x();
+        req->dest_y = req->src_ni->get_y();
+    }
+    req->src_ni = NULL;
+    // Same as the responses built by the network interfaces
+    req->is_address = req->get_is_write();
+    req->route_src_x = this->x;
+}
+
+void RouterV2::collective_merge(FloonocReqV2 *req)
+{
+    FloonocReqV2 *parent = req->coll_parent;
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Merging collective response (req: %p, parent: %p, size: 0x%x)\n",
+        req, parent, req->get_size());
+
+    if (!parent->get_is_write())
+    {
+        FloonocCollectiveV2::reduce(parent->coll_type,
+            parent->get_data() + (req->get_addr() - parent->get_addr()), req->get_data(),
+            req->get_size());
+    }
+
+    parent->coll_remaining -= req->get_size();
+    this->noc->free_req(req);
+
+    if (parent->coll_remaining == 0)
+    {
+        this->collective_complete(parent);
+    }
+}
+
+void RouterV2::collective_complete(FloonocReqV2 *req)
+{
+    if (req->coll_buffer)
+    {
+        this->noc->free_buffer(req->coll_buffer, req->coll_buffer_size);
+        req->coll_buffer = NULL;
+    }
+
+    this->collective_queues[this->get_output_queue(req)].push(req);
+}
+
+void RouterV2::update_ready_mask(bool progress)
+{
+    // After an invocation which forwarded or consumed something, all the
+    // heads must be looked at again. Otherwise, they stay blocked until a
+    // request is pushed or an output is unstalled, except the ones which are
+    // not ready yet (requests are pushed with a 1 cycle delay). Adaptive
+    // routes of blocked heads do not depend on the occupancy of the
+    // neighbours, since all their outputs are stalled.
+    if (progress)
+    {
+        this->ready_mask = RouterV2::READY_ALL;
+        return;
+    }
+
+    this->ready_mask = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        for (RouterQueueV2 *queue: this->input_queues[i])
         {
-            if (queue->queue.size())
+            if (queue->queue.size() && queue->queue.empty())
             {
-               _this->fsm_event.enqueue();
+                this->ready_mask |= 1 << i;
             }
         }
+    }
+
+    this->idle_reschedule = this->fsm_event.is_enqueued();
+    if (this->ready_mask == 0)
+    {
+        this->trace.msg(vp::Trace::LEVEL_TRACE, "No input can progress, skipping the next checks\n");
+    }
+}
+
+int RouterV2::get_output_queue(FloonocReqV2 *req)
+{
+    if (req->coll_type && req->src_ni)
+    {
+        return req->coll_out;
+    }
+
+    // Requests mapped to a mesh side always go straight
+    if (this->routing != FlooNocV2::ROUTING_XY && req->dest_x >= 0)
+    {
+        return this->get_adaptive_output(req);
+    }
 
-        in_queue_index += 1;
-        if (in_queue_index == 5)
+    int next_x, next_y;
+    this->get_next_router_pos(req->dest_x, req->dest_y, next_x, next_y);
+    return this->get_req_queue(next_x, next_y);
+}
+
+int RouterV2::get_output_cost(int dir, int vc)
+{
+    // A stalled output is the worst choice. Otherwise use the occupancy of
+    // the input queue of the next router which we would feed. Network
+    // interfaces are not buffered, they only count when they stall.
+    if (this->stalled_vcs[dir][vc])
+    {
+        return INT_MAX;
+    }
+
+    RouterV2 *router = this->output_routers[dir];
+    return router ? router->get_input_occupancy(this->x, this->y, vc) : 0;
+}
+
+int RouterV2::get_adaptive_output(FloonocReqV2 *req)
+{
+    // Routers are only on the inner part of the mesh, the outer ring only has
+    // network interfaces which are sinks. Route to the inner router next to
+    // the destination with the selected algorithm, then take the last hop.
+    int exit_x = std::max(1, std::min(req->dest_x, this->noc->dim_x - 2));
+    int exit_y = std::max(1, std::min(req->dest_y, this->noc->dim_y - 2));
+
+    if (this->x == exit_x && this->y == exit_y)
+    {
+        return this->get_req_queue(req->dest_x, req->dest_y);
+    }
+
+    int dir_x = exit_x > this->x ? FlooNocV2::DIR_RIGHT : FlooNocV2::DIR_LEFT;
+    int dir_y = exit_y > this->y ? FlooNocV2::DIR_UP : FlooNocV2::DIR_DOWN;
+    bool move_x = exit_x != this->x;
+    bool move_y = exit_y != this->y;
+
+    // Productive directions allowed by the turn model. All algorithms are
+    // minimal and forbid enough turns to avoid cyclic channel dependencies,
+    // so that they are deadlock-free without virtual channels.
+    bool allow_x = false, allow_y = false;
+
+    switch (this->routing)
+    {
+        case FlooNocV2::ROUTING_YX:
+            allow_y = move_y;
+            allow_x = !move_y;
+            break;
+
+        case FlooNocV2::ROUTING_WEST_FIRST:
+            // Turns to the west are forbidden, so go west first, then
+            // adaptively east, north or south
+            allow_x = move_x;
+            allow_y = move_y && !(move_x && dir_x == FlooNocV2::DIR_LEFT);
+            break;
+
+        case FlooNocV2::ROUTING_ADAPTIVE:
         {
-            in_queue_index = 0;
+            // Odd-even turn model: no east to north/south turns in even
+            // columns, no north/south to west turns in odd columns.
+            if (!move_x)
+            {
+                allow_y = true;
+            }
+            else if (dir_x == FlooNocV2::DIR_RIGHT)
+            {
+                if (!move_y)
+                {
+                    allow_x = true;
+                }
+                else
+                {
+                    allow_y = (this->x & 1) || this->x == req->route_src_x;
+                    allow_x = (exit_x & 1) || exit_x - this->x != 1;
+                }
+            }
+            else
+            {
+                allow_x = true;
+                allow_y = move_y && (this->x & 1) == 0;
+            }
+            break;
         }
     }
+
+    if (allow_x && allow_y)
+    {
+        // Ties go to the X direction so that an idle mesh routes like XY
+        return this->get_output_cost(dir_y, req->vc) < this->get_output_cost(dir_x, req->vc) ? dir_y : dir_x;
+    }
+
+    return allow_x ? dir_x : dir_y;
 }
 
 void RouterV2::get_next_router_pos(int dest_x, int dest_y, int &next_x, int &next_y)
@@ -214,11 +826,12 @@ void RouterV2::get_next_router_pos(int dest_x, int dest_y, int &next_x, int &nex
     }
 }
 
-void RouterV2::unstall_queue(int from_x, int from_y)
+void RouterV2::unstall_queue(int from_x, int from_y, int vc)
 {
     int queue = this->get_req_queue(from_x, from_y);
-    this->trace.msg(vp::Trace::LEVEL_TRACE, "Unstalling queue (position: (%d, %d), queue: %d)\n", from_x, from_y, queue);
-    this->stalled_queues[queue] = false;
+    this->trace.msg(vp::Trace::LEVEL_TRACE, "Unstalling queue (position: (%d, %d), queue: %d, vc: %d)\n", from_x, from_y, queue, vc);
+    this->set_stalled(queue, vc, false);
+    this->ready_mask |= RouterV2::READY_ALL;
     this->fsm_event.enqueue();
 }
 
@@ -226,7 +839,8 @@ void RouterV2::stall_queue(int from_x, int from_y)
 {
     int queue = this->get_req_queue(from_x, from_y);
     this->trace.msg(vp::Trace::LEVEL_TRACE, "Stalling queue (position: (%d, %d), queue: %d)\n", from_x, from_y, queue);
-    this->stalled_queues[queue] = true;
+    this->set_stalled(queue, FlooNocV2::ALL_VCS, true);
+    this->ready_mask |= RouterV2::READY_ALL;
 }
 
 void RouterV2::get_pos_from_queue(int queue, int &pos_x, int &pos_y)
@@ -279,15 +893,17 @@ void RouterV2::reset(bool active)
 {
     if (active)
     {
-        this->current_queue = 0;
+        std::fill(this->current_queue.begin(), this->current_queue.end(), 0);
+        this->ready_mask = RouterV2::READY_ALL;
+        this->idle_reschedule = false;
         for (int i = 0; i < 5; i++)
         {
-            this->stalled_queues[i] = false;
+            this->set_stalled(i, FlooNocV2::ALL_VCS, false);
         }
     }
 }
 
-RouterQueueV2::RouterQueueV2(vp::Block *parent, std::string name, vp::ClockEvent *ready_event)
-: queue(parent, name, ready_event)
+RouterQueueV2::RouterQueueV2(vp::Block *parent, std::string name, vp::ClockEvent *ready_event, int vc)
+: queue(parent, name, ready_event), occupancy(*parent, name + "_occupancy", 8), vc(vc)
 {
 }
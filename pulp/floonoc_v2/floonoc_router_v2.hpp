@@ -18,6 +18,8 @@
 #pragma once
 
 #include <array>
+#include <queue>
+#include <vector>
 #include <vp/vp.hpp>
 #include <vp/signal.hpp>
 #include "floonoc_v2.hpp"
@@ -27,41 +29,106 @@ class FlooNocV2;
 class RouterQueueV2
 {
 public:
-    RouterQueueV2(vp::Block *parent, std::string name, vp::ClockEvent *ready_event=NULL);
+    RouterQueueV2(vp::Block *parent, std::string name, vp::ClockEvent *ready_event=NULL, int vc=0);
     vp::Queue queue;
     FloonocNodeV2 *stalled_node;
+    // Number of requests in the queue, for traces
+    vp::Signal<uint64_t> occupancy;
+    // Virtual channel of this queue
+    int vc;
 };
 
 class RouterV2 : public FloonocNodeV2
 {
 public:
-    RouterV2(FlooNocV2 *noc, std::string name, int x, int y, int queue_size);
+    RouterV2(FlooNocV2 *noc, std::string name, int x, int y, int queue_size,
+        bool wake_on_unstall=true, int routing=0, int nb_vcs=1);
     ~RouterV2();
 
     void reset(bool active);
 
     bool handle_request(FloonocNodeV2 *node, FloonocReqV2 *req, int from_x, int from_y) override;
-    void unstall_queue(int from_x, int from_y) override;
+    void unstall_queue(int from_x, int from_y, int vc) override;
     void stall_queue(int from_x, int from_y);
     void set_neighbour(int dir, FloonocNodeV2 *node);
+    // Number of requests sitting in the input queue fed by the given position
+    int get_input_occupancy(int from_x, int from_y, int vc);
+    // True when no request is waiting in the router
+    bool is_idle();
+    // Remove the pending FSM event, returns true if there was one
+    bool cancel_fsm();
 
     int x;
     int y;
 
+    // Outcome of handle_collective for an input head: routed as a unicast
+    // request, consumed by a fork or a merge, or held
+    static constexpr int COLL_FORWARD = 0;
+    static constexpr int COLL_CONSUMED = 1;
+    static constexpr int COLL_BLOCKED = 2;
+
+    // ready_mask with all the input queues set
+    static constexpr uint32_t READY_ALL = (1 << 5) - 1;
+
 private:
     static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
     void get_next_router_pos(int dest_x, int dest_y, int &next_x, int &next_y);
+    int get_output_queue(FloonocReqV2 *req);
+    int get_adaptive_output(FloonocReqV2 *req);
+    int get_output_cost(int dir, int vc);
+    void forward(int out, FloonocReqV2 *req);
+    void set_stalled(int out, int vc, bool stalled);
+    void get_vc_order();
+    void update_ready_mask(bool progress);
+    void pop_input(RouterQueueV2 *queue);
+    int handle_collective(RouterQueueV2 *queue, FloonocReqV2 *req);
+    int get_collective_outputs(FloonocReqV2 *req, int *outputs);
+    bool collective_has_target(FloonocReqV2 *req, int x0, int x1, int y0, int y1);
+    void collective_fork(FloonocReqV2 *req, int *outputs, int nb_outputs);
+    void collective_merge(FloonocReqV2 *req);
+    void collective_complete(FloonocReqV2 *req);
     int get_req_queue(int from_x, int from_y);
     void get_pos_from_queue(int queue, int &pos_x, int &pos_y);
 
     FlooNocV2 *noc;
     vp::Trace trace;
     int queue_size;
-    RouterQueueV2 *input_queues[5];
+    // Input queues, per direction and virtual channel
+    std::vector<RouterQueueV2 *> input_queues[5];
+    int nb_vcs;
     FloonocNodeV2 *output_nodes[5];
+    // Same as output_nodes, NULL when the neighbour is not a router
+    RouterV2 *output_routers[5];
+    // Routing algorithm (FlooNocV2::ROUTING_*)
+    int routing;
+    // Children of forked collective requests, and completed forks travelling
+    // back as responses, waiting for their output. Each holds at most
+    // queue_size requests, the input heads feeding them are held otherwise.
+    std::queue<FloonocReqV2 *> collective_queues[5];
     vp::ClockEvent fsm_event;
-    int current_queue;
+    // Round-robin position, per virtual channel
+    std::vector<int> current_queue;
+    // Order in which the virtual channels are served in the current cycle
+    std::vector<int> vc_order;
+    // When true, an FSM invocation which could not forward anything is only
+    // followed by full checks once a request is pushed or an output is
+    // unstalled. The invocations in between only reschedule the FSM as the
+    // last full check did, so that the router runs in the same cycles as
+    // when it checks all heads every time. Timing depends on the order of the
+    // routers within a cycle, so dropping these invocations would change it.
+    bool wake_on_unstall;
+    // Input queues whose head may progress since the last full check. Bit i
+    // stands for the input queues of direction i.
+    uint32_t ready_mask;
+    // Whether the last full check which could not forward anything
+    // rescheduled the FSM
+    bool idle_reschedule;
+    // Outputs stalled for all virtual channels
     std::array<vp::Signal<bool>, 5> stalled_queues;
+    // Stall state per output and virtual channel, and the matching signals
+    // when there are several virtual channels
+    std::vector<bool> stalled_vcs[5];
+    std::vector<vp::Signal<bool> *> stalled_vc_signals[5];
     vp::Signal<uint64_t> signal_req;
     vp::Signal<uint64_t> signal_req_size;
     vp::Signal<bool> signal_req_is_write;
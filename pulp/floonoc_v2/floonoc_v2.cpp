@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <new>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include "floonoc_v2.hpp"
@@ -31,6 +32,41 @@ FlooNocV2::FlooNocV2(vp::ComponentConf &config)
     this->dim_x = get_js_config()->get_int("dim_x");
     this->dim_y = get_js_config()->get_int("dim_y");
     this->router_input_queue_size = get_js_config()->get_int("router_input_queue_size");
+    this->router_wake_on_unstall = get_js_config()->get_child_bool("router_wake_on_unstall");
+    this->nb_vcs = get_js_config()->get_int("router_nb_vcs");
+    this->vc_max_wait = get_js_config()->get_int("router_vc_max_wait");
+
+    std::string routing = get_js_config()->get_child_str("routing");
+    if (routing == "xy")
+    {
+        this->routing = FlooNocV2::ROUTING_XY;
+    }
+    else if (routing == "yx")
+    {
+        this->routing = FlooNocV2::ROUTING_YX;
+    }
+    else if (routing == "west_first")
+    {
+        this->routing = FlooNocV2::ROUTING_WEST_FIRST;
+    }
+    else if (routing == "adaptive")
+    {
+        this->routing = FlooNocV2::ROUTING_ADAPTIVE;
+    }
+    else
+    {
+        this->trace.fatal("Unknown routing algorithm (routing: %s)\n", routing.c_str());
+    }
+
+    this->collective_addr_shift = get_js_config()->get_int("collective_addr_shift");
+    this->print_pool_stats = get_js_config()->get_child_bool("print_pool_stats");
+    this->fast_forward = get_js_config()->get_child_bool("fast_forward");
+    this->print_fast_forward_stats = get_js_config()->get_child_bool("print_fast_forward_stats");
+    this->quiescent = false;
+    this->quiescent_since = 0;
+    this->nb_quiescent_cycles = 0;
+    this->nb_quiescent_periods = 0;
+    this->nb_cancelled_events = 0;
 
     this->itf_names.resize(this->dim_x * this->dim_y);
 
@@ -69,6 +105,11 @@ FlooNocV2::FlooNocV2(vp::ComponentConf &config)
 
             id++;
         }
+
+        this->route_table.build(this->entries);
+
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Compiled route table (entries: %zu, segments: %zu)\n",
+            this->entries.size(), this->route_table.get_nb_segments());
     }
 
     this->network_interfaces.resize(this->dim_x * this->dim_y);
@@ -101,9 +142,12 @@ FlooNocV2::FlooNocV2(vp::ComponentConf &config)
 
             this->trace.msg(vp::Trace::LEVEL_DEBUG, "Adding routers (req, rsp and wide) (x: %d, y: %d)\n", x, y);
 
-            this->req_routers[y*this->dim_x + x] = new RouterV2(this, "req_router_", x, y, this->router_input_queue_size);
-            this->rsp_routers[y*this->dim_x + x] = new RouterV2(this, "rsp_router_", x, y, this->router_input_queue_size);
-            this->wide_routers[y*this->dim_x + x] = new RouterV2(this, "wide_router_", x, y, this->router_input_queue_size);
+            this->req_routers[y*this->dim_x + x] = new RouterV2(this, "req_router_", x, y, this->router_input_queue_size,
+                this->router_wake_on_unstall, this->routing, this->nb_vcs);
+            this->rsp_routers[y*this->dim_x + x] = new RouterV2(this, "rsp_router_", x, y, this->router_input_queue_size,
+                this->router_wake_on_unstall, this->routing, this->nb_vcs);
+            this->wide_routers[y*this->dim_x + x] = new RouterV2(this, "wide_router_", x, y, this->router_input_queue_size,
+                this->router_wake_on_unstall, this->routing, this->nb_vcs);
         }
 
         for (RouterV2 *router: this->req_routers)
@@ -214,20 +258,257 @@ void FlooNocV2::router_init_neighbours(RouterV2 *router, std::vector<RouterV2 *>
 
 void FlooNocV2::reset(bool active)
 {
+    if (active)
+    {
+        this->quiescent = false;
+        this->nb_quiescent_cycles = 0;
+        this->nb_quiescent_periods = 0;
+        this->nb_cancelled_events = 0;
+    }
+}
+
+
+void FlooNocV2::check_quiescence()
+{
+    // Any request still allocated is somewhere in a queue or at a target, so
+    // this is enough to filter out most calls without walking the nodes.
+    if (!this->fast_forward || this->quiescent || this->req_pool.nb_in_use != 0)
+    {
+        return;
+    }
+
+    for (NetworkInterfaceV2 *ni: this->network_interfaces)
+    {
+        if (ni && !ni->is_idle())
+        {
+            return;
+        }
+    }
+
+    for (std::vector<RouterV2 *> *routers: { &this->req_routers, &this->rsp_routers, &this->wide_routers })
+    {
+        for (RouterV2 *router: *routers)
+        {
+            if (router && !router->is_idle())
+            {
+                return;
+            }
+        }
+    }
+
+    // Nothing is in flight, the remaining events would only find empty queues.
+    // Remove them so that the engine does not schedule the NoC until the next
+    // burst enters a network interface, which enqueues them again through the
+    // usual path. The timing stays the one without fast-forward as long as the
+    // engine runs the events of a cycle in enqueue order, or in the reverse
+    // one, since the events enqueued again then run in the order of the
+    // removed ones.
+    for (NetworkInterfaceV2 *ni: this->network_interfaces)
+    {
+        if (ni && ni->cancel_fsm())
+        {
+            this->nb_cancelled_events++;
+        }
+    }
+
+    for (std::vector<RouterV2 *> *routers: { &this->req_routers, &this->rsp_routers, &this->wide_routers })
+    {
+        for (RouterV2 *router: *routers)
+        {
+            if (router && router->cancel_fsm())
+            {
+                this->nb_cancelled_events++;
+            }
+        }
+    }
+
+    this->quiescent = true;
+    this->quiescent_since = this->clock.get_cycles();
+    this->nb_quiescent_periods++;
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Entering quiescence\n");
+}
+
+
+void FlooNocV2::leave_quiescence()
+{
+    int64_t cycles = this->clock.get_cycles() - this->quiescent_since;
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Leaving quiescence (quiescent cycles: %ld)\n", cycles);
+
+    this->quiescent = false;
+    this->nb_quiescent_cycles += cycles;
+}
+
+
+void FlooNocV2::stop()
+{
+    uint64_t nb_allocs = this->req_pool.nb_hits + this->req_pool.nb_misses;
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Request pool (allocs: %ld, hits: %ld, high_water: %ld)\n",
+        nb_allocs, this->req_pool.nb_hits, this->req_pool.high_water);
+
+    if (this->print_pool_stats)
+    {
+        printf("%s: request pool (allocs: %ld, hit rate: %.2f%%, high water mark: %ld)\n",
+            this->get_path().c_str(), nb_allocs,
+            nb_allocs ? 100.0 * this->req_pool.nb_hits / nb_allocs : 0.0,
+            this->req_pool.high_water);
+    }
+
+    uint64_t nb_quiescent_cycles = this->nb_quiescent_cycles;
+    if (this->quiescent)
+    {
+        nb_quiescent_cycles += this->clock.get_cycles() - this->quiescent_since;
+    }
+
+    // The saving is the number of events removed from the engine. The
+    // quiescent cycles are only given as context, the engine jumps over idle
+    // cycles anyway, so they do not cost anything by themselves.
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Fast-forward (cancelled events: %ld, periods: %ld, quiescent cycles: %ld)\n",
+        this->nb_cancelled_events, this->nb_quiescent_periods, nb_quiescent_cycles);
+
+    if (this->print_fast_forward_stats)
+    {
+        printf("%s: fast-forward (cancelled events: %ld, quiescent periods: %ld, quiescent cycles: %ld)\n",
+            this->get_path().c_str(), this->nb_cancelled_events, this->nb_quiescent_periods,
+            nb_quiescent_cycles);
+    }
 }
 
 
 EntryV2 *FlooNocV2::get_entry(uint64_t base, uint64_t size)
 {
-    for (int i=0; i<this->entries.size(); i++)
+    return this->route_table.lookup(base);
+}
+
+
+EntryV2 *FlooNocV2::get_entry(uint64_t base, uint64_t size, RouteTableV2::Cache &cache)
+{
+    return this->route_table.lookup(base, cache);
+}
+
+
+uint64_t FlooNocV2::get_collective(uint64_t addr, int &type, int &x_extent, int &y_extent)
+{
+    type = FloonocCollectiveV2::NONE;
+
+    if (this->collective_addr_shift == 0)
+    {
+        return addr;
+    }
+
+    uint64_t header = addr >> this->collective_addr_shift;
+    if (header == 0)
+    {
+        return addr;
+    }
+
+    type = header & 0xf;
+    x_extent = (header >> 4) & 0xff;
+    y_extent = (header >> 12) & 0xff;
+
+    if (type >= FloonocCollectiveV2::NB_OPS)
+    {
+        this->trace.force_warning("Invalid collective operation, doing unicast (addr: 0x%lx, op: %d)\n",
+            addr, type);
+        type = FloonocCollectiveV2::NONE;
+    }
+
+    return addr & ((1ULL << this->collective_addr_shift) - 1);
+}
+
+
+bool FlooNocV2::is_collective_node(int x, int y)
+{
+    if (x < 0 || x >= this->dim_x || y < 0 || y >= this->dim_y)
+    {
+        return false;
+    }
+
+    int index = y * this->dim_x + x;
+    return this->req_routers[index] != NULL && this->network_interfaces[index] != NULL;
+}
+
+
+FloonocReqPoolV2::~FloonocReqPoolV2()
+{
+    while (this->first_free)
+    {
+        FloonocReqV2 *req = this->first_free;
+        this->first_free = req->pool_next;
+        delete req;
+    }
+}
+
+
+FloonocReqV2 *FloonocReqPoolV2::alloc()
+{
+    FloonocReqV2 *req = this->first_free;
+
+    if (req)
+    {
+        this->first_free = req->pool_next;
+        this->nb_hits++;
+        // Rebuild the request in place so that no state leaks from its
+        // previous use
+        req->~FloonocReqV2();
+        new (req) FloonocReqV2();
+    }
+    else
+    {
+        this->nb_misses++;
+        req = new FloonocReqV2();
+    }
+
+    this->nb_in_use++;
+    if (this->nb_in_use > this->high_water)
+    {
+        this->high_water = this->nb_in_use;
+    }
+
+    return req;
+}
+
+
+void FloonocReqPoolV2::free(FloonocReqV2 *req)
+{
+    this->nb_in_use--;
+    req->pool_next = this->first_free;
+    this->first_free = req;
+}
+
+
+FloonocBufferPoolV2::~FloonocBufferPoolV2()
+{
+    for (auto &sized: this->free_buffers)
     {
-        EntryV2 *entry = &this->entries[i];
-        if (base >= entry->base && base < entry->base + entry->size)
+        for (uint8_t *buffer: sized.second)
         {
-            return entry;
+            delete[] buffer;
         }
     }
-    return NULL;
+}
+
+
+uint8_t *FloonocBufferPoolV2::alloc(uint64_t size)
+{
+    std::vector<uint8_t *> &buffers = this->free_buffers[size];
+
+    if (buffers.empty())
+    {
+        return new uint8_t[size];
+    }
+
+    uint8_t *buffer = buffers.back();
+    buffers.pop_back();
+    return buffer;
+}
+
+
+void FloonocBufferPoolV2::free(uint8_t *buffer, uint64_t size)
+{
+    this->free_buffers[size].push_back(buffer);
 }
 
 
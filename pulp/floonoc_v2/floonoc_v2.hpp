@@ -17,8 +17,12 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
+#include "floonoc_route_table_v2.hpp"
+#include "floonoc_collective_v2.hpp"
 
 class RouterV2;
 class NetworkInterfaceV2;
@@ -29,7 +33,8 @@ class FloonocNodeV2 : public vp::Block
 {
 public:
     FloonocNodeV2(Block *parent, std::string name) : vp::Block(parent, name) {}
-    virtual void unstall_queue(int from_x, int from_y) = 0;
+    // vc is the virtual channel which can accept requests again, or ALL_VCS
+    virtual void unstall_queue(int from_x, int from_y, int vc) = 0;
     virtual bool handle_request(FloonocNodeV2 *node, FloonocReqV2 *req, int from_x, int from_y) = 0;
 };
 
@@ -58,20 +63,91 @@ public:
     bool is_address;
     // Pre-translation address, used for VCD traces in the routers.
     uint64_t initiator_addr;
+    // Next free request when the request is sitting in the NoC request pool.
+    FloonocReqV2 *pool_next;
+
+    // Collective operation (FloonocCollectiveV2), NONE for unicast requests.
+    int coll_type = FloonocCollectiveV2::NONE;
+    // Rectangle of targeted nodes, bounds included
+    int coll_x0 = 0;
+    int coll_x1 = 0;
+    int coll_y0 = 0;
+    int coll_y1 = 0;
+    // Direction the request took to enter the current router, DIR_LOCAL when
+    // it has just been injected.
+    int coll_momentum = 0;
+    // Output chosen by the current router when the request is not forked.
+    int coll_out = 0;
+    // Forked request this one was spawned from, NULL for the root request.
+    // Responses are merged into it by the router at (coll_merge_x, coll_merge_y).
+    FloonocReqV2 *coll_parent = NULL;
+    int coll_merge_x = 0;
+    int coll_merge_y = 0;
+    // For forked requests, bytes of children responses still to be merged.
+    uint64_t coll_remaining = 0;
+    // For forked reads, buffer receiving the children read data.
+    uint8_t *coll_buffer = NULL;
+    uint64_t coll_buffer_size = 0;
+    // Virtual channel, given by the priority class assigned by the initiator
+    // network interface.
+    int vc = 0;
+    // X position of the router where the request entered the mesh, used by
+    // the odd-even routing rules.
+    int route_src_x = 0;
+    // Cycle at which the request entered its current queue, used to serve
+    // requests waiting for too long before the higher priority classes.
+    int64_t queue_cycle = 0;
+};
+
+
+/**
+ * Free-list of FloonocReqV2 shared by all the NIs of a NoC.
+ *
+ * Internal requests are allocated by the source NI and released by whichever
+ * NI sees them last, so the pool is owned by the NoC rather than by one NI.
+ * Released requests are kept on an intrusive list and rebuilt in place when
+ * reused, so that they start from the same state as a freshly allocated one.
+ */
+class FloonocReqPoolV2
+{
+public:
+    ~FloonocReqPoolV2();
+
+    FloonocReqV2 *alloc();
+    void free(FloonocReqV2 *req);
+
+    // Number of requests currently in flight in the NoC
+    uint64_t nb_in_use = 0;
+    // Maximum number of requests simultaneously in flight
+    uint64_t high_water = 0;
+    // Allocations served from the free-list
+    uint64_t nb_hits = 0;
+    // Allocations which had to go to the heap
+    uint64_t nb_misses = 0;
+
+private:
+    FloonocReqV2 *first_free = NULL;
 };
 
 
 /**
- * Memory-map entry: range -> target position on the mesh.
+ * Free-lists of the scratch buffers of forked reductions, per buffer size.
+ *
+ * A buffer receives the read data of all the children of a fork, so its size
+ * is the request size times the number of children. Only a few sizes are
+ * seen in practice, so released buffers are kept per size and reused as they
+ * are.
  */
-class EntryV2
+class FloonocBufferPoolV2
 {
 public:
-    uint64_t base;
-    uint64_t size;
-    int x;
-    int y;
-    uint64_t remove_offset;
+    ~FloonocBufferPoolV2();
+
+    uint8_t *alloc(uint64_t size);
+    void free(uint8_t *buffer, uint64_t size);
+
+private:
+    std::unordered_map<uint64_t, std::vector<uint8_t *>> free_buffers;
 };
 
 
@@ -89,8 +165,38 @@ public:
     ~FlooNocV2();
 
     void reset(bool active);
+    void stop() override;
 
     EntryV2 *get_entry(uint64_t base, uint64_t size);
+    // Same as above, but first checks the segment cached by the caller
+    EntryV2 *get_entry(uint64_t base, uint64_t size, RouteTableV2::Cache &cache);
+
+    // Extract the collective header from the upper address bits. Returns the
+    // address without the header, and NONE as type for unicast addresses.
+    // The extents are the number of nodes targeted beyond the decoded
+    // destination, towards the right and the top.
+    uint64_t get_collective(uint64_t addr, int &type, int &x_extent, int &y_extent);
+    // Tell if a node can be the target of a collective, i.e. has both a router
+    // and a network interface.
+    bool is_collective_node(int x, int y);
+
+    FloonocReqV2 *alloc_req() { return this->req_pool.alloc(); }
+    void free_req(FloonocReqV2 *req) { this->req_pool.free(req); }
+    uint8_t *alloc_buffer(uint64_t size) { return this->buffer_pool.alloc(size); }
+    void free_buffer(uint8_t *buffer, uint64_t size) { this->buffer_pool.free(buffer, size); }
+
+    // Called by a network interface which has nothing left to do. When no
+    // request is left anywhere in the NoC, all the router and network
+    // interface events are removed from the engine until the next burst.
+    void check_quiescence();
+    // Called by the network interfaces when they receive a burst
+    void exit_quiescence()
+    {
+        if (this->quiescent)
+        {
+            this->leave_quiescence();
+        }
+    }
 
     static constexpr int DIR_RIGHT = 0;
     static constexpr int DIR_LEFT = 1;
@@ -98,22 +204,70 @@ public:
     static constexpr int DIR_DOWN = 3;
     static constexpr int DIR_LOCAL = 4;
 
+    // Routing algorithms, see RouterV2::get_output_queue
+    static constexpr int ROUTING_XY = 0;
+    static constexpr int ROUTING_YX = 1;
+    static constexpr int ROUTING_WEST_FIRST = 2;
+    static constexpr int ROUTING_ADAPTIVE = 3;
+
+    // Priority classes assigned by the network interfaces, the higher the
+    // more urgent. Class i travels on virtual channel i, classes beyond the
+    // number of virtual channels share the last one.
+    static constexpr int CLASS_BULK = 0;
+    static constexpr int CLASS_NARROW = 1;
+    static constexpr int CLASS_SYNC = 2;
+    static constexpr int ALL_VCS = -1;
+
     uint64_t wide_width;
     uint64_t narrow_width;
     int dim_x;
     int dim_y;
+    // Number of virtual channels per router input
+    int nb_vcs;
+    // Virtual channels are served from the highest priority class down,
+    // except those whose oldest request waited for more than this number of
+    // cycles, which go first. 0 keeps the strict priority order.
+    int vc_max_wait;
 
 private:
     FloonocNodeV2 *get_router_neighbour(std::vector<RouterV2 *> &routers, int x, int y);
     void router_init_neighbours(RouterV2 *router, std::vector<RouterV2 *> &routers);
     FloonocNodeV2 *get_node(std::vector<RouterV2 *> &routers, int x, int y);
+    void leave_quiescence();
 
     vp::Trace trace;
     std::vector<EntryV2> entries;
+    // Compiled form of entries, used for all address decoding
+    RouteTableV2 route_table;
     std::vector<std::string> itf_names;
     int router_input_queue_size;
+    bool router_wake_on_unstall;
+    int routing;
+    // Position of the collective header in the request addresses, 0 when
+    // collectives are disabled.
+    int collective_addr_shift;
     std::vector<RouterV2 *> req_routers;
     std::vector<RouterV2 *> rsp_routers;
     std::vector<RouterV2 *> wide_routers;
     std::vector<NetworkInterfaceV2 *> network_interfaces;
+    FloonocReqPoolV2 req_pool;
+    FloonocBufferPoolV2 buffer_pool;
+    // Dump the request pool statistics at the end of the simulation
+    bool print_pool_stats;
+    // Remove all the NoC events from the engine while no request is in flight
+    bool fast_forward;
+    // Dump the fast-forward statistics at the end of the simulation
+    bool print_fast_forward_stats;
+    // True while no request is in flight and the NoC events are removed
+    bool quiescent;
+    // Cycle at which the current quiescent period started
+    int64_t quiescent_since;
+    // Pending events removed from the engine when entering quiescence, each
+    // of them would have been executed once to find nothing to do. This is
+    // what fast-forward saves.
+    uint64_t nb_cancelled_events;
+    // Number of quiescent periods
+    uint64_t nb_quiescent_periods;
+    // Cycles spent quiescent, not counting the current period
+    uint64_t nb_quiescent_cycles;
 };
@@ -35,7 +35,11 @@ class FlooNocV22dMeshNarrowWide(gvsoc.systree.Component):
     retry() deny handshake.
     """
     def __init__(self, parent: gvsoc.systree.Component, name, narrow_width: int, wide_width:int,
-            dim_x: int, dim_y:int, ni_outstanding_reqs: int=8, router_input_queue_size: int=2):
+            dim_x: int, dim_y:int, ni_outstanding_reqs: int=8, router_input_queue_size: int=2,
+            print_pool_stats: bool=False, router_wake_on_unstall: bool=True,
+            collective_addr_shift: int=0, routing: str='xy', router_nb_vcs: int=1,
+            fast_forward: bool=True, print_fast_forward_stats: bool=False,
+            router_vc_max_wait: int=64):
         super().__init__(parent, name)
 
         self.add_sources([
@@ -53,6 +57,45 @@ class FlooNocV22dMeshNarrowWide(gvsoc.systree.Component):
         self.add_property('dim_x', dim_x)
         self.add_property('dim_y', dim_y)
         self.add_property('router_input_queue_size', router_input_queue_size)
+        self.add_property('print_pool_stats', print_pool_stats)
+        # Routers sleep when none of their input heads can progress instead of
+        # polling every cycle. Timing is identical, only host time differs.
+        self.add_property('router_wake_on_unstall', router_wake_on_unstall)
+        # Collectives are requested through the address bits above this shift, 0
+        # disables them. From this bit: operation (4 bits, 1 for multicast,
+        # 2 to 7 for add/max reductions on uint16/int16/fp16), then X and Y
+        # extents (8 bits each). The targets are the nodes of the rectangle
+        # going from the decoded destination to extent nodes further right
+        # and up, clipped to the mesh. Writes are multicast to all of them,
+        # reads with a reduction operation return the reduction of all of them.
+        self.add_property('collective_addr_shift', collective_addr_shift)
+        # Routing algorithm, all of them are minimal and deadlock-free:
+        # - xy: dimension-ordered, X first
+        # - yx: dimension-ordered, Y first
+        # - west_first: turn model, west hops first, then the least congested
+        #   of the other productive directions
+        # - adaptive: odd-even turn model, picks the least congested productive
+        #   direction allowed in the current column
+        # Adaptive algorithms look at the input queue occupancy of the next
+        # routers.
+        self.add_property('routing', routing)
+        # Virtual channels per router input, each with router_input_queue_size
+        # entries. Network interfaces give atomics the highest priority class,
+        # then narrow requests, then wide bursts. Class i uses virtual channel
+        # i, the upper classes share the last one when there are fewer, and
+        # has its own injection queue in the network interfaces.
+        self.add_property('router_nb_vcs', router_nb_vcs)
+        # Routers and network interfaces serve virtual channels from the
+        # highest class down, except those whose oldest request waited for more
+        # than this number of cycles, which go first so that the low classes
+        # are not starved. 0 keeps the strict priority order.
+        self.add_property('router_vc_max_wait', router_vc_max_wait)
+        # When no request is in flight anywhere in the NoC, remove all the
+        # router and network interface events from the engine until the next
+        # burst comes in. Timing is identical, the number of events removed
+        # from the engine is reported with print_fast_forward_stats.
+        self.add_property('fast_forward', fast_forward)
+        self.add_property('print_fast_forward_stats', print_fast_forward_stats)
 
     def __add_mapping(self, name: str, base: int, size: int, x: int, y: int, remove_offset:int =0):
         self.get_property('mappings')[name] =  {'base': base, 'size': size, 'x': x, 'y': y, 'remove_offset':remove_offset}
@@ -103,11 +146,20 @@ class FlooNocV22dMeshNarrowWide(gvsoc.systree.Component):
 class FlooNocV2ClusterGridNarrowWide(FlooNocV22dMeshNarrowWide):
     """FlooNoC v2 instance for a grid of clusters (mirrors v1's variant)."""
     def __init__(self, parent: gvsoc.systree.Component, name, wide_width: int, narrow_width:int, nb_x_clusters: int,
-            nb_y_clusters, router_input_queue_size=2, ni_outstanding_reqs: int=2):
+            nb_y_clusters, router_input_queue_size=2, ni_outstanding_reqs: int=2,
+            print_pool_stats: bool=False, router_wake_on_unstall: bool=True,
+            collective_addr_shift: int=0, routing: str='xy', router_nb_vcs: int=1,
+            fast_forward: bool=True, print_fast_forward_stats: bool=False,
+            router_vc_max_wait: int=64):
         super().__init__(parent, name, wide_width=wide_width, narrow_width=narrow_width,
             dim_x=nb_x_clusters+2, dim_y=nb_y_clusters+2,
             router_input_queue_size=router_input_queue_size,
-            ni_outstanding_reqs=ni_outstanding_reqs)
+            ni_outstanding_reqs=ni_outstanding_reqs, print_pool_stats=print_pool_stats,
+            router_wake_on_unstall=router_wake_on_unstall,
+            collective_addr_shift=collective_addr_shift, routing=routing,
+            router_nb_vcs=router_nb_vcs, fast_forward=fast_forward,
+            print_fast_forward_stats=print_fast_forward_stats,
+            router_vc_max_wait=router_vc_max_wait)
 
         for tile_x in range(0, nb_x_clusters):
             for tile_y in range(0, nb_y_clusters):
@@ -74,6 +74,10 @@ IDmaBeAxi::~IDmaBeAxi()
     {
         delete[] req.get_data();
     }
+    for (vp::IoReq *req: this->write_reqs)
+    {
+        delete req;
+    }
 }
 
 
@@ -106,6 +110,9 @@ void IDmaBeAxi::reset(bool active)
             this->free_bursts.push(&req);
         }
 
+        // Same for write requests
+        this->free_write_reqs = this->write_reqs;
+
         // Note that to be safe,
         // if any request is pending outside this component, the convention is that
         // any component inside the same reset domain will just release the request, while
@@ -274,8 +281,8 @@ void IDmaBeAxi::write_burst(IdmaTransfer *transfer, uint64_t base, uint64_t size
 void IDmaBeAxi::write_data(IdmaTransfer *transfer, uint8_t *data, uint64_t size)
 {
     // Each chunk is directly sent to AXI to avoid sending whole burst at the end.
-    // Allocate a request and send it. The burst limitation is modeled with another request
-    vp::IoReq *req = new vp::IoReq();
+    // Get a request and send it. The burst limitation is modeled with another request
+    vp::IoReq *req = this->write_req_alloc();
 
     uint64_t base = this->current_burst_base;
     this->current_burst_base += size;
@@ -301,7 +308,6 @@ void IDmaBeAxi::write_data(IdmaTransfer *transfer, uint8_t *data, uint64_t size)
     req->set_addr(base);
     req->set_size(size);
     req->set_data(data);
-    req->arg_alloc();
     *req->arg_get(0) = (void *)transfer;
 
     vp::IoReqStatus status = this->ico_itf.req(req);
@@ -323,6 +329,25 @@ void IDmaBeAxi::write_data(IdmaTransfer *transfer, uint8_t *data, uint64_t size)
 
 
 
+vp::IoReq *IDmaBeAxi::write_req_alloc()
+{
+    if (this->free_write_reqs.empty())
+    {
+        vp::IoReq *req = new vp::IoReq();
+        // Reserve one argument to store the associated transfer, done once since the
+        // request is then reused
+        req->arg_alloc();
+        this->write_reqs.push_back(req);
+        return req;
+    }
+
+    vp::IoReq *req = this->free_write_reqs.back();
+    this->free_write_reqs.pop_back();
+    return req;
+}
+
+
+
 void IDmaBeAxi::write_handle_req_end(vp::IoReq *req)
 {
     this->trace.msg(vp::Trace::LEVEL_TRACE, "Handling end of request (req: %p)\n", req);
@@ -349,7 +374,7 @@ void IDmaBeAxi::write_handle_req_end(vp::IoReq *req)
         this->update();
     }
 
-    delete req;
+    this->free_write_reqs.push_back(req);
 
     // For now we ignore the latency for write requests.
     // This will be better modeled when we switch to the new AXI router
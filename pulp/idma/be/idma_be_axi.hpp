@@ -76,6 +76,8 @@ private:
     void send_read_burst_to_axi();
     // Enqueue a burst to pending queue. Burst will be processed in order
     void enqueue_burst(uint64_t base, uint64_t size, bool is_write, IdmaTransfer *transfer);
+    // Get a free request for writing a data chunk
+    vp::IoReq *write_req_alloc();
 
     // Pointer to backend, used for data synchronization
     IdmaBeProducer *be;
@@ -107,6 +109,13 @@ private:
 
     std::queue<vp::IoReq *> pending_bursts_ack;
 
+    // Requests used for writing data chunks. They point directly to the data of the other
+    // backend and are recycled once the write is done, new ones are allocated only when all
+    // are in flight.
+    std::vector<vp::IoReq *> write_reqs;
+    // Write requests which are not in flight
+    std::vector<vp::IoReq *> free_write_reqs;
+
     // Current base of the first transfer. This is when a chunk of data to be written is received
     // to know the base where it should be written.
     uint64_t current_burst_base;
@@ -50,6 +50,16 @@ IDmaBeTcdm::IDmaBeTcdm(vp::Component *idma, std::string itf_name, IdmaBeProducer
 
 
 
+IDmaBeTcdm::~IDmaBeTcdm()
+{
+    for (uint8_t *line: this->lines)
+    {
+        delete[] line;
+    }
+}
+
+
+
 void IDmaBeTcdm::activate_burst()
 {
     // If queue is not empty and we don't have any active burst, activate it
@@ -147,6 +157,9 @@ void IDmaBeTcdm::reset(bool active)
         this->write_ack_timestamp = -1;
 
         this->last_line_timestamp = -1;
+
+        // Line buffers still in flight are released by the other components of the reset domain
+        this->free_lines = this->lines;
     }
 }
 
@@ -294,9 +307,9 @@ void IDmaBeTcdm::read_line()
     req->set_addr(base - this->loc_base);
     req->set_size(size);
     // Since the destination backend may keep the data until the write is done, we need
-    // to dynamically allocate the data since we may read several times before data is acknowledged
-    // We will free it when we receive the ack
-    req->set_data(new uint8_t[size]);
+    // a different buffer for each line since we may read several times before data is acknowledged
+    // It will be released when we receive the ack
+    req->set_data(this->line_alloc());
 
     // Send to TCDM
     vp::IoReqStatus status = this->ico_itf.req(req);
@@ -331,11 +344,28 @@ void IDmaBeTcdm::read_line()
 
 
 
+uint8_t *IDmaBeTcdm::line_alloc()
+{
+    if (this->free_lines.empty())
+    {
+        // Lines never go over the interface width
+        uint8_t *line = new uint8_t[this->width];
+        this->lines.push_back(line);
+        return line;
+    }
+
+    uint8_t *line = this->free_lines.back();
+    this->free_lines.pop_back();
+    return line;
+}
+
+
+
 // Called by destination backend to ack the data we sent for writing
 void IDmaBeTcdm::write_data_ack(uint8_t *data)
 {
-    // Release the data since we are now sure it won't be used anymore
-    delete[] data;
+    // Release the line since we are now sure it won't be used anymore
+    this->free_lines.push_back(data);
     // And check if there is any action to take since backend may became ready
     this->update();
 }
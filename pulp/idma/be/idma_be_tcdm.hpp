@@ -43,6 +43,11 @@ public:
      */
     IDmaBeTcdm(vp::Component *idma, std::string itf_name, IdmaBeProducer *be);
 
+    /**
+     * @brief Destroy a TCDM back-end
+     */
+    ~IDmaBeTcdm();
+
     void reset(bool active) override;
 
     void update();
@@ -73,6 +78,8 @@ private:
     void activate_burst();
     // Enqueue a new burst to the queue of pending bursts
     void enqueue_burst(uint64_t base, uint64_t size, bool is_write, IdmaTransfer *transfer);
+    // Get a free line buffer to read a line into
+    uint8_t *line_alloc();
 
     // Pointer to back-end, used for data synchronization
     IdmaBeProducer *be;
@@ -141,4 +148,10 @@ private:
     int64_t last_line_timestamp;
     // Current transfer for which data to be written are push
     IdmaTransfer *write_current_transfer;
+    // Line buffers read lines are stored in. The destination back-end keeps them until the data
+    // is written, so they are recycled when acknowledged instead of being allocated for each line.
+    // New ones are allocated only when all are in flight.
+    std::vector<uint8_t *> lines;
+    // Line buffers which are not in flight
+    std::vector<uint8_t *> free_lines;
 };
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vp/vp.hpp>
+#include "idma_me_nd.hpp"
+
+
+IDmaMeNd::IDmaMeNd(vp::Component *idma, IdmaTransferProducer *fe, IdmaTransferConsumer *be)
+:   Block(idma, "me"),
+    fsm_event(this, &IDmaMeNd::fsm_handler)
+{
+    // Frontend and backend will be used later for interaction
+    this->fe = fe;
+    this->be = be;
+
+    // Declare our own trace so that we can individually activate traces
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    // Get the top parameter giving the maximum number of enqueued transfers
+    this->transfer_queue_size = idma->get_js_config()->get_int("transfer_queue_size");
+
+    this->nb_dims = idma->get_js_config()->get_int("me_nb_dims");
+    if (this->nb_dims < 2 || this->nb_dims > IDMA_ND_MAX_DIMS)
+    {
+        this->trace.fatal("Invalid number of dimensions (nb_dims: %d, max: %d)\n",
+            this->nb_dims, IDMA_ND_MAX_DIMS);
+    }
+
+    this->current_transfer = NULL;
+}
+
+
+
+// Called by front-end to enqueue transfer
+void IDmaMeNd::enqueue_transfer(IdmaTransfer *transfer)
+{
+    this->trace.msg(vp::Trace::LEVEL_TRACE, "Queueing transfer (transfer: %p)\n", transfer);
+
+    // Number of bursts will be used when they are acknowledged to know when transfer is done
+    transfer->nb_bursts = 0;
+    transfer->bursts_sent = false;
+
+    // Enqueue the transfer
+    this->transfer_queue.push(transfer);
+
+    // And trigger the FSM to check if the transfer must be handled
+    this->fsm_event.enqueue();
+}
+
+
+
+bool IDmaMeNd::can_accept_transfer()
+{
+    // Accept transfers as soon as there is room in the queue
+    return this->transfer_queue.size() < this->transfer_queue_size;
+}
+
+
+
+// Called by back-end to notify the end of a burst of the transfer
+void IDmaMeNd::ack_transfer(IdmaTransfer *transfer)
+{
+    // Decreased number of pending bursts
+    transfer->parent->nb_bursts--;
+
+    // And terminate the transfer if all bursts have been sent and no more burst is pending
+    if (transfer->parent->bursts_sent && transfer->parent->nb_bursts == 0)
+    {
+        this->fe->ack_transfer(transfer->parent);
+    }
+
+    delete transfer;
+}
+
+
+
+bool IDmaMeNd::load_transfer(IdmaTransfer *transfer)
+{
+    IdmaNdIter::Dim dims[IDMA_ND_MAX_DIMS - 1];
+    int nb_dims = 0;
+
+    // 1D transfers only have the contiguous dimension
+    if ((transfer->config >> 1) & 1)
+    {
+        dims[nb_dims++] = { transfer->src_stride, transfer->dst_stride, transfer->reps };
+
+        for (size_t i = 0; i + 2 < transfer->data.size(); i += 3)
+        {
+            if (nb_dims + 1 >= this->nb_dims)
+            {
+                this->trace.force_warning("Transfer has more dimensions than supported, ignoring "
+                    "extra ones (nb_dims: %d)\n", this->nb_dims);
+                break;
+            }
+
+            dims[nb_dims++] = { transfer->data[i], transfer->data[i + 1], transfer->data[i + 2] };
+        }
+    }
+
+    if (!this->iter.init(transfer->src, transfer->dst, transfer->size, dims, nb_dims))
+    {
+        return false;
+    }
+
+    this->trace.msg(vp::Trace::LEVEL_TRACE, "Starting transfer (transfer: %p, dims: %d, "
+        "burst_size: 0x%llx, nb_bursts: %lld)\n", transfer, this->iter.get_nb_dims() + 1,
+        this->iter.burst_size(), this->iter.nb_bursts());
+
+    return true;
+}
+
+
+
+void IDmaMeNd::reset(bool active)
+{
+    if (active)
+    {
+        // Empty the fifo
+        while (this->transfer_queue.size() > 0)
+        {
+            IdmaTransfer *transfer = this->transfer_queue.front();
+            this->transfer_queue.pop();
+            // Each transfer needs to be freed since we are owning them
+            delete transfer;
+        }
+
+        // Clear current transfer
+        this->current_transfer = NULL;
+    }
+}
+
+
+
+void IDmaMeNd::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    IDmaMeNd *_this = (IDmaMeNd *)__this;
+
+    // Check if one of the queued transfer can become the current one
+    if (_this->transfer_queue.size() > 0 && _this->current_transfer == NULL)
+    {
+        IdmaTransfer *transfer = _this->transfer_queue.front();
+
+        if (!_this->load_transfer(transfer))
+        {
+            // One of the dimensions is empty, terminate the transfer without any burst
+            _this->transfer_queue.pop();
+            transfer->bursts_sent = true;
+            _this->fe->ack_transfer(transfer);
+            _this->fe->update();
+            _this->fsm_event.enqueue();
+            return;
+        }
+
+        _this->current_transfer = transfer;
+    }
+
+    // Check if we can extract a burst from the current transfer
+    if (_this->current_transfer != NULL && _this->be->can_accept_transfer())
+    {
+        // Create a burst
+        IdmaTransfer *burst = new IdmaTransfer();
+
+        burst->parent = _this->current_transfer;
+        _this->current_transfer->nb_bursts++;
+        burst->size = _this->iter.burst_size();
+
+        if (_this->iter.next(burst->src, burst->dst))
+        {
+            // End of transfer, mark it as fully sent
+            _this->current_transfer->bursts_sent = true;
+
+            // And remove it
+            _this->current_transfer = NULL;
+            _this->transfer_queue.pop();
+
+            // Update frontend in case it has a transfer to queue
+            _this->fe->update();
+        }
+
+        // Enqueue burst to backend
+        _this->be->enqueue_transfer(burst);
+
+        // And trigger again FSM for next burst
+        _this->fsm_event.enqueue();
+    }
+}
+
+
+
+void IDmaMeNd::update()
+{
+    this->fsm_event.enqueue();
+}
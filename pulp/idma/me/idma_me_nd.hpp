@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vp/vp.hpp>
+#include "../idma.hpp"
+#include "idma_me_nd_iter.hpp"
+
+
+
+/**
+ * @brief N-dimensional middle-end
+ *
+ * This middle-end can be used instead of the 2D one to get support for up to IDMA_ND_MAX_DIMS
+ * dimensions. The second dimension is described by the strides and repetitions of the transfer,
+ * like for 2D transfers, and the next ones by the data field of the transfer, which holds
+ * for each of them its source stride, destination stride and repetitions.
+ *
+ * The number of supported dimensions is given by the me_nb_dims top parameter. Contiguous
+ * dimensions are merged together so that the back-end receives fewer and bigger bursts.
+ */
+class IDmaMeNd : public vp::Block, public IdmaTransferConsumer, public IdmaTransferProducer
+{
+public:
+    /**
+     * @brief Construct a new IDmaMeNd middle-end
+     *
+     * @param idma The top iDMA block.
+     * @param fe The front end.
+     * @param be The back end.
+     */
+    IDmaMeNd(vp::Component *idma, IdmaTransferProducer *fe, IdmaTransferConsumer *be);
+
+    void reset(bool active) override;
+
+    bool can_accept_transfer() override;
+    void enqueue_transfer(IdmaTransfer *transfer) override;
+    void update() override;
+    void ack_transfer(IdmaTransfer *transfer) override;
+
+
+private:
+    // FSM handler, called to check if any action should be taken after something was updated
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    // Extract the dimensions of the transfer, returns false if it has nothing to move
+    bool load_transfer(IdmaTransfer *transfer);
+
+    // Pointer to frontend
+    IdmaTransferProducer *fe;
+    // Pointer to backend
+    IdmaTransferConsumer *be;
+    // Trace for this block, messages will be displayed with this block's name
+    vp::Trace trace;
+    // Top parameter giving the maximum number of transfers which can be enqueued
+    int transfer_queue_size;
+    // Top parameter giving the number of supported dimensions, including the contiguous one
+    int nb_dims;
+    // Queue of enqueued transfers. The number of transfers which can be enqueued is defined by
+    // transfer_queue_size
+    std::queue<IdmaTransfer *> transfer_queue;
+    // Block FSM event, used to trigger all checks after something has been updated
+    vp::ClockEvent fsm_event;
+    // Current transfer being processed
+    IdmaTransfer *current_transfer;
+    // Bursts of the current transfer
+    IdmaNdIter iter;
+};
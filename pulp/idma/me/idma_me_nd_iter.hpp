@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Maximum number of dimensions of a transfer, including the contiguous one
+#define IDMA_ND_MAX_DIMS 4
+
+
+
+/**
+ * @brief Burst iterator of N-dimensional transfers
+ *
+ * Dimension 0 is the contiguous one, made of size bytes. Each outer dimension repeats reps times
+ * the dimensions below it, moving source and destination by its strides. Bursts are produced in
+ * the hardware order, innermost dimension first.
+ *
+ * Outer dimensions which are contiguous with the burst on both sides are merged into it, and
+ * outer dimensions which just continue the previous one are merged with it, so that contiguous
+ * layouts give fewer and bigger bursts.
+ */
+class IdmaNdIter
+{
+public:
+    // Outer dimension of a transfer
+    struct Dim
+    {
+        uint64_t src_stride;
+        uint64_t dst_stride;
+        uint64_t reps;
+    };
+
+    /**
+     * @brief Start iterating over a transfer
+     *
+     * @param src Source address.
+     * @param dst Destination address.
+     * @param size Size of the contiguous dimension.
+     * @param dims Outer dimensions, innermost first.
+     * @param nb_dims Number of outer dimensions.
+     * @param merge Merge contiguous dimensions, only disabled for comparing burst counts.
+     * @return false if the transfer has nothing to move.
+     */
+    bool init(uint64_t src, uint64_t dst, uint64_t size, const Dim *dims, int nb_dims,
+        bool merge=true)
+    {
+        this->size = size;
+        this->nb_dims = 0;
+
+        if (size == 0)
+        {
+            return false;
+        }
+
+        for (int i = 0; i < nb_dims; i++)
+        {
+            const Dim &dim = dims[i];
+
+            if (dim.reps == 0)
+            {
+                return false;
+            }
+
+            // A single repetition does not move anything
+            if (dim.reps == 1)
+            {
+                continue;
+            }
+
+            if (merge)
+            {
+                if (this->nb_dims == 0)
+                {
+                    if (dim.src_stride == this->size && dim.dst_stride == this->size)
+                    {
+                        this->size *= dim.reps;
+                        continue;
+                    }
+                }
+                else
+                {
+                    Dim &outer = this->dims[this->nb_dims - 1];
+                    if (dim.src_stride == outer.src_stride * outer.reps &&
+                        dim.dst_stride == outer.dst_stride * outer.reps)
+                    {
+                        outer.reps *= dim.reps;
+                        continue;
+                    }
+                }
+            }
+
+            this->dims[this->nb_dims++] = dim;
+        }
+
+        for (int i = 0; i <= this->nb_dims; i++)
+        {
+            this->src[i] = src;
+            this->dst[i] = dst;
+            this->count[i] = 0;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Get the next burst
+     *
+     * @param src Filled with the source address of the burst.
+     * @param dst Filled with the destination address of the burst.
+     * @return true if this is the last burst of the transfer.
+     */
+    bool next(uint64_t &src, uint64_t &dst)
+    {
+        src = this->src[0];
+        dst = this->dst[0];
+
+        // Move to the next element of the innermost dimension which is not done
+        int dim = 0;
+        for (; dim < this->nb_dims; dim++)
+        {
+            if (++this->count[dim] < this->dims[dim].reps)
+            {
+                this->src[dim] += this->dims[dim].src_stride;
+                this->dst[dim] += this->dims[dim].dst_stride;
+                break;
+            }
+            this->count[dim] = 0;
+        }
+
+        if (dim == this->nb_dims)
+        {
+            return true;
+        }
+
+        // And restart the dimensions below it from this element
+        for (int i = dim - 1; i >= 0; i--)
+        {
+            this->src[i] = this->src[dim];
+            this->dst[i] = this->dst[dim];
+        }
+
+        return false;
+    }
+
+    // Size of each burst
+    uint64_t burst_size() const { return this->size; }
+
+    // Number of outer dimensions left after merging
+    int get_nb_dims() const { return this->nb_dims; }
+
+    // Total number of bursts of the transfer
+    uint64_t nb_bursts() const
+    {
+        uint64_t result = 1;
+        for (int i = 0; i < this->nb_dims; i++)
+        {
+            result *= this->dims[i].reps;
+        }
+        return result;
+    }
+
+private:
+    // Burst size, after the contiguous outer dimensions have been merged
+    uint64_t size;
+    // Outer dimensions left after merging, innermost first
+    int nb_dims;
+    Dim dims[IDMA_ND_MAX_DIMS - 1];
+    // Current repetition of each outer dimension
+    uint64_t count[IDMA_ND_MAX_DIMS];
+    // Addresses of the current element of each dimension
+    uint64_t src[IDMA_ND_MAX_DIMS];
+    uint64_t dst[IDMA_ND_MAX_DIMS];
+};
@@ -44,6 +44,7 @@ class RegDma(gvsoc.systree.Component):
             'pulp/idma/reg_dma.cpp',
             'pulp/idma/fe/idma_fe_reg.cpp',
             'pulp/idma/me/idma_me_2d.cpp',
+            'pulp/idma/me/idma_me_nd.cpp',
             'pulp/idma/be/idma_be.cpp',
             'pulp/idma/be/idma_be_axi.cpp',
             'pulp/idma/be/idma_be_tcdm.cpp',
@@ -56,6 +57,8 @@ class RegDma(gvsoc.systree.Component):
             "loc_base": config.loc_base,
             "loc_size": config.loc_size,
             "tcdm_width": config.tcdm_width,
+            "me_nd": config.me_nd,
+            "me_nb_dims": config.me_nb_dims,
         })
 
     def i_INPUT(self) -> gvsoc.systree.SlaveItf:
@@ -114,6 +117,21 @@ class RegDma(gvsoc.systree.Component):
         """
         self.itf_bind('irq', itf, signature='wire<bool>')
 
+    def o_DESC(self, itf: gvsoc.systree.SlaveItf):
+        """Binds the descriptor port.
+
+        This port is used for reading the descriptors of a chain started through the
+        descriptor registers (0x20 head address, 0x28 config, 0x30 trigger). Each descriptor
+        is a 64-byte block which gets read only once the previous one has been pushed to the
+        middle-end. Chains can only be started if this port is bound.\n
+
+        Parameters
+        ----------
+        slave: gvsoc.systree.SlaveItf
+            Slave interface
+        """
+        self.itf_bind('desc', itf, signature='io')
+
     @override
     def gen_gui(self, parent_signal: Signal):
         active = Signal(self, parent_signal, name=self.name, path='fe/busy', groups='regmap',
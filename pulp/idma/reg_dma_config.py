@@ -41,3 +41,12 @@ class RegDmaConfig(Config):
     tcdm_width: int = cfg_field(default=0, desc=(
         "Width of the local interconnect, in bytes."
     ))
+
+    me_nd: bool = cfg_field(default=False, desc=(
+        "Use the N-dimensional middle-end instead of the 2D one. It also merges contiguous "
+        "dimensions into bigger bursts."
+    ))
+
+    me_nb_dims: int = cfg_field(default=4, desc=(
+        "Number of dimensions supported by the N-dimensional middle-end, from 2 to 4."
+    ))
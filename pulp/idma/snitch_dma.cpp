@@ -21,6 +21,7 @@
 #include <vp/vp.hpp>
 #include "fe/idma_fe_xdma.hpp"
 #include "me/idma_me_2d.hpp"
+#include "me/idma_me_nd.hpp"
 #include "be/idma_be.hpp"
 #include "be/idma_be_axi.hpp"
 #include "be/idma_be_tcdm.hpp"
@@ -32,7 +33,7 @@
  *
  * This puts together:
  *   - Xdma front-end to handle xdma custom instructions from snitch core
- *   - 2D middle end to add support for 2D transfers
+ *   - 2D middle end to add support for 2D transfers, or N-dimensional middle-end if me_nd is set
  *   - AXI and TCDM backend protocols to interact with external AXI interconnect and local
  *   TCDM memory
  */
@@ -42,8 +43,14 @@ public:
     SnitchDma(vp::ComponentConf &config);
 
 private:
+    // Interfaces of the middle-end which was instantiated
+    IdmaTransferConsumer *me_consumer();
+    IdmaTransferProducer *me_producer();
+
+    // Only one of the 2 middle-ends is instantiated, depending on the me_nd parameter
+    IDmaMeNd *me_nd;
+    IDmaMe2D *me_2d;
     IDmaFeXdma fe;
-    IDmaMe2D me;
     IDmaBeAxi be_axi_read;
     IDmaBeAxi be_axi_write;
     IDmaBeTcdm be_tcdm_read;
@@ -55,16 +62,38 @@ private:
 
 SnitchDma::SnitchDma(vp::ComponentConf &config)
     : vp::Component(config),
-    fe(this, &this->me),
-    me(this, &this->fe, &this->be),
+    me_nd(this->get_js_config()->get_child_bool("me_nd") ?
+        new IDmaMeNd(this, &this->fe, &this->be) : NULL),
+    me_2d(this->me_nd == NULL ? new IDmaMe2D(this, &this->fe, &this->be) : NULL),
+    fe(this, this->me_consumer()),
     be_axi_read(this, "axi_read", &this->be), be_axi_write(this, "axi_write", &this->be),
     be_tcdm_read(this, "tcdm_read", &this->be), be_tcdm_write(this, "tcdm_write", &this->be),
-    be(this, &this->me, &this->be_tcdm_read, &this->be_tcdm_write,
+    be(this, this->me_producer(), &this->be_tcdm_read, &this->be_tcdm_write,
         &this->be_axi_read, &this->be_axi_write)
 {
 }
 
 
+IdmaTransferConsumer *SnitchDma::me_consumer()
+{
+    if (this->me_nd)
+    {
+        return this->me_nd;
+    }
+    return this->me_2d;
+}
+
+
+IdmaTransferProducer *SnitchDma::me_producer()
+{
+    if (this->me_nd)
+    {
+        return this->me_nd;
+    }
+    return this->me_2d;
+}
+
+
 extern "C" vp::Component *gv_new(vp::ComponentConf &config)
 {
     return new SnitchDma(config);
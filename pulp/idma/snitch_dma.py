@@ -38,6 +38,11 @@ class SnitchDma(gvsoc.systree.Component):
         Size of the local area.
     tcdm_width: int
         Width of the local interconnect, in bytes.
+    me_nd: bool
+        Use the N-dimensional middle-end instead of the 2D one. It also merges contiguous
+        dimensions into bigger bursts.
+    me_nb_dims: int
+        Number of dimensions supported by the N-dimensional middle-end, from 2 to 4.
     """
 
     def __init__(self, parent: gvsoc.systree.Component, name: str,
@@ -46,7 +51,9 @@ class SnitchDma(gvsoc.systree.Component):
             burst_size: int=0,
             loc_base: int=0,
             loc_size: int=0,
-            tcdm_width: int=0):
+            tcdm_width: int=0,
+            me_nd: bool=False,
+            me_nb_dims: int=4):
 
         super().__init__(parent, name)
 
@@ -54,6 +61,7 @@ class SnitchDma(gvsoc.systree.Component):
             'pulp/idma/snitch_dma.cpp',
             'pulp/idma/fe/idma_fe_xdma.cpp',
             'pulp/idma/me/idma_me_2d.cpp',
+            'pulp/idma/me/idma_me_nd.cpp',
             'pulp/idma/be/idma_be.cpp',
             'pulp/idma/be/idma_be_axi.cpp',
             'pulp/idma/be/idma_be_tcdm.cpp',
@@ -66,6 +74,8 @@ class SnitchDma(gvsoc.systree.Component):
             "loc_base": loc_base,
             "loc_size": loc_size,
             "tcdm_width": tcdm_width,
+            "me_nd": me_nd,
+            "me_nb_dims": me_nb_dims,
         })
 
     def i_OFFLOAD(self) -> gvsoc.systree.SlaveItf:
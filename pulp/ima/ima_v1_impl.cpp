@@ -24,6 +24,7 @@
 #include <string.h>
 #include <archi/ima/ima_v1.h>
 #include "ima_v1_impl.hpp"
+#include "ima_v1_mvm.hpp"
 
 #define TOTAL_REQ 10
 
@@ -65,6 +66,7 @@ ima_v1::ima_v1(vp::ComponentConf &config)
   this->regs = new unsigned int[IMA_NB_REGS];
   this->buffer_in = new int8_t[this->xbar_y];
   this->buffer_out = new int8_t[this->xbar_x];
+  this->mvm_sum = new float[this->xbar_x];
 
   this->crossbar = new int8_t*[this->xbar_y];
   for(int i=0; i<this->xbar_y; i++)
@@ -743,20 +745,14 @@ int8_t ima_v1::adc_clipping(float value)
 /* Matrix-Vector Multiplication (MVM) */
 void ima_v1::exec_job()
 {
+  /* Same float computation as one column at a time, see ima_v1_mvm.hpp */
+  ima_v1_mvm(this->mvm_sum, this->crossbar, this->buffer_in, this->job->start_x, this->job->start_y,
+    this->job->width, this->job->height, ((1 << (DAC_PRECISION - 1)) - 1), ((1 << (STOR_DWIDTH - 1)) - 1));
+
   for(int i=0; i<this->job->width; i++)
   {
-    float sum = 0;
+    float sum = this->mvm_sum[i];
 
-    for(int j=0; j<this->job->height; j++)
-    {
-      sum += ((float) this->buffer_in[this->job->start_y + j] / ((1 << (DAC_PRECISION - 1)) - 1)) * ((float) this->crossbar[this->job->start_y + j][this->job->start_x + i]) / ((1 << (STOR_DWIDTH - 1)) - 1);
-      //sum += this->buffer_in[this->job->start_y + j] * this->crossbar[this->job->start_y + j][this->job->start_x + i];
-      //printf("in=%d, scaled_in=%f, cb=%d, scaled_cb=%f, sum=%f, scaled_sum=%f, ind_x=%d, ind_y=%d\n", this->buffer_in[this->job->start_y + j], \
-              (float) this->buffer_in[this->job->start_y + j] / ((1 << (DAC_PRECISION - 1)) - 1), \
-              this->crossbar[this->job->start_y + j][this->job->start_x + i], \
-              (float) this->crossbar[this->job->start_y + j][this->job->start_x + i] / ((1 << (STOR_DWIDTH - 1)) - 1), \
-              sum, (float) this->adc_clipping(sum), this->job->start_x + i, this->job->start_y + j);
-    }
     this->buffer_out[this->job->start_x + i] = this->adc_clipping(sum);
     //this->buffer_out[this->job->start_x + i] = sum;
     this->trace.msg("Written in output buffer at index %d (sum: %f, out: %x)\n", this->job->start_x + i, sum, this->buffer_out[this->job->start_x + i]);
@@ -169,6 +169,7 @@ private:
   unsigned int *regs;
   int8_t *buffer_in;
   int8_t *buffer_out;
+  float *mvm_sum;
   int8_t **crossbar;
 
   ima_job_t *job;
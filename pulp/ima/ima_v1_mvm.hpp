@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __IMA_V1_MVM_HPP__
+#define __IMA_V1_MVM_HPP__
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define IMA_V1_MVM_X86
+#endif
+
+/*
+ * Matrix-Vector Multiplication of the crossbar, bit-exact with the float model
+ * of the analog computation:
+ *
+ *   sum[i] = sum over j of ((float) in[j] / dac_max) * (float) xbar[j][i] / stor_max
+ *
+ * accumulated in float with j increasing. Crossbar values are 4-bit signed, so
+ * for a given row the term only takes 16 values, which are computed once per
+ * row with the same float operations. The sums are then accumulated along the
+ * rows, reading the crossbar contiguously, 8 columns at a time with AVX2.
+ * Values outside of [-8, 7] fall back to the full expression.
+ */
+
+#define IMA_V1_MVM_NB_TERMS 16
+
+static inline float ima_v1_mvm_term(float dac, int8_t weight, int stor_max)
+{
+  return dac * (float) weight / stor_max;
+}
+
+#ifdef IMA_V1_MVM_X86
+/* Accumulates row[0..width) into sum, 8 columns at a time, returns the number of columns done */
+__attribute__((target("avx2")))
+static inline int ima_v1_mvm_row_avx2(float *sum, const int8_t *row, const float *terms, float dac, int stor_max, int width)
+{
+  __m256 terms_lo = _mm256_loadu_ps(&terms[0]);
+  __m256 terms_hi = _mm256_loadu_ps(&terms[8]);
+  __m256i offset = _mm256_set1_epi32(8);
+  __m256i range = _mm256_set1_epi32(~(IMA_V1_MVM_NB_TERMS - 1));
+
+  int i = 0;
+  for(; i + 8 <= width; i += 8)
+  {
+    __m256i index = _mm256_add_epi32(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) &row[i])), offset);
+
+    if(!_mm256_testz_si256(index, range))
+    {
+      for(int k=0; k<8; k++)
+      {
+        sum[i + k] += ima_v1_mvm_term(dac, row[i + k], stor_max);
+      }
+      continue;
+    }
+
+    /* Bit 3 of the index selects the upper half of the table */
+    __m256 lo = _mm256_permutevar8x32_ps(terms_lo, index);
+    __m256 hi = _mm256_permutevar8x32_ps(terms_hi, index);
+    __m256 term = _mm256_blendv_ps(lo, hi, _mm256_castsi256_ps(_mm256_slli_epi32(index, 28)));
+
+    _mm256_storeu_ps(&sum[i], _mm256_add_ps(_mm256_loadu_ps(&sum[i]), term));
+  }
+
+  return i;
+}
+#endif
+
+static inline bool ima_v1_mvm_avx2()
+{
+#ifdef IMA_V1_MVM_X86
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+#else
+  return false;
+#endif
+}
+
+/* sum[i] for the width x height job at (start_x, start_y) of the crossbar */
+static inline void ima_v1_mvm(float *sum, int8_t **crossbar, const int8_t *buffer_in,
+  int start_x, int start_y, int width, int height, int dac_max, int stor_max)
+{
+  float terms[IMA_V1_MVM_NB_TERMS];
+
+  for(int i=0; i<width; i++)
+  {
+    sum[i] = 0;
+  }
+
+  for(int j=0; j<height; j++)
+  {
+    float dac = (float) buffer_in[start_y + j] / dac_max;
+    const int8_t *row = &crossbar[start_y + j][start_x];
+
+    for(int k=0; k<IMA_V1_MVM_NB_TERMS; k++)
+    {
+      terms[k] = ima_v1_mvm_term(dac, k - 8, stor_max);
+    }
+
+    int i = 0;
+#ifdef IMA_V1_MVM_X86
+    if(ima_v1_mvm_avx2())
+    {
+      i = ima_v1_mvm_row_avx2(sum, row, terms, dac, stor_max, width);
+    }
+#endif
+
+    for(; i<width; i++)
+    {
+      if(row[i] >= -8 && row[i] < 8)
+        sum[i] += terms[row[i] + 8];
+      else
+        sum[i] += ima_v1_mvm_term(dac, row[i], stor_max);
+    }
+  }
+}
+
+#endif
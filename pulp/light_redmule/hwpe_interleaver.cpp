@@ -21,6 +21,7 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
 #include <math.h>
+#include "pulp/common/bank_profiler.hpp"
 
 class HWPEInterleaver : public vp::Component
 {
@@ -28,6 +29,8 @@ class HWPEInterleaver : public vp::Component
 public:
     HWPEInterleaver(vp::ComponentConf &config);
 
+    void stop() override;
+
     static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
 
 private:
@@ -41,6 +44,7 @@ private:
     int offset_right_shift;
     int offset_left_shift;
     int bank_width;
+    BankProfiler *profiler;
 };
 
 HWPEInterleaver::HWPEInterleaver(vp::ComponentConf &config)
@@ -65,6 +69,13 @@ HWPEInterleaver::HWPEInterleaver(vp::ComponentConf &config)
 
     this->input_port.set_req_meth(&HWPEInterleaver::req);
     this->new_slave_port("input", &this->input_port);
+
+    this->profiler = new BankProfiler(this, nb_banks);
+}
+
+void HWPEInterleaver::stop()
+{
+    this->profiler->dump_report();
 }
 
 vp::IoReqStatus HWPEInterleaver::req(vp::Block *__this, vp::IoReq *req)
@@ -88,6 +99,8 @@ vp::IoReqStatus HWPEInterleaver::req(vp::Block *__this, vp::IoReq *req)
 
          _this->trace.msg(vp::Trace::LEVEL_TRACE, "------  Send to Bank %d with size %d\n", bank_id, bank_size);
 
+        _this->profiler->access(bank_id, offset);
+
         vp::IoReq * bank_req = new vp::IoReq;
 
         bank_req->init();
@@ -18,7 +18,8 @@ import gvsoc.systree
 
 class HWPEInterleaver(gvsoc.systree.Component):
 
-    def __init__(self, parent, slave, nb_master_ports, nb_banks, bank_width):
+    def __init__(self, parent, slave, nb_master_ports, nb_banks, bank_width, bank_conflicts=False,
+            bank_profiler=False, bank_profiler_file='', bank_profiler_top=16):
 
         super(HWPEInterleaver, self).__init__(parent, slave)
 
@@ -28,5 +29,9 @@ class HWPEInterleaver(gvsoc.systree.Component):
 
         self.add_properties({
             'nb_banks': nb_banks,
-            'bank_width': bank_width
+            'bank_width': bank_width,
+            'bank_conflicts': bank_conflicts,
+            'bank_profiler': bank_profiler,
+            'bank_profiler_file': bank_profiler_file,
+            'bank_profiler_top': bank_profiler_top,
         })
\ No newline at end of file
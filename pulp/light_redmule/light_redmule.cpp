@@ -25,6 +25,7 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
 #include <vp/itf/wire.hpp>
+#include <vp/debug_mem.hpp>
 #include <stdio.h>
 #include <iostream>
 #include <sstream>
@@ -38,31 +39,20 @@
 #include <math.h>
 
 #include <cpu/iss/include/offload.hpp>
-#include <cpu/iss/flexfloat/flexfloat.h>
+#include "light_redmule_gemm.hpp"
 
 /****************************************************
 *                   Type Definition                 *
 ****************************************************/
 
-// typedef union {
-//     float f;
-//     struct {
-//         uint32_t mantissa : 23;
-//         uint32_t exponent : 8;
-//         uint32_t sign : 1;
-//     } parts;
-// } FloatBits;
-
-typedef uint8_t  fp8e4m3;
-typedef uint16_t fp16;
-
 enum redmule_state {
     IDLE,
     PRELOAD,
     ROUTINE,
     STORING,
     FINISHED,
-    ACKNOWLEDGE
+    ACKNOWLEDGE,
+    ANALYTIC
 };
 
 enum iter_instruction {
@@ -74,16 +64,6 @@ enum iter_instruction {
     INSTR_FORWARD_YZ
 };
 
-/********************************************************
-*                   Function Definition                 *
-********************************************************/
-
-void matmul_uint16(uint16_t * z, uint16_t * y, uint16_t * x, uint16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
-void matmul_int16(int16_t * z, int16_t * y, int16_t * x, int16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
-void matmul_uint8(uint8_t * z, uint8_t * y, uint8_t * x, uint8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
-void matmul_int8(int8_t * z, int8_t * y, int8_t * x, int8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
-void matmul_fp8e4m3(fp8e4m3 * z, fp8e4m3 * y, fp8e4m3 * x, fp8e4m3 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
-
 /*****************************************************
 *                   Class Definition                 *
 *****************************************************/
@@ -119,7 +99,15 @@ public:
     uint32_t get_routine_to_storing_latency();
     void     process_iter_instruction();
     void     process_compute();
-    void     matmul_fp16(fp16 * z, fp16 * y, fp16 * x, fp16 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+    void     report_finished();
+
+    //analytic mode
+    void     analytic_start();
+    int64_t  analytic_runtime();
+    int64_t  analytic_access_cycles(uint32_t blocks);
+    bool     analytic_compute();
+    bool     analytic_matrix(uint32_t base, uint32_t rows, uint32_t cols, uint32_t tile_col, uint32_t tile_row, uint8_t * dense, bool is_write);
+    bool     analytic_access(uint32_t addr, uint8_t * data, uint32_t size, bool is_write);
 
     vp::Trace           trace;
     vp::IoSlave         input_itf;
@@ -161,6 +149,11 @@ public:
     uint32_t            LOCAL_BUFFER_H;
     uint32_t            LOCAL_BUFFER_N;
     uint32_t            LOCAL_BUFFER_W;
+    const LightRedmuleGemmBackend * gemm;
+    uint32_t            analytic;
+    double              analytic_contention;
+    vp::DebugMemIf *    tcdm_debug_mem;
+    bool                tcdm_debug_mem_resolved;
 
     //redmule registers
     uint32_t            m_size;
@@ -256,6 +249,12 @@ LightRedmule::LightRedmule(vp::ComponentConf &config)
     this->LOCAL_BUFFER_H    = this->ce_height;
     this->LOCAL_BUFFER_N    = this->bandwidth / this->elem_size;
     this->LOCAL_BUFFER_W    = this->ce_width * (this->ce_pipe + 1);
+    this->gemm              = light_redmule_gemm_select();
+    this->trace.msg("[LightRedmule] Using %s GEMM kernels\n", this->gemm->name);
+    this->analytic          = get_js_config()->get("analytic")->get_bool();
+    this->analytic_contention = get_js_config()->get("analytic_contention")->get_double();
+    this->tcdm_debug_mem    = NULL;
+    this->tcdm_debug_mem_resolved = false;
 
     //Initialize registers
     this->m_size            = 4;
@@ -478,7 +477,7 @@ void LightRedmule::process_compute(){
     if (this->compute_able == 1)
     {
         //UINT16
-        matmul_uint16(  (uint16_t *)this->z_buffer_compute,
+        this->gemm->matmul_uint16(  (uint16_t *)this->z_buffer_compute,
                         (uint16_t *)this->z_buffer_compute,
                         (uint16_t *)this->x_buffer,
                         (uint16_t *)this->w_buffer,
@@ -489,7 +488,7 @@ void LightRedmule::process_compute(){
     if (this->compute_able == 2)
     {
         //INT16
-        matmul_int16(   (int16_t *)this->z_buffer_compute,
+        this->gemm->matmul_int16(   (int16_t *)this->z_buffer_compute,
                         (int16_t *)this->z_buffer_compute,
                         (int16_t *)this->x_buffer,
                         (int16_t *)this->w_buffer,
@@ -500,7 +499,7 @@ void LightRedmule::process_compute(){
     if (this->compute_able == 3)
     {
         //FP16
-        this->matmul_fp16(    (fp16 *)this->z_buffer_compute,
+        this->gemm->matmul_fp16(    (fp16 *)this->z_buffer_compute,
                         (fp16 *)this->z_buffer_compute,
                         (fp16 *)this->x_buffer,
                         (fp16 *)this->w_buffer,
@@ -511,7 +510,7 @@ void LightRedmule::process_compute(){
     if (this->compute_able == 5)
     {
         //UINT8
-        matmul_uint8(   (uint8_t *)this->z_buffer_compute,
+        this->gemm->matmul_uint8(   (uint8_t *)this->z_buffer_compute,
                         (uint8_t *)this->z_buffer_compute,
                         (uint8_t *)this->x_buffer,
                         (uint8_t *)this->w_buffer,
@@ -522,7 +521,7 @@ void LightRedmule::process_compute(){
     if (this->compute_able == 6)
     {
         //UINT8
-        matmul_int8(    (int8_t *)this->z_buffer_compute,
+        this->gemm->matmul_int8(    (int8_t *)this->z_buffer_compute,
                         (int8_t *)this->z_buffer_compute,
                         (int8_t *)this->x_buffer,
                         (int8_t *)this->w_buffer,
@@ -533,7 +532,7 @@ void LightRedmule::process_compute(){
     if (this->compute_able == 7)
     {
         //UINT8
-        matmul_fp8e4m3(     (fp8e4m3 *)this->z_buffer_compute,
+        this->gemm->matmul_fp8e4m3(     (fp8e4m3 *)this->z_buffer_compute,
                         (fp8e4m3 *)this->z_buffer_compute,
                         (fp8e4m3 *)this->x_buffer,
                         (fp8e4m3 *)this->w_buffer,
@@ -799,6 +798,213 @@ uint32_t LightRedmule::get_redmule_array_runtime(){
     return runtime_pices * runtime_unit;
 }
 
+void LightRedmule::report_finished(){
+    int64_t start_time_ns   = (this->timer_start)/1000;
+    int64_t end_time_ns     = (this->time.get_time())/1000;
+    int64_t period_ns       = end_time_ns - start_time_ns;
+    int64_t period_clk      = this->clock.get_cycles() - this->cycle_start;
+    double  period_uti      = (1.0 * this->ideal_runtime)/(1.0 * period_clk);
+    int64_t gemm_size       = 2 * (this->m_size * this->n_size + this->n_size * this->k_size + 2 * this->m_size * this->k_size);
+    double  redmul_eff      = period_uti * (1.0 * this->ce_height * this->ce_width) / (1.0 * gemm_size);
+    this->total_runtime    += period_ns;
+    this->num_matmul       += 1;
+    this->trace.msg("[LightRedmule] Finished : %0d ns ---> %0d ns | period = %0d ns (%0d cyc) | uti = %0.3f | runtime = %0d ns | GEMM id = %0d | FMT = %0d | M-N-K = %0d-%0d-%0d | X-W-Y = 0x%5x-0x%5x-0x%5x\n",
+        start_time_ns, end_time_ns, period_ns, period_clk, period_uti, this->total_runtime, this->num_matmul, this->compute_able, this->m_size, this->n_size, this->k_size, this->x_addr, this->w_addr, this->y_addr);
+}
+
+/*
+ * Analytic mode
+ *
+ * Instead of one TCDM request per cycle, the job is modeled with a single
+ * event. The completion cycle is derived from the same access-block and array
+ * runtime helpers as the FSM, walking the tile iterations without any memory
+ * access: each phase lasts as many cycles as it has blocks to access, scaled
+ * by analytic_contention, and a routine iteration lasts the longest of its
+ * accesses and of the array runtime. The GEMM itself is computed at the
+ * completion cycle with bulk accesses and the same tile kernels, so results
+ * are bit-identical to the FSM.
+ */
+void LightRedmule::analytic_start(){
+    int64_t latency = this->analytic_runtime();
+
+    this->trace.msg(vp::Trace::LEVEL_TRACE,"[LightRedmule][Analytic] M-N-K = %0d-%0d-%0d | modeled runtime = %ld cyc\n", this->m_size, this->n_size, this->k_size, latency);
+
+    this->tcdm_block_total  = 0;
+    this->fsm_counter       = 0;
+    this->fsm_timestamp     = 0;
+    this->timer_start       = this->time.get_time();
+    this->cycle_start       = this->clock.get_cycles();
+    this->state.set(ANALYTIC);
+    this->event_enqueue(this->fsm_event, latency);
+}
+
+int64_t LightRedmule::analytic_access_cycles(uint32_t blocks){
+    int64_t cycles = (int64_t)ceil(blocks * this->analytic_contention);
+    return cycles > 1 ? cycles : 1;
+}
+
+int64_t LightRedmule::analytic_runtime(){
+    // Same sequence of phases as fsm_handler, see the cycle accounting there
+    int64_t cycles = this->analytic_access_cycles(this->get_preload_access_block_number());
+
+    // Forward YZ at Preload->Routine
+    this->z_store_height = this->m_size < this->ce_height ? this->m_size : this->ce_height;
+
+    while (1)
+    {
+        int64_t access_cycles   = this->analytic_access_cycles(this->get_routine_access_block_number());
+        int64_t modeled_runtime = this->get_redmule_array_runtime();
+        cycles += access_cycles > modeled_runtime ? access_cycles : modeled_runtime;
+
+        // Forward YZ
+        if (this->iter_k + 1 == this->x_row_tiles)
+        {
+            uint32_t z_height = this->m_size - this->iter_i * this->ce_height;
+            this->z_store_height = z_height < this->ce_height ? z_height : this->ce_height;
+        }
+
+        if (this->next_iteration() != 0)
+        {
+            break;
+        }
+    }
+
+    cycles += this->get_routine_to_storing_latency();
+    cycles += this->analytic_access_cycles(this->get_storing_access_block_number());
+
+    return cycles;
+}
+
+bool LightRedmule::analytic_access(uint32_t addr, uint8_t * data, uint32_t size, bool is_write){
+    uint64_t offset = addr - this->loc_base;
+
+    if (!this->tcdm_debug_mem_resolved)
+    {
+        this->tcdm_debug_mem_resolved = true;
+        std::vector<vp::SlavePort *> finals = this->tcdm_itf.get_final_ports();
+        if (!finals.empty() && finals[0]->get_owner() != NULL)
+        {
+            this->tcdm_debug_mem = finals[0]->get_owner()->debug_mem_if();
+        }
+        if (this->tcdm_debug_mem == NULL)
+        {
+            this->trace.msg(vp::Trace::LEVEL_WARNING, "[LightRedmule][Analytic] No backdoor to TCDM, using the timed port\n");
+        }
+    }
+
+    if (this->tcdm_debug_mem != NULL)
+    {
+        return this->tcdm_debug_mem->debug_mem_access(offset, data, size, is_write) == 0;
+    }
+
+    // Fall back to requests of the TCDM bandwidth, their latency is ignored
+    for (uint32_t done = 0; done < size; done += this->bandwidth)
+    {
+        uint32_t chunk = size - done < this->bandwidth ? size - done : this->bandwidth;
+        this->tcdm_req->init();
+        this->tcdm_req->set_addr(offset + done);
+        this->tcdm_req->set_size(chunk);
+        this->tcdm_req->set_data(data + done);
+        this->tcdm_req->set_is_write(is_write);
+        if (this->send_tcdm_req() != vp::IO_REQ_OK)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LightRedmule::analytic_matrix(uint32_t base, uint32_t rows, uint32_t cols, uint32_t tile_col, uint32_t tile_row, uint8_t * dense, bool is_write){
+    // Dense row-major copy of a rows x cols matrix, stored with the same
+    // mapping as the one the FSM walks
+    if (this->fold_tiles_mapping == 0)
+    {
+        return this->analytic_access(base, dense, rows * cols * this->elem_size, is_write);
+    }
+
+    uint32_t col_tiles = (rows + tile_col - 1) / tile_col;
+    uint32_t row_tiles = (cols + tile_row - 1) / tile_row;
+    for (uint32_t i = 0; i < col_tiles; i++)
+    {
+        for (uint32_t j = 0; j < row_tiles; j++)
+        {
+            uint32_t addr   = this->calculate_tile_base_address(base, cols, tile_col, tile_row, i, j);
+            uint32_t height = rows - i * tile_col < tile_col ? rows - i * tile_col : tile_col;
+            uint32_t width  = cols - j * tile_row < tile_row ? cols - j * tile_row : tile_row;
+            for (uint32_t r = 0; r < height; r++)
+            {
+                uint8_t * row = &dense[((i * tile_col + r) * cols + j * tile_row) * this->elem_size];
+                if (!this->analytic_access(addr, row, width * this->elem_size, is_write))
+                {
+                    return false;
+                }
+                addr = this->inc_addr(addr, cols, tile_row);
+            }
+        }
+    }
+    return true;
+}
+
+bool LightRedmule::analytic_compute(){
+    uint32_t buffer_h   = this->ce_height;
+    uint32_t buffer_w   = this->ce_width * (this->ce_pipe + 1);
+    uint32_t buffer_n   = this->bandwidth / this->elem_size;
+    uint32_t elem       = this->elem_size;
+
+    std::vector<uint8_t> x(this->m_size * this->n_size * elem);
+    std::vector<uint8_t> w(this->n_size * this->k_size * elem);
+    std::vector<uint8_t> yz(this->m_size * this->k_size * elem);
+
+    if (!this->analytic_matrix(this->x_addr, this->m_size, this->n_size, buffer_h, buffer_n, x.data(), false) ||
+        !this->analytic_matrix(this->w_addr, this->n_size, this->k_size, buffer_n, buffer_w, w.data(), false) ||
+        !this->analytic_matrix(this->y_addr, this->m_size, this->k_size, buffer_h, buffer_w, yz.data(), false))
+    {
+        return false;
+    }
+
+    // Same zero-padded tiles and accumulation order as the FSM, each Z tile
+    // replacing its Y tile in place
+    for (uint32_t i = 0; i < this->z_col_tiles; i++)
+    {
+        uint32_t height = this->m_size - i * buffer_h < buffer_h ? this->m_size - i * buffer_h : buffer_h;
+        for (uint32_t j = 0; j < this->z_row_tiles; j++)
+        {
+            uint32_t width = this->k_size - j * buffer_w < buffer_w ? this->k_size - j * buffer_w : buffer_w;
+
+            std::memset(this->z_buffer_compute, 0, buffer_h * buffer_w * elem);
+            for (uint32_t r = 0; r < height; r++)
+            {
+                std::memcpy(&this->z_buffer_compute[r * buffer_w * elem], &yz[((i * buffer_h + r) * this->k_size + j * buffer_w) * elem], width * elem);
+            }
+
+            for (uint32_t k = 0; k < this->x_row_tiles; k++)
+            {
+                uint32_t depth = this->n_size - k * buffer_n < buffer_n ? this->n_size - k * buffer_n : buffer_n;
+
+                std::memset(this->x_buffer, 0, buffer_h * this->bandwidth);
+                std::memset(this->w_buffer, 0, buffer_n * buffer_w * elem);
+                for (uint32_t r = 0; r < height; r++)
+                {
+                    std::memcpy(&this->x_buffer[r * this->bandwidth], &x[((i * buffer_h + r) * this->n_size + k * buffer_n) * elem], depth * elem);
+                }
+                for (uint32_t r = 0; r < depth; r++)
+                {
+                    std::memcpy(&this->w_buffer[r * buffer_w * elem], &w[((k * buffer_n + r) * this->k_size + j * buffer_w) * elem], width * elem);
+                }
+
+                this->process_compute();
+            }
+
+            for (uint32_t r = 0; r < height; r++)
+            {
+                std::memcpy(&yz[((i * buffer_h + r) * this->k_size + j * buffer_w) * elem], &this->z_buffer_compute[r * buffer_w * elem], width * elem);
+            }
+        }
+    }
+
+    return this->analytic_matrix(this->z_addr, this->m_size, this->k_size, buffer_h, buffer_w, yz.data(), true);
+}
+
 uint32_t LightRedmule::op_foramt_parser(uint32_t op_format) {
     uint32_t data_format=op_format&0x7;
     uint32_t operation=(op_format>>3)&0x7;
@@ -863,6 +1069,13 @@ void LightRedmule::offload_sync(vp::Block *__this, IssOffloadInsn<uint32_t> *ins
                 //Initilaize redmule meta data
                 _this->init_redmule_meta_data();
 
+                //Analytic mode: one event for the whole GEMM
+                if (_this->analytic)
+                {
+                    _this->analytic_start();
+                    break;
+                }
+
                 //Trigger FSM
                 _this->state.set(PRELOAD);
                 _this->tcdm_block_total = _this->get_preload_access_block_number();
@@ -911,6 +1124,13 @@ vp::IoReqStatus LightRedmule::req(vp::Block *__this, vp::IoReq *req)
 
                     
 
+                    //Analytic mode: one event for the whole GEMM
+                    if (_this->analytic)
+                    {
+                        _this->analytic_start();
+                        break;
+                    }
+
                     //Trigger FSM
                     _this->state.set(PRELOAD);
                     _this->tcdm_block_total = _this->get_preload_access_block_number();
@@ -1019,6 +1239,13 @@ vp::IoReqStatus LightRedmule::req_v2(vp::Block *__this, vp::IoReq *req)
 
                     
 
+                    //Analytic mode: one event for the whole GEMM
+                    if (_this->analytic)
+                    {
+                        _this->analytic_start();
+                        break;
+                    }
+
                     //Trigger FSM
                     _this->state.set(PRELOAD);
                     _this->tcdm_block_total = _this->get_preload_access_block_number();
@@ -1406,17 +1633,7 @@ void LightRedmule::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
                 _this->event_enqueue(_this->fsm_event, 1);
 
                 //report
-                int64_t start_time_ns   = (_this->timer_start)/1000;
-                int64_t end_time_ns     = (_this->time.get_time())/1000;
-                int64_t period_ns       = end_time_ns - start_time_ns;
-                int64_t period_clk      = _this->clock.get_cycles() - _this->cycle_start;
-                double  period_uti      = (1.0 * _this->ideal_runtime)/(1.0 * period_clk);
-                int64_t gemm_size       = 2 * (_this->m_size * _this->n_size + _this->n_size * _this->k_size + 2 * _this->m_size * _this->k_size);
-                double  redmul_eff      = period_uti * (1.0 * _this->ce_height * _this->ce_width) / (1.0 * gemm_size);
-                _this->total_runtime   += period_ns;
-                _this->num_matmul      += 1;
-                _this->trace.msg("[LightRedmule] Finished : %0d ns ---> %0d ns | period = %0d ns (%0d cyc) | uti = %0.3f | runtime = %0d ns | GEMM id = %0d | FMT = %0d | M-N-K = %0d-%0d-%0d | X-W-Y = 0x%5x-0x%5x-0x%5x\n",
-                    start_time_ns, end_time_ns, period_ns, period_clk, period_uti, _this->total_runtime, _this->num_matmul, _this->compute_able, _this->m_size, _this->n_size, _this->k_size, _this->x_addr, _this->w_addr, _this->y_addr);
+                _this->report_finished();
             } else {
                 _this->state.set(STORING);
                 _this->event_enqueue(_this->fsm_event, 1);
@@ -1453,493 +1670,23 @@ void LightRedmule::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
             _this->event_enqueue(_this->fsm_event, 1);
             break;
         }
-        default:
-            _this->trace.fatal("[LightRedmule] INVALID RedMule Status: %d\n", _this->state);
-    }
-}
-
-
-
-/************************************************************
-*                   Function Implementation                 *
-************************************************************/
-
-void matmul_uint16(uint16_t * z, uint16_t * y, uint16_t * x, uint16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
-    for (int i = 0; i < m_size; ++i)
-    {
-        for (int j = 0; j < k_size; ++j)
-        {
-            z[i * k_size + j] = y[i * k_size + j];
-            for (int k = 0; k < n_size; ++k)
-            {
-                z[i * k_size + j] += x[i * n_size + k] * w[k * k_size + j];
-            }
-        }
-    }
-}
-
-void matmul_int16(int16_t * z, int16_t * y, int16_t * x, int16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
-    for (int i = 0; i < m_size; ++i)
-    {
-        for (int j = 0; j < k_size; ++j)
-        {
-            z[i * k_size + j] = y[i * k_size + j];
-            for (int k = 0; k < n_size; ++k)
+        case ANALYTIC: {
+            //Deferred bulk compute, at the modeled completion cycle
+            if (_this->compute_able != 0 && !_this->analytic_compute())
             {
-                z[i * k_size + j] += x[i * n_size + k] * w[k * k_size + j];
+                _this->trace.fatal("[LightRedmule][Analytic] There was an error while reading/writing data\n");
+                return;
             }
-        }
-    }
-}
 
+            _this->fsm_timestamp    = 0;
+            _this->state.set(FINISHED);
+            _this->event_enqueue(_this->fsm_event, 1);
 
-// // Convert float to FP16 (half-precision)
-// fp16 float_to_fp16(float value) {
-//     FloatBits floatBits;
-//     floatBits.f = value;
-
-//     uint16_t sign = floatBits.parts.sign << 15;
-//     int32_t exponent = floatBits.parts.exponent - 127 + 15; // adjust bias from 127 to 15
-//     uint32_t mantissa = floatBits.parts.mantissa >> 13;     // reduce to 10 bits
-
-//     if (exponent <= 0) {
-//         if (exponent < -10) return sign;   // too small
-//         mantissa = (floatBits.parts.mantissa | 0x800000) >> (1 - exponent);
-//         return sign | mantissa;
-//     } else if (exponent >= 0x1F) {
-//         return sign | 0x7C00;  // overflow to infinity
-//     }
-//     return sign | (exponent << 10) | mantissa;
-// }
-
-// // Convert FP16 to float
-// float fp16_to_float(fp16 value) {
-//     FloatBits floatBits;
-//     floatBits.parts.sign = (value >> 15) & 0x1;
-//     int32_t exponent = (value >> 10) & 0x1F;
-//     floatBits.parts.exponent = (exponent == 0) ? 0 : exponent + 127 - 15;
-//     floatBits.parts.mantissa = (value & 0x3FF) << 13;
-//     return floatBits.f;
-// }
-
-// -----------------------------------------------------------------------------
-// Improved FP16 <-> FP32 conversion routines by Lorenzo Zuolo
-//
-// These versions fix several numerical and IEEE-754 compliance issues found
-// in the original naive implementations. The original functions performed
-// a simple bias adjustment and bit shift, which *worked for normalized values*
-// but failed to handle special cases properly.
-//
-// Key improvements over the original versions:
-//
-//  • Correct handling of subnormal (denormalized) numbers
-//    The old float_to_fp16() simply zeroed out very small values,
-//    losing precision for magnitudes near zero. The new version detects
-//    and correctly normalizes them using the implicit leading 1 bit.
-//
-//  • Accurate rounding (round-to-nearest-even)
-//    The old version truncated the mantissa bits directly (>> 13),
-//    introducing systematic downward bias. The improved version applies
-//    IEEE-compliant rounding to preserve statistical neutrality.
-//
-//  • Proper Inf/NaN propagation
-//    The old code treated any large exponent as infinity but did not
-//    propagate NaN payloads correctly. The new one does, matching real
-//    hardware FP16 behavior.
-//
-//  • Safe exponent biasing and shift handling
-//    The previous logic could produce undefined behavior with negative
-//    shifts or overflowed exponents. The new version clamps exponents
-//    safely and handles edge cases explicitly.
-//
-// In short: these functions produce the same results as hardware FP16 units
-// (ARM, NVIDIA, etc.), eliminating subtle rounding and underflow errors
-// that accumulated across multiple conversions (like in FMA loops).
-// -----------------------------------------------------------------------------
-
-// fp16 float_to_fp16(float f)
-// {
-//     uint32_t f_bits;
-//     memcpy(&f_bits, &f, sizeof(f));
-
-//     uint32_t sign = (f_bits >> 16) & 0x8000u;
-//     int32_t  exp  = ((f_bits >> 23) & 0xFF) - 127 + 15;
-//     uint32_t mant = f_bits & 0x007FFFFFu;
-
-//     if (exp <= 0) {
-//         // Subnormal or zero
-//         if (exp < -10) {
-//             // Too small -> underflow to zero
-//             return sign;
-//         }
-//         // Add implicit leading 1 and shift to create subnormal
-//         mant = (mant | 0x00800000u) >> (1 - exp);
-//         // Round-to-nearest-even
-//         if (mant & 0x00001000u)
-//             mant += 0x00002000u;
-//         return sign | (mant >> 13);
-//     } 
-//     else if (exp >= 0x1F) {
-//         // Overflow -> Inf or NaN
-//         if ((f_bits & 0x7FFFFFu) != 0)
-//             return sign | 0x7E00u; // NaN
-//         return sign | 0x7C00u;     // +Inf / -Inf
-//     }
-
-//     // Normal number: add rounding before truncating
-//     mant = mant + 0x00001000u;
-
-//     // Handle rounding overflow in mantissa
-//     if (mant & 0x00800000u) {
-//         mant = 0;
-//         exp += 1;
-//     }
-
-//     // Overflow after rounding -> Inf
-//     if (exp >= 0x1F)
-//         return sign | 0x7C00u;
-
-//     // Compose final 16-bit result
-//     return sign | ((exp & 0x1F) << 10) | (mant >> 13);
-// }
-
-// float fp16_to_float(fp16 h)
-// {
-//     uint16_t h_exp = (h & 0x7C00u);
-//     uint16_t h_sig = (h & 0x03FFu);
-//     uint32_t f_sgn = ((uint32_t)h & 0x8000u) << 16;
-//     uint32_t f_exp;
-//     uint32_t f_sig;
-
-//     if (h_exp == 0x0000u) {
-//         // Zero or subnormal number
-//         if (h_sig == 0) {
-//             // ±0
-//             f_exp = 0;
-//             f_sig = 0;
-//         } else {
-//             // Subnormal -> normalize it
-//             int shift = 0;
-//             while ((h_sig & 0x0400u) == 0) {
-//                 h_sig <<= 1;
-//                 shift++;
-//             }
-//             h_sig &= 0x03FFu;
-//             f_exp = (127 - 15 - shift) << 23;
-//             f_sig = ((uint32_t)h_sig) << 13;
-//         }
-//     } else if (h_exp == 0x7C00u) {
-//         // Inf or NaN
-//         f_exp = 0xFFu << 23;
-//         f_sig = ((uint32_t)h_sig) << 13;
-//     } else {
-//         // Normalized number
-//         uint32_t exp = ((h_exp >> 10) & 0x1Fu);
-//         f_exp = (exp + (127 - 15)) << 23;
-//         f_sig = ((uint32_t)h_sig) << 13;
-//     }
-
-//     uint32_t f_bits = f_sgn | f_exp | f_sig;
-//     float f;
-//     memcpy(&f, &f_bits, sizeof(f));
-//     return f;
-// }
-
-// // Fused multiply-add for FP16
-// fp16 fp16_fma(fp16 a, fp16 b, fp16 c) {
-//     float fa = fp16_to_float(a);
-//     float fb = fp16_to_float(b);
-//     float fc = fp16_to_float(c);
-//     if ((a == 0) || (b == 0))
-//          return c;
-//     else if (c == 0) {
-//         float result = fa * fb;
-//         return float_to_fp16(result);
-//     }
-//     else {
-//         float result = (fa * fb) + fc;
-//         return float_to_fp16(result);
-//     }
-// }
-
-// uint16_t double_to_fp16(double d) {
-//     uint64_t bits;
-//     memcpy(&bits, &d, sizeof(bits)); 
-
-//     uint16_t sign = (bits >> 63) & 0x1;
-//     int64_t exp_d = (bits >> 52) & 0x7FF;
-//     uint64_t frac_d = bits & 0x000FFFFFFFFFFFFFull; // 52 bits
-
-//     uint16_t exp_h, frac_h;
-
-//     // Handle special cases
-//     if (exp_d == 0x7FF) { // Inf or NaN
-//         exp_h = 0x1F;
-//         if (frac_d == 0) { // Infinity
-//             frac_h = 0;
-//         } else { // NaN: preserve quiet NaN bit
-//             // Preserve top 10 bits of FP32 fraction for FP16
-//             // Ensure quiet NaN (set MSB of frac_h)
-//             frac_h = (uint16_t)((frac_d >> (52 - 10)) | 0x200);
-//         }
-//     } else if (exp_d == 0) { // Zero or subnormal in double → zero in half
-//         // All double subnormals are mapped to FP16 zero.
-//         // Some double subnormals might be large enough to become FP16 subnormals.
-//         // This results in a small precision loss.
-//         exp_h = 0;
-//         frac_h = 0;
-//     } else { // Normalized double
-//         int32_t exp_unbiased = (int32_t)exp_d - 1023; // remove double bias
-//         int32_t exp_half = exp_unbiased + 15;         // re-bias for half
-
-//         if (exp_half >= 0x1F) { // Overflow → Infinity
-//             exp_h = 0x1F;
-//             frac_h = 0;
-//         } else if (exp_half <= 0) { // Subnormal or underflow to zero
-//             if (exp_half < -10) { // Too small → underflow to zero
-//                 exp_h = 0;
-//                 frac_h = 0;
-//             } else {
-//                 // Subnormal number
-//                 uint64_t mant = (frac_d | 0x10000000000000ull); // add hidden bit 
-//                 uint8_t shift = 52 + (1 - exp_half) - 10; 
-//                 uint64_t frac = mant >> shift; 
-
-//                 // Round to nearest-even
-//                 uint64_t round_bit = (mant >> (shift - 1)) & 1; 
-//                 uint64_t rest = mant & ((1ull << (shift - 1)) - 1); 
-//                 if (round_bit && (rest || (frac & 1))) 
-//                     frac++;
-
-//                 frac_h = (uint16_t)frac;
-//                 exp_h = 0;
-//             }
-//         } else {
-//             // Normal half-precision number
-//             uint64_t mant = frac_d;
-
-//             // Extract top 10 bits and round
-//             uint64_t frac = mant >> (52 - 10);
-//             uint64_t round_bit = (mant >> (52 - 10 - 1)) & 1;
-//             uint64_t rest = mant & ((1ull << (52 - 10 - 1)) - 1);
-
-//             if (round_bit && (rest || (frac & 1)))
-//                 frac++;
-
-//             if (frac == 0x400) { // mantissa overflow
-//                 frac = 0;
-//                 exp_half++;
-//             }
-
-//             if (exp_half >= 0x1F) {
-//                 // Overflow → Infinity
-//                 exp_h = 0x1F;
-//                 frac_h = 0;
-//             } else {
-//                 exp_h = exp_half & 0x1F;
-//                 frac_h = (uint16_t)(frac & 0x3FF);
-//             }
-//         }
-//     }
-
-//     return (sign << 15) | (exp_h << 10) | frac_h;
-// }
-
-// double fp16_to_double(fp16 h) { 
-//     uint16_t sign = (h >> 15) & 0x1u; 
-//     uint16_t exp = (h >> 10) & 0x1Fu; 
-//     uint16_t frac = h & 0x03FFu; 
-//     uint64_t exp_d = 0; 
-//     uint64_t frac_d = 0; 
-//     if (exp == 0x1F) { // Inf or NaN 
-//         exp_d = 0x7FF; // double exponent all 1s 
-//         frac_d = (frac ? ((uint64_t)frac << (52 - 10)) : 0); // propagate fraction 
-//     } else if (exp == 0) { // Zero or subnormal 
-//         if (frac != 0) { // if Zero, do nothing (exp_d and frac_d are 0) 
-//             // Subnormal: scale fraction up to normalized double 
-//             // FP16 subnormal: value = frac * 2^(-24) (2^-14 / 2^10) 
-//             uint64_t frac_norm = frac; 
-//             int exp_shift = 0; 
-//             while ((frac_norm & 0x400) == 0) { // 0x400 = 1 << 10 (FP16 MSB) 
-//                 frac_norm <<= 1; exp_shift++; 
-//             } 
-//             frac_norm &= 0x3FF; 
-//             frac_d = frac_norm << (52 - 10); 
-//             exp_d = (uint64_t)(1023 - 15 - exp_shift); 
-//         } 
-//     } else { // Normalized number 
-//         frac_d = ((uint64_t)frac) << (52 - 10); // align fraction to 52 bits 
-//         exp_d = (uint64_t)((int32_t)exp - 15 + 1023); // double bias 
-//     } 
-    
-//     // Compose final 64-bit result 
-//     uint64_t d_bits = ((uint64_t)sign << 63) | (exp_d << 52) | frac_d; 
-//     double d; 
-//     memcpy(&d, &d_bits, sizeof(d)); 
-//     return d; 
-// }
-
-// // Fused multiply-add for FP16
-// fp16 fp16_fma(fp16 a, fp16 b, fp16 c) {
-//     double da = fp16_to_double(a);
-//     double db = fp16_to_double(b);
-//     double dc = fp16_to_double(c);
-//     if ((a==0) || (b==0))
-//         return c;
-//     else if (c==0) {
-//         double result = (da * db);
-//         return double_to_fp16(result);
-//     }
-//     else {
-//         double result = (da * db) + dc;
-//         return double_to_fp16(result);
-//     }
-// }
-
-fp16 fp16_fma(fp16 a, fp16 b, fp16 c) {
-    flexfloat_t ff_a, ff_b, ff_c, ff_res; 
-    flexfloat_desc_t env = (flexfloat_desc_t){5, 10}; 
-    ff_init(&ff_a, env); 
-    ff_init(&ff_b, env); 
-    ff_init(&ff_c, env); 
-    ff_init(&ff_res, env); 
-    flexfloat_set_bits(&ff_a, a); 
-    flexfloat_set_bits(&ff_b, b); 
-    flexfloat_set_bits(&ff_c, c);
-    ff_fma(&ff_res, &ff_a, &ff_b, &ff_c); 
-    return (fp16)flexfloat_get_bits(&ff_res);
-}
-
-void LightRedmule::matmul_fp16(fp16 * z, fp16 * y, fp16 * x, fp16 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
-    for (int i = 0; i < m_size; ++i)
-    {
-        for (int j = 0; j < k_size; ++j)
-        {
-            z[i * k_size + j] = y[i * k_size + j];
-            //printf("y[%d]=0x%4x\n",i * k_size + j, y[i * k_size + j]);
-            for (int k = 0; k < n_size; ++k)
-            {
-                // this->trace.msg(vp::Trace::LEVEL_TRACE,"[i=%d-j=%d-k=%d] x[%d]=0x%04x w[%d]=0x%04x y[%d]=0x%04x \n",i,
-                //                                                                     j,
-                //                                                                     k,
-                //                                                                     i * n_size + k,
-                //                                                                     x[i * n_size + k],
-                //                                                                     k * k_size + j,
-                //                                                                     w[k * k_size + j],
-                //                                                                     i * k_size + j,
-                //                                                                     y[i * k_size + j]);
-                z[i * k_size + j] = fp16_fma(x[i * n_size + k], w[k * k_size + j], z[i * k_size + j]);
-            }
-            //this->trace.msg(vp::Trace::LEVEL_TRACE,"z[%d]=0x%4x\n",i * k_size + j, z[i * k_size + j]);
-        }
-    }
-}
-
-
-void matmul_uint8(uint8_t * z, uint8_t * y, uint8_t * x, uint8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
-    for (int i = 0; i < m_size; ++i)
-    {
-        for (int j = 0; j < k_size; ++j)
-        {
-            z[i * k_size + j] = y[i * k_size + j];
-            for (int k = 0; k < n_size; ++k)
-            {
-                z[i * k_size + j] += x[i * n_size + k] * w[k * k_size + j];
-            }
-        }
-    }
-}
-
-void matmul_int8(int8_t * z, int8_t * y, int8_t * x, int8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
-    for (int i = 0; i < m_size; ++i)
-    {
-        for (int j = 0; j < k_size; ++j)
-        {
-            z[i * k_size + j] = y[i * k_size + j];
-            for (int k = 0; k < n_size; ++k)
-            {
-                z[i * k_size + j] += x[i * n_size + k] * w[k * k_size + j];
-            }
+            //report
+            _this->report_finished();
+            break;
         }
+        default:
+            _this->trace.fatal("[LightRedmule] INVALID RedMule Status: %d\n", _this->state);
     }
 }
-
-// Constants for FP8-E4M3 format
-#define FP8_EXP_MASK  0x78  // 0111 1000
-#define FP8_FRAC_MASK 0x07  // 0000 0111
-#define FP8_SIGN_MASK 0x80  // 1000 0000
-#define FP8_BIAS      7
-
-// Convert FP8 (E4M3) to float
-float fp8e4m3_to_float(fp8e4m3 value) {
-    uint8_t sign = (value & FP8_SIGN_MASK) >> 7;
-    uint8_t exponent = (value & FP8_EXP_MASK) >> 3;
-    uint8_t fraction = value & FP8_FRAC_MASK;
-
-    if (exponent == 0) {
-        // Subnormal number
-        if (fraction == 0) return sign ? -0.0f : 0.0f;
-        return (sign ? -1.0f : 1.0f) * (fraction / 8.0f) * powf(2, -6);
-    } else if (exponent == 15) {
-        // Infinity or NaN
-        return fraction ? NAN : (sign ? -INFINITY : INFINITY);
-    }
-
-    // Normalized number
-    float mantissa = 1.0f + (fraction / 8.0f);
-    float result = mantissa * powf(2, exponent - FP8_BIAS);
-    return sign ? -result : result;
-}
-
-// Convert float to FP8 (E4M3)
-fp8e4m3 float_to_fp8e4m3(float value) {
-    if (isnan(value)) return 0x7F;  // NaN representation
-    if (isinf(value)) return value < 0 ? 0xF8 : 0x78;  // +/-Inf representation
-
-    uint8_t sign = (value < 0) ? 0x80 : 0x00;
-    value = fabsf(value);
-
-    int exponent;
-    float mantissa = frexpf(value, &exponent);
-
-    if (value == 0.0f) return 0;  // Zero representation
-
-    exponent += FP8_BIAS - 1;
-
-    if (exponent < 1) {
-        // Subnormal handling
-        int frac = (int)roundf(value / powf(2, -6) * 8.0f);
-        return sign | (frac & FP8_FRAC_MASK);
-    } else if (exponent > 14) {
-        // Clamp to infinity
-        return sign | 0x78;
-    }
-
-    // Normal number
-    uint8_t frac = (uint8_t)roundf((mantissa - 0.5f) * 16.0f);
-    return sign | ((exponent << 3) & FP8_EXP_MASK) | (frac & FP8_FRAC_MASK);
-}
-
-// Fused Multiply-Add for FP8
-fp8e4m3 fp8e4m3_fma(fp8e4m3 a, fp8e4m3 b, fp8e4m3 c) {
-    float fa = fp8e4m3_to_float(a);
-    float fb = fp8e4m3_to_float(b);
-    float fc = fp8e4m3_to_float(c);
-
-    float result = fa * fb + fc;
-    return float_to_fp8e4m3(result);
-}
-
-void matmul_fp8e4m3(fp8e4m3 * z, fp8e4m3 * y, fp8e4m3 * x, fp8e4m3 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
-    for (int i = 0; i < m_size; ++i)
-    {
-        for (int j = 0; j < k_size; ++j)
-        {
-            z[i * k_size + j] = y[i * k_size + j];
-            for (int k = 0; k < n_size; ++k)
-            {
-                z[i * k_size + j] = fp8e4m3_fma(x[i * n_size + k], w[k * k_size + j], z[i * k_size + j]);
-            }
-        }
-    }
-}
\ No newline at end of file
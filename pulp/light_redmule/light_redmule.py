@@ -32,11 +32,13 @@ class LightRedmule(gvsoc.systree.Component):
                 ce_pipe: int,
                 queue_depth: int=128,
                 fold_tiles_mapping: int=0,
-                loc_base=0): #here we might add also local size to check that tcdm requests do not overflow...
+                loc_base=0,
+                analytic: bool=False,
+                analytic_contention: float=1.0): #here we might add also local size to check that tcdm requests do not overflow...
 
         super().__init__(parent, name)
 
-        self.add_sources(['pulp/light_redmule/light_redmule.cpp'])
+        self.add_sources(['pulp/light_redmule/light_redmule.cpp', 'pulp/light_redmule/light_redmule_gemm.cpp'])
 
         self.add_properties({
             'tcdm_bank_width'   : tcdm_bank_width,
@@ -51,6 +53,11 @@ class LightRedmule(gvsoc.systree.Component):
             'queue_depth'       : queue_depth,
             'fold_tiles_mapping': fold_tiles_mapping,
             'loc_base'          : loc_base,
+            # Model each GEMM with a single completion event instead of one
+            # TCDM request per cycle, TCDM accesses being slowed down by
+            # analytic_contention
+            'analytic'          : analytic,
+            'analytic_contention': float(analytic_contention),
         })
 
     def i_INPUT(self) -> gvsoc.systree.SlaveItf:
@@ -0,0 +1,846 @@
+/*
+ * Copyright (C) 2024 ETH Zurich, University of Bologna, and Fondazione Chips-IT
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Authors: Chi     Zhang, ETH Zurich (chizhang@iis.ee.ethz.ch)
+            Lorenzo Zuolo, Chips-IT   (lorenzo.zuolo@chips.it)
+            Alex Marchioni, Chips-IT   (alex.marchioni@chips.it)
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <cpu/iss/flexfloat/flexfloat.h>
+#include "light_redmule_gemm.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LIGHT_REDMULE_GEMM_X86
+#endif
+
+
+/************************************************************
+*                   Function Implementation                 *
+************************************************************/
+
+void matmul_uint16(uint16_t * z, uint16_t * y, uint16_t * x, uint16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
+    for (int i = 0; i < m_size; ++i)
+    {
+        for (int j = 0; j < k_size; ++j)
+        {
+            z[i * k_size + j] = y[i * k_size + j];
+            for (int k = 0; k < n_size; ++k)
+            {
+                z[i * k_size + j] += x[i * n_size + k] * w[k * k_size + j];
+            }
+        }
+    }
+}
+
+void matmul_int16(int16_t * z, int16_t * y, int16_t * x, int16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
+    for (int i = 0; i < m_size; ++i)
+    {
+        for (int j = 0; j < k_size; ++j)
+        {
+            z[i * k_size + j] = y[i * k_size + j];
+            for (int k = 0; k < n_size; ++k)
+            {
+                z[i * k_size + j] += x[i * n_size + k] * w[k * k_size + j];
+            }
+        }
+    }
+}
+
+
+// // Convert float to FP16 (half-precision)
+// fp16 float_to_fp16(float value) {
+//     FloatBits floatBits;
+//     floatBits.f = value;
+
+//     uint16_t sign = floatBits.parts.sign << 15;
+//     int32_t exponent = floatBits.parts.exponent - 127 + 15; // adjust bias from 127 to 15
+//     uint32_t mantissa = floatBits.parts.mantissa >> 13;     // reduce to 10 bits
+
+//     if (exponent <= 0) {
+//         if (exponent < -10) return sign;   // too small
+//         mantissa = (floatBits.parts.mantissa | 0x800000) >> (1 - exponent);
+//         return sign | mantissa;
+//     } else if (exponent >= 0x1F) {
+//         return sign | 0x7C00;  // overflow to infinity
+//     }
+//     return sign | (exponent << 10) | mantissa;
+// }
+
+// // Convert FP16 to float
+// float fp16_to_float(fp16 value) {
+//     FloatBits floatBits;
+//     floatBits.parts.sign = (value >> 15) & 0x1;
+//     int32_t exponent = (value >> 10) & 0x1F;
+//     floatBits.parts.exponent = (exponent == 0) ? 0 : exponent + 127 - 15;
+//     floatBits.parts.mantissa = (value & 0x3FF) << 13;
+//     return floatBits.f;
+// }
+
+// -----------------------------------------------------------------------------
+// Improved FP16 <-> FP32 conversion routines by Lorenzo Zuolo
+//
+// These versions fix several numerical and IEEE-754 compliance issues found
+// in the original naive implementations. The original functions performed
+// a simple bias adjustment and bit shift, which *worked for normalized values*
+// but failed to handle special cases properly.
+//
+// Key improvements over the original versions:
+//
+//  • Correct handling of subnormal (denormalized) numbers
+//    The old float_to_fp16() simply zeroed out very small values,
+//    losing precision for magnitudes near zero. The new version detects
+//    and correctly normalizes them using the implicit leading 1 bit.
+//
+//  • Accurate rounding (round-to-nearest-even)
+//    The old version truncated the mantissa bits directly (>> 13),
+//    introducing systematic downward bias. The improved version applies
+//    IEEE-compliant rounding to preserve statistical neutrality.
+//
+//  • Proper Inf/NaN propagation
+//    The old code treated any large exponent as infinity but did not
+//    propagate NaN payloads correctly. The new one does, matching real
+//    hardware FP16 behavior.
+//
+//  • Safe exponent biasing and shift handling
+//    The previous logic could produce undefined behavior with negative
+//    shifts or overflowed exponents. The new version clamps exponents
+//    safely and handles edge cases explicitly.
+//
+// In short: these functions produce the same results as hardware FP16 units
+// (ARM, NVIDIA, etc.), eliminating subtle rounding and underflow errors
+// that accumulated across multiple conversions (like in FMA loops).
+// -----------------------------------------------------------------------------
+
+// fp16 float_to_fp16(float f)
+// {
+//     uint32_t f_bits;
+//     memcpy(&f_bits, &f, sizeof(f));
+
+//     uint32_t sign = (f_bits >> 16) & 0x8000u;
+//     int32_t  exp  = ((f_bits >> 23) & 0xFF) - 127 + 15;
+//     uint32_t mant = f_bits & 0x007FFFFFu;
+
+//     if (exp <= 0) {
+//         // Subnormal or zero
+//         if (exp < -10) {
+//             // Too small -> underflow to zero
+//             return sign;
+//         }
+//         // Add implicit leading 1 and shift to create subnormal
+//         mant = (mant | 0x00800000u) >> (1 - exp);
+//         // Round-to-nearest-even
+//         if (mant & 0x00001000u)
+//             mant += 0x00002000u;
+//         return sign | (mant >> 13);
+//     } 
+//     else if (exp >= 0x1F) {
+//         // Overflow -> Inf or NaN
+//         if ((f_bits & 0x7FFFFFu) != 0)
+//             return sign | 0x7E00u; // NaN
+//         return sign | 0x7C00u;     // +Inf / -Inf
+//     }
+
+//     // Normal number: add rounding before truncating
+//     mant = mant + 0x00001000u;
+
+//     // Handle rounding overflow in mantissa
+//     if (mant & 0x00800000u) {
+//         mant = 0;
+//         exp += 1;
+//     }
+
+//     // Overflow after rounding -> Inf
+//     if (exp >= 0x1F)
+//         return sign | 0x7C00u;
+
+//     // Compose final 16-bit result
+//     return sign | ((exp & 0x1F) << 10) | (mant >> 13);
+// }
+
+// float fp16_to_float(fp16 h)
+// {
+//     uint16_t h_exp = (h & 0x7C00u);
+//     uint16_t h_sig = (h & 0x03FFu);
+//     uint32_t f_sgn = ((uint32_t)h & 0x8000u) << 16;
+//     uint32_t f_exp;
+//     uint32_t f_sig;
+
+//     if (h_exp == 0x0000u) {
+//         // Zero or subnormal number
+//         if (h_sig == 0) {
+//             // ±0
+//             f_exp = 0;
+//             f_sig = 0;
+//         } else {
+//             // Subnormal -> normalize it
+//             int shift = 0;
+//             while ((h_sig & 0x0400u) == 0) {
+//                 h_sig <<= 1;
+//                 shift++;
+//             }
+//             h_sig &= 0x03FFu;
+//             f_exp = (127 - 15 - shift) << 23;
+//             f_sig = ((uint32_t)h_sig) << 13;
+//         }
+//     } else if (h_exp == 0x7C00u) {
+//         // Inf or NaN
+//         f_exp = 0xFFu << 23;
+//         f_sig = ((uint32_t)h_sig) << 13;
+//     } else {
+//         // Normalized number
+//         uint32_t exp = ((h_exp >> 10) & 0x1Fu);
+//         f_exp = (exp + (127 - 15)) << 23;
+//         f_sig = ((uint32_t)h_sig) << 13;
+//     }
+
+//     uint32_t f_bits = f_sgn | f_exp | f_sig;
+//     float f;
+//     memcpy(&f, &f_bits, sizeof(f));
+//     return f;
+// }
+
+// // Fused multiply-add for FP16
+// fp16 fp16_fma(fp16 a, fp16 b, fp16 c) {
+//     float fa = fp16_to_float(a);
+//     float fb = fp16_to_float(b);
+//     float fc = fp16_to_float(c);
+//     if ((a == 0) || (b == 0))
+//          return c;
+//     else if (c == 0) {
+//         float result = fa * fb;
+//         return float_to_fp16(result);
+//     }
+//     else {
+//         float result = (fa * fb) + fc;
+//         return float_to_fp16(result);
+//     }
+// }
+
+// uint16_t double_to_fp16(double d) {
+//     uint64_t bits;
+//     memcpy(&bits, &d, sizeof(bits)); 
+
+//     uint16_t sign = (bits >> 63) & 0x1;
+//     int64_t exp_d = (bits >> 52) & 0x7FF;
+//     uint64_t frac_d = bits & 0x000FFFFFFFFFFFFFull; // 52 bits
+
+//     uint16_t exp_h, frac_h;
+
+//     // Handle special cases
+//     if (exp_d == 0x7FF) { // Inf or NaN
+//         exp_h = 0x1F;
+//         if (frac_d == 0) { // Infinity
+//             frac_h = 0;
+//         } else { // NaN: preserve quiet NaN bit
+//             // Preserve top 10 bits of FP32 fraction for FP16
+//             // Ensure quiet NaN (set MSB of frac_h)
+//             frac_h = (uint16_t)((frac_d >> (52 - 10)) | 0x200);
+//         }
+//     } else if (exp_d == 0) { // Zero or subnormal in double → zero in half
+//         // All double subnormals are mapped to FP16 zero.
+//         // Some double subnormals might be large enough to become FP16 subnormals.
+//         // This results in a small precision loss.
+//         exp_h = 0;
+//         frac_h = 0;
+//     } else { // Normalized double
+//         int32_t exp_unbiased = (int32_t)exp_d - 1023; // remove double bias
+//         int32_t exp_half = exp_unbiased + 15;         // re-bias for half
+
+//         if (exp_half >= 0x1F) { // Overflow → Infinity
+//             exp_h = 0x1F;
+//             frac_h = 0;
+//         } else if (exp_half <= 0) { // Subnormal or underflow to zero
+//             if (exp_half < -10) { // Too small → underflow to zero
+//                 exp_h = 0;
+//                 frac_h = 0;
+//             } else {
+//                 // Subnormal number
+//                 uint64_t mant = (frac_d | 0x10000000000000ull); // add hidden bit 
+//                 uint8_t shift = 52 + (1 - exp_half) - 10; 
+//                 uint64_t frac = mant >> shift; 
+
+//                 // Round to nearest-even
+//                 uint64_t round_bit = (mant >> (shift - 1)) & 1; 
+//                 uint64_t rest = mant & ((1ull << (shift - 1)) - 1); 
+//                 if (round_bit && (rest || (frac & 1))) 
+//                     frac++;
+
+//                 frac_h = (uint16_t)frac;
+//                 exp_h = 0;
+//             }
+//         } else {
+//             // Normal half-precision number
+//             uint64_t mant = frac_d;
+
+//             // Extract top 10 bits and round
+//             uint64_t frac = mant >> (52 - 10);
+//             uint64_t round_bit = (mant >> (52 - 10 - 1)) & 1;
+//             uint64_t rest = mant & ((1ull << (52 - 10 - 1)) - 1);
+
+//             if (round_bit && (rest || (frac & 1)))
+//                 frac++;
+
+//             if (frac == 0x400) { // mantissa overflow
+//                 frac = 0;
+//                 exp_half++;
+//             }
+
+//             if (exp_half >= 0x1F) {
+//                 // Overflow → Infinity
+//                 exp_h = 0x1F;
+//                 frac_h = 0;
+//             } else {
+//                 exp_h = exp_half & 0x1F;
+//                 frac_h = (uint16_t)(frac & 0x3FF);
+//             }
+//         }
+//     }
+
+//     return (sign << 15) | (exp_h << 10) | frac_h;
+// }
+
+// double fp16_to_double(fp16 h) { 
+//     uint16_t sign = (h >> 15) & 0x1u; 
+//     uint16_t exp = (h >> 10) & 0x1Fu; 
+//     uint16_t frac = h & 0x03FFu; 
+//     uint64_t exp_d = 0; 
+//     uint64_t frac_d = 0; 
+//     if (exp == 0x1F) { // Inf or NaN 
+//         exp_d = 0x7FF; // double exponent all 1s 
+//         frac_d = (frac ? ((uint64_t)frac << (52 - 10)) : 0); // propagate fraction 
+//     } else if (exp == 0) { // Zero or subnormal 
+//         if (frac != 0) { // if Zero, do nothing (exp_d and frac_d are 0) 
+//             // Subnormal: scale fraction up to normalized double 
+//             // FP16 subnormal: value = frac * 2^(-24) (2^-14 / 2^10) 
+//             uint64_t frac_norm = frac; 
+//             int exp_shift = 0; 
+//             while ((frac_norm & 0x400) == 0) { // 0x400 = 1 << 10 (FP16 MSB) 
+//                 frac_norm <<= 1; exp_shift++; 
+//             } 
+//             frac_norm &= 0x3FF; 
+//             frac_d = frac_norm << (52 - 10); 
+//             exp_d = (uint64_t)(1023 - 15 - exp_shift); 
+//         } 
+//     } else { // Normalized number 
+//         frac_d = ((uint64_t)frac) << (52 - 10); // align fraction to 52 bits 
+//         exp_d = (uint64_t)((int32_t)exp - 15 + 1023); // double bias 
+//     } 
+    
+//     // Compose final 64-bit result 
+//     uint64_t d_bits = ((uint64_t)sign << 63) | (exp_d << 52) | frac_d; 
+//     double d; 
+//     memcpy(&d, &d_bits, sizeof(d)); 
+//     return d; 
+// }
+
+// // Fused multiply-add for FP16
+// fp16 fp16_fma(fp16 a, fp16 b, fp16 c) {
+//     double da = fp16_to_double(a);
+//     double db = fp16_to_double(b);
+//     double dc = fp16_to_double(c);
+//     if ((a==0) || (b==0))
+//         return c;
+//     else if (c==0) {
+//         double result = (da * db);
+//         return double_to_fp16(result);
+//     }
+//     else {
+//         double result = (da * db) + dc;
+//         return double_to_fp16(result);
+//     }
+// }
+
+fp16 fp16_fma(fp16 a, fp16 b, fp16 c) {
+    flexfloat_t ff_a, ff_b, ff_c, ff_res; 
+    flexfloat_desc_t env = (flexfloat_desc_t){5, 10}; 
+    ff_init(&ff_a, env); 
+    ff_init(&ff_b, env); 
+    ff_init(&ff_c, env); 
+    ff_init(&ff_res, env); 
+    flexfloat_set_bits(&ff_a, a); 
+    flexfloat_set_bits(&ff_b, b); 
+    flexfloat_set_bits(&ff_c, c);
+    ff_fma(&ff_res, &ff_a, &ff_b, &ff_c); 
+    return (fp16)flexfloat_get_bits(&ff_res);
+}
+
+void matmul_fp16(fp16 * z, fp16 * y, fp16 * x, fp16 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
+    for (int i = 0; i < m_size; ++i)
+    {
+        for (int j = 0; j < k_size; ++j)
+        {
+            z[i * k_size + j] = y[i * k_size + j];
+            //printf("y[%d]=0x%4x\n",i * k_size + j, y[i * k_size + j]);
+            for (int k = 0; k < n_size; ++k)
+            {
+                // this->trace.msg(vp::Trace::LEVEL_TRACE,"[i=%d-j=%d-k=%d] x[%d]=0x%04x w[%d]=0x%04x y[%d]=0x%04x \n",i,
+                //                                                                     j,
+                //                                                                     k,
+                //                                                                     i * n_size + k,
+                //                                                                     x[i * n_size + k],
+                //                                                                     k * k_size + j,
+                //                                                                     w[k * k_size + j],
+                //                                                                     i * k_size + j,
+                //                                                                     y[i * k_size + j]);
+                z[i * k_size + j] = fp16_fma(x[i * n_size + k], w[k * k_size + j], z[i * k_size + j]);
+            }
+            //this->trace.msg(vp::Trace::LEVEL_TRACE,"z[%d]=0x%4x\n",i * k_size + j, z[i * k_size + j]);
+        }
+    }
+}
+
+
+void matmul_uint8(uint8_t * z, uint8_t * y, uint8_t * x, uint8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
+    for (int i = 0; i < m_size; ++i)
+    {
+        for (int j = 0; j < k_size; ++j)
+        {
+            z[i * k_size + j] = y[i * k_size + j];
+            for (int k = 0; k < n_size; ++k)
+            {
+                z[i * k_size + j] += x[i * n_size + k] * w[k * k_size + j];
+            }
+        }
+    }
+}
+
+void matmul_int8(int8_t * z, int8_t * y, int8_t * x, int8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
+    for (int i = 0; i < m_size; ++i)
+    {
+        for (int j = 0; j < k_size; ++j)
+        {
+            z[i * k_size + j] = y[i * k_size + j];
+            for (int k = 0; k < n_size; ++k)
+            {
+                z[i * k_size + j] += x[i * n_size + k] * w[k * k_size + j];
+            }
+        }
+    }
+}
+
+// Constants for FP8-E4M3 format
+#define FP8_EXP_MASK  0x78  // 0111 1000
+#define FP8_FRAC_MASK 0x07  // 0000 0111
+#define FP8_SIGN_MASK 0x80  // 1000 0000
+#define FP8_BIAS      7
+
+// Convert FP8 (E4M3) to float
+float fp8e4m3_to_float(fp8e4m3 value) {
+    uint8_t sign = (value & FP8_SIGN_MASK) >> 7;
+    uint8_t exponent = (value & FP8_EXP_MASK) >> 3;
+    uint8_t fraction = value & FP8_FRAC_MASK;
+
+    if (exponent == 0) {
+        // Subnormal number
+        if (fraction == 0) return sign ? -0.0f : 0.0f;
+        return (sign ? -1.0f : 1.0f) * (fraction / 8.0f) * powf(2, -6);
+    } else if (exponent == 15) {
+        // Infinity or NaN
+        return fraction ? NAN : (sign ? -INFINITY : INFINITY);
+    }
+
+    // Normalized number
+    float mantissa = 1.0f + (fraction / 8.0f);
+    float result = mantissa * powf(2, exponent - FP8_BIAS);
+    return sign ? -result : result;
+}
+
+// Convert float to FP8 (E4M3)
+fp8e4m3 float_to_fp8e4m3(float value) {
+    if (isnan(value)) return 0x7F;  // NaN representation
+    if (isinf(value)) return value < 0 ? 0xF8 : 0x78;  // +/-Inf representation
+
+    uint8_t sign = (value < 0) ? 0x80 : 0x00;
+    value = fabsf(value);
+
+    int exponent;
+    float mantissa = frexpf(value, &exponent);
+
+    if (value == 0.0f) return 0;  // Zero representation
+
+    exponent += FP8_BIAS - 1;
+
+    if (exponent < 1) {
+        // Subnormal handling
+        int frac = (int)roundf(value / powf(2, -6) * 8.0f);
+        return sign | (frac & FP8_FRAC_MASK);
+    } else if (exponent > 14) {
+        // Clamp to infinity
+        return sign | 0x78;
+    }
+
+    // Normal number
+    uint8_t frac = (uint8_t)roundf((mantissa - 0.5f) * 16.0f);
+    return sign | ((exponent << 3) & FP8_EXP_MASK) | (frac & FP8_FRAC_MASK);
+}
+
+// Fused Multiply-Add for FP8
+fp8e4m3 fp8e4m3_fma(fp8e4m3 a, fp8e4m3 b, fp8e4m3 c) {
+    float fa = fp8e4m3_to_float(a);
+    float fb = fp8e4m3_to_float(b);
+    float fc = fp8e4m3_to_float(c);
+
+    float result = fa * fb + fc;
+    return float_to_fp8e4m3(result);
+}
+
+void matmul_fp8e4m3(fp8e4m3 * z, fp8e4m3 * y, fp8e4m3 * x, fp8e4m3 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size){
+    for (int i = 0; i < m_size; ++i)
+    {
+        for (int j = 0; j < k_size; ++j)
+        {
+            z[i * k_size + j] = y[i * k_size + j];
+            for (int k = 0; k < n_size; ++k)
+            {
+                z[i * k_size + j] = fp8e4m3_fma(x[i * n_size + k], w[k * k_size + j], z[i * k_size + j]);
+            }
+        }
+    }
+}
+
+
+/************************************************************
+*                  Vectorized Implementation                *
+************************************************************/
+
+#ifdef LIGHT_REDMULE_GEMM_X86
+
+// Integer kernels. The reference kernels accumulate modulo the element width,
+// so a 16-bit accumulator gives the right low bits whatever the signedness and
+// 8-bit elements can be zero-extended and accumulated on 16 bits. Each block
+// computes ROWS rows of 16 columns, sharing the w loads between the rows.
+
+template<typename T>
+__attribute__((target("avx2")))
+static inline __m256i gemm_int_load(const T *p)
+{
+    if (sizeof(T) == 2)
+        return _mm256_loadu_si256((const __m256i *)p);
+    else
+        return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)p));
+}
+
+template<typename T>
+__attribute__((target("avx2")))
+static inline void gemm_int_store(T *p, __m256i v)
+{
+    if (sizeof(T) == 2)
+    {
+        _mm256_storeu_si256((__m256i *)p, v);
+    }
+    else
+    {
+        // packus works on each 128-bit lane, the bytes end up in quadwords 0 and 2
+        __m256i bytes = _mm256_packus_epi16(_mm256_and_si256(v, _mm256_set1_epi16(0xFF)), _mm256_setzero_si256());
+        bytes = _mm256_permute4x64_epi64(bytes, 0x08);
+        _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(bytes));
+    }
+}
+
+template<typename T, int ROWS>
+__attribute__((target("avx2")))
+static inline void gemm_int_block(T * z, T * y, T * x, T * w, int i, int j, int n_size, int k_size)
+{
+    __m256i acc[ROWS];
+    for (int r = 0; r < ROWS; r++)
+        acc[r] = gemm_int_load(&y[(i + r) * k_size + j]);
+
+    for (int k = 0; k < n_size; k++)
+    {
+        __m256i wv = gemm_int_load(&w[k * k_size + j]);
+        for (int r = 0; r < ROWS; r++)
+        {
+            __m256i xv = _mm256_set1_epi16((int16_t)x[(i + r) * n_size + k]);
+            acc[r] = _mm256_add_epi16(acc[r], _mm256_mullo_epi16(xv, wv));
+        }
+    }
+
+    for (int r = 0; r < ROWS; r++)
+        gemm_int_store(&z[(i + r) * k_size + j], acc[r]);
+}
+
+template<typename T>
+__attribute__((target("avx2")))
+static void matmul_int_avx2(T * z, T * y, T * x, T * w, uint16_t m_size, uint16_t n_size, uint16_t k_size)
+{
+    int k_vec = k_size - k_size % 16;
+
+    for (int j = 0; j < k_vec; j += 16)
+    {
+        int i = 0;
+        for (; i + 4 <= m_size; i += 4)
+            gemm_int_block<T, 4>(z, y, x, w, i, j, n_size, k_size);
+        for (; i < m_size; i++)
+            gemm_int_block<T, 1>(z, y, x, w, i, j, n_size, k_size);
+    }
+
+    // Remaining columns
+    for (int i = 0; i < m_size; i++)
+    {
+        for (int j = k_vec; j < k_size; j++)
+        {
+            T acc = y[i * k_size + j];
+            for (int k = 0; k < n_size; k++)
+                acc += x[i * n_size + k] * w[k * k_size + j];
+            z[i * k_size + j] = acc;
+        }
+    }
+}
+
+// FP16 kernel. flexfloat computes each FMA in double and rounds the result to
+// fp16 to nearest even. The double is first rounded to odd on float precision,
+// which is exact since the product of two fp16 plus an fp16 always fits the
+// float exponent range, then F16C rounds it to fp16. Rounding to odd with 13
+// extra bits makes the second rounding give the same result as rounding the
+// double directly. Tiles with infinite or NaN inputs go to the reference.
+
+__attribute__((target("avx2,fma,f16c")))
+static inline __m128i fp16_round_pd(__m256d d)
+{
+    const __m256i low = _mm256_set1_epi64x((1LL << 29) - 1);
+    __m256i bits = _mm256_castpd_si256(d);
+    __m256i inexact = _mm256_andnot_si256(
+        _mm256_cmpeq_epi64(_mm256_and_si256(bits, low), _mm256_setzero_si256()),
+        _mm256_set1_epi64x(1LL << 29));
+    bits = _mm256_or_si256(_mm256_andnot_si256(low, bits), inexact);
+    return _mm_cvtps_ph(_mm256_cvtpd_ps(_mm256_castsi256_pd(bits)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+
+static bool fp16_is_finite(const fp16 * v, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        if ((v[i] & 0x7C00) == 0x7C00)
+            return false;
+    }
+    return true;
+}
+
+template<int ROWS>
+__attribute__((target("avx2,fma,f16c")))
+static inline void gemm_fp16_block(fp16 * z, fp16 * y, fp16 * x, fp16 * w, int i, int j, int n_size, int k_size)
+{
+    __m128i acc[ROWS];
+    for (int r = 0; r < ROWS; r++)
+        acc[r] = _mm_loadu_si128((const __m128i *)&y[(i + r) * k_size + j]);
+
+    for (int k = 0; k < n_size; k++)
+    {
+        __m256 wv = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)&w[k * k_size + j]));
+        __m256d w_lo = _mm256_cvtps_pd(_mm256_castps256_ps128(wv));
+        __m256d w_hi = _mm256_cvtps_pd(_mm256_extractf128_ps(wv, 1));
+        for (int r = 0; r < ROWS; r++)
+        {
+            __m256d xv = _mm256_set1_pd(_cvtsh_ss(x[(i + r) * n_size + k]));
+            __m256 zv = _mm256_cvtph_ps(acc[r]);
+            __m256d z_lo = _mm256_fmadd_pd(xv, w_lo, _mm256_cvtps_pd(_mm256_castps256_ps128(zv)));
+            __m256d z_hi = _mm256_fmadd_pd(xv, w_hi, _mm256_cvtps_pd(_mm256_extractf128_ps(zv, 1)));
+            acc[r] = _mm_unpacklo_epi64(fp16_round_pd(z_lo), fp16_round_pd(z_hi));
+        }
+    }
+
+    for (int r = 0; r < ROWS; r++)
+        _mm_storeu_si128((__m128i *)&z[(i + r) * k_size + j], acc[r]);
+}
+
+__attribute__((target("avx2,fma,f16c")))
+static void matmul_fp16_avx2(fp16 * z, fp16 * y, fp16 * x, fp16 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size)
+{
+    if (!fp16_is_finite(x, m_size * n_size) || !fp16_is_finite(w, n_size * k_size) ||
+        !fp16_is_finite(y, m_size * k_size))
+    {
+        matmul_fp16(z, y, x, w, m_size, n_size, k_size);
+        return;
+    }
+
+    int k_vec = k_size - k_size % 8;
+
+    for (int j = 0; j < k_vec; j += 8)
+    {
+        int i = 0;
+        for (; i + 4 <= m_size; i += 4)
+            gemm_fp16_block<4>(z, y, x, w, i, j, n_size, k_size);
+        for (; i < m_size; i++)
+            gemm_fp16_block<1>(z, y, x, w, i, j, n_size, k_size);
+    }
+
+    // Remaining columns
+    for (int i = 0; i < m_size; i++)
+    {
+        for (int j = k_vec; j < k_size; j++)
+        {
+            fp16 acc = y[i * k_size + j];
+            for (int k = 0; k < n_size; k++)
+                acc = fp16_fma(x[i * n_size + k], w[k * k_size + j], acc);
+            z[i * k_size + j] = acc;
+        }
+    }
+}
+
+// FP8 kernel. Operands are decoded with a table built from fp8e4m3_to_float,
+// the FMA is done in float as in fp8e4m3_fma (the product is exact so it does
+// not matter whether it is fused), and float_to_fp8e4m3 is emulated with
+// integer operations on the float encoding, including its rounding of ties
+// away from zero and its mantissa wrap-around when rounding up.
+
+struct Fp8e4m3Values
+{
+    Fp8e4m3Values()
+    {
+        for (int i = 0; i < 256; i++)
+            this->values[i] = fp8e4m3_to_float(i);
+    }
+    float values[256];
+};
+
+__attribute__((target("avx2")))
+static inline __m256i fp8_round_ps(__m256 v)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i bits = _mm256_and_si256(_mm256_castps_si256(v), _mm256_set1_epi32(0x7FFFFFFF));
+    __m256i exp = _mm256_srli_epi32(bits, 23);
+    __m256i frac = _mm256_and_si256(bits, _mm256_set1_epi32(0x7FFFFF));
+    __m256i sign = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_LT_OQ)),
+        _mm256_set1_epi32(FP8_SIGN_MASK));
+
+    // Normal fp8, exponent between 1 and 14
+    __m256i normal = _mm256_or_si256(
+        _mm256_slli_epi32(_mm256_sub_epi32(exp, _mm256_set1_epi32(127 - FP8_BIAS)), 3),
+        _mm256_and_si256(_mm256_srli_epi32(_mm256_add_epi32(frac, _mm256_set1_epi32(1 << 19)), 20),
+            _mm256_set1_epi32(FP8_FRAC_MASK)));
+
+    // Subnormal fp8, round(value * 2^9) as mant * 2^-shift
+    __m256i is_normal = _mm256_cmpgt_epi32(exp, zero);
+    __m256i mant = _mm256_or_si256(frac, _mm256_and_si256(is_normal, _mm256_set1_epi32(0x800000)));
+    __m256i shift = _mm256_blendv_epi8(_mm256_set1_epi32(140),
+        _mm256_sub_epi32(_mm256_set1_epi32(141), exp), is_normal);
+    __m256i half = _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_sub_epi32(shift, _mm256_set1_epi32(1)));
+    __m256i subnormal = _mm256_and_si256(_mm256_srlv_epi32(_mm256_add_epi32(mant, half), shift),
+        _mm256_set1_epi32(FP8_FRAC_MASK));
+
+    __m256i result = _mm256_blendv_epi8(subnormal, normal,
+        _mm256_cmpgt_epi32(exp, _mm256_set1_epi32(127 - FP8_BIAS)));
+    // Overflow and infinity
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi32(FP8_EXP_MASK),
+        _mm256_cmpgt_epi32(exp, _mm256_set1_epi32(127 - FP8_BIAS + 14)));
+    result = _mm256_or_si256(result, sign);
+    // NaN
+    return _mm256_blendv_epi8(result, _mm256_set1_epi32(0x7F),
+        _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q)));
+}
+
+template<int ROWS>
+__attribute__((target("avx2")))
+static inline void gemm_fp8_block(fp8e4m3 * z, fp8e4m3 * y, fp8e4m3 * x, fp8e4m3 * w, const float *values,
+    int i, int j, int n_size, int k_size)
+{
+    __m256i acc[ROWS];
+    for (int r = 0; r < ROWS; r++)
+        acc[r] = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)&y[(i + r) * k_size + j]));
+
+    for (int k = 0; k < n_size; k++)
+    {
+        __m256 wv = _mm256_i32gather_ps(values,
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)&w[k * k_size + j])), 4);
+        for (int r = 0; r < ROWS; r++)
+        {
+            __m256 xv = _mm256_set1_ps(values[x[(i + r) * n_size + k]]);
+            __m256 zv = _mm256_i32gather_ps(values, acc[r], 4);
+            acc[r] = fp8_round_ps(_mm256_add_ps(_mm256_mul_ps(xv, wv), zv));
+        }
+    }
+
+    for (int r = 0; r < ROWS; r++)
+    {
+        __m128i codes = _mm_packus_epi32(_mm256_castsi256_si128(acc[r]), _mm256_extracti128_si256(acc[r], 1));
+        _mm_storel_epi64((__m128i *)&z[(i + r) * k_size + j], _mm_packus_epi16(codes, codes));
+    }
+}
+
+__attribute__((target("avx2")))
+static void matmul_fp8e4m3_avx2(fp8e4m3 * z, fp8e4m3 * y, fp8e4m3 * x, fp8e4m3 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size)
+{
+    static const Fp8e4m3Values fp8_values;
+    int k_vec = k_size - k_size % 8;
+
+    for (int j = 0; j < k_vec; j += 8)
+    {
+        int i = 0;
+        for (; i + 4 <= m_size; i += 4)
+            gemm_fp8_block<4>(z, y, x, w, fp8_values.values, i, j, n_size, k_size);
+        for (; i < m_size; i++)
+            gemm_fp8_block<1>(z, y, x, w, fp8_values.values, i, j, n_size, k_size);
+    }
+
+    // Remaining columns
+    for (int i = 0; i < m_size; i++)
+    {
+        for (int j = k_vec; j < k_size; j++)
+        {
+            fp8e4m3 acc = y[i * k_size + j];
+            for (int k = 0; k < n_size; k++)
+                acc = fp8e4m3_fma(x[i * n_size + k], w[k * k_size + j], acc);
+            z[i * k_size + j] = acc;
+        }
+    }
+}
+
+static const LightRedmuleGemmBackend gemm_avx2 = {
+    "avx2",
+    matmul_int_avx2<uint16_t>,
+    matmul_int_avx2<int16_t>,
+    matmul_fp16_avx2,
+    matmul_int_avx2<uint8_t>,
+    matmul_int_avx2<int8_t>,
+    matmul_fp8e4m3_avx2,
+};
+
+#endif
+
+static const LightRedmuleGemmBackend gemm_reference = {
+    "reference",
+    matmul_uint16,
+    matmul_int16,
+    matmul_fp16,
+    matmul_uint8,
+    matmul_int8,
+    matmul_fp8e4m3,
+};
+
+std::vector<const LightRedmuleGemmBackend *> light_redmule_gemm_backends()
+{
+    std::vector<const LightRedmuleGemmBackend *> backends = { &gemm_reference };
+
+#ifdef LIGHT_REDMULE_GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c"))
+    {
+        backends.push_back(&gemm_avx2);
+    }
+#endif
+
+    return backends;
+}
+
+const LightRedmuleGemmBackend *light_redmule_gemm_select()
+{
+    return light_redmule_gemm_backends().back();
+}
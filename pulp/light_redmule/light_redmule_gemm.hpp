@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2024 ETH Zurich, University of Bologna, and Fondazione Chips-IT
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Tile GEMM kernels of the LightRedmule model.
+ *
+ * All kernels compute z = y + x * w on one tile, x being m_size x n_size,
+ * w n_size x k_size, y and z m_size x k_size, all row-major. z may alias y.
+ * The reference kernels accumulate in the element format, one MAC after the
+ * other. The other backends must give bit-identical results.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+/****************************************************
+*                   Type Definition                 *
+****************************************************/
+
+// typedef union {
+//     float f;
+//     struct {
+//         uint32_t mantissa : 23;
+//         uint32_t exponent : 8;
+//         uint32_t sign : 1;
+//     } parts;
+// } FloatBits;
+
+typedef uint8_t  fp8e4m3;
+typedef uint16_t fp16;
+
+/********************************************************
+*                   Function Definition                 *
+********************************************************/
+
+// Reference kernels
+void matmul_uint16(uint16_t * z, uint16_t * y, uint16_t * x, uint16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+void matmul_int16(int16_t * z, int16_t * y, int16_t * x, int16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+void matmul_fp16(fp16 * z, fp16 * y, fp16 * x, fp16 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+void matmul_uint8(uint8_t * z, uint8_t * y, uint8_t * x, uint8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+void matmul_int8(int8_t * z, int8_t * y, int8_t * x, int8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+void matmul_fp8e4m3(fp8e4m3 * z, fp8e4m3 * y, fp8e4m3 * x, fp8e4m3 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+
+// One set of kernels, one per compute_able format
+struct LightRedmuleGemmBackend
+{
+    const char *name;
+    void (*matmul_uint16)(uint16_t * z, uint16_t * y, uint16_t * x, uint16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+    void (*matmul_int16)(int16_t * z, int16_t * y, int16_t * x, int16_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+    void (*matmul_fp16)(fp16 * z, fp16 * y, fp16 * x, fp16 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+    void (*matmul_uint8)(uint8_t * z, uint8_t * y, uint8_t * x, uint8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+    void (*matmul_int8)(int8_t * z, int8_t * y, int8_t * x, int8_t * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+    void (*matmul_fp8e4m3)(fp8e4m3 * z, fp8e4m3 * y, fp8e4m3 * x, fp8e4m3 * w, uint16_t m_size, uint16_t n_size, uint16_t k_size);
+};
+
+// Backends the host can run, the reference one first
+std::vector<const LightRedmuleGemmBackend *> light_redmule_gemm_backends();
+
+// Fastest backend the host can run, checked with CPUID
+const LightRedmuleGemmBackend *light_redmule_gemm_select();
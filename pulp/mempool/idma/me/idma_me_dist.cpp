@@ -18,6 +18,7 @@
  * Authors: Germain Haugou, ETH Zurich (germain.haugou@iis.ee.ethz.ch)
  */
 
+#include <algorithm>
 #include <vp/vp.hpp>
 #include "idma_me_dist.hpp"
 
@@ -27,9 +28,6 @@ IDmaMeDist::IDmaMeDist(vp::Component *idma, std::string name, IdmaTransferProduc
 {
     // Frontend and backend will be used later for interaction
     this->fe = fe;
-    this->nb_be = be.size();
-    this->be = be;
-    this->transfer_queue.resize(this->nb_be);
     this->be_region_size = be_region_size;
     this->dma_region_start = idma->get_js_config()->get_int("loc_base");
     this->dma_region_end = this->dma_region_start + idma->get_js_config()->get_int("loc_size");
@@ -39,6 +37,54 @@ IDmaMeDist::IDmaMeDist(vp::Component *idma, std::string name, IdmaTransferProduc
 
     // Get the top parameter giving the maximum number of enqueued transfers
     this->transfer_queue_size = idma->get_js_config()->get_int("transfer_queue_size");
+    this->slot_transfer.resize(this->transfer_queue_size);
+
+    this->set_be(be);
+}
+
+
+
+IDmaMeDist::~IDmaMeDist()
+{
+    for (IDmaMeDistBurst *burst: this->bursts)
+    {
+        delete burst;
+    }
+}
+
+
+
+IDmaMeDistBurst *IDmaMeDist::burst_alloc()
+{
+    IDmaMeDistBurst *burst;
+    if (this->free_bursts.empty())
+    {
+        burst = new IDmaMeDistBurst();
+        this->bursts.push_back(burst);
+    }
+    else
+    {
+        burst = this->free_bursts.back();
+        this->free_bursts.pop_back();
+    }
+
+    // Recycled bursts may have been modified by the backend or, if it is itself a middle-end,
+    // used as a parent, so put them back into the state of a new one
+    burst->src_stride = 0;
+    burst->dst_stride = 0;
+    burst->config = 0;
+    burst->ack_size = 0;
+    burst->nb_bursts = 0;
+    burst->bursts_sent = false;
+
+    return burst;
+}
+
+
+
+void IDmaMeDist::burst_free(IDmaMeDistBurst *burst)
+{
+    this->free_bursts.push_back(burst);
 }
 
 
@@ -51,38 +97,40 @@ void IDmaMeDist::enqueue_transfer(IdmaTransfer *transfer)
     }
     this->trace.msg(vp::Trace::LEVEL_TRACE, "Queueing transfer (transfer: %p)\n", transfer);
 
-    int be_region_width = clog2(this->be_region_size);
-    int full_region_width = clog2(this->be_region_size * this->nb_be);
-    uint64_t be_region_mask = be_region_width >= 64 ? (uint64_t)-1 :
-        (((uint64_t)1 << be_region_width) - 1);
-    uint64_t full_region_mask = full_region_width >= 64 ? (uint64_t)-1 :
-        (((uint64_t)1 << full_region_width) - 1);
+    int slot = this->free_slots.back();
+    this->free_slots.pop_back();
+    this->slot_transfer[slot] = transfer;
+    uint64_t *pending = &this->slot_pending[slot * this->pending_words];
 
     bool src_in_region = transfer->src >= (uint64_t)this->dma_region_start
         && transfer->src < (uint64_t)this->dma_region_end;
 
-    uint64_t src_addr = transfer->src & full_region_mask;
-    uint64_t dst_addr = transfer->dst & full_region_mask;
+    uint64_t src_addr = transfer->src & this->full_region_mask;
+    uint64_t dst_addr = transfer->dst & this->full_region_mask;
     uint64_t start_addr = src_in_region ? src_addr : dst_addr;
     uint64_t end_addr = start_addr + transfer->size;
 
     transfer->nb_bursts = 0;
 
-    for (int i = 0; i < this->nb_be; i++) {
-        uint64_t region_start = (uint64_t)i * this->be_region_size;
+    // Only go through the backends whose region overlaps the transfer, starting with the one
+    // containing the first byte
+    uint64_t first_be = start_addr / this->be_region_size;
+
+    for (uint64_t i = first_be; i < (uint64_t)this->nb_be; i++) {
+        uint64_t region_start = i * this->be_region_size;
         uint64_t region_end = region_start + this->be_region_size;
 
-        IdmaTransfer *burst = new IdmaTransfer();
+        if (end_addr <= region_start) {
+            break;
+        }
+
+        IDmaMeDistBurst *burst = this->burst_alloc();
         burst->parent = transfer;
+        burst->be_id = i;
+        burst->slot = slot;
+        burst->reps = 1;
 
-        if (start_addr >= region_end || end_addr <= region_start) {
-            burst->src = 0;
-            burst->dst = 0;
-            burst->size = 0;
-            burst->reps = 0;
-            this->transfer_queue[i].push(burst);
-        }
-        else if (start_addr >= region_start) {
+        if (start_addr >= region_start) {
             // First (and potentially only) slice.
             burst->src = transfer->src;
             burst->dst = transfer->dst;
@@ -91,31 +139,27 @@ void IDmaMeDist::enqueue_transfer(IdmaTransfer *transfer)
             } else {
                 burst->size = region_end - start_addr;
             }
-            burst->reps = 1;
-            this->transfer_queue[i].push(burst);
-            transfer->nb_bursts++;
-            this->be[i]->enqueue_transfer(burst);
         }
         else {
             // Middle or last slice, align to the region boundary.
             uint64_t offset = region_start - start_addr;
             if (src_in_region) {
-                burst->src = (transfer->src & ~full_region_mask) | region_start;
+                burst->src = (transfer->src & ~this->full_region_mask) | region_start;
                 burst->dst = transfer->dst + offset;
             } else {
                 burst->src = transfer->src + offset;
-                burst->dst = (transfer->dst & ~full_region_mask) | region_start;
+                burst->dst = (transfer->dst & ~this->full_region_mask) | region_start;
             }
             if (end_addr >= region_end) {
                 burst->size = this->be_region_size;
             } else {
                 burst->size = end_addr - region_start;
             }
-            burst->reps = 1;
-            this->transfer_queue[i].push(burst);
-            transfer->nb_bursts++;
-            this->be[i]->enqueue_transfer(burst);
         }
+
+        pending[i / 64] |= (uint64_t)1 << (i % 64);
+        transfer->nb_bursts++;
+        this->be[i]->enqueue_transfer(burst);
     }
     transfer->bursts_sent = true;
 
@@ -125,11 +169,12 @@ void IDmaMeDist::enqueue_transfer(IdmaTransfer *transfer)
 
 bool IDmaMeDist::can_accept_transfer()
 {
-    // Accept transfers as soon as there is room in the queue
+    // Accept transfers as soon as there is a free in-flight slot, which bounds the number of
+    // pending bursts of each backend to transfer_queue_size
+    if (this->free_slots.empty()) {
+        return false;
+    }
     for (int i = 0; i < this->nb_be; i++) {
-        if (this->transfer_queue[i].size() >= this->transfer_queue_size) {
-            return false;
-        }
         if (!this->be[i]->can_accept_transfer()) {
             return false;
         }
@@ -142,26 +187,37 @@ bool IDmaMeDist::can_accept_transfer()
 // Called by back-end to notify the end of a burst of the transfer
 void IDmaMeDist::ack_transfer(IdmaTransfer *transfer)
 {
+    // All the transfers we receive here are the bursts we sent
+    IDmaMeDistBurst *burst = (IDmaMeDistBurst *)transfer;
+    IdmaTransfer *parent = burst->parent;
+    int slot = burst->slot;
+    uint64_t *pending = &this->slot_pending[slot * this->pending_words];
+    uint64_t be_bit = (uint64_t)1 << (burst->be_id % 64);
+
+    if (this->slot_transfer[slot] != parent || (pending[burst->be_id / 64] & be_bit) == 0) {
+        this->trace.fatal("Transfer completion mismatch\n");
+    }
+    pending[burst->be_id / 64] &= ~be_bit;
+
+    // The burst can be reused as soon as the backend is done with it
+    this->burst_free(burst);
+
     // Decreased number of pending bursts
-    transfer->parent->nb_bursts--;
+    parent->nb_bursts--;
     this->trace.msg(vp::Trace::LEVEL_TRACE, "Remaining bursts for transfer (transfer: %p, nb_bursts: %d)\n",
-        transfer->parent, transfer->parent->nb_bursts);
+        parent, parent->nb_bursts);
 
     // And terminate the transfer if all bursts have been sent and no more burst is pending
-    if (transfer->parent->bursts_sent && transfer->parent->nb_bursts == 0)
+    if (parent->bursts_sent && parent->nb_bursts == 0)
     {
-        // Keep the parent in a local since the loop below frees all the bursts of this
-        // transfer, including the one we received, making transfer->parent a dangling read.
-        IdmaTransfer *parent = transfer->parent;
-        this->trace.msg(vp::Trace::LEVEL_TRACE, "Finished transfer (transfer: %p)\n", parent);
-        for (auto &queue: this->transfer_queue) {
-            if (queue.empty() || queue.front()->parent != parent) {
+        for (int i = 0; i < this->pending_words; i++) {
+            if (pending[i] != 0) {
                 this->trace.fatal("Transfer completion mismatch\n");
             }
-            IdmaTransfer *burst = queue.front();
-            queue.pop();
-            delete burst;
         }
+        this->trace.msg(vp::Trace::LEVEL_TRACE, "Finished transfer (transfer: %p)\n", parent);
+        this->slot_transfer[slot] = NULL;
+        this->free_slots.push_back(slot);
         this->fe->ack_transfer(parent);
         this->fe->update();
     }
@@ -172,23 +228,29 @@ void IDmaMeDist::set_be(std::vector<IdmaTransferConsumer *> be)
 {
     this->be = be;
     this->nb_be = be.size();
-    this->transfer_queue.resize(this->nb_be);
+
+    int full_region_width = clog2(this->be_region_size * this->nb_be);
+    this->full_region_mask = full_region_width >= 64 ? (uint64_t)-1 :
+        (((uint64_t)1 << full_region_width) - 1);
+
+    this->pending_words = (this->nb_be + 63) / 64;
+    this->slot_pending.assign(this->transfer_queue_size * this->pending_words, 0);
+    this->reset(true);
 }
 
 void IDmaMeDist::reset(bool active)
 {
     if (active)
     {
-        // Empty the fifo
-        for (auto &queue: this->transfer_queue) {
-            while (!queue.empty())
-            {
-                IdmaTransfer *transfer = queue.front();
-                queue.pop();
-                // Each transfer needs to be freed since we are owning them
-                delete transfer;
-            }
+        // Drop all in-flight transfers, the bursts are owned by us and go back to the pool
+        this->free_slots.clear();
+        for (int i = this->transfer_queue_size - 1; i >= 0; i--)
+        {
+            this->slot_transfer[i] = NULL;
+            this->free_slots.push_back(i);
         }
+        std::fill(this->slot_pending.begin(), this->slot_pending.end(), 0);
+        this->free_bursts = this->bursts;
     }
 }
 
@@ -26,9 +26,26 @@
 
 
 /**
- * @brief 2D middle-end
+ * @brief Burst of a distributed transfer
  *
- * This front-end can be used to get support for 2D transfers
+ * Bursts are owned by the middle-end and recycled once the backend has acknowledged them.
+ */
+class IDmaMeDistBurst : public IdmaTransfer
+{
+public:
+    // Index of the backend the burst was sent to
+    int be_id;
+    // In-flight slot of the parent transfer
+    int slot;
+};
+
+
+
+/**
+ * @brief Distribution middle-end
+ *
+ * This middle-end splits transfers into bursts along the address regions of its backends, each
+ * backend handling be_region_size bytes. Only the backends touched by a transfer receive a burst.
  */
 class IDmaMeDist : public vp::Block, public IdmaTransferConsumer, public IdmaTransferProducer
 {
@@ -41,6 +58,7 @@ public:
      * @param be The back end.
      */
     IDmaMeDist(vp::Component *idma, std::string name, IdmaTransferProducer *fe, std::vector<IdmaTransferConsumer *> be, int be_region_size);
+    ~IDmaMeDist();
 
     void reset(bool active) override;
 
@@ -54,6 +72,8 @@ public:
 
 private:
     static unsigned int clog2(int value);
+    IDmaMeDistBurst *burst_alloc();
+    void burst_free(IDmaMeDistBurst *burst);
 
     // Pointer to frontend
     IdmaTransferProducer *fe;
@@ -67,7 +87,19 @@ private:
     int transfer_queue_size;
     int dma_region_start;
     int dma_region_end;
-    // Queue of enqueued transfers. The number of transfers which can be enqueued is defined by
-    // transfer_queue_size
-    std::vector<std::queue<IdmaTransfer *>> transfer_queue;
+    // Mask extracting the offset within the whole area covered by the backends, computed when
+    // the backends are set
+    uint64_t full_region_mask;
+    // Number of 64-bit words of a completion bitmap
+    int pending_words;
+    // In-flight transfers, one slot per transfer which can be enqueued
+    std::vector<IdmaTransfer *> slot_transfer;
+    // Completion bitmaps of the in-flight transfers, pending_words per slot. A bit is set for
+    // each backend which still has to acknowledge its burst.
+    std::vector<uint64_t> slot_pending;
+    // Free in-flight slots
+    std::vector<int> free_slots;
+    // All bursts ever allocated, and the ones which are currently not in flight
+    std::vector<IDmaMeDistBurst *> bursts;
+    std::vector<IDmaMeDistBurst *> free_bursts;
 };
@@ -21,6 +21,7 @@
 #include <vp/vp.hpp>
 #include "fe/idma_fe_xdma.hpp"
 #include "me/idma_me_2d.hpp"
+#include "me/idma_me_nd.hpp"
 #include "me/idma_me_split.hpp"
 #include "me/idma_me_dist.hpp"
 #include "be/idma_be.hpp"
@@ -34,7 +35,7 @@
  *
  * This puts together:
  *   - Xdma front-end to handle xdma custom instructions from snitch core
- *   - 2D middle end to add support for 2D transfers
+ *   - 2D middle end to add support for 2D transfers, or N-dimensional middle-end if me_nd is set
  *   - AXI and TCDM backend protocols to interact with external AXI interconnect and local
  *   TCDM memory
  */
@@ -45,7 +46,9 @@ public:
 
 private:
     IDmaFeXdma *fe;
-    IDmaMe2D *me;
+    // Only one of the 2 middle-ends is instantiated, depending on the me_nd parameter
+    IDmaMe2D *me = nullptr;
+    IDmaMeNd *me_nd = nullptr;
     IDmaMeSplit *me_split;
     IDmaMeDist * me_cluster_dist;
     std::vector<IDmaMeDist *> me_group_dist;
@@ -68,11 +71,29 @@ MemPoolDma::MemPoolDma(vp::ComponentConf &config)
 
     this->fe = new IDmaFeXdma(this, nullptr);
 
-    this->me = new IDmaMe2D(this, this->fe, nullptr);
-    this->fe->set_me(this->me);
+    IdmaTransferProducer *me_producer;
+    if (get_js_config()->get_child_bool("me_nd"))
+    {
+        this->me_nd = new IDmaMeNd(this, this->fe, nullptr);
+        this->fe->set_me(this->me_nd);
+        me_producer = this->me_nd;
+    }
+    else
+    {
+        this->me = new IDmaMe2D(this, this->fe, nullptr);
+        this->fe->set_me(this->me);
+        me_producer = this->me;
+    }
 
-    this->me_split = new IDmaMeSplit(this, this->me, nullptr, nb_be * be_width);
-    this->me->set_be(this->me_split);
+    this->me_split = new IDmaMeSplit(this, me_producer, nullptr, nb_be * be_width);
+    if (this->me_nd)
+    {
+        this->me_nd->set_be(this->me_split);
+    }
+    else
+    {
+        this->me->set_be(this->me_split);
+    }
 
     this->me_cluster_dist = new IDmaMeDist(this, "me_cluster_dist", this->me_split, {}, nb_dmas_per_group * be_width);
     this->me_split->set_be(this->me_cluster_dist);
@@ -38,6 +38,11 @@ class MemPoolDma(gvsoc.systree.Component):
         Size of the local area.
     tcdm_width: int
         Width of the local interconnect, in bytes.
+    me_nd: bool
+        Use the N-dimensional middle-end instead of the 2D one. It also merges contiguous
+        dimensions into bigger bursts.
+    me_nb_dims: int
+        Number of dimensions supported by the N-dimensional middle-end, from 2 to 4.
     """
 
     def __init__(self, parent: gvsoc.systree.Component, name: str,
@@ -49,7 +54,9 @@ class MemPoolDma(gvsoc.systree.Component):
             tcdm_width: int=0,
             nb_groups: int=4,
             nb_dmas_per_group: int=1,
-            be_width: int=1024):
+            be_width: int=1024,
+            me_nd: bool=False,
+            me_nb_dims: int=4):
 
         super().__init__(parent, name)
 
@@ -57,6 +64,7 @@ class MemPoolDma(gvsoc.systree.Component):
             'pulp/mempool/idma/mempool_dma.cpp',
             'pulp/mempool/idma/fe/idma_fe_xdma.cpp',
             'pulp/mempool/idma/me/idma_me_2d.cpp',
+            'pulp/mempool/idma/me/idma_me_nd.cpp',
             'pulp/mempool/idma/me/idma_me_split.cpp',
             'pulp/mempool/idma/me/idma_me_dist.cpp',
             'pulp/mempool/idma/be/idma_be.cpp',
@@ -71,6 +79,8 @@ class MemPoolDma(gvsoc.systree.Component):
             "loc_base": loc_base,
             "loc_size": loc_size,
             "tcdm_width": tcdm_width,
+            "me_nd": me_nd,
+            "me_nb_dims": me_nb_dims,
             "nb_groups": nb_groups,
             "nb_dmas_per_group": nb_dmas_per_group,
             "be_width": be_width,
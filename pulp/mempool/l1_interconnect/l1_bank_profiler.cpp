@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Bank conflict profiler of the tile L1 banks.
+ *
+ * Sits in front of the banks of a tile, where the requests of the local cores,
+ * of the remote tiles and of the DMA meet. Each path goes from input_<i> to
+ * output_<i> and leads to the bank given by the paths property, so that a bank
+ * can be reached through several paths. Requests are forwarded untouched, and
+ * reported to the bank profiler as accesses to the bank of their path.
+ *
+ * The profiler sees bank offsets, which are turned back into the address of the
+ * tile interleaved view, so that the same offset in different banks gives
+ * different addresses in the report.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <vector>
+#include "pulp/common/bank_profiler.hpp"
+
+class L1_BankProfiler : public vp::Component
+{
+public:
+    L1_BankProfiler(vp::ComponentConf &config);
+
+    void stop() override;
+
+private:
+    static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req, int path);
+    static void grant(vp::Block *__this, vp::IoReq *req);
+    static void response(vp::Block *__this, vp::IoReq *req);
+
+    vp::Trace trace;
+    std::vector<vp::IoSlave> input_itf;
+    std::vector<vp::IoMaster> output_itf;
+
+    // Bank reached by each path
+    std::vector<int> path_bank;
+    int interleaving_bits;
+    int bank_bits;
+    BankProfiler *profiler;
+};
+
+L1_BankProfiler::L1_BankProfiler(vp::ComponentConf &config)
+    : vp::Component(config)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    int nb_banks = this->get_js_config()->get_int("nb_banks");
+    this->interleaving_bits = this->get_js_config()->get_int("interleaving_bits");
+    this->bank_bits = 0;
+    while ((1 << this->bank_bits) < nb_banks)
+    {
+        this->bank_bits++;
+    }
+
+    for (js::Config *bank: this->get_js_config()->get("paths")->get_elems())
+    {
+        this->path_bank.push_back(bank->get_int());
+    }
+
+    int nb_paths = this->path_bank.size();
+    this->input_itf.resize(nb_paths);
+    this->output_itf.resize(nb_paths);
+    for (int i = 0; i < nb_paths; i++)
+    {
+        this->input_itf[i].set_req_meth_muxed(&L1_BankProfiler::req, i);
+        this->new_slave_port("input_" + std::to_string(i), &this->input_itf[i]);
+
+        this->output_itf[i].set_resp_meth(&L1_BankProfiler::response);
+        this->output_itf[i].set_grant_meth(&L1_BankProfiler::grant);
+        this->new_master_port("output_" + std::to_string(i), &this->output_itf[i]);
+    }
+
+    this->profiler = new BankProfiler(this, nb_banks);
+}
+
+void L1_BankProfiler::stop()
+{
+    this->profiler->dump_report();
+}
+
+vp::IoReqStatus L1_BankProfiler::req(vp::Block *__this, vp::IoReq *req, int path)
+{
+    L1_BankProfiler *_this = (L1_BankProfiler *)__this;
+    int bank_id = _this->path_bank[path];
+    uint64_t offset = req->get_addr();
+    uint64_t granule_mask = (1ULL << _this->interleaving_bits) - 1;
+    uint64_t addr = ((offset & ~granule_mask) << _this->bank_bits)
+        + ((uint64_t)bank_id << _this->interleaving_bits) + (offset & granule_mask);
+
+    _this->profiler->access(bank_id, addr);
+
+    return _this->output_itf[path].req_forward(req);
+}
+
+void L1_BankProfiler::grant(vp::Block *__this, vp::IoReq *req)
+{
+}
+
+void L1_BankProfiler::response(vp::Block *__this, vp::IoReq *req)
+{
+}
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new L1_BankProfiler(config);
+}
@@ -0,0 +1,44 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class L1_BankProfiler(gvsoc.systree.Component):
+    """Bank conflict profiler of the tile L1 banks.
+
+    Forwards the requests of each path from input_<i> to output_<i> and reports
+    them as accesses to the bank paths[i]. It is placed where all the masters
+    of a tile meet its banks, since each core goes through its own scrambler
+    and interleaver before.
+    """
+
+    def __init__(self, parent: gvsoc.systree.Component, name: str, *, nb_banks: int,
+            paths: list, interleaving_bits: int, bank_conflicts: bool=False,
+            bank_profiler: bool=True, bank_profiler_file: str='', bank_profiler_top: int=16):
+        super().__init__(parent, name)
+
+        self.add_sources(['pulp/mempool/l1_interconnect/l1_bank_profiler.cpp'])
+
+        self.add_properties({
+            'nb_banks': nb_banks,
+            'paths': paths,
+            'interleaving_bits': interleaving_bits,
+            'bank_conflicts': bank_conflicts,
+            'bank_profiler': bank_profiler,
+            'bank_profiler_file': bank_profiler_file,
+            'bank_profiler_top': bank_profiler_top,
+        })
@@ -22,6 +22,7 @@ from interco.router import Router
 from interco.interleaver import Interleaver
 from pulp.mempool.xbar.mempool_xbar import MempoolXbar
 from pulp.mempool.l1_interconnect.l1_remote_itf import L1_RemoteItf
+from pulp.mempool.l1_interconnect.l1_bank_profiler import L1_BankProfiler
 from pulp.mempool.xbar.mempool_xbar_selector import MempoolXbarSelector
 import math
 
@@ -46,12 +47,16 @@ class L1_subsystem(gvsoc.systree.Component):
     bandwidth: int
         Global bandwidth, in bytes per cycle, applied to all incoming request. This impacts the
         end time of the burst.
+    bank_profiler: bool
+        Profile the bank conflicts of the tile, where the requests of all the masters meet the
+        banks.
 
     """
 
     def __init__(self, parent: gvsoc.systree.Component, name: str, terapool: bool=False, async_l1_interco: bool=False, tile_id: int=0, sub_group_id: int=0, group_id: int=0,
                  nb_tiles_per_sub_group: int=4, nb_sub_groups_per_group: int=1, nb_groups: int=4, nb_remote_local_masters: int=1, nb_remote_group_masters: int=4,
-                 nb_remote_sub_group_masters: int=4, nb_pe: int=0, size: int=0, nb_banks_per_tile: int=0, bandwidth: int=0, axi_data_width: int=512, terapool_group_latency: int=7):
+                 nb_remote_sub_group_masters: int=4, nb_pe: int=0, size: int=0, nb_banks_per_tile: int=0, bandwidth: int=0, axi_data_width: int=512, terapool_group_latency: int=7,
+                 bank_profiler: bool=False):
         super(L1_subsystem, self).__init__(parent, name)
 
         #
@@ -181,6 +186,13 @@ class L1_subsystem(gvsoc.systree.Component):
         dma_interface = Router(self, 'dma_itf', bandwidth=axi_data_width, latency=0, shared_rw_bandwidth=True)
         dma_interface.add_mapping('output')
 
+        # Bank profiler, paths from the remove_offset interleavers, then paths from the DMA
+        # interleaver
+        if bank_profiler:
+            l1_bank_profiler = L1_BankProfiler(self, 'bank_profiler', nb_banks=nb_banks_per_tile,
+                                               paths=list(range(nb_banks_per_tile)) * 2,
+                                               interleaving_bits=int(math.log2(bandwidth)))
+
         # DMA Interleaver
         dma_interleaver = Interleaver(self, 'dma_interleaver', nb_slaves=nb_banks_per_tile, nb_masters=1, interleaving_bits=2, enable_shift=(total_banks - 1).bit_length(), offset_translation=False)
 
@@ -237,7 +249,11 @@ class L1_subsystem(gvsoc.systree.Component):
         self.bind(dma_interface, 'output', dma_interleaver, 'in_0')
 
         for i in range(0, nb_banks_per_tile):
-            self.bind(dma_interleaver, f'out_{i}', l1_banks[i], 'input')
+            if bank_profiler:
+                self.bind(dma_interleaver, f'out_{i}', l1_bank_profiler, f'input_{nb_banks_per_tile + i}')
+                self.bind(l1_bank_profiler, f'output_{nb_banks_per_tile + i}', l1_banks[i], 'input')
+            else:
+                self.bind(dma_interleaver, f'out_{i}', l1_banks[i], 'input')
 
         #
         # Address sorting
@@ -257,7 +273,12 @@ class L1_subsystem(gvsoc.systree.Component):
                     self.bind(remote_sub_group_interleaver, 'out_%d' % i, remove_offset, 'in_0')
                 for remote_group_interleaver in remote_group_interleavers:
                     self.bind(remote_group_interleaver, 'out_%d' % i, remove_offset, 'in_0')
-                self.bind(remove_offset, 'out_0', l1_adapters[i - start_bank_id] if async_l1_interco else l1_banks[i - start_bank_id], 'input')
+                bank = l1_adapters[i - start_bank_id] if async_l1_interco else l1_banks[i - start_bank_id]
+                if bank_profiler:
+                    self.bind(remove_offset, 'out_0', l1_bank_profiler, f'input_{i - start_bank_id}')
+                    self.bind(l1_bank_profiler, f'output_{i - start_bank_id}', bank, 'input')
+                else:
+                    self.bind(remove_offset, 'out_0', bank, 'input')
             elif tgt_grp_id == group_id:
                 if tgt_sg_id == sub_group_id:
                     for j, local_interleaver in enumerate(local_interleavers):
@@ -21,12 +21,11 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
 #include <vp/itf/wire.hpp>
+#include <vp/signal.hpp>
 #include <cpu/iss/include/offload.hpp>
-#include <vector>
-#include <algorithm>
-#include <atomic>
-#include <mutex>
-#include <memory>
+#include <string.h>
+#include "cache_filter_rules.hpp"
+#include "cache_filter_tags.hpp"
 
 class CacheFilter : public vp::Component
 {
@@ -34,17 +33,18 @@ class CacheFilter : public vp::Component
 public:
     CacheFilter(vp::ComponentConf &config);
 
+    void reset(bool active) override;
+
 private:
-    struct CacheRule { uint64_t start, end; };
-    struct RuleSnapshot { std::vector<CacheRule> intervals; std::vector<uint64_t> max_hi_prefix; };
     void add_rule(uint64_t start, uint64_t end);
-    void update_rule(size_t idx, uint64_t start, uint64_t end);
-    void get_rule(size_t idx, uint64_t &start, uint64_t &end);
     bool match(uint64_t addr, uint64_t size);
-    void build_snapshot_unlocked();
-    mutable std::mutex mu_;
-    std::vector<CacheRule> rules_;
-    std::shared_ptr<RuleSnapshot> snapshot_{nullptr};
+    CacheFilterRules rules_;
+
+    // Cache model, handles a request matching the rules instead of forwarding it to the cache
+    vp::IoReqStatus model_req(vp::IoReq *req);
+    void refill_done();
+    void update_stats();
+    CacheFilterTags tags_;
 
     static void config_sync(vp::Block *__this, IssOffloadInsn<uint32_t> *insn);
     static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
@@ -59,12 +59,39 @@ private:
 
     bool bypass;
     int cache_latency;
+
+    // Cache model parameters
+    bool cache_model;
+    int hit_latency;
+    int miss_latency;
+
+    // Line refill sent through the bypass port, only one at a time. refill_target is the request
+    // waiting for it, and refill_way the way being refilled, invalid until the refill is done
+    vp::IoReq refill_req;
+    vp::IoReq *refill_target;
+    int refill_way;
+    bool refill_stale;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    vp::Signal<uint64_t> nb_hits;
+    vp::Signal<uint64_t> nb_misses;
+    vp::Signal<uint64_t> nb_evictions;
+    // Hit and miss rates of the cached requests so far, in per-mille
+    vp::Signal<uint64_t> hit_rate;
+    vp::Signal<uint64_t> miss_rate;
 };
 
 
 
 CacheFilter::CacheFilter(vp::ComponentConf &config)
-    : vp::Component(config)
+    : vp::Component(config),
+    nb_hits(*this, "nb_hits", 64, vp::SignalCommon::ResetKind::Value, 0),
+    nb_misses(*this, "nb_misses", 64, vp::SignalCommon::ResetKind::Value, 0),
+    nb_evictions(*this, "nb_evictions", 64, vp::SignalCommon::ResetKind::Value, 0),
+    hit_rate(*this, "hit_rate", 64, vp::SignalCommon::ResetKind::Value, 0),
+    miss_rate(*this, "miss_rate", 64, vp::SignalCommon::ResetKind::Value, 0)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
     this->config_itf.set_sync_meth(&CacheFilter::config_sync);
@@ -95,89 +122,55 @@ CacheFilter::CacheFilter(vp::ComponentConf &config)
     {
         this->trace.msg("CacheFilter: no cache rules defined\n");
     }
-}
 
-void CacheFilter::add_rule(uint64_t start, uint64_t end)
-{
-    if (start >= end)
+    cache_model = get_js_config()->get_child_bool("cache_model");
+    if (cache_model)
     {
-        this->trace.fatal("CacheFilter: invalid cache rule [0x%lx, 0x%lx)\n", start, end);
-        return;
+        hit_latency = get_js_config()->get_child_int("hit_latency");
+        miss_latency = get_js_config()->get_child_int("miss_latency");
+
+        std::string replacement_name = get_js_config()->get_child_str("replacement");
+        CacheFilterTags::Replacement replacement;
+        if (!CacheFilterTags::parse_replacement(replacement_name, replacement))
+        {
+            this->trace.fatal("CacheFilter: invalid replacement policy %s\n", replacement_name.c_str());
+        }
+
+        int nb_sets = get_js_config()->get_child_int("nb_sets");
+        int nb_ways = get_js_config()->get_child_int("nb_ways");
+        int line_size = get_js_config()->get_child_int("line_size");
+        if (!tags_.configure(nb_sets, nb_ways, line_size, replacement))
+        {
+            this->trace.fatal("CacheFilter: invalid cache geometry (nb_sets: %d, nb_ways: %d, line_size: %d)\n",
+                              nb_sets, nb_ways, line_size);
+        }
     }
-    std::lock_guard<std::mutex> g(mu_);
-    rules_.push_back({start, end});
-    build_snapshot_unlocked();
 }
 
-void CacheFilter::update_rule(size_t idx, uint64_t start, uint64_t end)
+void CacheFilter::reset(bool active)
 {
-    if (start >= end)
+    if (active)
     {
-        this->trace.fatal("CacheFilter: invalid cache rule [0x%lx, 0x%lx)\n", start, end);
-        return;
-    }
-    std::lock_guard<std::mutex> g(mu_);
-    if (idx >= rules_.size())
-    {
-        this->trace.fatal("CacheFilter: invalid rule index %zu\n", idx);
-        return;
+        tags_.reset();
+        refill_target = NULL;
+        refill_stale = false;
+        hits = 0;
+        misses = 0;
+        evictions = 0;
     }
-    rules_[idx] = {start, end};
-    build_snapshot_unlocked();
 }
 
-void CacheFilter::get_rule(size_t idx, uint64_t &start, uint64_t &end)
+void CacheFilter::add_rule(uint64_t start, uint64_t end)
 {
-    std::lock_guard<std::mutex> g(mu_);
-    if (idx >= rules_.size())
+    if (!rules_.add(start, end))
     {
-        this->trace.fatal("CacheFilter: invalid rule index %zu\n", idx);
-        return;
+        this->trace.fatal("CacheFilter: invalid cache rule [0x%lx, 0x%lx)\n", start, end);
     }
-    start = rules_[idx].start;
-    end = rules_[idx].end;
 }
 
 bool CacheFilter::match(uint64_t addr, uint64_t size)
 {
-    if (size == 0) return false;
-    uint64_t end = addr + size;
-    if (end < addr) return false;
-
-    auto snap = std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
-    if (!snap || snap->intervals.empty()) return false;
-
-    const auto &ivs = snap->intervals;
-    auto it = std::upper_bound(ivs.begin(), ivs.end(), end - 1,
-                                [](uint64_t value, const CacheRule &r){ return value < r.start; });
-    if (it == ivs.begin()) return false;
-    size_t j = static_cast<size_t>(std::distance(ivs.begin(), it) - 1);
-    return snap->max_hi_prefix[j] > addr;
-}
-
-void CacheFilter::build_snapshot_unlocked()
-{
-    std::vector<CacheRule> ivs = rules_;
-    std::sort(ivs.begin(), ivs.end(), [](const CacheRule &a, const CacheRule &b){
-        if (a.start != b.start) return a.start < b.start;
-        return a.end < b.end;
-    });
-
-    ivs.erase(std::remove_if(ivs.begin(), ivs.end(),
-                [](const CacheRule &r){ return r.end <= r.start; }), ivs.end());
-
-    std::vector<uint64_t> prefix;
-    prefix.reserve(ivs.size());
-    uint64_t cur = 0;
-    for (size_t i = 0; i < ivs.size(); ++i) {
-        cur = (i == 0) ? ivs[i].end : std::max(cur, ivs[i].end);
-        prefix.push_back(cur);
-    }
-
-    auto snap = std::make_shared<RuleSnapshot>();
-    snap->intervals     = std::move(ivs);
-    snap->max_hi_prefix = std::move(prefix);
-    std::atomic_store_explicit(&snapshot_, snap, std::memory_order_release);
+    return rules_.match(addr, size);
 }
 
 void CacheFilter::config_sync(vp::Block *__this, IssOffloadInsn<uint32_t> *insn)
@@ -185,17 +178,21 @@ void CacheFilter::config_sync(vp::Block *__this, IssOffloadInsn<uint32_t> *insn)
     CacheFilter *_this = (CacheFilter *)__this;
     _this->trace.msg("CacheFilter: config sync opcode=0x%x arg_a=%u arg_b=%u arg_c=%u\n",
                     insn->opcode, insn->arg_a, insn->arg_b, insn->arg_c);
-    uint64_t start, end;
-    _this->get_rule(insn->arg_a, start, end);
-    if (insn->arg_b == 0)
+    // arg_b selects the start (0) or the end of the rule, which is updated at once so that
+    // requests never see a half-updated rule
+    uint64_t start = 0, end = 0;
+    if (!_this->rules_.set_bound(insn->arg_a, insn->arg_b != 0, insn->arg_c, start, end))
     {
-        start = insn->arg_c;
+        _this->trace.fatal("CacheFilter: invalid update of rule %u to [0x%lx, 0x%lx)\n",
+                           insn->arg_a, start, end);
     }
-    else
+
+    // Lines of ranges which are no longer cached would not see bypassed writes
+    if (_this->cache_model)
     {
-        end = insn->arg_c;
+        _this->tags_.invalidate_all();
+        _this->refill_stale = true;
     }
-    _this->update_rule(insn->arg_a, start, end);
 }
 
 vp::IoReqStatus CacheFilter::req(vp::Block *__this, vp::IoReq *req)
@@ -210,11 +207,147 @@ vp::IoReqStatus CacheFilter::req(vp::Block *__this, vp::IoReq *req)
     else
     {
         _this->trace.msg("CacheFilter: caching req addr=0x%lx size=%lu\n", req->get_addr(), req->get_size());
+        if (_this->cache_model)
+        {
+            return _this->model_req(req);
+        }
         req->inc_latency(_this->cache_latency);
         return _this->cache_itf.req_forward(req);
     }
 }
 
+vp::IoReqStatus CacheFilter::model_req(vp::IoReq *req)
+{
+    uint64_t addr = req->get_addr();
+    uint64_t size = req->get_size();
+    uint64_t offset = addr - tags_.line_base(addr);
+
+    // Requests crossing lines are not modeled, they go to the L2 like uncached ones
+    if (offset + size > (uint64_t)tags_.line_size())
+    {
+        this->trace.msg("CacheFilter: request crossing lines, bypassing addr=0x%lx size=%lu\n", addr, size);
+        if (req->get_is_write())
+        {
+            // Drop the lines it writes to instead of updating them
+            for (uint64_t line = tags_.line_base(addr); line < addr + size; line += tags_.line_size())
+            {
+                int way = tags_.find(line);
+                if (way >= 0)
+                {
+                    tags_.invalidate(line, way);
+                }
+                if (refill_target && line == refill_req.get_addr())
+                {
+                    refill_stale = true;
+                }
+            }
+        }
+        return bypass_itf.req_forward(req);
+    }
+
+    int way = tags_.find(addr);
+
+    // Write-through without allocation, the line is only updated if present
+    if (req->get_is_write())
+    {
+        if (way >= 0)
+        {
+            memcpy(tags_.data(addr, way) + offset, req->get_data(), size);
+            tags_.touch(addr, way);
+        }
+        if (refill_target && tags_.line_base(addr) == tags_.line_base(refill_req.get_addr()))
+        {
+            refill_stale = true;
+        }
+        return bypass_itf.req_forward(req);
+    }
+
+    if (way >= 0)
+    {
+        this->trace.msg("CacheFilter: hit addr=0x%lx size=%lu way=%d\n", addr, size, way);
+        memcpy(req->get_data(), tags_.data(addr, way) + offset, size);
+        tags_.touch(addr, way);
+        req->inc_latency(hit_latency);
+        hits++;
+        this->update_stats();
+        return vp::IO_REQ_OK;
+    }
+
+    misses++;
+
+    // Only one refill at a time, other misses meanwhile are served by the L2 without allocating
+    if (refill_target)
+    {
+        this->update_stats();
+        req->inc_latency(miss_latency);
+        return bypass_itf.req_forward(req);
+    }
+
+    bool evicted;
+    way = tags_.victim(addr, evicted);
+    if (evicted)
+    {
+        evictions++;
+    }
+    this->update_stats();
+
+    this->trace.msg("CacheFilter: miss addr=0x%lx size=%lu way=%d evicted=%d\n", addr, size, way, evicted);
+
+    // The way is refilled in place, it stays invalid until the refill is done
+    tags_.invalidate(addr, way);
+    refill_target = req;
+    refill_way = way;
+    refill_stale = false;
+
+    refill_req.init();
+    refill_req.set_addr(tags_.line_base(addr));
+    refill_req.set_size(tags_.line_size());
+    refill_req.set_is_write(false);
+    refill_req.set_data(tags_.data(addr, way));
+
+    vp::IoReqStatus status = bypass_itf.req(&refill_req);
+    if (status == vp::IO_REQ_OK)
+    {
+        req->inc_latency(refill_req.get_latency());
+        this->refill_done();
+        return vp::IO_REQ_OK;
+    }
+    else if (status == vp::IO_REQ_INVALID)
+    {
+        refill_target = NULL;
+        return vp::IO_REQ_INVALID;
+    }
+
+    // Denied or pending, the request is answered once the refill response is received
+    return vp::IO_REQ_PENDING;
+}
+
+void CacheFilter::refill_done()
+{
+    vp::IoReq *req = refill_target;
+    uint64_t addr = req->get_addr();
+
+    refill_target = NULL;
+
+    if (!refill_stale)
+    {
+        tags_.fill(addr, refill_way);
+    }
+    memcpy(req->get_data(), tags_.data(addr, refill_way) + (addr - tags_.line_base(addr)),
+        req->get_size());
+    req->inc_latency(miss_latency);
+}
+
+void CacheFilter::update_stats()
+{
+    uint64_t total = hits + misses;
+    nb_hits = hits;
+    nb_misses = misses;
+    nb_evictions = evictions;
+    hit_rate = total ? hits * 1000 / total : 0;
+    miss_rate = total ? misses * 1000 / total : 0;
+}
+
 void CacheFilter::grant(vp::Block *__this, vp::IoReq *req)
 {
 
@@ -222,6 +355,23 @@ void CacheFilter::grant(vp::Block *__this, vp::IoReq *req)
 
 void CacheFilter::response(vp::Block *__this, vp::IoReq *req)
 {
+    CacheFilter *_this = (CacheFilter *)__this;
+
+    // Only our own refills come back here, forwarded requests are answered to their initiator
+    if (req == &_this->refill_req && _this->refill_target)
+    {
+        vp::IoReq *target = _this->refill_target;
+        if (req->status == vp::IO_REQ_INVALID)
+        {
+            _this->refill_target = NULL;
+            target->status = vp::IO_REQ_INVALID;
+        }
+        else
+        {
+            _this->refill_done();
+        }
+        target->get_resp_port()->resp(target);
+    }
 }
 
 extern "C" vp::Component *gv_new(vp::ComponentConf &config)
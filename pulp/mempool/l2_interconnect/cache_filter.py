@@ -18,8 +18,22 @@ import gvsoc.systree
 from typing import List, Tuple
 
 class CacheFilter(gvsoc.systree.Component):
+    """L2 cache filter
 
-    def __init__(self, parent: gvsoc.systree.Component, name: str, bypass: bool = False, cache_rules: List[Tuple[int, int]]=[], cache_latency: int=0):
+    Requests overlapping one of the cache_rules address ranges go to the cache port with
+    cache_latency added, the other ones go to the bypass port.
+
+    With cache_model, matching requests are instead handled by a built-in set-associative tag
+    array of nb_sets sets of nb_ways lines of line_size bytes, replaced with the lru, fifo or
+    random policy. Read hits are answered with hit_latency. Read misses refill the line through
+    the bypass port and add miss_latency to the refill latency. Writes go through the bypass
+    port and update the line if present. The nb_hits, nb_misses and nb_evictions signals count
+    the cached requests, and hit_rate and miss_rate give their ratio in per-mille.
+    """
+
+    def __init__(self, parent: gvsoc.systree.Component, name: str, bypass: bool = False, cache_rules: List[Tuple[int, int]]=[], cache_latency: int=0,
+                 cache_model: bool=False, nb_sets: int=64, nb_ways: int=2, line_size: int=64,
+                 replacement: str='lru', hit_latency: int=1, miss_latency: int=1):
 
         super().__init__(parent, name)
 
@@ -27,4 +41,11 @@ class CacheFilter(gvsoc.systree.Component):
 
         self.add_property('bypass', bypass)
         self.add_property('cache_rules', cache_rules)
-        self.add_property('cache_latency', cache_latency)
\ No newline at end of file
+        self.add_property('cache_latency', cache_latency)
+        self.add_property('cache_model', cache_model)
+        self.add_property('nb_sets', nb_sets)
+        self.add_property('nb_ways', nb_ways)
+        self.add_property('line_size', line_size)
+        self.add_property('replacement', replacement)
+        self.add_property('hit_latency', hit_latency)
+        self.add_property('miss_latency', miss_latency)
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+/*
+ * Address ranges of the CacheFilter, a request matches if it overlaps any of them.
+ *
+ * Each change of the rules rebuilds the sorted list of merged intervals which match() searches.
+ * match() keeps the interval which matched last time and checks it first without searching,
+ * until the rules change.
+ *
+ * Rules are only updated and matched from the engine thread, so this is not thread-safe.
+ */
+class CacheFilterRules
+{
+public:
+    // Rules are [start, end) and must not be empty, returns false if they are
+    bool add(uint64_t start, uint64_t end)
+    {
+        if (start >= end) return false;
+        rules_.push_back({start, end});
+        rebuild();
+        return true;
+    }
+
+    // Replace the start or the end of a rule within a single update, start and end are filled
+    // with the resulting rule
+    bool set_bound(size_t idx, bool is_end, uint64_t value, uint64_t &start, uint64_t &end)
+    {
+        if (idx >= rules_.size()) return false;
+        Rule rule = rules_[idx];
+        (is_end ? rule.end : rule.start) = value;
+        start = rule.start;
+        end = rule.end;
+        if (start >= end) return false;
+        rules_[idx] = rule;
+        rebuild();
+        return true;
+    }
+
+    bool match(uint64_t addr, uint64_t size)
+    {
+        if (size == 0) return false;
+        uint64_t end = addr + size;
+        if (end < addr) return false;
+
+        // Most requests hit the same rule as the previous one
+        if (addr < last_.end && end > last_.start)
+        {
+            return true;
+        }
+
+        // Last interval starting before the end of the request, intervals are disjoint so it
+        // is the only one which can overlap it
+        auto it = std::upper_bound(intervals_.begin(), intervals_.end(), end - 1,
+                                    [](uint64_t value, const Rule &r){ return value < r.start; });
+        if (it == intervals_.begin()) return false;
+        --it;
+        if (it->end <= addr) return false;
+
+        last_ = *it;
+        return true;
+    }
+
+private:
+    struct Rule { uint64_t start, end; };
+
+    void rebuild()
+    {
+        std::vector<Rule> ivs = rules_;
+        std::sort(ivs.begin(), ivs.end(), [](const Rule &a, const Rule &b){
+            if (a.start != b.start) return a.start < b.start;
+            return a.end < b.end;
+        });
+
+        // Merge overlapping and adjacent rules, a request overlaps the union of rules if and
+        // only if it overlaps one of them
+        intervals_.clear();
+        for (const Rule &r : ivs) {
+            if (!intervals_.empty() && r.start <= intervals_.back().end) {
+                intervals_.back().end = std::max(intervals_.back().end, r.end);
+            } else {
+                intervals_.push_back(r);
+            }
+        }
+
+        // The last match may not be part of the new intervals, the empty interval never matches
+        last_ = {0, 0};
+    }
+
+    std::vector<Rule> rules_;
+    // Sorted, merged and disjoint intervals of the rules
+    std::vector<Rule> intervals_;
+    // Interval which matched last
+    Rule last_{0, 0};
+};
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+ * Set-associative tag array of the CacheFilter cache model, with the data of each line.
+ *
+ * Sets are selected by the address bits just above the line offset. The victim of a set is its
+ * first invalid way, or else the one chosen by the replacement policy: least recently used, first
+ * filled, or pseudo-random.
+ */
+class CacheFilterTags
+{
+public:
+    enum Replacement { LRU, FIFO, RANDOM };
+
+    // Returns false if the geometry is not supported, sets and line size must be powers of 2
+    bool configure(int nb_sets, int nb_ways, int line_size, Replacement replacement)
+    {
+        if (nb_sets <= 0 || nb_ways <= 0 || line_size <= 0) return false;
+        if ((nb_sets & (nb_sets - 1)) || (line_size & (line_size - 1))) return false;
+
+        nb_sets_ = nb_sets;
+        nb_ways_ = nb_ways;
+        line_size_ = line_size;
+        replacement_ = replacement;
+        line_bits_ = __builtin_ctz(line_size);
+        lines_.assign(nb_sets * nb_ways, Line());
+        data_.assign((size_t)nb_sets * nb_ways * line_size, 0);
+        this->reset();
+        return true;
+    }
+
+    static bool parse_replacement(const std::string &name, Replacement &replacement)
+    {
+        if (name == "lru") replacement = LRU;
+        else if (name == "fifo") replacement = FIFO;
+        else if (name == "random") replacement = RANDOM;
+        else return false;
+        return true;
+    }
+
+    void reset()
+    {
+        for (Line &line : lines_) line = Line();
+        stamp_ = 0;
+        lfsr_ = 0xace1u;
+    }
+
+    int line_size() const { return line_size_; }
+    uint64_t line_base(uint64_t addr) const { return addr & ~(uint64_t)(line_size_ - 1); }
+    int set_of(uint64_t addr) const { return (addr >> line_bits_) & (nb_sets_ - 1); }
+
+    // Way holding the line of addr in its set, or -1 on a miss
+    int find(uint64_t addr) const
+    {
+        uint64_t tag = addr >> line_bits_;
+        const Line *set = &lines_[set_of(addr) * nb_ways_];
+        for (int way = 0; way < nb_ways_; way++)
+        {
+            if (set[way].valid && set[way].tag == tag) return way;
+        }
+        return -1;
+    }
+
+    // Way to replace in the set of addr, valid tells if it currently holds a line
+    int victim(uint64_t addr, bool &valid)
+    {
+        Line *set = &lines_[set_of(addr) * nb_ways_];
+        int result = 0;
+
+        for (int way = 0; way < nb_ways_; way++)
+        {
+            if (!set[way].valid)
+            {
+                valid = false;
+                return way;
+            }
+        }
+
+        if (replacement_ == RANDOM)
+        {
+            lfsr_ = (lfsr_ >> 1) ^ (-(lfsr_ & 1u) & 0xb400u);
+            result = lfsr_ % nb_ways_;
+        }
+        else
+        {
+            // The LRU stamp is updated on each access, the FIFO one only when filling
+            for (int way = 1; way < nb_ways_; way++)
+            {
+                if (set[way].stamp < set[result].stamp) result = way;
+            }
+        }
+
+        valid = true;
+        return result;
+    }
+
+    void touch(uint64_t addr, int way)
+    {
+        if (replacement_ == LRU) lines_[set_of(addr) * nb_ways_ + way].stamp = ++stamp_;
+    }
+
+    void fill(uint64_t addr, int way)
+    {
+        Line &line = lines_[set_of(addr) * nb_ways_ + way];
+        line.valid = true;
+        line.tag = addr >> line_bits_;
+        line.stamp = ++stamp_;
+    }
+
+    void invalidate(uint64_t addr, int way) { lines_[set_of(addr) * nb_ways_ + way].valid = false; }
+
+    void invalidate_all() { for (Line &line : lines_) line.valid = false; }
+
+    uint8_t *data(uint64_t addr, int way)
+    {
+        return &data_[((size_t)set_of(addr) * nb_ways_ + way) * line_size_];
+    }
+
+private:
+    struct Line { bool valid = false; uint64_t tag = 0; uint64_t stamp = 0; };
+
+    int nb_sets_ = 0;
+    int nb_ways_ = 0;
+    int line_size_ = 0;
+    int line_bits_ = 0;
+    Replacement replacement_ = LRU;
+    std::vector<Line> lines_;
+    std::vector<uint8_t> data_;
+    // Incremented on each access or fill to order the lines for LRU and FIFO replacement
+    uint64_t stamp_ = 0;
+    // Pseudo-random generator for random replacement
+    uint32_t lfsr_ = 0xace1u;
+};
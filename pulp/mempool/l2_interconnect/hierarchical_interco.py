@@ -39,7 +39,7 @@ class Hierarchical_Interco(gvsoc.systree.Component):
 
     def __init__(self, parent: gvsoc.systree.Component, name: str, bandwidth: int, synchronous: bool=True,
                  nb_slaves: int=1, nb_masters: int=1, enable_cache: bool=False, cache_rules: List[Tuple[int, int]]=[],
-                 cache_line_width: int=64, cache_size: int=8192, nb_cache_sets: int=2):
+                 cache_line_width: int=64, cache_size: int=8192, nb_cache_sets: int=2, cache_model: bool=False):
         super(Hierarchical_Interco, self).__init__(parent, name)
 
         nb_sets = 2
@@ -57,7 +57,10 @@ class Hierarchical_Interco(gvsoc.systree.Component):
             _ = input_itf.i_INPUT(i)
         input_itf.add_mapping("output")
 
-        filter = CacheFilter(self, 'filter', bypass=False, cache_rules=cache_rules)
+        # With cache_model, the filter models the cache timing itself, with the same geometry
+        filter = CacheFilter(self, 'filter', bypass=False, cache_rules=cache_rules,
+                             cache_model=cache_model, nb_sets=int(nb_lines), nb_ways=nb_sets,
+                             line_size=cache_line_width)
         
         for i in range(0, nb_slaves):
             self.bind(self, f'input_{i}', input_itf, 'input' if i == 0 else f'input_{i}')
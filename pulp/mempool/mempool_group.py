@@ -27,7 +27,7 @@ from pulp.mempool.l2_interconnect.hierarchical_interco import Hierarchical_Inter
 
 class Group(st.Component):
 
-    def __init__(self, parent, name, parser, terapool: bool=False, async_l1_interco: bool=False, group_id: int=0, nb_cores_per_tile: int=4, nb_sub_groups_per_group: int=1, nb_groups: int=4, total_cores: int= 256, bank_factor: int=4, axi_data_width: int=64, nb_dmas_per_group: int=1, terapool_group_latency: int=7, nb_fus_per_core: int=1):
+    def __init__(self, parent, name, parser, terapool: bool=False, async_l1_interco: bool=False, group_id: int=0, nb_cores_per_tile: int=4, nb_sub_groups_per_group: int=1, nb_groups: int=4, total_cores: int= 256, bank_factor: int=4, axi_data_width: int=64, nb_dmas_per_group: int=1, terapool_group_latency: int=7, nb_fus_per_core: int=1, bank_profiler: bool=False):
         super().__init__(parent, name)
 
         ################################################################
@@ -55,13 +55,13 @@ class Group(st.Component):
             for i in range(0, nb_sub_groups_per_group):
                 self.sub_group_list.append(Sub_group(self, f'sub_group_{i}', parser=parser, terapool=terapool, async_l1_interco=async_l1_interco, sub_group_id=i, group_id=group_id, nb_cores_per_tile=nb_cores_per_tile,
                     nb_sub_groups_per_group=nb_sub_groups_per_group, nb_groups=nb_groups, total_cores=total_cores, bank_factor=bank_factor, axi_data_width=axi_data_width, terapool_group_latency=terapool_group_latency,
-                    nb_fus_per_core=nb_fus_per_core))
+                    nb_fus_per_core=nb_fus_per_core, bank_profiler=bank_profiler))
         else:
             # TIles
             self.tile_list = []
             for i in range(0, nb_tiles_per_group):
                 self.tile_list.append(Tile(self, f'tile_{i}', parser=parser, terapool=terapool, async_l1_interco=async_l1_interco, tile_id=i, sub_group_id=0, group_id=group_id, nb_cores_per_tile=nb_cores_per_tile,
-                    nb_sub_groups_per_group=1, nb_groups=nb_groups, total_cores=total_cores, bank_factor=bank_factor, axi_data_width=axi_data_width, nb_fus_per_core=nb_fus_per_core))
+                    nb_sub_groups_per_group=1, nb_groups=nb_groups, total_cores=total_cores, bank_factor=bank_factor, axi_data_width=axi_data_width, nb_fus_per_core=nb_fus_per_core, bank_profiler=bank_profiler))
 
         # TCDM Interconnect
         if terapool:
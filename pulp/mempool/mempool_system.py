@@ -51,6 +51,11 @@ class System(st.Component):
             cast=str
         )
 
+        bank_profiler = TargetParameter(
+            self, name='bank_profiler', value=False,
+            description='Profile the L1 bank conflicts of each tile', cast=bool
+        ).get_value()
+
         # With the legacy gvsoc launcher, configure() is never called and the binary comes
         # from the command line, so it must be resolved now. With gvrun, it comes from a
         # parameter and is handled in configure() since it can also be set from the build
@@ -72,7 +77,7 @@ class System(st.Component):
         mempool_cluster=Cluster(self, 'mempool_cluster', async_l1_interco=async_l1_interco, terapool=terapool, parser=parser, nb_cores_per_tile=nb_cores_per_tile,
                             nb_sub_groups_per_group=nb_sub_groups_per_group, nb_groups=nb_groups, total_cores=total_cores, bank_factor=bank_factor,
                             axi_data_width=axi_data_width, nb_axi_masters_per_group=nb_axi_masters_per_group, nb_dmas_per_group=nb_dmas_per_group, terapool_group_latency=terapool_group_latency, 
-                            nb_fus_per_core=nb_fus_per_core)
+                            nb_fus_per_core=nb_fus_per_core, bank_profiler=bank_profiler)
 
         # Boot Rom
         rom = memory.Memory(self, 'rom', size=0x1000, width_log2=(axi_data_width - 1).bit_length(), stim_file=self.get_file_path('pulp/chips/spatz/rom.bin'))
@@ -143,6 +143,12 @@ private:
     static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
     // Handle a request which has been granted
     void handle_req_grant(InputPort *in);
+    // Try to elect the first pending request of an input to its output port
+    void elect(InputPort *in, int64_t cycles);
+    // Push a request to the pending queue of an input and mark the input as active
+    void input_push(InputPort *in, vp::IoReq *req);
+    // Return the first bit set in [from, end) of a port set, or -1 if there is none
+    static int next_set(const std::vector<uint64_t> &set, int from, int end);
     // Handle a request which has received its response
     void handle_req_end(vp::IoReq *req, vp::IoReqStatus status);
 
@@ -163,6 +169,14 @@ private:
     vp::ClockEvent fsm_event;
     // Input where election will start in the next election phase. Used to implement round robin
     int current_input = 0;
+    // Inputs having pending requests, one bit per input. Only these ones are checked during
+    // arbitration
+    std::vector<uint64_t> active_inputs;
+    // Number of inputs in active_inputs
+    int nb_active_inputs = 0;
+    // Outputs having an elected request, one bit per output. Only these ones are checked by the
+    // FSM
+    std::vector<uint64_t> elected_outputs;
     vp::Queue ended_reqs;
 };
 
@@ -296,88 +310,121 @@ void Channel::arbiter_handler(vp::Block *__this, vp::ClockEvent *event)
 {
     Channel *_this = (Channel *)__this;
     int64_t cycles = _this->clock.get_cycles();
+    int nb_inputs = _this->inputs.size();
 
-    // Go through each input port and see if we can route a new request to an output port
-    for (int i=0, current_input=_this->current_input; i<_this->inputs.size(); i++)
+    // Go through each input port having pending requests and see if we can route a new request
+    // to an output port. Inputs are checked in round-robin order starting from current_input,
+    // the other ones have nothing to route.
+    for (int i = next_set(_this->active_inputs, _this->current_input, nb_inputs); i != -1;
+        i = next_set(_this->active_inputs, i + 1, nb_inputs))
     {
-        InputPort *in = _this->inputs[current_input];
+        _this->elect(_this->inputs[i], cycles);
+    }
+    for (int i = next_set(_this->active_inputs, 0, _this->current_input); i != -1;
+        i = next_set(_this->active_inputs, i + 1, _this->current_input))
+    {
+        _this->elect(_this->inputs[i], cycles);
+    }
 
-        // Check if the bandwidth allows the request to go through the input
-        if (cycles >= in->next_burst_cycle)
+    // Update election round-robin
+    _this->current_input++;
+    if (_this->current_input == _this->inputs.size())
+    {
+        _this->current_input = 0;
+    }
+
+    if (_this->top->latency == 1)
+    {
+        _this->fsm_event.enqueue(1);
+    }
+    else
+    {
+        _this->fsm_event.enqueue(0);
+    }
+}
+
+void Channel::elect(InputPort *in, int64_t cycles)
+{
+    // Check if the bandwidth allows the request to go through the input
+    if (cycles >= in->next_burst_cycle)
+    {
+        // Check if this port is not stalled and has any pending request
+        if (!in->stalled && !in->pending_reqs.empty())
         {
-            // Check if this port is not stalled and has any pending request
-            if (!in->stalled && !in->pending_reqs.empty())
+            vp::IoReq *req = in->pending_reqs.front();
+            // Since a request can be checked multiple times before it is routed, we only
+            // get its mapping the first time when it is not yet initialized
+            if (!in->arbitration_lock.get())
             {
-                vp::IoReq *req = in->pending_reqs.front();
-                // Since a request can be checked multiple times before it is routed, we only
-                // get its mapping the first time when it is not yet initialized
-                if (!in->arbitration_lock.get())
+                uint64_t output_id = 0;
+                if (this->top->use_selector)
                 {
-                    uint64_t output_id = 0;
-                    if (_this->top->use_selector)
-                    {
-                        output_id = (uint64_t)req->arg_pop();
-                    }
-                    if (output_id >= _this->top->nb_output_port)
-                    {
-                        _this->trace.fatal("Invalid output ID %ld\n", output_id);
-                    }
-                    else
-                    {
-                        in->arbitration_lock = true;
-                        in->pending_mapping = output_id;
-                    }
+                    output_id = (uint64_t)req->arg_pop();
                 }
-
-                OutputPort *out = _this->entries[in->pending_mapping.get()];
-                // Check if the output we need is not already assigned a request
-                if (out->elected_input == NULL && out->stalled == false)
+                if (output_id >= this->top->nb_output_port)
+                {
+                    this->trace.fatal("Invalid output ID %ld\n", output_id);
+                }
+                else
                 {
-                    _this->trace.msg(vp::Trace::LEVEL_TRACE, "Elected input (req: %p, in: %d, out: %d)\n",
-                        req, i, in->pending_mapping.get());
+                    in->arbitration_lock = true;
+                    in->pending_mapping = output_id;
+                }
+            }
 
-                    // If not, store the request, it will be sent in the FSM event
-                    out->elected_input = in;
+            int mapping = in->pending_mapping.get();
+            OutputPort *out = this->entries[mapping];
+            // Check if the output we need is not already assigned a request
+            if (out->elected_input == NULL && out->stalled == false)
+            {
+                this->trace.msg(vp::Trace::LEVEL_TRACE, "Elected input (req: %p, in: %d, out: %d)\n",
+                    req, in->id, mapping);
 
-                    req->get_resp_port()->grant(req);
+                // If not, store the request, it will be sent in the FSM event
+                out->elected_input = in;
+                this->elected_outputs[mapping >> 6] |= 1ULL << (mapping & 63);
 
-                    // Update now the input FIFO to let another request be accepted in the next
-                    // cycle. This only works for requests smaller than bandwidth
-                    in->pending_size -= req->get_size();
+                req->get_resp_port()->grant(req);
 
-                    // Update now the bandwidth since the next request will anyway be processed
-                    // only when this one has been sent
-                    if (_this->top->bandwidth > 0)
-                    {
-                        in->next_burst_cycle = cycles +
-                            (req->get_size() + _this->top->bandwidth - 1) / _this->top->bandwidth;
-                    }
+                // Update now the input FIFO to let another request be accepted in the next
+                // cycle. This only works for requests smaller than bandwidth
+                in->pending_size -= req->get_size();
+
+                // Update now the bandwidth since the next request will anyway be processed
+                // only when this one has been sent
+                if (this->top->bandwidth > 0)
+                {
+                    in->next_burst_cycle = cycles +
+                        (req->get_size() + this->top->bandwidth - 1) / this->top->bandwidth;
                 }
             }
         }
-
-        current_input++;
-        if (current_input == _this->inputs.size())
-        {
-            current_input = 0;
-        }
     }
+}
 
-    // Update election round-robin
-    _this->current_input++;
-    if (_this->current_input == _this->inputs.size())
+int Channel::next_set(const std::vector<uint64_t> &set, int from, int end)
+{
+    while (from < end)
     {
-        _this->current_input = 0;
+        uint64_t word = set[from >> 6] >> (from & 63);
+        if (word)
+        {
+            int bit = from + __builtin_ctzll(word);
+            return bit < end ? bit : -1;
+        }
+        from = (from | 63) + 1;
     }
+    return -1;
+}
 
-    if (_this->top->latency == 1)
-    {
-        _this->fsm_event.enqueue(1);
-    }
-    else
+void Channel::input_push(InputPort *in, vp::IoReq *req)
+{
+    if (in->pending_reqs.empty())
     {
-        _this->fsm_event.enqueue(0);
+        this->active_inputs[in->id >> 6] |= 1ULL << (in->id & 63);
+        this->nb_active_inputs++;
     }
+    in->pending_reqs.push(req);
 }
 
 void Channel::grant(vp::IoReq *req, int id)
@@ -414,8 +461,10 @@ void Channel::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
         _this->handle_req_end(ended_req, vp::IO_REQ_OK);
     }
 
-    // Go through each output to see if we can send requests
-    for (int i=0; i<_this->entries.size(); i++)
+    // Go through each output having an elected request to see if we can send it
+    int nb_outputs = _this->entries.size();
+    for (int i = next_set(_this->elected_outputs, 0, nb_outputs); i != -1;
+        i = next_set(_this->elected_outputs, i + 1, nb_outputs))
     {
         OutputPort *out = _this->entries[i];
 
@@ -435,12 +484,13 @@ void Channel::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
                     vp::IoReq *denied_req = in->denied_reqs.front();
                     in->denied_reqs.pop();
                     in->stalled_signal = !in->denied_reqs.empty();
-                    in->pending_reqs.push(denied_req);
+                    _this->input_push(in, denied_req);
                     in->pending_size += denied_req->get_size();
                 }
 
                 vp::IoMaster *itf =_this->top->output_itfs[i];
                 out->elected_input = NULL;
+                _this->elected_outputs[i >> 6] &= ~(1ULL << (i & 63));
 
                 vp::IoReq *req;
                 uint64_t addr;
@@ -496,11 +546,7 @@ void Channel::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
         }
     }
 
-    bool resched = false;
-    for (int i=0; i<_this->inputs.size(); i++)
-    {
-        resched |= _this->inputs[i]->pending_reqs.size() > 0;
-    }
+    bool resched = _this->nb_active_inputs > 0;
 
     if (resched || _this->ended_reqs.has_reqs())
     {
@@ -535,9 +581,10 @@ Channel::Channel(MempoolXbar *top, std::string name)
         OutputPort *entry = new OutputPort(this->top, name + '/' + std::to_string(i), this->top->bandwidth, 0);
 
         this->entries.push_back(entry);
-
-
     }
+
+    this->active_inputs.resize((this->top->nb_input_port + 63) / 64);
+    this->elected_outputs.resize((this->top->nb_output_port + 63) / 64);
 }
 
 vp::IoReqStatus Channel::handle_req(vp::IoReq *req, int port)
@@ -564,7 +611,7 @@ vp::IoReqStatus Channel::handle_req(vp::IoReq *req, int port)
     {
         this->trace.msg(vp::Trace::LEVEL_TRACE, "Pushing req to pending (req: %p, in: %d)\n",
             req, port);
-        in->pending_reqs.push(req);
+        this->input_push(in, req);
         in->pending_size += req->get_size();
         this->arbiter_event.enqueue(0);
         return vp::IO_REQ_DENIED;
@@ -576,6 +623,11 @@ void Channel::handle_req_grant(InputPort *in)
     vp::IoReq *req = in->pending_reqs.front();
     in->pending_reqs.pop();
     in->arbitration_lock = false;
+    if (in->pending_reqs.empty())
+    {
+        this->active_inputs[in->id >> 6] &= ~(1ULL << (in->id & 63));
+        this->nb_active_inputs--;
+    }
 }
 
 void Channel::handle_req_end(vp::IoReq *req, vp::IoReqStatus status)
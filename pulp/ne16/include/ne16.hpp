@@ -24,6 +24,7 @@
 
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
+#include <vp/debug_mem.hpp>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -99,6 +100,10 @@ class Ne16;
 
 #define STREAM_MAX_WIDTH_BYTES 40
 
+// the NE16 can only access L1 memory in the range 0xY000_0000 -- 0xY001_FFFC, where Y=1 or 0
+// in the model, Y is ignored
+#define NE16_STREAM_L1_MASK 0x0001FFFF
+
 class Ne16StreamAccess {
   public:
     Ne16StreamAccess(
@@ -181,6 +186,9 @@ class Ne16VectorStore : public Ne16StreamAccess {
     xt::xarray<T> ex(xt::xarray<T> data, int width, int64_t& cycles, int32_t enable);
 };
 
+// unpacking of the weight bits loaded by matrixvec, also used by the functional mode
+xt::xarray<uint8_t> __WeightUnpack(xt::xarray<uint8_t> w, int size, bool mode16);
+
 class Ne16 : public vp::Component
 {
     friend class Ne16_base;
@@ -199,6 +207,12 @@ public:
     Ne16TraceLevel trace_level;
     int trace_format;
 
+    // FUNCTIONAL mode: the whole job runs when it is started, as one batched
+    // layer kernel working on a copy of L1 fetched through the debug backdoor of
+    // the memory, and the job duration is estimated from the layer parameters
+    bool functional;
+    bool l1_backdoor(uint64_t addr, uint8_t *data, int size, bool is_write);
+
 private:
 
     // HARDWARE parameters
@@ -245,6 +259,15 @@ private:
     // MAIN FSM and LOOP
     int  fsm();
     void fsm_loop();
+    void fsm_functional();
+
+    // FUNCTIONAL mode batched layer
+    bool functional_batched();
+    void functional_layer();
+    int64_t functional_latency();
+    uint8_t l1_image_rd(uint32_t addr);
+    void l1_image_wr(uint32_t addr, uint8_t value);
+    void l1_image_flush();
     //Ne16State state;
 
     // REGISTER FILE member functions
@@ -268,6 +291,14 @@ private:
     char running_job_id;
     int  job_running;
 
+    // FUNCTIONAL mode
+    vp::DebugMemIf *l1_debug_mem; // backdoor to L1, NULL if the target has none
+    bool l1_debug_mem_resolved;
+    vp::DebugMemIf *l1_backdoor_if();
+    std::vector<uint8_t> l1_image;      // copy of the L1 range, fetched by blocks
+    std::vector<bool> l1_image_valid;   // blocks of l1_image fetched from L1
+    std::vector<bool> l1_image_dirty;   // bytes of l1_image to write back to L1
+
     // REGISTER FILE configuration parameters
     int weights_ptr;
     int infeat_ptr;
@@ -18,12 +18,16 @@ import gvsoc.systree as st
 
 class Ne16(st.Component):
 
-    def __init__(self, parent, name):
+    def __init__(self, parent, name, functional: bool=False):
 
         super(Ne16, self).__init__(parent, name)
 
         self.set_component('pulp.ne16.ne16')
 
+        self.add_properties({
+            "functional": functional
+        })
+
     def gen_gtkw(self, tree, traces):
         if tree.get_view() == 'overview':
             map_file = tree.new_map_file(self, 'state')
@@ -42,6 +42,8 @@ Ne16::Ne16(vp::ComponentConf &config)
     this->OVERHEAD_MV     = 17;
     this->QUANT_PER_CYCLE = 4;
 
+    this->functional      = this->get_js_config()->get_child_bool("functional");
+
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
     this->new_reg("fsm_state", &this->state, 32);
     this->new_reg("ne16_busy", &this->activity, 8);
@@ -80,6 +82,33 @@ void Ne16::reset(bool active)
     this->cxt_job_id[0] = this->cxt_job_id[1] = -1;
     this->running_job_id  = 0;
     this->job_running     = 0;
+    this->l1_debug_mem    = NULL;
+    this->l1_debug_mem_resolved = false;
+}
+
+// Backdoor to L1 used in functional mode, NULL if the L1 target has none
+vp::DebugMemIf *Ne16::l1_backdoor_if()
+{
+    if(!this->l1_debug_mem_resolved) {
+      this->l1_debug_mem_resolved = true;
+      std::vector<vp::SlavePort *> finals = this->out.get_final_ports();
+      if(!finals.empty() && finals[0]->get_owner() != NULL) {
+        this->l1_debug_mem = finals[0]->get_owner()->debug_mem_if();
+      }
+      if(this->l1_debug_mem == NULL) {
+        this->trace.msg(vp::Trace::LEVEL_WARNING, "No backdoor to L1, functional mode will use the timed port\n");
+      }
+    }
+    return this->l1_debug_mem;
+}
+
+// Backdoor access to L1 used in functional mode. Returns false when the L1
+// target has no backdoor or rejects the access, in which case the caller goes
+// through the timed port.
+bool Ne16::l1_backdoor(uint64_t addr, uint8_t *data, int size, bool is_write)
+{
+    vp::DebugMemIf *l1_debug_mem = this->l1_backdoor_if();
+    return l1_debug_mem != NULL && l1_debug_mem->debug_mem_access(addr, data, size, is_write) == 0;
 }
 
 // The `hwpe_slave` member function models an access to the NE16 SLAVE interface
@@ -78,7 +78,12 @@ void Ne16::fsm_start_handler(vp::Block *__this, vp::ClockEvent *event) {
     _this->w_out = 1;
   }
 
-  _this->fsm_loop();
+  if(_this->functional) {
+    _this->fsm_functional();
+  }
+  else {
+    _this->fsm_loop();
+  }
 }
 
 void Ne16::fsm_handler(vp::Block *__this, vp::ClockEvent *event) {
@@ -116,6 +121,28 @@ void Ne16::fsm_loop() {
   }
 }
 
+// Functional mode: run the whole job at once and end it after its estimated
+// cycles. Jobs supported by the batched layer kernel skip the fsm steps, the
+// others run them back to back, accounting for their latency.
+void Ne16::fsm_functional() {
+  int64_t cycles = 0;
+  if(this->functional_batched()) {
+    this->fsm(); // START: job activity and configuration printout
+    cycles = this->functional_latency();
+    this->functional_layer();
+    this->state.set(END);
+  }
+  else {
+    do {
+      cycles += this->fsm();
+    } while(state.get() != END);
+  }
+  if (this->trace_level == L3_ALL) {
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Functional job done, estimated latency=%lld\n", (long long)cycles);
+  }
+  this->event_enqueue(this->fsm_end_event, cycles > 0 ? cycles : 1);
+}
+
 int Ne16::fsm() {
   auto state_next = this->state.get();
   auto latency = 0;
@@ -0,0 +1,460 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Functional mode batched layer of NE16.
+ *
+ * The whole job runs as one convolution kernel over plain integer arrays,
+ * instead of the fsm steps with their streamers and xtensor buffers. Tiles are
+ * computed in the fsm order and with its arithmetic, including the padding
+ * regions, filter masking, weight offset and normalization of each tile, so
+ * that L1 ends up as in timed mode. L1 is accessed through a copy, fetched by
+ * blocks through the debug backdoor when first touched and written back at the
+ * end of the job.
+ *
+ * The job duration is estimated in closed form from the layer parameters: it
+ * is the sum of the fsm step latencies with single-cycle L1 accesses.
+ */
+
+#include <ne16.hpp>
+#include <map>
+
+#define NE16_L1_IMAGE_BLOCK 64
+
+bool Ne16::functional_batched() {
+  auto tp = this->depthwise ? this->TP_IN : this->TP_OUT;
+
+  // traces are produced by the fsm steps
+  if(this->trace_level != L0_CONFIG) {
+    return false;
+  }
+  // streamin, 16-bit, linear and 16-bit output modes only run through the fsm
+  if(this->streamin || this->mode16 || this->mode_linear || (this->quantization_bits != 8 && this->quantization_bits != 32)) {
+    return false;
+  }
+  if(this->output_quant && this->normalization_bits > 32) {
+    return false;
+  }
+  // configurations outside of the tile buffers
+  if(this->subtile_nb_ko < 1 || this->subtile_nb_ki < 1 || this->subtile_nb_ho < 1 || this->subtile_nb_wo < 1 ||
+     this->subtile_rem_ko > tp || this->subtile_rem_ki > this->TP_IN ||
+     this->subtile_rem_ho > this->FILTER_SIZE || this->subtile_rem_wo > this->FILTER_SIZE ||
+     this->subtile_rem_hi > this->F_BUFFER_SIZE || this->subtile_rem_wi > this->F_BUFFER_SIZE ||
+     this->padding_top >= this->F_BUFFER_SIZE || this->padding_right >= this->F_BUFFER_SIZE ||
+     this->padding_bottom >= this->F_BUFFER_SIZE || this->padding_left >= this->F_BUFFER_SIZE ||
+     this->filter_mask_top > this->FILTER_SIZE || this->filter_mask_right > this->FILTER_SIZE ||
+     this->filter_mask_bottom > this->FILTER_SIZE || this->filter_mask_left > this->FILTER_SIZE) {
+    return false;
+  }
+  return this->l1_backdoor_if() != NULL;
+}
+
+int64_t Ne16::functional_latency() {
+  auto tp = this->depthwise ? this->TP_IN : this->TP_OUT;
+  int64_t cycles = 0;
+
+  // tiles only differ on the last row, column and output channel subtiles
+  for(auto last_k=0; last_k<2; last_k++) {
+    int64_t nb_k = last_k ? 1 : this->subtile_nb_ko-1;
+    for(auto last_i=0; last_i<2; last_i++) {
+      int64_t nb_i = last_i ? 1 : this->subtile_nb_ho-1;
+      for(auto last_j=0; last_j<2; last_j++) {
+        int64_t nb_j = last_j ? 1 : this->subtile_nb_wo-1;
+        if(nb_k*nb_i*nb_j == 0) {
+          continue;
+        }
+
+        auto h_size_in  = (!last_i || this->subtile_rem_hi==0) ? (this->fs == 1 ? this->FILTER_SIZE : this->F_BUFFER_SIZE) : this->subtile_rem_hi;
+        auto w_size_in  = (!last_j || this->subtile_rem_wi==0) ? (this->fs == 1 ? this->FILTER_SIZE : this->F_BUFFER_SIZE) : this->subtile_rem_wi;
+        auto h_size_out = (!last_i || this->subtile_rem_ho==0) ? this->FILTER_SIZE : this->subtile_rem_ho;
+        auto w_size_out = (!last_j || this->subtile_rem_wo==0) ? this->FILTER_SIZE : this->subtile_rem_wo;
+        int64_t tile = 0;
+
+        // STREAMIN_LOAD and LOAD, the 1x1 loads being padded to 9 cycles
+        auto load = 6 + (this->fs == 1 ? this->FILTER_SIZE*this->FILTER_SIZE : h_size_in*w_size_in);
+
+        // LOAD_MATRIXVEC and MATRIXVEC
+        if(this->depthwise) {
+          auto dw_lim = (last_k && this->subtile_rem_ki != this->TP_IN && this->subtile_rem_ki != 0) ? this->subtile_rem_ki : this->TP_IN;
+          tile += load + 22 + dw_lim*this->qw;
+        }
+        else {
+          auto mv_k_out_lim = (last_k && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) ? this->subtile_rem_ko : this->TP_OUT;
+          tile += this->subtile_nb_ki * (load + (this->fs == 1 ? 10 : 6) + mv_k_out_lim*(this->fs == 3 ? this->qw : 1) + 6);
+        }
+
+        // NORMQUANT_SHIFT, NORMQUANT_MULT and NORMQUANT_BIAS
+        if(this->output_quant) {
+          auto nq_lim = this->normalization_bits;
+          if(last_k && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) {
+            nq_lim = this->normalization_bits == 32 ? this->subtile_rem_ko :
+                     this->normalization_bits == 16 ? this->subtile_rem_ko / 2 + (this->subtile_rem_ko % 2 ? 1 : 0) :
+                                                      this->subtile_rem_ko / 4 + (this->subtile_rem_ko % 4 ? 1 : 0);
+          }
+          tile += (this->norm_option_shift ? 1 : 0) + nq_lim + (this->norm_option_bias ? 4 : 0);
+        }
+
+        // STREAMOUT, on all the columns of the rows before the last one
+        auto streamout_k_out_lim = this->quantization_bits == 32 ? tp/8 : 1;
+        if(last_k && this->subtile_rem_ko != tp && this->subtile_rem_ko != 0) {
+          streamout_k_out_lim = this->quantization_bits == 32 ? this->subtile_rem_ko/8 + (this->subtile_rem_ko%8 == 0 ? 0 : 1) : 1;
+        }
+        tile += ((h_size_out-1)*this->FILTER_SIZE + w_size_out) * streamout_k_out_lim;
+        if(this->fs == 1) {
+          tile += 9 - h_size_out*w_size_out * (this->output_quant ? this->quantization_bits/8 : 4);
+        }
+
+        cycles += nb_k*nb_i*nb_j * tile;
+      }
+    }
+  }
+
+  return cycles;
+}
+
+void Ne16::functional_layer() {
+  auto tp = this->depthwise ? this->TP_IN : this->TP_OUT;
+  auto nb_rows = this->FILTER_SIZE*this->FILTER_SIZE;
+  auto fbuf = this->F_BUFFER_SIZE;
+
+  this->l1_image.resize(NE16_STREAM_L1_MASK+1);
+  this->l1_image_valid.assign((NE16_STREAM_L1_MASK+1) / NE16_L1_IMAGE_BLOCK, false);
+  this->l1_image_dirty.assign(NE16_STREAM_L1_MASK+1, false);
+
+  std::vector<int64_t> accum(this->TP_OUT*this->NR_COLUMN);
+  std::vector<uint8_t> x_buffer(fbuf*fbuf*this->TP_IN);
+  std::vector<int32_t> row_enable(nb_rows, 1);
+  std::vector<uint8_t> nqs(this->TP_OUT);
+
+  // filter masking, all the rows being enabled in 1x1 mode
+  if(this->fs == 3) {
+    for(auto r=0; r<nb_rows; r++) {
+      auto i = r / this->FILTER_SIZE;
+      auto j = r % this->FILTER_SIZE;
+      if(i < this->filter_mask_top || j >= this->fs-this->filter_mask_right ||
+         i >= this->fs-this->filter_mask_bottom || j < this->filter_mask_left) {
+        row_enable[r] = 0;
+      }
+    }
+  }
+
+  // weight bits of the weight offset, as unpacked by the fsm
+  xt::xarray<uint8_t> woffs_ld = xt::zeros<uint8_t>({nb_rows, 2});
+  if(this->fs == 3)
+    xt::view(woffs_ld, xt::all()) = 0xff;
+  else
+    xt::view(woffs_ld, 0, xt::all()) = 0xff;
+  xt::xarray<uint8_t> woffs = __WeightUnpack(woffs_ld, nb_rows, false);
+
+  // weights of an output channel (of the input channel in depthwise mode), from
+  // the address of their first line. They are unpacked as in the fsm, and
+  // reused across the spatial tiles as long as their bytes are unchanged. In
+  // 3x3 mode, there is one line of 9 rows per weight bit; in 1x1 mode, a single
+  // line with one row per weight bit, the weight values being in the first row.
+  std::map<uint32_t, std::pair<std::vector<uint8_t>, std::vector<int32_t>>> weights;
+  auto weight_values = [&](uint32_t addr) -> std::vector<int32_t>& {
+    auto nb_lines = this->fs == 3 ? this->qw : 1;
+    auto line_rows = this->fs == 3 ? nb_rows : this->qw;
+    std::vector<uint8_t> raw(nb_lines*line_rows*2);
+    for(auto l=0; l<nb_lines; l++) {
+      for(auto i=0; i<line_rows*2; i++) {
+        raw[l*line_rows*2 + i] = this->l1_image_rd(addr + l*this->weights_d0_stride + i);
+      }
+    }
+    auto &entry = weights[addr];
+    if(entry.first != raw) {
+      entry.first = raw;
+      entry.second.assign(nb_rows*this->TP_IN, 0);
+      for(auto l=0; l<nb_lines; l++) {
+        xt::xarray<uint8_t> weight_ld = xt::zeros<uint8_t>({line_rows*2});
+        for(auto i=0; i<line_rows*2; i++) {
+          weight_ld(i) = raw[l*line_rows*2 + i];
+        }
+        auto weight = __WeightUnpack(weight_ld, line_rows, false);
+        for(auto r=0; r<line_rows; r++) {
+          for(auto k=0; k<this->TP_IN; k++) {
+            entry.second[(this->fs == 3 ? r : 0)*this->TP_IN + k] += weight(r, k) << (this->fs == 3 ? l : r);
+          }
+        }
+      }
+    }
+    return entry.second;
+  };
+
+  // activation of filter row r for output column c (x_array of the fsm)
+  auto x_array = [&](int c, int r, int k) -> int64_t {
+    if(this->fs == 3) {
+      return x_buffer[((c/3 + r/3)*fbuf + c%3 + r%3)*this->TP_IN + k];
+    }
+    return r < this->qw ? x_buffer[((c/3)*fbuf + c%3)*this->TP_IN + k] : 0;
+  };
+
+  for(auto k_out_major=0; k_out_major<this->subtile_nb_ko; k_out_major++) {
+    for(auto i_major=0; i_major<this->subtile_nb_ho; i_major++) {
+      for(auto j_major=0; j_major<this->subtile_nb_wo; j_major++) {
+        auto h_size_in  = (i_major < this->subtile_nb_ho-1 || this->subtile_rem_hi==0) ? (this->fs == 1 ? this->FILTER_SIZE : fbuf) : this->subtile_rem_hi;
+        auto w_size_in  = (j_major < this->subtile_nb_wo-1 || this->subtile_rem_wi==0) ? (this->fs == 1 ? this->FILTER_SIZE : fbuf) : this->subtile_rem_wi;
+        auto h_size_out = (i_major < this->subtile_nb_ho-1 || this->subtile_rem_ho==0) ? this->FILTER_SIZE : this->subtile_rem_ho;
+        auto w_size_out = (j_major < this->subtile_nb_wo-1 || this->subtile_rem_wo==0) ? this->FILTER_SIZE : this->subtile_rem_wo;
+        bool last_k_out = k_out_major == this->subtile_nb_ko-1;
+
+        std::fill(accum.begin(), accum.end(), 0);
+
+        auto k_in_major_lim = this->depthwise ? 1 : this->subtile_nb_ki;
+        for(auto k_in_major_iter=0; k_in_major_iter<k_in_major_lim; k_in_major_iter++) {
+          auto k_in_major = this->depthwise ? k_out_major : k_in_major_iter;
+
+          // LOAD
+          std::fill(x_buffer.begin(), x_buffer.end(), 0);
+          auto load_k_in_lim = (k_in_major == this->subtile_nb_ki-1 && this->subtile_rem_ki != this->TP_IN) ? this->subtile_rem_ki : this->TP_IN;
+          uint32_t base_addr_x = this->infeat_ptr + i_major*this->FILTER_SIZE*this->infeat_d1_stride + j_major*this->FILTER_SIZE*this->infeat_d0_stride + k_in_major*this->TP_IN;
+          for(auto i=0; i<h_size_in; i++) {
+            for(auto j=0; j<w_size_in; j++) {
+              uint32_t addr = base_addr_x + i*this->infeat_d1_stride + j*this->infeat_d0_stride;
+              for(auto k=0; k<load_k_in_lim; k++) {
+                x_buffer[(i*fbuf + j)*this->TP_IN + k] = this->l1_image_rd(addr + k);
+              }
+            }
+          }
+
+          // explicit padding, on the regions of load_do_padding
+          auto right_lim  = std::min(fbuf-this->padding_right, w_size_in);
+          auto bottom_lim = std::min(fbuf-this->padding_bottom, h_size_in);
+          auto pad = [&](int i_start, int i_end, int j_start, int j_end) {
+            for(auto i=i_start; i<i_end; i++) {
+              for(auto j=j_start; j<j_end; j++) {
+                for(auto k=0; k<load_k_in_lim; k++) {
+                  x_buffer[(i*fbuf + j)*this->TP_IN + k] = this->padding_value;
+                }
+              }
+            }
+          };
+          bool pad_top    = this->padding_top > 0 && i_major == 0;
+          bool pad_right  = this->padding_right > 0 && j_major == this->subtile_nb_wo-1;
+          bool pad_bottom = this->padding_bottom > 0 && i_major == this->subtile_nb_ho-1;
+          bool pad_left   = this->padding_left > 0 && j_major == 0;
+          if(pad_left || pad_top)     pad(0, this->padding_top, 0, this->padding_left);
+          if(pad_top)                 pad(0, this->padding_top, this->padding_left, right_lim);
+          if(pad_right || pad_top)    pad(0, this->padding_top, right_lim, w_size_in);
+          if(pad_right)               pad(this->padding_top, bottom_lim, right_lim, w_size_in);
+          if(pad_right || pad_bottom) pad(bottom_lim, h_size_in, right_lim, w_size_in);
+          if(pad_bottom)              pad(bottom_lim, h_size_in, this->padding_left, right_lim);
+          if(pad_left || pad_bottom)  pad(bottom_lim, h_size_in, 0, this->padding_left);
+          if(pad_left)                pad(this->padding_top, bottom_lim, 0, this->padding_left);
+
+          auto dw_lim = !this->depthwise ? 1 :
+                        (k_in_major == this->subtile_nb_ki-1 && this->subtile_rem_ki != this->TP_IN && this->subtile_rem_ki != 0) ? this->subtile_rem_ki : this->TP_IN;
+          for(auto dw_iter=0; dw_iter<dw_lim; dw_iter++) {
+
+            // weight offset, on all the output channels except in depthwise mode
+            for(auto c=0; c<this->NR_COLUMN; c++) {
+              int64_t sum = 0;
+              for(auto r=0; r<nb_rows; r++) {
+                if(row_enable[r] == 0) {
+                  continue;
+                }
+                int32_t row_sum = 0;
+                for(auto k=0; k<this->TP_IN; k++) {
+                  if(!this->depthwise || k == dw_iter) {
+                    row_sum += woffs(r, k) * x_array(c, r, k);
+                  }
+                }
+                // the block sums are 32-bit wide, Wmin included
+                sum += (int32_t) ((uint32_t) row_sum * (uint32_t) this->Wmin);
+              }
+              for(auto s=1; s<this->SHIFT_CYCLES; s++) {
+                if(this->depthwise) {
+                  accum[dw_iter*this->NR_COLUMN + c] += sum;
+                }
+                else {
+                  for(auto k_out=0; k_out<this->TP_OUT; k_out++) {
+                    accum[k_out*this->NR_COLUMN + c] += sum;
+                  }
+                }
+              }
+            }
+
+            // MATRIXVEC
+            uint32_t base_addr_W;
+            int mv_k_out_lim;
+            if(this->depthwise) {
+              base_addr_W = this->weights_ptr + (k_in_major*this->qw) * nb_rows * 2;
+              mv_k_out_lim = 1;
+            }
+            else {
+              base_addr_W = this->weights_ptr + (k_out_major*this->TP_OUT*this->subtile_nb_ki*this->qw + k_in_major*this->qw) * (this->fs == 3 ? nb_rows : 1) * 2;
+              mv_k_out_lim = (last_k_out && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) ? this->subtile_rem_ko : this->TP_OUT;
+            }
+
+            for(auto mv_k_out_iter=0; mv_k_out_iter<mv_k_out_lim; mv_k_out_iter++) {
+              auto k_out = this->depthwise ? dw_iter : mv_k_out_iter;
+              auto &weight = weight_values(base_addr_W + (this->depthwise ? 0 : mv_k_out_iter*this->weights_d1_stride));
+
+              for(auto c=0; c<this->NR_COLUMN; c++) {
+                int64_t sum = 0;
+                for(auto r=0; r<nb_rows; r++) {
+                  if(row_enable[r] == 0) {
+                    continue;
+                  }
+                  for(auto k=0; k<this->TP_IN; k++) {
+                    if(!this->depthwise || k == dw_iter) {
+                      sum += weight[r*this->TP_IN + k] * x_array(c, r, k);
+                    }
+                  }
+                }
+                accum[k_out*this->NR_COLUMN + c] += sum;
+              }
+            }
+          }
+        }
+
+        // NORMQUANT_SHIFT, NORMQUANT_MULT and NORMQUANT_BIAS
+        if(this->output_quant) {
+          if(this->norm_option_shift) {
+            for(auto k_out=0; k_out<this->TP_OUT; k_out++) {
+              nqs[k_out] = this->l1_image_rd(this->scale_shift_ptr + k_out_major*tp + k_out);
+            }
+          }
+
+          auto nq_bytes = this->normalization_bits/8;
+          auto nq_lim = this->normalization_bits;
+          if(last_k_out && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) {
+            nq_lim = this->normalization_bits == 32 ? this->subtile_rem_ko :
+                     this->normalization_bits == 16 ? this->subtile_rem_ko / 2 + (this->subtile_rem_ko % 2 ? 1 : 0) :
+                                                      this->subtile_rem_ko / 4 + (this->subtile_rem_ko % 4 ? 1 : 0);
+          }
+          uint32_t base_addr_nq = this->scale_ptr + k_out_major*tp*nq_bytes;
+          for(auto nq_iter=0; nq_iter<nq_lim; nq_iter++) {
+            for(auto i=0; i<4/nq_bytes; i++) {
+              uint32_t scale = 0;
+              for(auto b=0; b<nq_bytes; b++) {
+                scale |= this->l1_image_rd(base_addr_nq + nq_iter*4 + i*nq_bytes + b) << (b*8);
+              }
+              auto k_out = nq_iter*(4/nq_bytes) + i;
+              for(auto c=0; c<this->NR_COLUMN; c++) {
+                accum[k_out*this->NR_COLUMN + c] = (int64_t)((uint64_t)accum[k_out*this->NR_COLUMN + c] * scale);
+              }
+            }
+          }
+
+          uint32_t base_addr_nqb = this->scale_bias_ptr + k_out_major*tp*4;
+          for(auto nqb_iter=0; nqb_iter<4; nqb_iter++) {
+            // with tp/8 lines, the depthwise lines are read twice
+            uint32_t addr = base_addr_nqb + (nqb_iter % (tp/8))*32;
+            for(auto i=0; i<8; i++) {
+              auto k_out = nqb_iter*8 + i;
+              auto shift = this->norm_option_shift ? nqs[k_out] : this->quantization_right_shift;
+              int32_t bias = 0;
+              if(this->norm_option_bias) {
+                for(auto b=0; b<4; b++) {
+                  bias |= this->l1_image_rd(addr + i*4 + b) << (b*8);
+                }
+              }
+              // out-of-range shifts are taken modulo the width, as on the host
+              for(auto c=0; c<this->NR_COLUMN; c++) {
+                auto &value = accum[k_out*this->NR_COLUMN + c];
+                if(this->norm_option_bias) {
+                  value = (int32_t)((uint32_t)value + (uint32_t)bias) >> (shift & 31);
+                }
+                else {
+                  value = value >> (shift & 63);
+                }
+              }
+            }
+          }
+        }
+
+        // STREAMOUT, relu and clipping included
+        for(auto &value: accum) {
+          if(this->quantization_bits == 8) {
+            value = this->use_relu ? std::min<int64_t>(std::max<int64_t>(value, 0), 255) : std::min<int64_t>(std::max<int64_t>(value, -128), 127);
+          }
+          else if(this->use_relu && this->output_quant) {
+            value = std::min<int64_t>(std::max<int64_t>(value, 0), 0xffffffff);
+          }
+        }
+
+        auto k_out_last = (last_k_out && this->subtile_rem_ko != tp && this->subtile_rem_ko != 0) ? this->subtile_rem_ko : tp;
+        uint32_t base_addr_y = this->outfeat_ptr + i_major*this->FILTER_SIZE*this->outfeat_d2_stride + j_major*this->FILTER_SIZE*this->outfeat_d1_stride + k_out_major*tp*this->quantization_bits/8;
+        for(auto i=0; i<h_size_out; i++) {
+          for(auto j=0; j<w_size_out; j++) {
+            if(this->strided2x2 && (i == 1 || j == 1)) {
+              continue;
+            }
+            auto c = i*this->FILTER_SIZE + j;
+            uint32_t addr = base_addr_y + i*this->outfeat_d2_stride + j*this->outfeat_d1_stride;
+            if(this->quantization_bits == 8) {
+              for(auto k_out=0; k_out<k_out_last; k_out++) {
+                this->l1_image_wr(addr + k_out, accum[k_out*this->NR_COLUMN + c]);
+              }
+            }
+            else {
+              // one line of up to 8 output channels per word stride
+              for(auto k_out=0; k_out<k_out_last; k_out++) {
+                for(auto b=0; b<4; b++) {
+                  this->l1_image_wr(addr + (k_out/8)*this->outfeat_d0_stride + (k_out%8)*4 + b, accum[k_out*this->NR_COLUMN + c] >> (b*8));
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  this->l1_image_flush();
+}
+
+// L1 copy of the batched layer, each block being fetched through the backdoor
+// on its first access and the written bytes being written back by l1_image_flush
+uint8_t Ne16::l1_image_rd(uint32_t addr) {
+  addr &= NE16_STREAM_L1_MASK;
+  auto block = addr / NE16_L1_IMAGE_BLOCK;
+  if(!this->l1_image_valid[block]) {
+    auto block_addr = block * NE16_L1_IMAGE_BLOCK;
+    if(!this->l1_backdoor(block_addr, &this->l1_image[block_addr], NE16_L1_IMAGE_BLOCK, false)) {
+      this->trace.fatal("Functional mode failed to read L1 (addr=0x%x, size=%d)\n", block_addr, NE16_L1_IMAGE_BLOCK);
+    }
+    this->l1_image_valid[block] = true;
+  }
+  return this->l1_image[addr];
+}
+
+void Ne16::l1_image_wr(uint32_t addr, uint8_t value) {
+  addr &= NE16_STREAM_L1_MASK;
+  this->l1_image_rd(addr);
+  this->l1_image[addr] = value;
+  this->l1_image_dirty[addr] = true;
+}
+
+void Ne16::l1_image_flush() {
+  uint32_t size = this->l1_image_dirty.size();
+  uint32_t addr = 0;
+  while(addr < size) {
+    if(!this->l1_image_dirty[addr]) {
+      addr++;
+      continue;
+    }
+    uint32_t end = addr;
+    while(end < size && this->l1_image_dirty[end]) {
+      end++;
+    }
+    if(!this->l1_backdoor(addr, &this->l1_image[addr], end-addr, true)) {
+      this->trace.fatal("Functional mode failed to write L1 (addr=0x%x, size=%d)\n", addr, end-addr);
+    }
+    addr = end;
+  }
+}
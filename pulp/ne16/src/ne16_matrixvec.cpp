@@ -91,6 +91,8 @@ void Ne16::__BinConvArray(
     for(auto r=0; r<this->COLUMN_SIZE; r++) { // spatial loop - over blocks in a column
       if(row_enable(r) == 0) // row disabling to implement filter masks
         continue;
+      if(r >= weight.shape()[0]) // 1x1 mode only unpacks qw rows of weights
+        continue;
       auto scale_loc = use_row_as_scale ? 1 << r : scale;
       auto activ = xt::view(this->x_array, c, r, xt::all()); // 16x channels of 8-bit
       if(this->binconv_traces) {
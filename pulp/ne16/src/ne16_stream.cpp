@@ -29,9 +29,12 @@
 #include "xtensor/xpad.hpp"
 #include <ne16.hpp>
 
-// the NE16 can only access L1 memory in the range 0xY000_0000 -- 0xY001_FFFC, where Y=1 or 0
-// in the model, Y is ignored
-#define NE16_STREAM_L1_MASK 0x0001FFFF
+// the timed path masks each access, so a line crossing the end of the L1 range
+// wraps around to its start. The backdoor access is only equivalent when the
+// line does not cross it.
+static inline bool ne16_stream_l1_contiguous(uint32_t addr, int size) {
+  return (addr & NE16_STREAM_L1_MASK) + size <= NE16_STREAM_L1_MASK + 1;
+}
 
 Ne16StreamAccess::Ne16StreamAccess(
   Ne16 *ne16,
@@ -165,38 +168,44 @@ xt::xarray<T> Ne16VectorLoad<T>::ex(int width, int64_t& cycles) {
   auto width_words = width_padded*sizeof(T)/4;
   auto width_rem   = width_padded*sizeof(T)%4;
   int64_t max_latency = 0;
-  for(auto i=0; i<width_words; i++) {
-    this->ne16->io_req.init();
-    this->ne16->io_req.set_addr(addr_padded+i*4 & NE16_STREAM_L1_MASK);
-    this->ne16->io_req.set_size(4);
-    this->ne16->io_req.set_data(load_data+i*4);
-    this->ne16->io_req.set_is_write(false);
-    int err = this->ne16->out.req(&this->ne16->io_req);
-    if (err == vp::IO_REQ_OK) {
-      int64_t latency = this->ne16->io_req.get_latency();
-      if (latency > max_latency) {
-        max_latency = latency;
+  // in functional mode, the whole line is read at once through the L1 backdoor
+  bool backdoor = this->ne16->functional &&
+    ne16_stream_l1_contiguous(addr_padded, width_padded*sizeof(T)) &&
+    this->ne16->l1_backdoor(addr_padded & NE16_STREAM_L1_MASK, load_data, width_padded*sizeof(T), false);
+  if(!backdoor) {
+    for(auto i=0; i<width_words; i++) {
+      this->ne16->io_req.init();
+      this->ne16->io_req.set_addr(addr_padded+i*4 & NE16_STREAM_L1_MASK);
+      this->ne16->io_req.set_size(4);
+      this->ne16->io_req.set_data(load_data+i*4);
+      this->ne16->io_req.set_is_write(false);
+      int err = this->ne16->out.req(&this->ne16->io_req);
+      if (err == vp::IO_REQ_OK) {
+        int64_t latency = this->ne16->io_req.get_latency();
+        if (latency > max_latency) {
+          max_latency = latency;
+        }
+      }
+      else {
+        this->ne16->trace.fatal("Unsupported asynchronous reply\n");
       }
     }
-    else {
-      this->ne16->trace.fatal("Unsupported asynchronous reply\n");
-    }
-  }
-  if(width_rem) {
-    this->ne16->io_req.init();
-    this->ne16->io_req.set_addr(addr_padded+width_words*4 & NE16_STREAM_L1_MASK);
-    this->ne16->io_req.set_size(width_rem);
-    this->ne16->io_req.set_data(load_data+width_words*4);
-    this->ne16->io_req.set_is_write(false);
-    int err = this->ne16->out.req(&this->ne16->io_req);
-    if (err == vp::IO_REQ_OK) {
-      // int64_t latency = this->ne16->io_req.get_latency();
-      // if (latency > max_latency) {
-      //   max_latency = latency;
-      // }
-    }
-    else {
-      this->ne16->trace.fatal("Unsupported asynchronous reply\n");
+    if(width_rem) {
+      this->ne16->io_req.init();
+      this->ne16->io_req.set_addr(addr_padded+width_words*4 & NE16_STREAM_L1_MASK);
+      this->ne16->io_req.set_size(width_rem);
+      this->ne16->io_req.set_data(load_data+width_words*4);
+      this->ne16->io_req.set_is_write(false);
+      int err = this->ne16->out.req(&this->ne16->io_req);
+      if (err == vp::IO_REQ_OK) {
+        // int64_t latency = this->ne16->io_req.get_latency();
+        // if (latency > max_latency) {
+        //   max_latency = latency;
+        // }
+      }
+      else {
+        this->ne16->trace.fatal("Unsupported asynchronous reply\n");
+      }
     }
   }
   std::ostringstream stringStream;
@@ -248,7 +257,11 @@ xt::xarray<T> Ne16VectorStore<T>::ex(xt::xarray<T> data, int width, int64_t& cyc
   }
   auto width_bytes = width*sizeof(T);
   int64_t max_latency = 0;
-  if(enable) {
+  // in functional mode, the whole line is written at once through the L1 backdoor
+  bool backdoor = enable && this->ne16->functional &&
+    ne16_stream_l1_contiguous(addr, width_bytes) &&
+    this->ne16->l1_backdoor(addr & NE16_STREAM_L1_MASK, store_data, width_bytes, true);
+  if(enable && !backdoor) {
     for(auto i=0; i<width_bytes; i++) {
       this->ne16->io_req.init();
       this->ne16->io_req.set_addr(addr+i & NE16_STREAM_L1_MASK);
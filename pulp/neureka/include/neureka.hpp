@@ -25,6 +25,7 @@
 
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
+#include <vp/debug_mem.hpp>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -40,6 +41,7 @@
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xvectorize.hpp"
 #include "xtensor/xpad.hpp"
+#include "neureka_binconv.hpp"
 
 #define NEUREKA_REG_WEIGHTS_PTR       0
 #define NEUREKA_REG_INFEAT_PTR        1
@@ -116,6 +118,10 @@ class Neureka;
 
 #define STREAM_MAX_WIDTH_BYTES 40
 
+// the NEUREKA can only access L1 memory in the range 0xY000_0000 -- 0xY003_FFFC, where Y=1 or 0
+// in the model, Y is ignored
+#define NEUREKA_STREAM_L1_MASK 0x0003FFFF
+
 class NeurekaStreamAccess {
   public:
     NeurekaStreamAccess(
@@ -198,6 +204,10 @@ class NeurekaVectorStore : public NeurekaStreamAccess {
     xt::xarray<T> ex(xt::xarray<T> data, int width, int64_t& cycles, int32_t enable);
 };
 
+// Shape of the default NEUREKA configuration, handled by the fixed-shape
+// BinConv engine. Other configurations use the xtensor model.
+typedef NeurekaBinConvEngine<32, 9, 36> NeurekaBinConv;
+
 class Neureka : public vp::Component
 {
     friend class Neureka_base;
@@ -217,6 +227,12 @@ public:
     NeurekaTraceLevel trace_level;
     int trace_format;
 
+    // FUNCTIONAL mode: the whole job runs when it is started, as one batched
+    // layer kernel working on a copy of L1 fetched through the debug backdoor of
+    // the memory, and the job duration is estimated from the layer parameters
+    bool functional;
+    bool l1_backdoor(uint64_t addr, uint8_t *data, int size, bool is_write);
+
 private:
 
     // HARDWARE parameters
@@ -266,6 +282,15 @@ private:
     // MAIN FSM and LOOP
     int  fsm();
     void fsm_loop();
+    void fsm_functional();
+
+    // FUNCTIONAL mode batched layer
+    bool functional_batched();
+    void functional_layer();
+    int64_t functional_latency();
+    uint8_t l1_image_rd(uint32_t addr);
+    void l1_image_wr(uint32_t addr, uint8_t value);
+    void l1_image_flush();
     //NeurekaState state;
 
     // REGISTER FILE member functions
@@ -363,6 +388,13 @@ private:
     int state_phase_track_cycles;
     bool state_phase_track_valid;
     int64_t state_phase_track_start_cycle;
+    int64_t functional_cycles;        // cycles elapsed in the job being run in functional mode
+    vp::DebugMemIf *l1_debug_mem;     // backdoor to L1, NULL if the target has none
+    bool l1_debug_mem_resolved;
+    vp::DebugMemIf *l1_backdoor_if();
+    std::vector<uint8_t> l1_image;      // copy of the L1 range, fetched by blocks
+    std::vector<bool> l1_image_valid;   // blocks of l1_image fetched from L1
+    std::vector<bool> l1_image_dirty;   // bytes of l1_image to write back to L1
 
 
     // STATEFUL BUFFERS
@@ -375,6 +407,8 @@ private:
     xt::xarray<int8_t> x_array;     // reordered feature array (no actual storage in NEUREKA)
     xt::xarray<uint8_t> weight;      // input weight stream
     xt::xarray<uint8_t> dw_weight_buffer;//fake weight buffer to save dw weight without refetching it continuously
+    NeurekaBinConv *binconv;         // fixed-shape BinConv model, NULL when the configuration does not match its shape
+    bool x_array_dirty;              // x_array changed since the BinConv engine last read it
 
     // CLEAR
     void clear_all();
@@ -411,6 +445,7 @@ private:
     bool matrixvec_to_matrixvec_idx();
     // internal functions
     void __BinConvArray(xt::xarray<uint8_t>&, int, int, xt::xarray<int32_t>, xt::xarray<int32_t>, bool=false, bool=false, bool=false);
+    bool __BinConvArrayPacked(const uint8_t *, int, int, int, xt::xarray<int32_t>&, xt::xarray<int32_t>&, bool=false, bool=false, bool=false);
     void __weightoffs(int, xt::xarray<int32_t>, xt::xarray<int32_t>);
     
     // NORMQUANT
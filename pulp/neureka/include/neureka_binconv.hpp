@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2020-2022  GreenWaves Technologies, ETH Zurich, University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NEUREKA_BINCONV_HPP__
+#define __NEUREKA_BINCONV_HPP__
+
+#include <stdint.h>
+#include <string.h>
+
+// Same as __Weight_transform_1x1, on raw bytes: 32 bytes in, 32 bytes out
+static inline void neureka_weight_transform_1x1(const uint8_t *W, uint8_t *wout)
+{
+  for(int i=0; i<32; i++)
+  {
+    int index_q8 = i/8;
+    int index_r4 = i%4;
+    int index_q4r2 = (i/4)%2;
+    int index_l = 8*index_r4+index_q8;
+    int index_h = 8*index_r4+index_q8+4;
+    if(index_q4r2==0)
+      wout[i] = (W[index_l] & 0x0F) + ((W[index_h] & 0x0F)<<4);
+    else
+      wout[i] = ((W[index_l] & 0xF0)>>4) + 16*((W[index_h] & 0xF0)>>4);
+  }
+}
+
+// Same as __Weight_transform_28, on raw bytes: 32 bytes in, 36 bytes out
+static inline void neureka_weight_transform_28(const uint8_t *W, uint8_t *wout)
+{
+  memset(wout, 0, 36);
+  for(int i=0; i<32; i++)
+  {
+    int index0 = i % 7;
+    int index1 = i / 7;
+    if(index0==3)
+    {
+      wout[index1*8+index0] = (W[i] & 0x0F);
+    }
+    else if(index0>3)
+    {
+      wout[index1*8+index0] = ((W[i-1] & 0xF0) >> 4) + ((W[i] & 0x0F)*16);
+      if(index0==6)
+        wout[index1*8+index0+1] = ((W[i] & 0xF0) >> 4);
+    }
+    else
+    {
+      wout[index1*8+index0] = W[i];
+    }
+  }
+}
+
+/*
+ * Fixed-shape model of the BinConv array, bit-exact with
+ * Neureka::__BinConvArray.
+ *
+ * Weights are binary, so each block computes sum(w[i] * x[i]) over the TP_IN
+ * input channels with w[i] in {0, 1}. Activations are kept as 8 bit-planes
+ * of TP_IN bits per block, rebuilt only when the activation array changes,
+ * and the dot product becomes 8 popcounts of (weight mask & plane), bit 7
+ * counting as -128 for signed activations. All buffers have a compile-time
+ * size so nothing is allocated per cycle.
+ */
+template<int TP_IN, int COLUMN_SIZE, int NR_COLUMN>
+class NeurekaBinConvEngine
+{
+  static_assert(TP_IN % 8 == 0, "TP_IN must be a multiple of 8");
+  static_assert(COLUMN_SIZE <= 32, "Row enables are kept in a 32-bit mask");
+
+public:
+  static constexpr int NB_WORDS = (TP_IN + 63) / 64;
+  static constexpr int ROW_BYTES = TP_IN / 8;
+  static constexpr int NB_ROWS = COLUMN_SIZE;
+
+  // Build the bit-planes from the activation array, laid out as
+  // [NR_COLUMN][COLUMN_SIZE][TP_IN] bytes.
+  void load_activations(const int8_t *x_array)
+  {
+    for(int c=0; c<NR_COLUMN; c++) {
+      for(int r=0; r<COLUMN_SIZE; r++) {
+        const uint8_t *x = (const uint8_t *)&x_array[(c*COLUMN_SIZE + r)*TP_IN];
+        uint64_t (*planes)[NB_WORDS] = this->planes[c][r];
+        memset(planes, 0, sizeof(this->planes[c][r]));
+
+        for(int i=0; i<TP_IN; i+=8) {
+          uint64_t bytes;
+          memcpy(&bytes, &x[i], 8);
+          for(int b=0; b<8; b++) {
+            // Gather bit b of the 8 bytes into 8 consecutive bits, byte k
+            // giving bit k (little-endian host)
+            uint64_t bits = (((bytes >> b) & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56;
+            planes[b][i/64] |= bits << (i%64);
+          }
+        }
+      }
+    }
+  }
+
+  // Set the MAC enables, one per input channel. Returns false if one of them
+  // does not act as a single bit once applied to the weights, which the
+  // engine can not represent.
+  bool set_mac_enable(const int32_t *mac_enable)
+  {
+    memset(this->mac_mask, 0, sizeof(this->mac_mask));
+    for(int i=0; i<TP_IN; i++) {
+      uint8_t enable = (uint8_t)mac_enable[i];
+      if(enable > 1)
+        return false;
+      this->mac_mask[i/64] |= (uint64_t)enable << (i%64);
+    }
+    return true;
+  }
+
+  // Equivalent of __BinConvArray, with the weights given packed as nb_rows
+  // rows of TP_IN/8 bytes (bit i of a row is input channel i) and the row
+  // enables as a mask. Rows beyond nb_rows have null weights.
+  // psum_block is [NR_COLUMN][COLUMN_SIZE], psum_column [NR_COLUMN] and
+  // accum [tp_out][NR_COLUMN].
+  void compute(const uint8_t *weight, int nb_rows, int scale, int idx, uint32_t row_mask,
+    bool signed_activation, bool weight_shift, bool weight_invert, bool use_row_as_scale,
+    int tp_out, int64_t *psum_block, int64_t *psum_column, int64_t *accum)
+  {
+    uint64_t weights[COLUMN_SIZE][NB_WORDS];
+    memset(weights, 0, sizeof(weights));
+    for(int r=0; r<COLUMN_SIZE && r<nb_rows; r++) {
+      for(int w=0; w<NB_WORDS; w++) {
+        int size = TP_IN/8 - w*8 < 8 ? TP_IN/8 - w*8 : 8;
+        memcpy(&weights[r][w], &weight[r*(TP_IN/8) + w*8], size);
+        weights[r][w] &= this->mac_mask[w];
+      }
+    }
+
+    for(int c=0; c<NR_COLUMN; c++) {
+      int64_t column = 0;
+      for(int r=0; r<COLUMN_SIZE; r++) {
+        if(((row_mask >> r) & 1) == 0)
+          continue;
+
+        uint64_t (*planes)[NB_WORDS] = this->planes[c][r];
+        int32_t sum = 0;
+        for(int w=0; w<NB_WORDS; w++) {
+          uint64_t mask = weights[r][w];
+          for(int b=0; b<7; b++)
+            sum += __builtin_popcountll(mask & planes[b][w]) << b;
+          int msb = __builtin_popcountll(mask & planes[7][w]) << 7;
+          sum += signed_activation ? -msb : msb;
+        }
+
+        // The reference computes the block in int, keep its wrap-around
+        uint32_t scale_loc = use_row_as_scale ? 1 << r : scale;
+        int64_t block = (int32_t)((uint32_t)sum * scale_loc);
+        if(weight_shift && weight_invert)
+          block = -block;
+        psum_block[c*COLUMN_SIZE + r] = block;
+        column += block;
+      }
+
+      psum_column[c] = column;
+      if(weight_shift) {
+        for(int k=0; k<tp_out; k++)
+          accum[k*NR_COLUMN + c] += column;
+      }
+      else {
+        accum[idx*NR_COLUMN + c] += column;
+      }
+    }
+  }
+
+private:
+  // Bit-plane b of the activations of block (c, r)
+  uint64_t planes[NR_COLUMN][COLUMN_SIZE][8][NB_WORDS];
+  uint64_t mac_mask[NB_WORDS];
+};
+
+#endif
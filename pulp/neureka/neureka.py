@@ -36,7 +36,8 @@ class Neureka(st.Component):
                 overhead_ld_1x1 : int=19,
                 overhead_ld_3x3 : int=31,
                 overhead_mv     : int=17,
-                quant_per_cycle : int=4):
+                quant_per_cycle : int=4,
+                functional      : bool=False):
 
         super(Neureka, self).__init__(parent, name)
 
@@ -58,5 +59,6 @@ class Neureka(st.Component):
             "overhead_ld_1x1"   :   overhead_ld_1x1,
             "overhead_ld_3x3"   :   overhead_ld_3x3,
             "overhead_mv"       :   overhead_mv,
-            "quant_per_cycle"   :   quant_per_cycle
+            "quant_per_cycle"   :   quant_per_cycle,
+            "functional"        :   functional
         })
@@ -44,6 +44,12 @@ Neureka::Neureka(vp::ComponentConf &config)
     this->OVERHEAD_LD_3X3 = this->get_js_config()->get_child_int("overhead_ld_3x3");
     this->OVERHEAD_MV     = this->get_js_config()->get_child_int("overhead_mv");
     this->QUANT_PER_CYCLE = this->get_js_config()->get_child_int("quant_per_cycle");
+    this->functional      = this->get_js_config()->get_child_bool("functional");
+
+    if(this->TP_IN == 32 && this->COLUMN_SIZE == 9 && this->NR_COLUMN == 36)
+      this->binconv = new NeurekaBinConv();
+    else
+      this->binconv = NULL;
 
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
     this->new_reg("fsm_state", &this->state, 32);//public in hpp
@@ -72,6 +78,7 @@ void Neureka::reset(bool active)
     this->accum           = xt::zeros<int64_t>({this->TP_OUT, this->NR_COLUMN});
     this->x_buffer        = xt::zeros<uint8_t>({this->F_BUFFER_SIZE, this->F_BUFFER_SIZE, this->TP_IN});
     this->x_array         = xt::zeros<uint8_t>({this->NR_COLUMN, this->COLUMN_SIZE, this->TP_IN}); 
+    this->x_array_dirty   = true;
     this->weight          = xt::zeros<uint8_t>({this->FILTER_SIZE*this->FILTER_SIZE, (this->TP_IN/8)});
     this->dw_weight_buffer= xt::zeros<uint8_t>({8, 32});//<8 bits of weight so 8 cycles, 32*8 is the bw offered>
     this->nqs             = xt::zeros<uint8_t>({this->TP_OUT});
@@ -85,6 +92,34 @@ void Neureka::reset(bool active)
     this->state_phase_track_cycles = 0;
     this->state_phase_track_valid = false;
     this->state_phase_track_start_cycle = 0;
+    this->functional_cycles = 0;
+    this->l1_debug_mem = NULL;
+    this->l1_debug_mem_resolved = false;
+}
+
+// Backdoor to L1 used in functional mode, NULL if the L1 target has none
+vp::DebugMemIf *Neureka::l1_backdoor_if()
+{
+    if(!this->l1_debug_mem_resolved) {
+      this->l1_debug_mem_resolved = true;
+      std::vector<vp::SlavePort *> finals = this->out.get_final_ports();
+      if(!finals.empty() && finals[0]->get_owner() != NULL) {
+        this->l1_debug_mem = finals[0]->get_owner()->debug_mem_if();
+      }
+      if(this->l1_debug_mem == NULL) {
+        this->trace.msg(vp::Trace::LEVEL_WARNING, "No backdoor to L1, functional mode will use the timed port\n");
+      }
+    }
+    return this->l1_debug_mem;
+}
+
+// Backdoor access to L1 used in functional mode. Returns false when the L1
+// target has no backdoor or rejects the access, in which case the caller goes
+// through the timed port.
+bool Neureka::l1_backdoor(uint64_t addr, uint8_t *data, int size, bool is_write)
+{
+    vp::DebugMemIf *l1_debug_mem = this->l1_backdoor_if();
+    return l1_debug_mem != NULL && l1_debug_mem->debug_mem_access(addr, data, size, is_write) == 0;
 }
 
 // The `hwpe_slave` member function models an access to the NEUREKA SLAVE interface
@@ -38,6 +38,8 @@ void Neureka::clear_all() {
   this->k_out_lim_dw = 0;
   this->dw_lim = 0;
   this->dw_iter = 0;
+  this->matrixvec_latency = 0;
+  this->load_latency = 0;
 
   // ACCUM_STREAMIN state
   this->streamin_ij_out = 0;
@@ -75,5 +77,6 @@ void Neureka::clear_accum() {
 void Neureka::clear_x_buffer() {
   xt::view(this->x_buffer, xt::all()) = 0;
   xt::view(this->x_array,  xt::all()) = 0;
+  this->x_array_dirty = true;
 }
 
@@ -107,7 +107,12 @@ void Neureka::fsm_start_handler(vp::Block *__this, vp::ClockEvent *event) {
     _this->w_out = 1;
   }
 
-  _this->fsm_loop();
+  if(_this->functional) {
+    _this->fsm_functional();
+  }
+  else {
+    _this->fsm_loop();
+  }
 }
 
 void Neureka::fsm_handler(vp::Block *__this, vp::ClockEvent *event) {
@@ -199,6 +204,32 @@ void Neureka::fsm_loop() {
   }
 }
 
+// Functional mode: run the whole job at once and end it after its estimated
+// cycles. Jobs supported by the batched layer kernel skip the fsm steps, the
+// others run them back to back, accounting for their latency.
+void Neureka::fsm_functional() {
+  this->functional_cycles = 0;
+  if(this->functional_batched()) {
+    this->fsm(); // JOB_START: job activity and configuration printout
+    this->functional_cycles = this->functional_latency();
+    this->functional_layer();
+    this->state.set(JOB_END);
+  }
+  else {
+    do {
+      this->functional_cycles += this->fsm();
+    } while(state.get() != JOB_END);
+  }
+
+  if (trace_at_least(this->trace_level, NEUREKA_L3_ALL)) {
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Functional job done, estimated latency=%lld\n", (long long)this->functional_cycles);
+  }
+
+  this->event_enqueue(this->fsm_end_event, this->functional_cycles > 0 ? this->functional_cycles : 1);
+  this->end_cycles = this->fsm_end_event->get_cycle();
+  this->functional_cycles = 0;
+}
+
 int Neureka::fsm() {
   auto state_cur = this->state.get();
   auto state_next = state_cur;
@@ -558,7 +589,7 @@ int Neureka::fsm() {
   }
 
   if (trace_state_phase_summary_only(this->trace_level)) {
-    const int64_t current_cycle = this->clock.get_cycles();
+    const int64_t current_cycle = this->clock.get_cycles() + this->functional_cycles;
     if (!this->state_phase_track_valid || this->state_phase_track_state != state_cur) {
       this->state_phase_track_state = static_cast<NeurekaState>(state_cur);
       this->state_phase_track_cycles = 0;
@@ -0,0 +1,544 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Functional mode batched layer of NEUREKA.
+ *
+ * The whole job runs as one convolution kernel over plain integer arrays,
+ * instead of the fsm steps with their streamers and xtensor buffers. Tiles are
+ * computed in the fsm order and with its arithmetic, the binary weight lines of
+ * all the bits being summed into integer weights once per output channel, so
+ * that L1 ends up as in timed mode. L1 is accessed through a copy, fetched by
+ * blocks through the debug backdoor when first touched and written back at the
+ * end of the job.
+ *
+ * The job duration is estimated from the layer parameters, tile by tile: it is
+ * the sum of the fsm step latencies with single-cycle L1 accesses, including
+ * the overlap of the matrixvec phases with the next load when activations are
+ * prefetched.
+ */
+
+#include <neureka.hpp>
+#include <map>
+
+#define NEUREKA_L1_IMAGE_BLOCK 64
+
+bool Neureka::functional_batched() {
+  auto tp = this->depthwise ? this->TP_IN_S : this->TP_OUT;
+
+  // traces beyond the configuration printout are produced by the fsm steps
+  if(this->trace_level != NEUREKA_L0_JOB_START_END && this->trace_level != NEUREKA_L1_CONFIG) {
+    return false;
+  }
+  // streamin, 16-bit, linear and 16-bit output modes only run through the fsm,
+  // as well as the weights read from the weight memory
+  if(this->streamin || this->mode16 || this->mode_linear || this->weight_demux ||
+     (this->quantization_bits != 8 && this->quantization_bits != 32)) {
+    return false;
+  }
+  if(this->output_quant && this->normalization_bits > 32) {
+    return false;
+  }
+  // the weight lines are only laid out for the shape of the BinConv engine
+  if(this->binconv == NULL || this->FILTER_SIZE*this->FILTER_SIZE > NeurekaBinConv::NB_ROWS || this->H_SIZE != this->W_SIZE) {
+    return false;
+  }
+  // configurations outside of the tile buffers
+  if(this->subtile_nb_ko < 1 || this->subtile_nb_ki < 1 || this->subtile_nb_ho < 1 || this->subtile_nb_wo < 1 ||
+     this->subtile_rem_ko > tp || this->subtile_rem_ki > this->TP_IN ||
+     this->subtile_rem_ho > this->H_SIZE || this->subtile_rem_wo > this->W_SIZE ||
+     this->subtile_rem_hi > this->F_BUFFER_SIZE || this->subtile_rem_wi > this->F_BUFFER_SIZE ||
+     this->padding_top >= this->F_BUFFER_SIZE || this->padding_right >= this->F_BUFFER_SIZE ||
+     this->padding_bottom >= this->F_BUFFER_SIZE || this->padding_left >= this->F_BUFFER_SIZE) {
+    return false;
+  }
+  // depthwise jobs without any output channel
+  if(this->depthwise && this->subtile_nb_ko == 1 && this->subtile_rem_ko == 0) {
+    return false;
+  }
+  return this->l1_backdoor_if() != NULL;
+}
+
+int64_t Neureka::functional_latency() {
+  auto tp = this->depthwise ? this->TP_IN_S : this->TP_OUT;
+  auto k_in_major_lim = this->depthwise ? 1 : this->subtile_nb_ki;
+  int64_t cycles = 0;
+  int64_t matrixvec_latency = 0;
+  int64_t load_latency = 0;
+
+  for(auto k_out_major=0; k_out_major<this->subtile_nb_ko; k_out_major++) {
+    bool last_k = k_out_major == this->subtile_nb_ko-1;
+    for(auto i_major=0; i_major<this->subtile_nb_ho; i_major++) {
+      bool last_i = i_major == this->subtile_nb_ho-1;
+      for(auto j_major=0; j_major<this->subtile_nb_wo; j_major++) {
+        bool last_j = j_major == this->subtile_nb_wo-1;
+
+        auto h_size_in  = (!last_i || this->subtile_rem_hi==0) ? (this->fs == 1 ? this->H_SIZE : this->H_SIZE+this->FILTER_SIZE-1) : this->subtile_rem_hi;
+        auto w_size_in  = (!last_j || this->subtile_rem_wi==0) ? (this->fs == 1 ? this->W_SIZE : this->W_SIZE+this->FILTER_SIZE-1) : this->subtile_rem_wi;
+        auto h_size_out = (!last_i || this->subtile_rem_ho==0) ? this->H_SIZE : this->subtile_rem_ho;
+        auto w_size_out = (!last_j || this->subtile_rem_wo==0) ? this->W_SIZE : this->subtile_rem_wo;
+        auto mv_k_out_lim = this->depthwise ? 1 :
+                            (last_k && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) ? this->subtile_rem_ko : this->TP_OUT;
+        auto mv_qw_lim = this->fs == 3 ? this->qw : 1;
+        // in depthwise mode, k_in_major follows k_out_major
+        auto dw_lim = !this->depthwise ? 1 :
+                      (last_k && this->subtile_rem_ki != this->TP_IN_S && this->subtile_rem_ki != 0) ? this->subtile_rem_ki : this->TP_IN_S;
+
+        for(auto k_in_major_iter=0; k_in_major_iter<k_in_major_lim; k_in_major_iter++) {
+          // the matrixvec of the last load of the job is not overlapped
+          bool last = last_i && last_j && k_in_major_iter == k_in_major_lim-1;
+
+          // LOAD_PREPARE and ACTIVATION_LOAD, the 1x1 loads being padded
+          int64_t load = h_size_in*w_size_in;
+          if(this->fs == 1) {
+            load += this->H_SIZE*this->W_SIZE - h_size_in*w_size_in + 6;
+          }
+          cycles += 6 + load;
+          load_latency = 3 + load;
+
+          for(auto dw_iter=0; dw_iter<dw_lim; dw_iter++) {
+            // MATRIXVEC_PREPARE
+            if(this->activation_prefetch && matrixvec_latency > load_latency) {
+              cycles += matrixvec_latency - load_latency;
+            }
+            matrixvec_latency = 0;
+            if(this->depthwise && dw_iter == 0) {
+              cycles += 34;
+              matrixvec_latency = this->activation_prefetch ? 34 : 0;
+            }
+            else if(!this->depthwise) {
+              auto prepare = this->activation_prefetch ? (this->fs == 1 ? 3 : 6) : (this->fs == 1 ? 10 : 6);
+              cycles += prepare;
+              matrixvec_latency = this->activation_prefetch ? prepare : 0;
+            }
+
+            // MATRIX_VECTOR_COMPUTE, the depthwise weights being only read once
+            int64_t compute = (this->depthwise && dw_iter > 0) ? 0 : mv_k_out_lim*mv_qw_lim;
+            int64_t overhead = (!this->depthwise && this->fs == 3) ? 8 : 0;
+            if(this->activation_prefetch && !last) {
+              matrixvec_latency += compute + overhead;
+            }
+            else {
+              cycles += compute + overhead;
+              if(this->activation_prefetch && this->fs == 1) {
+                cycles += 10;
+                matrixvec_latency += 10;
+              }
+            }
+          }
+        }
+
+        // NORM_SHIFT, NORM_MULTIPLY and NORM_BIAS_SHIFT
+        if(this->output_quant) {
+          auto nq_lim = this->normalization_bits;
+          if(last_k && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) {
+            nq_lim = this->normalization_bits == 32 ? this->subtile_rem_ko :
+                     this->normalization_bits == 16 ? this->subtile_rem_ko / 2 + (this->subtile_rem_ko % 2 ? 1 : 0) :
+                                                      this->subtile_rem_ko / 4 + (this->subtile_rem_ko % 4 ? 1 : 0);
+          }
+          cycles += (this->norm_option_shift ? 8 : 0) + nq_lim + 9 + (this->norm_option_bias ? 4 : 0) + 8;
+        }
+
+        // OUTPUT_STREAMOUT, on all the columns of the rows before the last one
+        auto streamout_k_out_lim = this->quantization_bits == 32 ? (this->depthwise ? this->TP_IN/8 : tp/8) : 1;
+        if(last_k && this->subtile_rem_ko != tp && this->subtile_rem_ko != 0) {
+          streamout_k_out_lim = this->quantization_bits == 32 ? this->subtile_rem_ko/8 + (this->subtile_rem_ko%8 == 0 ? 0 : 1) : 1;
+        }
+        cycles += ((h_size_out-1)*this->W_SIZE + w_size_out) * streamout_k_out_lim + (this->fs == 1 ? 3 : 0);
+      }
+    }
+  }
+
+  return cycles;
+}
+
+void Neureka::functional_layer() {
+  auto tp = this->depthwise ? this->TP_IN_S : this->TP_OUT;
+  auto fbuf = this->F_BUFFER_SIZE;
+  auto nb_rows = this->COLUMN_SIZE;
+  auto row_bytes = NeurekaBinConv::ROW_BYTES;
+
+  this->l1_image.resize(NEUREKA_STREAM_L1_MASK+1);
+  this->l1_image_valid.assign((NEUREKA_STREAM_L1_MASK+1) / NEUREKA_L1_IMAGE_BLOCK, false);
+  this->l1_image_dirty.assign(NEUREKA_STREAM_L1_MASK+1, false);
+
+  std::vector<int64_t> accum(this->TP_OUT*this->NR_COLUMN);
+  std::vector<uint8_t> x_buffer(fbuf*fbuf*this->TP_IN);
+  std::vector<int32_t> x_array(this->NR_COLUMN*nb_rows*this->TP_IN);
+  std::vector<uint8_t> nqs(this->TP_OUT);
+
+  // rows of the x_array holding distinct activations: the filter rows in 3x3
+  // mode, a single one in 1x1 mode where the first qw rows hold the same pixel
+  // and the weight bits are summed with their row as scale. All the rows are
+  // enabled in 1x1 mode, otherwise the filter masking applies.
+  auto x_rows = this->fs == 3 ? this->FILTER_SIZE*this->FILTER_SIZE : 1;
+  std::vector<bool> row_enable(x_rows);
+  for(auto r=0; r<x_rows; r++) {
+    row_enable[r] = this->fs != 3 || ((this->filter_mask_top >> r) & 1) == 0;
+  }
+  // input channels with a MAC enabled, out of depthwise mode
+  auto k_in_lim = this->fs == 3 ? this->TP_IN_S : this->TP_IN;
+
+  // weights of an output channel (of the input channel in depthwise mode), from
+  // the address of their first line. They are transformed as in the fsm, and
+  // reused across the spatial tiles as long as their bytes are unchanged. In
+  // 3x3 mode, there is one line of 9 rows per weight bit; in 1x1 mode, a single
+  // line with one row per weight bit, only the first qw rows seeing the pixel.
+  std::map<uint32_t, std::pair<std::vector<uint8_t>, std::vector<int32_t>>> weights;
+  auto weight_values = [&](uint32_t addr) -> std::vector<int32_t>& {
+    auto nb_lines = this->fs == 3 ? this->qw : 1;
+    std::vector<uint8_t> raw(nb_lines*32);
+    for(auto l=0; l<nb_lines; l++) {
+      for(auto i=0; i<32; i++) {
+        raw[l*32 + i] = this->l1_image_rd(addr + l*this->weights_d0_stride + i);
+      }
+    }
+    auto &entry = weights[addr];
+    if(entry.first != raw) {
+      entry.first = raw;
+      entry.second.assign(x_rows*this->TP_IN, 0);
+      for(auto l=0; l<nb_lines; l++) {
+        uint8_t weight_packed[36];
+        if(this->fs == 3)
+          neureka_weight_transform_28(&raw[l*32], weight_packed);
+        else
+          neureka_weight_transform_1x1(&raw[l*32], weight_packed);
+        auto line_rows = this->fs == 3 ? x_rows : std::min(this->qw, 8);
+        for(auto r=0; r<line_rows; r++) {
+          for(auto k=0; k<this->TP_IN; k++) {
+            int32_t bit = (weight_packed[r*row_bytes + k/8] >> (k%8)) & 1;
+            entry.second[(this->fs == 3 ? r : 0)*this->TP_IN + k] += bit << (this->fs == 3 ? l : r);
+          }
+        }
+      }
+    }
+    return entry.second;
+  };
+
+  for(auto k_out_major=0; k_out_major<this->subtile_nb_ko; k_out_major++) {
+    for(auto i_major=0; i_major<this->subtile_nb_ho; i_major++) {
+      for(auto j_major=0; j_major<this->subtile_nb_wo; j_major++) {
+        auto h_size_in  = (i_major < this->subtile_nb_ho-1 || this->subtile_rem_hi==0) ? (this->fs == 1 ? this->H_SIZE : this->H_SIZE+this->FILTER_SIZE-1) : this->subtile_rem_hi;
+        auto w_size_in  = (j_major < this->subtile_nb_wo-1 || this->subtile_rem_wi==0) ? (this->fs == 1 ? this->W_SIZE : this->W_SIZE+this->FILTER_SIZE-1) : this->subtile_rem_wi;
+        auto h_size_out = (i_major < this->subtile_nb_ho-1 || this->subtile_rem_ho==0) ? this->H_SIZE : this->subtile_rem_ho;
+        auto w_size_out = (j_major < this->subtile_nb_wo-1 || this->subtile_rem_wo==0) ? this->W_SIZE : this->subtile_rem_wo;
+        auto h_size_in_hw = (i_major < this->subtile_nb_ho-1 || this->subtile_rem_hi==0) ? (this->fs == 3 ? fbuf : this->H_SIZE) : this->subtile_rem_hi;
+        auto w_size_in_hw = (j_major < this->subtile_nb_wo-1 || this->subtile_rem_wi==0) ? (this->fs == 3 ? fbuf : this->W_SIZE) : this->subtile_rem_wi;
+        bool last_k_out = k_out_major == this->subtile_nb_ko-1;
+
+        std::fill(accum.begin(), accum.end(), 0);
+
+        auto k_in_major_lim = this->depthwise ? 1 : this->subtile_nb_ki;
+        for(auto k_in_major_iter=0; k_in_major_iter<k_in_major_lim; k_in_major_iter++) {
+          auto k_in_major = this->depthwise ? k_out_major : k_in_major_iter;
+          auto dw_lim = !this->depthwise ? 1 :
+                        (k_in_major == this->subtile_nb_ki-1 && this->subtile_rem_ki != this->TP_IN_S && this->subtile_rem_ki != 0) ? this->subtile_rem_ki : this->TP_IN_S;
+
+          // ACTIVATION_LOAD, the 3x3 input channels being strided by TP_IN_S
+          std::fill(x_buffer.begin(), x_buffer.end(), 0);
+          auto load_k_in_lim = (k_in_major == this->subtile_nb_ki-1 && this->subtile_rem_ki != this->TP_IN) ? this->subtile_rem_ki : this->TP_IN;
+          uint32_t base_addr_x = this->infeat_ptr + i_major*this->H_SIZE*this->infeat_d1_stride + j_major*this->W_SIZE*this->infeat_d0_stride +
+                                 k_in_major*(this->fs == 1 ? this->TP_IN : this->TP_IN_S);
+          for(auto i=0; i<h_size_in; i++) {
+            for(auto j=0; j<w_size_in; j++) {
+              uint32_t addr = base_addr_x + i*this->infeat_d1_stride + j*this->infeat_d0_stride;
+              for(auto k=0; k<load_k_in_lim; k++) {
+                x_buffer[(i*fbuf + j)*this->TP_IN + k] = this->l1_image_rd(addr + k);
+              }
+            }
+          }
+
+          // explicit padding, on the regions of load_do_padding
+          auto right_lim  = std::min(fbuf-this->padding_right, w_size_in_hw);
+          auto bottom_lim = std::min(fbuf-this->padding_bottom, h_size_in_hw);
+          auto pad = [&](int i_start, int i_end, int j_start, int j_end) {
+            for(auto i=i_start; i<i_end; i++) {
+              for(auto j=j_start; j<j_end; j++) {
+                for(auto k=0; k<load_k_in_lim; k++) {
+                  x_buffer[(i*fbuf + j)*this->TP_IN + k] = this->padding_value;
+                }
+              }
+            }
+          };
+          bool pad_top    = this->padding_top > 0 && i_major == 0;
+          bool pad_right  = this->padding_right > 0 && j_major == this->subtile_nb_wo-1;
+          bool pad_bottom = this->padding_bottom > 0 && i_major == this->subtile_nb_ho-1;
+          bool pad_left   = this->padding_left > 0 && j_major == 0;
+          if(pad_left || pad_top)     pad(0, this->padding_top, 0, this->padding_left);
+          if(pad_top)                 pad(0, this->padding_top, this->padding_left, right_lim);
+          if(pad_right || pad_top)    pad(0, this->padding_top, right_lim, w_size_in_hw);
+          if(pad_right)               pad(this->padding_top, bottom_lim, right_lim, w_size_in_hw);
+          if(pad_right || pad_bottom) pad(bottom_lim, h_size_in_hw, right_lim, w_size_in_hw);
+          if(pad_bottom)              pad(bottom_lim, h_size_in_hw, this->padding_left, right_lim);
+          if(pad_left || pad_bottom)  pad(bottom_lim, h_size_in_hw, 0, this->padding_left);
+          if(pad_left)                pad(this->padding_top, bottom_lim, 0, this->padding_left);
+
+          // x_array of the fsm: in 3x3 mode, the windows of the output pixels of
+          // the tile, in 1x1 mode, the pixels
+          std::fill(x_array.begin(), x_array.end(), 0);
+          for(auto c=0; c<this->NR_COLUMN; c++) {
+            auto i = c / this->W_SIZE;
+            auto j = c % this->W_SIZE;
+            for(auto r=0; r<x_rows; r++) {
+              int32_t *x = &x_array[(c*nb_rows + r)*this->TP_IN];
+              uint8_t *xb;
+              if(this->fs == 3 && i < h_size_out && j < w_size_out) {
+                xb = &x_buffer[((i + r/this->FILTER_SIZE)*fbuf + j + r%this->FILTER_SIZE)*this->TP_IN];
+              }
+              else if(this->fs == 1 && this->qw > 0) {
+                xb = &x_buffer[(i*fbuf + j)*this->TP_IN];
+              }
+              else {
+                continue;
+              }
+              for(auto k=0; k<this->TP_IN; k++) {
+                x[k] = this->signed_activation ? (int8_t) xb[k] : xb[k];
+              }
+            }
+          }
+
+          // weight offset, on all the output channels except in depthwise mode.
+          // The block sums are 32-bit wide, Wmin included.
+          for(auto c=0; c<this->NR_COLUMN; c++) {
+            if(this->depthwise) {
+              for(auto dw_iter=0; dw_iter<dw_lim; dw_iter++) {
+                int64_t sum = 0;
+                for(auto r=0; r<x_rows; r++) {
+                  if(row_enable[r]) {
+                    sum += (int32_t) ((uint32_t) x_array[(c*nb_rows + r)*this->TP_IN + dw_iter] * (uint32_t) this->Wmin);
+                  }
+                }
+                accum[dw_iter*this->NR_COLUMN + c] += sum * (this->SHIFT_CYCLES-1);
+              }
+            }
+            else {
+              int64_t sum = 0;
+              for(auto r=0; r<x_rows; r++) {
+                if(row_enable[r]) {
+                  int32_t row_sum = 0;
+                  for(auto k=0; k<k_in_lim; k++) {
+                    row_sum += x_array[(c*nb_rows + r)*this->TP_IN + k];
+                  }
+                  sum += (int32_t) ((uint32_t) row_sum * (uint32_t) this->Wmin);
+                }
+              }
+              for(auto k_out=0; k_out<this->TP_OUT; k_out++) {
+                accum[k_out*this->NR_COLUMN + c] += sum * (this->SHIFT_CYCLES-1);
+              }
+            }
+          }
+
+          // MATRIX_VECTOR_COMPUTE, the depthwise steps each using one input
+          // channel of the same weights
+          uint32_t base_addr_W;
+          int mv_k_out_lim;
+          if(this->depthwise) {
+            base_addr_W = this->weights_ptr + (k_in_major*this->qw) * 8 * row_bytes;
+            mv_k_out_lim = 1;
+          }
+          else if(this->fs == 3) {
+            base_addr_W = this->weights_ptr + (k_out_major*this->TP_OUT*this->subtile_nb_ki*this->qw + k_in_major*this->qw) * 8 * row_bytes;
+            mv_k_out_lim = (last_k_out && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) ? this->subtile_rem_ko : this->TP_OUT;
+          }
+          else {
+            base_addr_W = this->weights_ptr + (k_out_major*this->TP_OUT*this->subtile_nb_ki*8 + k_in_major*8) * row_bytes;
+            mv_k_out_lim = (last_k_out && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) ? this->subtile_rem_ko : this->TP_OUT;
+          }
+
+          for(auto mv_k_out_iter=0; mv_k_out_iter<mv_k_out_lim; mv_k_out_iter++) {
+            auto &weight = weight_values(base_addr_W + mv_k_out_iter*this->weights_d1_stride);
+            for(auto c=0; c<this->NR_COLUMN; c++) {
+              if(this->depthwise) {
+                for(auto dw_iter=0; dw_iter<dw_lim; dw_iter++) {
+                  int64_t sum = 0;
+                  for(auto r=0; r<x_rows; r++) {
+                    if(row_enable[r]) {
+                      sum += weight[r*this->TP_IN + dw_iter] * x_array[(c*nb_rows + r)*this->TP_IN + dw_iter];
+                    }
+                  }
+                  accum[dw_iter*this->NR_COLUMN + c] += sum;
+                }
+              }
+              else {
+                int64_t sum = 0;
+                for(auto r=0; r<x_rows; r++) {
+                  if(row_enable[r]) {
+                    const int32_t *w = &weight[r*this->TP_IN];
+                    const int32_t *x = &x_array[(c*nb_rows + r)*this->TP_IN];
+                    int32_t row_sum = 0;
+                    for(auto k=0; k<k_in_lim; k++) {
+                      row_sum += w[k] * x[k];
+                    }
+                    sum += row_sum;
+                  }
+                }
+                accum[mv_k_out_iter*this->NR_COLUMN + c] += sum;
+              }
+            }
+          }
+        }
+
+        // NORM_SHIFT, NORM_MULTIPLY and NORM_BIAS_SHIFT
+        if(this->output_quant) {
+          if(this->norm_option_shift) {
+            for(auto k_out=0; k_out<this->TP_OUT; k_out++) {
+              nqs[k_out] = this->l1_image_rd(this->scale_shift_ptr + k_out_major*tp + k_out);
+            }
+          }
+
+          auto nq_bytes = this->normalization_bits/8;
+          auto nq_lim = this->normalization_bits;
+          if(last_k_out && this->subtile_rem_ko != this->TP_OUT && this->subtile_rem_ko != 0) {
+            nq_lim = this->normalization_bits == 32 ? this->subtile_rem_ko :
+                     this->normalization_bits == 16 ? this->subtile_rem_ko / 2 + (this->subtile_rem_ko % 2 ? 1 : 0) :
+                                                      this->subtile_rem_ko / 4 + (this->subtile_rem_ko % 4 ? 1 : 0);
+          }
+          uint32_t base_addr_nq = this->scale_ptr + k_out_major*tp*nq_bytes;
+          for(auto nq_iter=0; nq_iter<nq_lim; nq_iter++) {
+            for(auto i=0; i<4/nq_bytes; i++) {
+              uint32_t scale = 0;
+              for(auto b=0; b<nq_bytes; b++) {
+                scale |= this->l1_image_rd(base_addr_nq + nq_iter*4 + i*nq_bytes + b) << (b*8);
+              }
+              auto k_out = nq_iter*(4/nq_bytes) + i;
+              for(auto c=0; c<this->NR_COLUMN; c++) {
+                accum[k_out*this->NR_COLUMN + c] = (int64_t)((uint64_t)accum[k_out*this->NR_COLUMN + c] * scale);
+              }
+            }
+          }
+
+          uint32_t base_addr_nqb = this->scale_bias_ptr + k_out_major*tp*4;
+          for(auto nqb_iter=0; nqb_iter<4; nqb_iter++) {
+            for(auto i=0; i<8; i++) {
+              auto k_out = nqb_iter*8 + i;
+              auto shift = this->norm_option_shift ? nqs[k_out] : this->quantization_right_shift;
+              int32_t bias = 0;
+              if(this->norm_option_bias) {
+                for(auto b=0; b<4; b++) {
+                  bias |= this->l1_image_rd(base_addr_nqb + nqb_iter*32 + i*4 + b) << (b*8);
+                }
+              }
+              // out-of-range shifts are taken modulo the width, as on the host
+              for(auto c=0; c<this->NR_COLUMN; c++) {
+                auto &value = accum[k_out*this->NR_COLUMN + c];
+                if(this->norm_option_bias) {
+                  value = (int32_t)((uint32_t)value + (uint32_t)bias) >> (shift & 31);
+                }
+                else {
+                  value = value >> (shift & 63);
+                }
+              }
+            }
+          }
+        }
+
+        // OUTPUT_STREAMOUT, relu and clipping included
+        for(auto &value: accum) {
+          if(this->quantization_bits == 8 && this->output_quant) {
+            value = this->use_relu ? std::min<int64_t>(std::max<int64_t>(value, 0), 255) : std::min<int64_t>(std::max<int64_t>(value, -128), 127);
+          }
+          else if(this->use_relu && this->output_quant) {
+            value = std::min<int64_t>(std::max<int64_t>(value, 0), 0xffffffff);
+          }
+        }
+
+        bool rem_k_out = last_k_out && this->subtile_rem_ko != tp && this->subtile_rem_ko != 0;
+        auto streamout_k_out_lim = this->quantization_bits == 32 ? (this->depthwise ? this->TP_IN/8 : tp/8) : 1;
+        if(rem_k_out) {
+          streamout_k_out_lim = this->quantization_bits == 32 ? this->subtile_rem_ko/8 + (this->subtile_rem_ko%8 == 0 ? 0 : 1) : 1;
+        }
+        // the last depthwise line stops at the remainder of the output channels
+        auto ko = (this->subtile_nb_ko-1)*tp + this->subtile_rem_ko;
+        auto ko_rem = (this->subtile_nb_ko==1) ? this->subtile_rem_ko : (ko%tp == 0) ? tp : ko%tp;
+        auto ko_rem_index = (this->subtile_nb_ko==1 || last_k_out) ? ko_rem : tp;
+
+        uint32_t base_addr_y = this->outfeat_ptr + i_major*this->H_SIZE*this->outfeat_d2_stride + j_major*this->W_SIZE*this->outfeat_d1_stride + k_out_major*tp*this->quantization_bits/8;
+        for(auto i=0; i<h_size_out; i++) {
+          for(auto j=0; j<w_size_out; j++) {
+            if(this->strided2x2 && (i == 1 || (j == 1 && (i == 0 || i == 2)))) {
+              continue;
+            }
+            auto c = i*this->H_SIZE + j;
+            uint32_t addr = base_addr_y + i*this->outfeat_d2_stride + j*this->outfeat_d1_stride;
+            if(this->quantization_bits == 8) {
+              auto k_out_last = rem_k_out ? this->subtile_rem_ko : tp;
+              for(auto k_out=0; k_out<k_out_last; k_out++) {
+                this->l1_image_wr(addr + k_out, accum[k_out*this->NR_COLUMN + c]);
+              }
+            }
+            else {
+              // one line of up to 8 output channels per word stride
+              for(auto kw=0; kw<streamout_k_out_lim; kw++) {
+                auto k_out_last = (kw == streamout_k_out_lim-1 && this->depthwise) ? ko_rem_index : (kw+1)*8;
+                if(rem_k_out) {
+                  k_out_last = std::min(k_out_last, this->subtile_rem_ko);
+                }
+                for(auto k_out=kw*8; k_out<k_out_last; k_out++) {
+                  for(auto b=0; b<4; b++) {
+                    this->l1_image_wr(addr + kw*this->outfeat_d0_stride + (k_out-kw*8)*4 + b, accum[k_out*this->NR_COLUMN + c] >> (b*8));
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  this->l1_image_flush();
+}
+
+// L1 copy of the batched layer, each block being fetched through the backdoor
+// on its first access and the written bytes being written back by l1_image_flush
+uint8_t Neureka::l1_image_rd(uint32_t addr) {
+  addr &= NEUREKA_STREAM_L1_MASK;
+  auto block = addr / NEUREKA_L1_IMAGE_BLOCK;
+  if(!this->l1_image_valid[block]) {
+    auto block_addr = block * NEUREKA_L1_IMAGE_BLOCK;
+    if(!this->l1_backdoor(block_addr, &this->l1_image[block_addr], NEUREKA_L1_IMAGE_BLOCK, false)) {
+      this->trace.fatal("Functional mode failed to read L1 (addr=0x%x, size=%d)\n", block_addr, NEUREKA_L1_IMAGE_BLOCK);
+    }
+    this->l1_image_valid[block] = true;
+  }
+  return this->l1_image[addr];
+}
+
+void Neureka::l1_image_wr(uint32_t addr, uint8_t value) {
+  addr &= NEUREKA_STREAM_L1_MASK;
+  this->l1_image_rd(addr);
+  this->l1_image[addr] = value;
+  this->l1_image_dirty[addr] = true;
+}
+
+void Neureka::l1_image_flush() {
+  uint32_t size = this->l1_image_dirty.size();
+  uint32_t addr = 0;
+  while(addr < size) {
+    if(!this->l1_image_dirty[addr]) {
+      addr++;
+      continue;
+    }
+    uint32_t end = addr;
+    while(end < size && this->l1_image_dirty[end]) {
+      end++;
+    }
+    if(!this->l1_backdoor(addr, &this->l1_image[addr], end-addr, true)) {
+      this->trace.fatal("Functional mode failed to write L1 (addr=0x%x, size=%d)\n", addr, end-addr);
+    }
+    addr = end;
+  }
+}
@@ -176,6 +176,7 @@ void Neureka::load_do_extract() {
       xt::view(this->x_array, xt::all(), i_row) = x_buffer_view.reshape({shape[0] * shape[1], shape[2]});
     }
   }
+  this->x_array_dirty = true;
 }
 
 void Neureka::load_filter_masking() {
@@ -139,6 +139,8 @@ void Neureka::__BinConvArray(
     for(auto r=0; r<this->COLUMN_SIZE; r++) { // spatial loop - over blocks in a column
       if(row_enable(r) == 0) // row disabling to implement filter masks
         continue;
+      if(r >= weight.shape()[0]) // 1x1 mode only unpacks 8 rows of weights
+        continue;
       auto scale_loc = use_row_as_scale ? 1 << r : scale;
       auto activ = xt::view(this->x_array, c, r, xt::all()); // 16x channels of 8-bit
       if(this->binconv_traces) {
@@ -164,6 +166,45 @@ void Neureka::__BinConvArray(
   }
 }
 
+// Fast path of __BinConvArray with the fixed-shape engine, with the weights
+// still packed. Returns false when the engine can not be used, in which case
+// the caller goes through __BinConvArray.
+bool Neureka::__BinConvArrayPacked(
+  const uint8_t*       weight,
+  int                  nb_rows,
+  int                  scale,
+  int                  idx,
+  xt::xarray<int32_t>& row_enable,
+  xt::xarray<int32_t>& mac_enable,
+  bool                 weight_shift,
+  bool                 weight_invert,
+  bool                 use_row_as_scale
+) {
+  // per-block traces are only produced by the xtensor model
+  if(this->binconv == NULL || this->binconv_traces)
+    return false;
+
+  if(!this->binconv->set_mac_enable(mac_enable.data()))
+    return false;
+
+  uint32_t row_mask = 0;
+  for(auto r=0; r<this->COLUMN_SIZE; r++) {
+    if(row_enable(r) != 0)
+      row_mask |= 1 << r;
+  }
+
+  if(this->x_array_dirty) {
+    this->binconv->load_activations(this->x_array.data());
+    this->x_array_dirty = false;
+  }
+
+  this->binconv->compute(weight, nb_rows, scale, idx, row_mask, this->signed_activation,
+    weight_shift, weight_invert, use_row_as_scale, this->TP_OUT,
+    this->psum_block.data(), this->psum_column.data(), this->accum.data());
+
+  return true;
+}
+
 void Neureka::__weightoffs(
   int dw_iter,
   xt::xarray<int32_t> row_enable,
@@ -174,6 +215,15 @@ void Neureka::__weightoffs(
 
     // fake-load and unpack weight bits
     auto read_size = this->FILTER_SIZE*this->FILTER_SIZE;
+    auto scale = this->Wmin;
+
+    if(this->binconv && read_size <= NeurekaBinConv::NB_ROWS) {
+      uint8_t weight_packed[NeurekaBinConv::NB_ROWS*NeurekaBinConv::ROW_BYTES] = { 0 };
+      memset(weight_packed, 0xff, (this->fs == 3 ? read_size : 1)*NeurekaBinConv::ROW_BYTES);
+      if(this->__BinConvArrayPacked(weight_packed, read_size, scale, this->depthwise ? dw_iter : 0, row_enable, mac_enable, !this->depthwise, false, false))
+        continue;
+    }
+
     xt::xarray<uint8_t> weight_ld = xt::zeros<uint8_t>({read_size, this->TP_IN/8});
     if(this->fs == 3)
       xt::view(weight_ld, xt::all()) = 0xff;
@@ -181,8 +231,6 @@ void Neureka::__weightoffs(
       xt::view(weight_ld, 0, xt::all()) = 0xff;
     auto weight = __WeightUnpack(weight_ld, read_size, this->TP_IN); //this->mode16 & this->mode_linear);
     
-    auto scale = this->Wmin;
-    
     this->__BinConvArray(weight, scale, this->depthwise ? dw_iter : 0, row_enable, mac_enable, !this->depthwise, false, false); 
   }
 }
@@ -296,10 +344,21 @@ int Neureka::matrixvec_cycle() {
     this->trace.msg(vp::Trace::LEVEL_DEBUG, msg.c_str());
   }
 
+  auto scale = 1 << this->mv_qw_iter;
+
+  if(this->binconv) {
+    uint8_t weight_packed[36];
+    if(this->fs == 3)
+      neureka_weight_transform_28(weight_ld.data(), weight_packed);
+    else
+      neureka_weight_transform_1x1(weight_ld.data(), weight_packed);
+    if(this->__BinConvArrayPacked(weight_packed, (this->fs==3) ? 9 : read_size, scale, k_out, this->row_enable, this->mac_enable, false, false, this->fs==1))
+      return (int) cycles;
+  }
+
   xt::xarray<uint8_t> weight_ld_transform = (this->fs == 3) ? __Weight_transform_28(weight_ld) : __Weight_transform_1x1(weight_ld);
 
   auto weight = __WeightUnpack(weight_ld_transform, (this->fs==3) ? 9 : read_size, this->TP_IN);
-  auto scale = 1 << this->mv_qw_iter;
 
   this->__BinConvArray(weight, scale, k_out, this->row_enable, this->mac_enable, false, false, this->fs==1);
 
@@ -30,9 +30,12 @@
 #include "xtensor/xpad.hpp"
 #include <neureka.hpp>
 
-// the NEUREKA can only access L1 memory in the range 0xY000_0000 -- 0xY003_FFFC, where Y=1 or 0
-// in the model, Y is ignored
-#define NEUREKA_STREAM_L1_MASK 0x0003FFFF
+// the timed path masks each access, so a line crossing the end of the L1 range
+// wraps around to its start. The backdoor access is only equivalent when the
+// line does not cross it.
+static inline bool neureka_stream_l1_contiguous(uint32_t addr, int size) {
+  return (addr & NEUREKA_STREAM_L1_MASK) + size <= NEUREKA_STREAM_L1_MASK + 1;
+}
 
 NeurekaStreamAccess::NeurekaStreamAccess(
   Neureka *neureka,
@@ -167,37 +170,43 @@ xt::xarray<T> NeurekaVectorLoad<T>::ex(int width, bool w_demux, int64_t& cycles)
   auto width_rem   = width_padded * sizeof(T) % 4;
   int64_t max_latency = 0;
   
-  for(auto i=0; i<width_words; i++) {
-    this->neureka->io_req.init();
-    if(w_demux==true)
-      this->neureka->io_req.set_addr(addr_padded+i*4);
-    else 
-      this->neureka->io_req.set_addr(addr_padded+i*4 & NEUREKA_STREAM_L1_MASK);
-    
-    this->neureka->io_req.set_size(4);
-    this->neureka->io_req.set_data(load_data+i*4);
-    this->neureka->io_req.set_is_write(false);
-    int err = (w_demux==true) ? this->neureka->wmem_out.req(&this->neureka->io_req) : this->neureka->out.req(&this->neureka->io_req);
-    
-    if (err == vp::IO_REQ_OK) {
-      int64_t latency = this->neureka->io_req.get_latency();
-      if (latency > max_latency) {
-        max_latency = latency;
+  // in functional mode, the whole line is read at once through the L1 backdoor
+  bool backdoor = this->neureka->functional && !w_demux &&
+    neureka_stream_l1_contiguous(addr_padded, width_padded * sizeof(T)) &&
+    this->neureka->l1_backdoor(addr_padded & NEUREKA_STREAM_L1_MASK, load_data, width_padded * sizeof(T), false);
+  if(!backdoor) {
+    for(auto i=0; i<width_words; i++) {
+      this->neureka->io_req.init();
+      if(w_demux==true)
+        this->neureka->io_req.set_addr(addr_padded+i*4);
+      else 
+        this->neureka->io_req.set_addr(addr_padded+i*4 & NEUREKA_STREAM_L1_MASK);
+      
+      this->neureka->io_req.set_size(4);
+      this->neureka->io_req.set_data(load_data+i*4);
+      this->neureka->io_req.set_is_write(false);
+      int err = (w_demux==true) ? this->neureka->wmem_out.req(&this->neureka->io_req) : this->neureka->out.req(&this->neureka->io_req);
+      
+      if (err == vp::IO_REQ_OK) {
+        int64_t latency = this->neureka->io_req.get_latency();
+        if (latency > max_latency) {
+          max_latency = latency;
+        }
+      }
+      else {
+        this->neureka->trace.fatal("Unsupported asynchronous reply\n");
       }
     }
-    else {
-      this->neureka->trace.fatal("Unsupported asynchronous reply\n");
-    }
-  }
-  if(width_rem) {
-    this->neureka->io_req.init();
-    this->neureka->io_req.set_addr(addr_padded+width_words*4 & NEUREKA_STREAM_L1_MASK);
-    this->neureka->io_req.set_size(width_rem);
-    this->neureka->io_req.set_data(load_data+width_words*4);
-    this->neureka->io_req.set_is_write(false);
-    int err = (w_demux==true) ? this->neureka->wmem_out.req(&this->neureka->io_req) : this->neureka->out.req(&this->neureka->io_req);
-    if (err != vp::IO_REQ_OK) {
-      this->neureka->trace.fatal("Unsupported asynchronous reply\n");
+    if(width_rem) {
+      this->neureka->io_req.init();
+      this->neureka->io_req.set_addr(addr_padded+width_words*4 & NEUREKA_STREAM_L1_MASK);
+      this->neureka->io_req.set_size(width_rem);
+      this->neureka->io_req.set_data(load_data+width_words*4);
+      this->neureka->io_req.set_is_write(false);
+      int err = (w_demux==true) ? this->neureka->wmem_out.req(&this->neureka->io_req) : this->neureka->out.req(&this->neureka->io_req);
+      if (err != vp::IO_REQ_OK) {
+        this->neureka->trace.fatal("Unsupported asynchronous reply\n");
+      }
     }
   }
   if (trace_at_least(this->neureka->trace_level, NEUREKA_L2_STREAM_INOUT)) {
@@ -269,7 +278,11 @@ xt::xarray<T> NeurekaVectorStore<T>::ex(xt::xarray<T> data, int width, int64_t&
 
 
   int64_t max_latency = 0;
-  if(enable) {
+  // in functional mode, the whole line is written at once through the L1 backdoor
+  bool backdoor = enable && this->neureka->functional &&
+    neureka_stream_l1_contiguous(addr_start, width_bytes) &&
+    this->neureka->l1_backdoor(addr_start & NEUREKA_STREAM_L1_MASK, store_data, width_bytes, true);
+  if(enable && !backdoor) {
     for(auto i=0; i<width_words+misaligned_start_byte+misaligned_end_byte; i++) {
       this->neureka->io_req.init();
 
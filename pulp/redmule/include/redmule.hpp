@@ -124,6 +124,7 @@ class RedMule_Streamer {
 		bool		is_write	;
 
 		int rw_data(int width, void* buf, strobe_t strb);
+		bool rw_line(uint32_t offs, int width, uint8_t* buf, strobe_t strb, int64_t* latency);
 };
 
 class RedMule : public vp::Component {
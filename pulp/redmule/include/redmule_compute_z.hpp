@@ -0,0 +1,69 @@
+#ifndef __REDMULE_COMPUTE_Z_HPP__
+#define __REDMULE_COMPUTE_Z_HPP__
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REDMULE_BUFFERS_X86
+#endif
+
+#ifdef REDMULE_BUFFERS_X86
+
+// One row of compute_z with an fp32 destination, the cols columns at once.
+// x_row is read from x_offs, wrapping around at x_len as in x_row_offs, and
+// each column accumulates over k in the same order as the scalar loop.
+// With single_rounding, each step is a float fma, as std::fma(float). Otherwise
+// it is a double fma rounded back to float, as the C fma(double) on floats.
+// Kept apart from RedMule_Buffers so that it can be checked without gvsoc
+// (tests/redmule).
+template<int cols, bool single_rounding>
+__attribute__((target("avx2,fma")))
+static void compute_z_row_avx2(float* z, const float* y, const float* x_row, int x_offs, int x_len, float** w, int n) {
+    int j = 0;
+
+    if (single_rounding) {
+        for (; j + 8 <= cols; j += 8) {
+            __m256 acc = _mm256_loadu_ps(&y[j]);
+
+            for (int k = 0; k < n; k++) {
+                int offs = x_offs + k < x_len ? x_offs + k : x_offs + k - x_len;
+                acc = _mm256_fmadd_ps(_mm256_set1_ps(x_row[offs]), _mm256_loadu_ps(&w[k][j]), acc);
+            }
+
+            _mm256_storeu_ps(&z[j], acc);
+        }
+    } else {
+        for (; j + 4 <= cols; j += 4) {
+            __m128 acc = _mm_loadu_ps(&y[j]);
+
+            for (int k = 0; k < n; k++) {
+                int offs = x_offs + k < x_len ? x_offs + k : x_offs + k - x_len;
+                __m256d prod = _mm256_fmadd_pd(_mm256_set1_pd(x_row[offs]), _mm256_cvtps_pd(_mm_loadu_ps(&w[k][j])), _mm256_cvtps_pd(acc));
+                acc = _mm256_cvtpd_ps(prod);
+            }
+
+            _mm_storeu_ps(&z[j], acc);
+        }
+    }
+
+    for (; j < cols; j++) {
+        float tmp_z = y[j];
+
+        for (int k = 0; k < n; k++) {
+            int offs = x_offs + k < x_len ? x_offs + k : x_offs + k - x_len;
+
+            if (single_rounding) {
+                tmp_z = std::fma(x_row[offs], w[k][j], tmp_z);
+            } else {
+                tmp_z = (float) std::fma((double) x_row[offs], (double) w[k][j], (double) tmp_z);
+            }
+        }
+
+        z[j] = tmp_z;
+    }
+}
+
+#endif
+
+#endif
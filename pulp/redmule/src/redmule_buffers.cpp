@@ -2,6 +2,9 @@
 
 #include <cmath>
 #include <memory.h>
+#include <type_traits>
+
+#include "redmule_compute_z.hpp"
 
 #if DST_FMT==FP32
     typedef uint32_t print_t;
@@ -11,6 +14,23 @@
     typedef uint8_t print_t;
 #endif
 
+#if DST_FMT==FP32 && defined(REDMULE_BUFFERS_X86)
+
+#define Z_COLS ((PIPE_REGS + 1) * ARRAY_HEIGHT)
+
+// Depending on the headers in scope, fma() on floats is either std::fma(float)
+// or the C fma(double) rounded back to float at each step. Both round the same
+// when the operands come from a narrower source format: their product is then
+// exact in float, and a sum of two floats rounded to double and then to float
+// is rounded as once to float, double having more than 2 * 24 + 1 bits.
+// Otherwise the vector kernel follows the double one. tests/redmule checks both
+// kernels against the scalar loop.
+static constexpr bool fma_single_rounding = std::is_same<decltype(fma(0.0f, 0.0f, 0.0f)), float>::value || sizeof(src_fmt_t) < sizeof(float);
+
+static const bool compute_z_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+#endif
+
 RedMule_Buffers::RedMule_Buffers() {
     this->redmule = (RedMule *) NULL;
 }
@@ -158,6 +178,14 @@ int RedMule_Buffers::x_row_offs(int k) {
 
 void RedMule_Buffers::compute_z() {
     for (int i = 0; i < ARRAY_WIDTH; i++) {
+    #if DST_FMT==FP32 && defined(REDMULE_BUFFERS_X86)
+        if (compute_z_avx2) {
+            int x_len = this->n + ((PIPE_REGS + 1) * ARRAY_HEIGHT - this->x_cols_lftovr ) % ((PIPE_REGS + 1) * ARRAY_HEIGHT) + 2 * ARRAY_HEIGHT * (PIPE_REGS + 1);
+
+            compute_z_row_avx2<Z_COLS, fma_single_rounding>(this->z[i], this->y[i + this->y_offs], this->x[i], this->x_offs, x_len, this->w, this->n);
+            continue;
+        }
+    #endif
         for (int j = 0; j < (PIPE_REGS + 1) * ARRAY_HEIGHT; j++) {
         #if DST_FMT!=FP8
             float tmp_z;
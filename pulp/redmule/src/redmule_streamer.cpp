@@ -84,7 +84,7 @@ int RedMule_Streamer::rw_data(int width, void* buf, strobe_t strb) {
 		return 1;
 	}
 
-	if (buf != NULL) {
+	if (buf != NULL && !this->rw_line(offs, width, (uint8_t *) buf, strb, &max_latency)) {
 		if (offs % BYTES_PER_BANK != 0) {
 			if (this->is_write) {	//TODO: strobe is not taken into account
 				this->req->set_addr(offs);
@@ -243,6 +243,48 @@ int RedMule_Streamer::rw_data(int width, void* buf, strobe_t strb) {
 	return (int) max_latency + 1;
 }
 
+// Move a whole buffer line with a single request instead of one request per
+// bank. The l1_interleaver splits it over the banks and returns the latency of
+// the slowest one. Only aligned lines whose strobe selects a prefix of the line
+// are handled, which is all the scheduler generates; for those, rw_data reads
+// the full line or writes up to the last strobed byte. Targets which refuse a
+// request spanning several banks get the per-bank requests.
+bool RedMule_Streamer::rw_line(uint32_t offs, int width, uint8_t* buf, strobe_t strb, int64_t* latency) {
+	if (offs % BYTES_PER_BANK != 0 || (strb & (strb + 1)) != 0) {
+		return false;
+	}
+
+	int ones = strb == 0 ? 0 : sizeof(uint64_t) * 8 - __builtin_clzll (strb);
+	int size = ones > width ? width : ones;
+
+	if (!this->is_write && size < width) {
+		return false;
+	}
+
+	*latency = 0;
+
+	if (size != 0) {
+		this->req->set_addr(offs);
+		this->req->set_data(buf);
+		this->req->set_size(size);
+
+		vp::IoReqStatus err = this->redmule->out.req(this->req);
+
+		if (err == vp::IO_REQ_INVALID && size > BYTES_PER_BANK) {
+			return false;
+		}
+
+		if (err != vp::IO_REQ_OK) {
+			this->redmule->trace.fatal("There was an error while reading/writing data\n");
+			return true;
+		}
+
+		*latency = req->get_latency();
+	}
+
+	return true;
+}
+
 int RedMule_Streamer::iterate(void* _buf, strobe_t strb) {
 	int latency = 1;
 
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone benchmark of the CacheFilter rule matching.
+ *
+ * First checks CacheFilterRules against the previous shared_ptr snapshot
+ * matching, used as reference, on random overlapping rules, requests and
+ * rule updates. Then measures matches per second of both, with 1, 8 and 64
+ * rules, for a stream of requests walking through the same rule (the common
+ * case of a core streaming through a buffer) and for random requests.
+ *
+ * Built and run with "make match_bench".
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include "cache_filter_rules.hpp"
+
+static constexpr int NB_CHECKS = 200000;
+static constexpr int NB_MATCHES = 20000000;
+
+// Previous implementation, snapshot of sorted rules and prefix maximum of their ends
+class ReferenceRules
+{
+public:
+    void set(const std::vector<std::pair<uint64_t, uint64_t>> &rules)
+    {
+        auto snap = std::make_shared<Snapshot>();
+        for (auto &r : rules) snap->intervals.push_back({r.first, r.second});
+        std::sort(snap->intervals.begin(), snap->intervals.end(), [](const Rule &a, const Rule &b){
+            if (a.start != b.start) return a.start < b.start;
+            return a.end < b.end;
+        });
+        uint64_t cur = 0;
+        for (size_t i = 0; i < snap->intervals.size(); ++i) {
+            cur = (i == 0) ? snap->intervals[i].end : std::max(cur, snap->intervals[i].end);
+            snap->max_hi_prefix.push_back(cur);
+        }
+        std::atomic_store_explicit(&snapshot_, snap, std::memory_order_release);
+    }
+
+    bool match(uint64_t addr, uint64_t size)
+    {
+        if (size == 0) return false;
+        uint64_t end = addr + size;
+        if (end < addr) return false;
+
+        auto snap = std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+        if (!snap || snap->intervals.empty()) return false;
+
+        const auto &ivs = snap->intervals;
+        auto it = std::upper_bound(ivs.begin(), ivs.end(), end - 1,
+                                    [](uint64_t value, const Rule &r){ return value < r.start; });
+        if (it == ivs.begin()) return false;
+        size_t j = static_cast<size_t>(std::distance(ivs.begin(), it) - 1);
+        return snap->max_hi_prefix[j] > addr;
+    }
+
+private:
+    struct Rule { uint64_t start, end; };
+    struct Snapshot { std::vector<Rule> intervals; std::vector<uint64_t> max_hi_prefix; };
+    std::shared_ptr<Snapshot> snapshot_;
+};
+
+static bool check(std::mt19937_64 &rng)
+{
+    for (int nb_rules : { 1, 3, 8, 64 })
+    {
+        CacheFilterRules rules;
+        ReferenceRules ref;
+        std::vector<std::pair<uint64_t, uint64_t>> list;
+
+        for (int i = 0; i < nb_rules; i++)
+        {
+            uint64_t start = rng() % 0x10000;
+            uint64_t end = start + 1 + rng() % 0x800;
+            list.push_back({start, end});
+            rules.add(start, end);
+        }
+        ref.set(list);
+
+        for (int i = 0; i < NB_CHECKS; i++)
+        {
+            // Updates a rule from time to time, like config_sync does
+            if (rng() % 64 == 0)
+            {
+                size_t idx = rng() % nb_rules;
+                bool is_end = rng() & 1;
+                uint64_t value = rng() % 0x10800, start = 0, end = 0;
+                bool valid = rules.set_bound(idx, is_end, value, start, end);
+                if (valid != (start < end))
+                {
+                    printf("FAILED: bad update of rule %zu to [0x%lx, 0x%lx)\n", idx, start, end);
+                    return false;
+                }
+                if (valid)
+                {
+                    list[idx] = { start, end };
+                    ref.set(list);
+                }
+            }
+
+            // Requests are often close to the previous one, to go through the last match
+            uint64_t addr = rng() % 0x11000;
+            uint64_t size = rng() % 0x100;
+            if (rng() & 1 && i > 0) addr = (addr & 0xff) + list[rng() % nb_rules].first;
+            if (rng() % 1024 == 0) addr = ~0ULL - (rng() % 0x100);
+
+            if (rules.match(addr, size) != ref.match(addr, size))
+            {
+                printf("FAILED: %d rules, addr 0x%lx size 0x%lx: got %d, expected %d\n",
+                    nb_rules, addr, size, !ref.match(addr, size), ref.match(addr, size));
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<typename T>
+static double bench(T &rules, const std::vector<uint64_t> &addrs, int &matched)
+{
+    auto start = std::chrono::steady_clock::now();
+    int count = 0;
+    for (int i = 0; i < NB_MATCHES; i++)
+    {
+        count += rules.match(addrs[i & (addrs.size() - 1)], 64);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    matched = count;
+    return NB_MATCHES / elapsed;
+}
+
+int main()
+{
+    std::mt19937_64 rng(0);
+
+    if (!check(rng))
+    {
+        return 1;
+    }
+
+    printf("%-6s %-7s %14s %14s %8s\n", "rules", "stream", "reference/s", "matches/s", "speedup");
+
+    for (int nb_rules : { 1, 8, 64 })
+    {
+        // Disjoint 64KB rules, every other 64KB region, so that half the random requests match
+        CacheFilterRules rules;
+        ReferenceRules ref;
+        std::vector<std::pair<uint64_t, uint64_t>> list;
+        for (int i = 0; i < nb_rules; i++)
+        {
+            list.push_back({ 0x80000000ULL + i * 0x20000ULL, 0x80000000ULL + i * 0x20000ULL + 0x10000 });
+            rules.add(list.back().first, list.back().second);
+        }
+        ref.set(list);
+
+        std::vector<uint64_t> walk, random;
+        for (int i = 0; i < 1 << 16; i++)
+        {
+            // 1024 requests of 64 bytes through a rule before moving to another one
+            walk.push_back(list[(i >> 10) % nb_rules].first + (i & 1023) * 64 % 0x10000);
+            random.push_back(0x80000000ULL + rng() % (nb_rules * 0x20000ULL));
+        }
+
+        for (auto &stream : { std::make_pair("walk", &walk), std::make_pair("random", &random) })
+        {
+            int ref_matched, matched;
+            double ref_rate = bench(ref, *stream.second, ref_matched);
+            double rate = bench(rules, *stream.second, matched);
+            if (ref_matched != matched)
+            {
+                printf("FAILED: %d rules, %s: %d matches, expected %d\n", nb_rules, stream.first,
+                    matched, ref_matched);
+                return 1;
+            }
+            printf("%-6d %-7s %14.0f %14.0f %7.2fx\n", nb_rules, stream.first, ref_rate, rate,
+                rate / ref_rate);
+        }
+    }
+
+    printf("PASSED\n");
+    return 0;
+}
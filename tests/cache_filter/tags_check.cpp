@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone check of the CacheFilter cache model tag array.
+ *
+ * Random accesses go through CacheFilterTags, allocating on misses like the
+ * CacheFilter does for reads, and through a reference model keeping each set
+ * as a list of tags ordered by last use (LRU) or by fill (FIFO). Hits, misses
+ * and evictions must be the same for each access. Random replacement is only
+ * checked for hits of lines which were just accessed.
+ *
+ * Built and run with "make tags_check".
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <list>
+#include <random>
+#include <vector>
+#include "cache_filter_tags.hpp"
+
+static constexpr int NB_ACCESSES = 200000;
+
+static bool check(int nb_sets, int nb_ways, int line_size, CacheFilterTags::Replacement replacement,
+    std::mt19937_64 &rng)
+{
+    CacheFilterTags tags;
+    if (!tags.configure(nb_sets, nb_ways, line_size, replacement))
+    {
+        printf("FAILED: geometry %d x %d x %d refused\n", nb_sets, nb_ways, line_size);
+        return false;
+    }
+
+    std::vector<std::list<uint64_t>> ref(nb_sets);
+    uint64_t footprint = (uint64_t)nb_sets * nb_ways * line_size * 2;
+    uint64_t last = 0;
+
+    for (int i = 0; i < NB_ACCESSES; i++)
+    {
+        uint64_t addr = rng() % 4 ? rng() % footprint : last;
+        uint64_t line = addr / line_size;
+        std::list<uint64_t> &set = ref[line % nb_sets];
+        auto it = std::find(set.begin(), set.end(), line);
+        bool ref_hit = it != set.end(), ref_evict = false;
+
+        if (replacement != CacheFilterTags::RANDOM)
+        {
+            if (ref_hit && replacement == CacheFilterTags::LRU)
+            {
+                set.erase(it);
+                set.push_back(line);
+            }
+            else if (!ref_hit)
+            {
+                ref_evict = (int)set.size() == nb_ways;
+                if (ref_evict) set.pop_front();
+                set.push_back(line);
+            }
+        }
+
+        int way = tags.find(addr);
+        bool hit = way >= 0, evicted = false;
+        if (hit)
+        {
+            tags.touch(addr, way);
+        }
+        else
+        {
+            way = tags.victim(addr, evicted);
+            tags.fill(addr, way);
+        }
+
+        if (replacement == CacheFilterTags::RANDOM)
+        {
+            if (i > 0 && addr == last && !hit)
+            {
+                printf("FAILED: random, miss on the line just accessed (addr 0x%lx)\n", addr);
+                return false;
+            }
+        }
+        else if (hit != ref_hit || evicted != ref_evict)
+        {
+            printf("FAILED: %d x %d, access %d addr 0x%lx: hit %d evicted %d, expected hit %d evicted %d\n",
+                nb_sets, nb_ways, i, addr, hit, evicted, ref_hit, ref_evict);
+            return false;
+        }
+
+        last = addr;
+    }
+
+    return true;
+}
+
+int main()
+{
+    std::mt19937_64 rng(0);
+    CacheFilterTags tags;
+
+    if (tags.configure(3, 2, 64, CacheFilterTags::LRU) || tags.configure(4, 2, 48, CacheFilterTags::LRU))
+    {
+        printf("FAILED: non power of 2 geometry accepted\n");
+        return 1;
+    }
+
+    for (auto replacement : { CacheFilterTags::LRU, CacheFilterTags::FIFO, CacheFilterTags::RANDOM })
+    {
+        for (auto geometry : { std::make_pair(1, 1), std::make_pair(1, 8), std::make_pair(64, 2),
+            std::make_pair(16, 4), std::make_pair(256, 1) })
+        {
+            if (!check(geometry.first, geometry.second, 64, replacement, rng))
+            {
+                return 1;
+            }
+        }
+    }
+
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone check of the FlooNoC v2 in-network reduction kernels.
+ *
+ * Reduces random vectors the way a reduction tree does (neutral element, then
+ * one child after the other) and compares against a scalar reference. Odd
+ * sizes check the tail handling of the blocked kernels.
+ *
+ * Built and run with "make collective_check".
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include <vector>
+#include "floonoc_collective_v2.hpp"
+
+static uint16_t reference(int op, uint16_t a, uint16_t b)
+{
+    switch (op)
+    {
+        case FloonocCollectiveV2::ADD_UINT16:
+        case FloonocCollectiveV2::ADD_INT16:
+            return a + b;
+        case FloonocCollectiveV2::MAX_UINT16:
+            return a > b ? a : b;
+        case FloonocCollectiveV2::MAX_INT16:
+            return (int16_t)a > (int16_t)b ? a : b;
+        case FloonocCollectiveV2::ADD_FP16:
+        {
+            // float has enough precision for the exact sum of 2 fp16 values
+            // which are not too far apart, which is the case of the inputs
+            float sum = FloonocCollectiveV2::fp16_to_float(a) + FloonocCollectiveV2::fp16_to_float(b);
+            return FloonocCollectiveV2::double_to_fp16(sum);
+        }
+        case FloonocCollectiveV2::MAX_FP16:
+            return FloonocCollectiveV2::fp16_to_float(a) >= FloonocCollectiveV2::fp16_to_float(b) ? a : b;
+    }
+    return 0;
+}
+
+static uint16_t random_value(int op, std::mt19937 &rng)
+{
+    if (op == FloonocCollectiveV2::ADD_FP16 || op == FloonocCollectiveV2::MAX_FP16)
+    {
+        // Finite values with a limited exponent range
+        return (rng() & 0x8000) | ((10 + rng() % 10) << 10) | (rng() & 0x3ff);
+    }
+    return rng();
+}
+
+int main()
+{
+    int status = 0;
+    std::mt19937 rng(0);
+
+    // Conversions must round-trip on all finite values
+    for (int value=0; value<0x10000; value++)
+    {
+        if ((value & 0x7c00) == 0x7c00)
+        {
+            continue;
+        }
+        uint16_t result = FloonocCollectiveV2::double_to_fp16(FloonocCollectiveV2::fp16_to_float(value));
+        if (result != value)
+        {
+            printf("Conversion mismatch (value: 0x%x, result: 0x%x)\n", value, result);
+            status = 1;
+            break;
+        }
+    }
+
+    for (int op=FloonocCollectiveV2::ADD_UINT16; op<FloonocCollectiveV2::NB_OPS; op++)
+    {
+        for (int nb_elems: {1, 15, 16, 17, 100, 1024})
+        {
+            int nb_children = 1 + rng() % 8;
+            uint64_t size = nb_elems * 2;
+            std::vector<uint16_t> expected(nb_elems);
+            std::vector<uint8_t> result(size);
+
+            FloonocCollectiveV2::init(op, result.data(), size);
+            FloonocCollectiveV2::init(op, (uint8_t *)expected.data(), size);
+
+            for (int child=0; child<nb_children; child++)
+            {
+                std::vector<uint16_t> values(nb_elems);
+                for (int i=0; i<nb_elems; i++)
+                {
+                    values[i] = random_value(op, rng);
+                    expected[i] = reference(op, expected[i], values[i]);
+                }
+                FloonocCollectiveV2::reduce(op, result.data(), (uint8_t *)values.data(), size);
+            }
+
+            if (memcmp(result.data(), expected.data(), size) != 0)
+            {
+                printf("Reduction mismatch (op: %d, elems: %d, children: %d)\n", op, nb_elems,
+                    nb_children);
+                status = 1;
+            }
+        }
+    }
+
+    printf("%s\n", status ? "FAILED" : "PASSED");
+
+    return status;
+}
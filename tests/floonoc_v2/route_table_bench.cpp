@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone microbenchmark for the FlooNoC v2 compiled address decoder.
+ *
+ * Builds memory maps similar to the ones of large cluster meshes (one entry
+ * per tile plus a few overlapping border ranges), checks that the route table
+ * returns exactly what the former linear decode returns, and reports the
+ * decode rate of both.
+ *
+ * Built and run with "make route_table_bench".
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "floonoc_route_table_v2.hpp"
+
+static EntryV2 *linear_lookup(std::vector<EntryV2> &entries, uint64_t addr)
+{
+    for (size_t i=0; i<entries.size(); i++)
+    {
+        EntryV2 *entry = &entries[i];
+        if (addr >= entry->base && addr < entry->base + entry->size)
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void build_map(std::vector<EntryV2> &entries, int nb_tiles)
+{
+    uint64_t tile_base = 0x80000000;
+    uint64_t tile_size = 0x40000;
+    int dim_x = 1;
+    while (dim_x * dim_x < nb_tiles)
+    {
+        dim_x++;
+    }
+
+    // Border memories first, with one range overlapping the tiles, so that
+    // the first-match rule is exercised.
+    entries.push_back({0x70000000, 0x10080000, -2, 0, 0x70000000});
+    entries.push_back({0x10000000, 0x10000000, -1, 0, 0x10000000});
+
+    for (int i=0; i<nb_tiles; i++)
+    {
+        entries.push_back({tile_base + tile_size * i, tile_size, i % dim_x + 1, i / dim_x + 1,
+            tile_base + tile_size * i});
+    }
+
+    // Empty placeholder, as produced by mappings without size
+    entries.push_back({0, 0, 0, 0, 0});
+}
+
+int main()
+{
+    int status = 0;
+    const int nb_lookups = 1 << 22;
+
+    printf("%8s %10s %14s %14s %14s %10s\n", "entries", "segments", "linear Mlk/s",
+        "table Mlk/s", "cached Mlk/s", "hit rate");
+
+    for (int nb_tiles: {16, 256, 1024, 4096})
+    {
+        std::vector<EntryV2> entries;
+        build_map(entries, nb_tiles);
+
+        RouteTableV2 table;
+        table.build(entries);
+
+        // Bursts are split into beats which mostly hit the same tile, model
+        // that with short sequential runs starting from random addresses.
+        std::mt19937_64 rng(nb_tiles);
+        std::vector<uint64_t> addrs(nb_lookups);
+        uint64_t addr = 0;
+        for (int i=0; i<nb_lookups; i++)
+        {
+            if ((i & 15) == 0)
+            {
+                addr = 0x70000000 + rng() % (0x10000000 + 0x40000 * (uint64_t)nb_tiles);
+            }
+            addrs[i] = addr;
+            addr += 64;
+        }
+
+        for (int i=0; i<nb_lookups; i += 7)
+        {
+            if (table.lookup(addrs[i]) != linear_lookup(entries, addrs[i]))
+            {
+                printf("Mismatch (entries: %ld, addr: 0x%lx)\n", entries.size(), addrs[i]);
+                status = 1;
+                break;
+            }
+        }
+
+        uintptr_t checksum = 0;
+
+        // The linear decode is way too slow on large maps, sample it
+        int nb_linear = nb_lookups / (nb_tiles / 16);
+        auto start = std::chrono::steady_clock::now();
+        for (int i=0; i<nb_linear; i++)
+        {
+            checksum += (uintptr_t)linear_lookup(entries, addrs[i]);
+        }
+        double linear = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (int i=0; i<nb_lookups; i++)
+        {
+            checksum += (uintptr_t)table.lookup(addrs[i]);
+        }
+        double compiled = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        RouteTableV2::Cache cache;
+        start = std::chrono::steady_clock::now();
+        for (int i=0; i<nb_lookups; i++)
+        {
+            checksum += (uintptr_t)table.lookup(addrs[i], cache);
+        }
+        double cached = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%8ld %10ld %14.1f %14.1f %14.1f %9.1f%% (checksum: %lx)\n", entries.size(),
+            table.get_nb_segments(), nb_linear / linear / 1e6, nb_lookups / compiled / 1e6,
+            nb_lookups / cached / 1e6, 100.0 * cache.nb_hits / (cache.nb_hits + cache.nb_misses),
+            checksum & 0xff);
+    }
+
+    printf("%s\n", status ? "FAILED" : "PASSED");
+
+    return status;
+}
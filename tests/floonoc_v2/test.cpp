@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <stdio.h>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include "interco/traffic/generator.hpp"
@@ -23,8 +24,18 @@
 
 #define CYCLES_ERROR 0.01f
 
-void Testbench::stub_retry(vp::Block *__this, vp::IoRetryChannel) {}
-vp::IoRespAck Testbench::stub_response(vp::Block *__this, vp::IoReq *req) { return vp::IO_RESP_ACCEPTED; }
+void Testbench::ni_retry(vp::Block *__this, vp::IoRetryChannel)
+{
+    Testbench *_this = (Testbench *)__this;
+    _this->tests[_this->current_test - 1]->handle_retry();
+}
+
+vp::IoRespAck Testbench::ni_response(vp::Block *__this, vp::IoReq *req)
+{
+    Testbench *_this = (Testbench *)__this;
+    _this->tests[_this->current_test - 1]->handle_response(req);
+    return vp::IO_RESP_ACCEPTED;
+}
 
 Testbench::Testbench(vp::ComponentConf &config)
     : vp::Component(config)
@@ -39,6 +50,15 @@ Testbench::Testbench(vp::ComponentConf &config)
 
     this->use_memory = this->get_js_config()->get_child_bool("use_memory");
     this->mem_bw = this->get_js_config()->get_int("mem_bw");
+    this->routing = this->get_js_config()->get_child_str("routing");
+    this->router_nb_vcs = this->get_js_config()->get_int("router_nb_vcs");
+    this->collective = this->get_js_config()->get_child_bool("collective");
+    this->cycles_file = this->get_js_config()->get_child_str("cycles_file");
+    this->reference_file = this->get_js_config()->get_child_str("reference_file");
+    this->xy_reference_file = this->get_js_config()->get_child_str("xy_reference_file");
+
+    this->load_cycles(this->reference_file, this->reference_cycles);
+    this->load_cycles(this->xy_reference_file, this->xy_reference_cycles);
 
     int nb_cluster = this->nb_cluster_x*this->nb_cluster_y;
 
@@ -61,10 +81,8 @@ Testbench::Testbench(vp::ComponentConf &config)
                 &this->generator_control_itf[2*cid + 1]);
 
             // v2 IoMaster requires retry+response callbacks at construction.
-            // This master is never actively used to send requests; the stubs
-            // are there only to satisfy the framework.
-            this->noc_ni_itf[cid] = new vp::IoMaster(&Testbench::stub_retry,
-                                                    &Testbench::stub_response);
+            this->noc_ni_itf[cid] = new vp::IoMaster(&Testbench::ni_retry,
+                                                    &Testbench::ni_response);
             this->new_master_port(
                 "noc_ni_" + std::to_string(x) + "_" + std::to_string(y),
                 this->noc_ni_itf[cid]);
@@ -102,6 +120,21 @@ void Testbench::exec_next_test()
 {
     if (this->current_test == this->tests.size())
     {
+        if (this->cycles_file != "")
+        {
+            FILE *file = fopen(this->cycles_file.c_str(), "w");
+            if (file == NULL)
+            {
+                this->trace.fatal("Unable to open cycles file (path: %s)\n", this->cycles_file.c_str());
+            }
+            fprintf(file, "# Cycles of the saturation tests, recorded with CASE=record\n");
+            for (auto &test_cycles: this->cycles)
+            {
+                fprintf(file, "%s %lld\n", test_cycles.first.c_str(), (long long)test_cycles.second);
+            }
+            fclose(file);
+        }
+
         this->time.get_engine()->quit(0);
     }
     else
@@ -110,6 +143,33 @@ void Testbench::exec_next_test()
     }
 }
 
+void Testbench::load_cycles(std::string path, std::map<std::string, int64_t> &cycles)
+{
+    if (path == "")
+    {
+        return;
+    }
+
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == NULL)
+    {
+        this->trace.fatal("Unable to open reference cycles (path: %s)\n", path.c_str());
+    }
+
+    // One "<test> <cycles>" line per test, lines starting with # are comments
+    char line[256];
+    char name[64];
+    long long test_cycles;
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (line[0] != '#' && sscanf(line, "%63s %lld", name, &test_cycles) == 2)
+        {
+            cycles[name] = test_cycles;
+        }
+    }
+    fclose(file);
+}
+
 int Testbench::get_cluster_id(int x, int y)
 {
     return this->nb_cluster_x * y + x;
@@ -170,6 +230,54 @@ int Testbench::check_cycles(int64_t result, int64_t expected)
     return error > CYCLES_ERROR;
 }
 
+int Testbench::record_cycles(std::string name, int64_t cycles)
+{
+    this->cycles.push_back({name, cycles});
+
+    if (this->reference_file == "")
+    {
+        return 0;
+    }
+
+    auto reference = this->reference_cycles.find(name);
+    if (reference == this->reference_cycles.end())
+    {
+        printf("    No reference cycles, they must be recorded with CASE=record (test: %s, cycles: %lld)\n",
+            name.c_str(), (long long)cycles);
+        return 1;
+    }
+
+    if (reference->second != cycles)
+    {
+        printf("    Cycles differ from reference (test: %s, cycles: %lld, reference: %lld)\n",
+            name.c_str(), (long long)cycles, (long long)reference->second);
+        return 1;
+    }
+
+    return 0;
+}
+
+int Testbench::check_not_slower_than_xy(std::string name, int64_t cycles)
+{
+    if (this->xy_reference_file == "")
+    {
+        return 0;
+    }
+
+    auto reference = this->xy_reference_cycles.find(name);
+    if (reference == this->xy_reference_cycles.end() ||
+        cycles > reference->second * (1 + CYCLES_ERROR))
+    {
+        printf("    Slower than XY routing (test: %s, cycles: %lld, xy cycles: %lld)\n",
+            name.c_str(), (long long)cycles,
+            reference == this->xy_reference_cycles.end() ? -1LL : (long long)reference->second);
+        return 1;
+    }
+
+    printf("    Speedup over XY routing: %.2f\n", (double)reference->second / cycles);
+    return 0;
+}
+
 TestCommon::TestCommon(Block *parent, std::string name)
 : Block(parent, name)
 {
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <map>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include "interco/traffic/generator.hpp"
@@ -27,6 +28,9 @@ class TestCommon : public vp::Block
 public:
     TestCommon(Block *parent, std::string name);
     virtual void exec_test() = 0;
+    // Called for the responses and retries of the network interface ports
+    virtual void handle_response(vp::IoReq *req) {}
+    virtual void handle_retry() {}
 };
 
 
@@ -44,21 +48,29 @@ public:
     TrafficReceiverConfigMaster *get_receiver(int x, int y, bool narrow=false);
     void test_end(int status);
     int check_cycles(int64_t result, int64_t expected);
+    int record_cycles(std::string name, int64_t cycles);
+    int check_not_slower_than_xy(std::string name, int64_t cycles);
 
     int nb_cluster_x;
     int nb_cluster_y;
     bool use_memory;
     int mem_bw;
+    std::string routing;
+    int router_nb_vcs;
+    // Collectives are enabled in the NoC, with their header at this address bit
+    bool collective;
+    static constexpr int COLLECTIVE_ADDR_SHIFT = 32;
 
 private:
     int get_cluster_id(int x, int y);
     void exec_next_test();
+    void load_cycles(std::string path, std::map<std::string, int64_t> &cycles);
 
-    // Stubs for the v2 IoMaster: this test harness never actually sends through
-    // noc_ni_itf — those ports exist only as a structural binding. v2's
-    // IoMaster requires retry and response callbacks at construction time.
-    static void stub_retry(vp::Block *__this, vp::IoRetryChannel);
-    static vp::IoRespAck stub_response(vp::Block *__this, vp::IoReq *req);
+    // Callbacks of noc_ni_itf, forwarded to the running test. Only the
+    // collective test sends requests through these ports, the other ones go
+    // through the traffic generators.
+    static void ni_retry(vp::Block *__this, vp::IoRetryChannel);
+    static vp::IoRespAck ni_response(vp::Block *__this, vp::IoReq *req);
 
     vp::Trace trace;
     std::vector<TestCommon *>tests;
@@ -69,4 +81,15 @@ private:
     std::vector<vp::IoMaster *> noc_ni_itf;
     std::vector<TrafficGeneratorConfigMaster> generator_control_itf;
     std::vector<TrafficReceiverConfigMaster> receiver_control_itf;
+    // Cycles of the tests which must not depend on the router wakeup and
+    // fast-forward modes, compared with the reference ones read from
+    // reference_file, or written to cycles_file to record them
+    std::string cycles_file;
+    std::string reference_file;
+    std::vector<std::pair<std::string, int64_t>> cycles;
+    std::map<std::string, int64_t> reference_cycles;
+    // Reference cycles with XY routing, which other routing algorithms must
+    // not exceed on the tests where they can spread the traffic
+    std::string xy_reference_file;
+    std::map<std::string, int64_t> xy_reference_cycles;
 };
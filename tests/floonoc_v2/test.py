@@ -31,7 +31,8 @@ from gvrun.parameter import TargetParameter
 class FloonocV2Test(gvsoc.systree.Component):
     """Test driver for the v2 FlooNoC model. Mirrors the v1 FloonocTest layout."""
 
-    def __init__(self, parent, name, nb_cluster_x, nb_cluster_y, cluster_base, cluster_size, use_memory, mem_bw):
+    def __init__(self, parent, name, nb_cluster_x, nb_cluster_y, cluster_base, cluster_size, use_memory, mem_bw,
+            routing, router_nb_vcs, cycles_file, reference_file, xy_reference_file, collective):
         super().__init__(parent, name)
 
         self.add_property('nb_cluster_x', nb_cluster_x)
@@ -40,6 +41,12 @@ class FloonocV2Test(gvsoc.systree.Component):
         self.add_property('cluster_size', cluster_size)
         self.add_property('use_memory', use_memory)
         self.add_property('mem_bw', mem_bw)
+        self.add_property('routing', routing)
+        self.add_property('router_nb_vcs', router_nb_vcs)
+        self.add_property('cycles_file', cycles_file)
+        self.add_property('reference_file', reference_file)
+        self.add_property('xy_reference_file', xy_reference_file)
+        self.add_property('collective', collective)
 
         self.add_sources(['test.cpp'])
         self.add_sources(['test0.cpp'])
@@ -75,7 +82,9 @@ class Testbench(gvsoc.systree.Component):
         limiter.o_OUTPUT(mem.i_INPUT())
         return limiter
 
-    def __init__(self, parent, name, use_memory=False, target_bw=0, mem_bw=0):
+    def __init__(self, parent, name, use_memory=False, target_bw=0, mem_bw=0, router_wake_on_unstall=True,
+            routing='xy', router_nb_vcs=1, fast_forward=True, cycles_file='', reference_file='',
+            xy_reference_file='', collective=False):
         super().__init__(parent, name)
 
         nb_cluster_x = 3
@@ -86,16 +95,25 @@ class Testbench(gvsoc.systree.Component):
         mem_size = 0x10_0000
         mem_group_size = 0x1000_0000
 
-        noc = pulp.floonoc_v2.floonoc_v2.FlooNocV2ClusterGridNarrowWide(self, 'noc', 64, 8, nb_cluster_x, nb_cluster_y, ni_outstanding_reqs=32)
+        # The collective test sends its requests directly from the test
+        # component, which is then the only master of the wide inputs
+        noc = pulp.floonoc_v2.floonoc_v2.FlooNocV2ClusterGridNarrowWide(self, 'noc', 64, 8, nb_cluster_x, nb_cluster_y, ni_outstanding_reqs=32,
+            print_pool_stats=True, router_wake_on_unstall=router_wake_on_unstall, routing=routing,
+            router_nb_vcs=router_nb_vcs, fast_forward=fast_forward, print_fast_forward_stats=True,
+            collective_addr_shift=32 if collective else 0)
 
-        test = FloonocV2Test(self, 'test', nb_cluster_x, nb_cluster_y, cluster_base, cluster_size, use_memory, mem_bw)
+        test = FloonocV2Test(self, 'test', nb_cluster_x, nb_cluster_y, cluster_base, cluster_size, use_memory, mem_bw,
+            routing, router_nb_vcs, cycles_file, reference_file, xy_reference_file, collective)
 
         for x in range(0, nb_cluster_x):
             for y in range(0, nb_cluster_y):
-                generator_w = GeneratorV2(self, f'generator_{x}_{y}_w')
-                generator_w.o_OUTPUT(noc.i_CLUSTER_WIDE_INPUT(x, y))
-                generator_n = GeneratorV2(self, f'generator_{x}_{y}_n')
-                generator_n.o_OUTPUT(noc.i_CLUSTER_NARROW_INPUT(x, y))
+                if not collective:
+                    generator_w = GeneratorV2(self, f'generator_{x}_{y}_w')
+                    generator_w.o_OUTPUT(noc.i_CLUSTER_WIDE_INPUT(x, y))
+                    generator_n = GeneratorV2(self, f'generator_{x}_{y}_n')
+                    generator_n.o_OUTPUT(noc.i_CLUSTER_NARROW_INPUT(x, y))
+                    test.o_GENERATOR_CONTROL(x, y, True, generator_w.i_CONTROL())
+                    test.o_GENERATOR_CONTROL(x, y, False, generator_n.i_CONTROL())
 
                 if use_memory:
                     mem_w = MemoryV3(self, f'mem_{x}_{y}_w',
@@ -115,8 +133,6 @@ class Testbench(gvsoc.systree.Component):
                     test.o_RECEIVER_CONTROL(x+1, y+1, False, receiver_n.i_CONTROL())
 
                 test.o_NOC_NI(x, y, noc.i_CLUSTER_WIDE_INPUT(x, y))
-                test.o_GENERATOR_CONTROL(x, y, True, generator_w.i_CONTROL())
-                test.o_GENERATOR_CONTROL(x, y, False, generator_n.i_CONTROL())
 
                 noc.o_MAP(cluster_base + cluster_size * (y * nb_cluster_x + x),
                     cluster_size, x+1, y+1, rm_base=True)
@@ -213,8 +229,54 @@ class Chip(gvsoc.systree.Component):
             cast=int
         ).get_value()
 
+        router_wake_on_unstall = TargetParameter(
+            self, name='router_wake_on_unstall', value=True,
+            description='Let routers sleep until one of their input heads can progress',
+            cast=bool
+        ).get_value()
+
+        routing = TargetParameter(
+            self, name='routing', value='xy',
+            description='Routing algorithm (xy, yx, west_first or adaptive)'
+        ).get_value()
+
+        router_nb_vcs = TargetParameter(
+            self, name='router_nb_vcs', value=1, description='Number of virtual channels per router input',
+            cast=int
+        ).get_value()
+
+        fast_forward = TargetParameter(
+            self, name='fast_forward', value=True,
+            description='Remove the NoC events from the engine while no request is in flight',
+            cast=bool
+        ).get_value()
+
+        cycles_file = TargetParameter(
+            self, name='cycles_file', value='',
+            description='File where the cycles of the saturation tests are recorded'
+        ).get_value()
+
+        reference_file = TargetParameter(
+            self, name='reference_file', value='',
+            description='File with the reference cycles of the saturation tests, which must be matched'
+        ).get_value()
+
+        xy_reference_file = TargetParameter(
+            self, name='xy_reference_file', value='',
+            description='File with the reference XY cycles, which the transpose test must not exceed'
+        ).get_value()
+
+        collective = TargetParameter(
+            self, name='collective', value=False,
+            description='Enable the NoC collectives and only run the collective test',
+            cast=bool
+        ).get_value()
+
         clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100000000)
-        soc = Testbench(self, 'soc', use_memory=use_memory, mem_bw=mem_bw)
+        soc = Testbench(self, 'soc', use_memory=use_memory, mem_bw=mem_bw,
+            router_wake_on_unstall=router_wake_on_unstall, routing=routing, router_nb_vcs=router_nb_vcs,
+            fast_forward=fast_forward, cycles_file=cycles_file, reference_file=reference_file,
+            xy_reference_file=xy_reference_file, collective=collective)
         clock.o_CLOCK(soc.i_CLOCK())
 
 
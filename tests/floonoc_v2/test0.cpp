@@ -15,6 +15,8 @@
  * limitations under the License.
  */
 
+#include <string.h>
+#include <pulp/floonoc_v2/floonoc_collective_v2.hpp>
 #include "test0.hpp"
 
 
@@ -243,6 +245,290 @@ bool Test0::check_prefered_path()
     return false;
 }
 
+bool Test0::check_hotspot()
+{
+    // Every cluster but one reads from the same cluster, so that routers on
+    // the paths to it are congested while the rest of the mesh is idle.
+    int x_hot=(this->top->nb_cluster_x-1)/2, y_hot=(this->top->nb_cluster_y-1)/2;
+    size_t size = 1024*64;
+    size_t bw = 8;
+
+    if (this->step == 0)
+    {
+        printf("Test 5, checking all clusters reading from a hotspot cluster\n");
+
+        TrafficGeneratorSync *sync = new TrafficGeneratorSync(&this->fsm_event);
+
+        uint64_t base = this->top->get_cluster_base(x_hot, y_hot);
+        int index = 0;
+
+        for (int x=0; x<this->top->nb_cluster_x; x++)
+        {
+            for (int y=0; y<this->top->nb_cluster_y; y++)
+            {
+                if (x != x_hot || y != y_hot)
+                {
+                    this->top->get_generator(x, y)->start(base + 0x1000 * index, size, bw, sync,
+                        false, true);
+                    index++;
+                }
+            }
+        }
+
+        if (!this->top->use_memory)
+        {
+            this->top->get_receiver(x_hot + 1, y_hot + 1)->start(bw);
+        }
+
+        sync->start();
+
+        this->clockstamp = this->clock.get_cycles();
+        this->host_start = std::chrono::steady_clock::now();
+        this->step++;
+    }
+    else
+    {
+        int64_t cycles = 0;
+        bool check_status = false;
+
+        for (int x=0; x<this->top->nb_cluster_x; x++)
+        {
+            for (int y=0; y<this->top->nb_cluster_y; y++)
+            {
+                if (x != x_hot || y != y_hot)
+                {
+                    this->top->get_generator(x, y)->get_result(&check_status, &cycles);
+                }
+            }
+        }
+
+        // Cycles depend on arbitration across the mesh and are only checked
+        // against the reference cycles, if any. The host time is reported to
+        // compare router wakeup modes.
+        int64_t sim_cycles = this->clock.get_cycles() - this->clockstamp;
+        double host_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - this->host_start).count();
+
+        printf("    %s (check: %d, size: %lld, cycles: %lld, host ns/cycle: %.1f)\n",
+            check_status ? "Failed" : "Done", check_status, size, sim_cycles,
+            sim_cycles ? host_ns / sim_cycles : 0.0);
+
+        this->status |= check_status;
+        this->status |= this->top->record_cycles("hotspot", sim_cycles) != 0;
+        return true;
+    }
+    return false;
+}
+
+bool Test0::check_transpose()
+{
+    // Each cluster writes to its mirror cluster across the diagonal. With XY
+    // routing, all flows of a row turn in the same column, which saturates it,
+    // while adaptive algorithms can spread them. The aggregated throughput is
+    // reported, and other routing algorithms are checked not to be slower
+    // than XY.
+    size_t size = 1024*64;
+    size_t bw = 64;
+    int nb_flows = 0;
+
+    for (int x=0; x<this->top->nb_cluster_x; x++)
+    {
+        for (int y=0; y<this->top->nb_cluster_y; y++)
+        {
+            if (x != y && y < this->top->nb_cluster_x && x < this->top->nb_cluster_y)
+            {
+                nb_flows++;
+            }
+        }
+    }
+
+    if (this->step == 0)
+    {
+        printf("Test 6, checking transpose traffic throughput (routing: %s)\n", this->top->routing.c_str());
+
+        TrafficGeneratorSync *sync = new TrafficGeneratorSync(&this->fsm_event);
+
+        for (int x=0; x<this->top->nb_cluster_x; x++)
+        {
+            for (int y=0; y<this->top->nb_cluster_y; y++)
+            {
+                if (x != y && y < this->top->nb_cluster_x && x < this->top->nb_cluster_y)
+                {
+                    uint64_t base = this->top->get_cluster_base(y, x);
+                    this->top->get_generator(x, y)->start(base, size, bw, sync, true, true);
+
+                    if (!this->top->use_memory)
+                    {
+                        this->top->get_receiver(y + 1, x + 1)->start(bw);
+                    }
+                }
+            }
+        }
+
+        sync->start();
+
+        this->clockstamp = this->clock.get_cycles();
+        this->step++;
+    }
+    else
+    {
+        int64_t cycles = 0;
+        bool check_status = false;
+
+        for (int x=0; x<this->top->nb_cluster_x; x++)
+        {
+            for (int y=0; y<this->top->nb_cluster_y; y++)
+            {
+                if (x != y && y < this->top->nb_cluster_x && x < this->top->nb_cluster_y)
+                {
+                    this->top->get_generator(x, y)->get_result(&check_status, &cycles);
+                }
+            }
+        }
+
+        int64_t sim_cycles = this->clock.get_cycles() - this->clockstamp;
+
+        printf("    %s (check: %d, size: %lld, cycles: %lld, throughput: %.2f bytes/cycle)\n",
+            check_status ? "Failed" : "Done", check_status, size, sim_cycles,
+            sim_cycles ? (double)size * nb_flows / sim_cycles : 0.0);
+
+        this->status |= check_status;
+        this->status |= this->top->record_cycles("transpose", sim_cycles) != 0;
+        this->status |= this->top->check_not_slower_than_xy("transpose", sim_cycles) != 0;
+        return true;
+    }
+    return false;
+}
+
+bool Test0::check_collectives()
+{
+    // The center cluster multicasts to all the clusters but the first
+    // column, then reduces data from all of them. Each access is sent once
+    // the previous one completed, and the data is checked through unicast
+    // reads.
+    int nb_x = this->top->nb_cluster_x, nb_y = this->top->nb_cluster_y;
+    int x_init = (nb_x-1)/2, y_init = (nb_y-1)/2;
+    uint64_t offset = 0x1000;
+    size_t size = 256;
+
+    if (this->step == 0)
+    {
+        printf("Test 7, checking multicast write and add reduction (initiator: (%d, %d))\n", x_init, y_init);
+
+        this->accesses.clear();
+
+        std::vector<uint8_t> pattern(size);
+        for (size_t i=0; i<size; i++)
+        {
+            pattern[i] = i * 7 + 3;
+        }
+
+        uint64_t header = FloonocCollectiveV2::MULTICAST | ((nb_x - 2) << 4) | ((nb_y - 1) << 12);
+        this->accesses.push_back({ x_init, y_init,
+            (this->top->get_cluster_base(1, 0) + offset) | (header << Testbench::COLLECTIVE_ADDR_SHIFT),
+            true, pattern, true });
+
+        for (int x=0; x<nb_x; x++)
+        {
+            for (int y=0; y<nb_y; y++)
+            {
+                this->accesses.push_back({ x_init, y_init, this->top->get_cluster_base(x, y) + offset,
+                    false, pattern, x >= 1 });
+            }
+        }
+
+        // Each cluster gets different values, the sum is checked at the initiator
+        std::vector<uint16_t> sum(size / 2, 0);
+        for (int x=0; x<nb_x; x++)
+        {
+            for (int y=0; y<nb_y; y++)
+            {
+                std::vector<uint16_t> values(size / 2);
+                for (size_t i=0; i<size / 2; i++)
+                {
+                    values[i] = (y * nb_x + x + 1) * (i * 37 + 11);
+                    sum[i] += values[i];
+                }
+                std::vector<uint8_t> data(size);
+                memcpy(data.data(), values.data(), size);
+                this->accesses.push_back({ x_init, y_init,
+                    this->top->get_cluster_base(x, y) + offset + size, true, data, true });
+            }
+        }
+
+        std::vector<uint8_t> expected(size);
+        memcpy(expected.data(), sum.data(), size);
+        header = FloonocCollectiveV2::ADD_UINT16 | ((nb_x - 1) << 4) | ((nb_y - 1) << 12);
+        this->accesses.push_back({ x_init, y_init,
+            (this->top->get_cluster_base(0, 0) + offset + size) | (header << Testbench::COLLECTIVE_ADDR_SHIFT),
+            false, expected, true });
+
+        this->current_access = 0;
+        this->clockstamp = this->clock.get_cycles();
+        this->send_access();
+        this->step++;
+    }
+    else if (this->current_access < this->accesses.size())
+    {
+        this->send_access();
+    }
+    else
+    {
+        printf("    %s (cycles: %lld)\n", this->status ? "Failed" : "Done",
+            this->clock.get_cycles() - this->clockstamp);
+        return true;
+    }
+    return false;
+}
+
+void Test0::send_access()
+{
+    Access &access = this->accesses[this->current_access];
+
+    this->access_data = access.data;
+    if (!access.is_write)
+    {
+        memset(this->access_data.data(), 0, this->access_data.size());
+    }
+
+    vp::IoReq *req = &this->access_req;
+    req->prepare();
+    req->set_addr(access.addr);
+    req->set_size(this->access_data.size());
+    req->set_data(this->access_data.data());
+    req->set_is_write(access.is_write);
+
+    vp::IoReqStatus result = this->top->get_noc_ni_itf(access.x, access.y)->req(req);
+    this->access_denied = result == vp::IO_REQ_DENIED;
+    if (result == vp::IO_REQ_DONE)
+    {
+        this->handle_response(req);
+    }
+}
+
+void Test0::handle_retry()
+{
+    if (this->access_denied)
+    {
+        this->send_access();
+    }
+}
+
+void Test0::handle_response(vp::IoReq *req)
+{
+    Access &access = this->accesses[this->current_access];
+
+    if (!access.is_write && (this->access_data == access.data) != access.match)
+    {
+        printf("    Data mismatch (addr: 0x%llx, expected %s)\n", (unsigned long long)access.addr,
+            access.match ? "equal" : "different");
+        this->status = true;
+    }
+
+    this->current_access++;
+    this->fsm_event.enqueue();
+}
+
 void Test0::entry(vp::Block *__this, vp::ClockEvent *event)
 {
     Test0 *_this = (Test0 *)__this;
@@ -305,20 +591,53 @@ void Test0::exec_test()
         }
     };
 
-    single_path_tests_add(0, 0, this->top->nb_cluster_x, this->top->nb_cluster_y, 0);
-    single_path_tests_add(0, 0, this->top->nb_cluster_x + 1, this->top->nb_cluster_y, 0);
-    single_path_tests_add(0, 0, this->top->nb_cluster_x, 0, 0);
-    single_path_tests_add(0, 0, this->top->nb_cluster_x, this->top->nb_cluster_y + 1, 0);
-    single_path_tests_add(0, 0, 0, this->top->nb_cluster_y, 0);
-    single_path_tests_add(0, 0, this->top->nb_cluster_x, this->top->nb_cluster_y, 1);
-    single_path_tests_add(0, 0, this->top->nb_cluster_x-1, this->top->nb_cluster_y-1, 0x100000 - 8, this->top->nb_cluster_x, this->top->nb_cluster_y - 1);
+    if (this->top->collective)
+    {
+        this->testcases.push_back([&] { return this->check_collectives(); });
+
+        this->status = false;
+        this->step = 0;
+        this->testcase = 0;
+        this->fsm_event.enqueue();
+        return;
+    }
+
+    // Expected cycles of these tests assume a single virtual channel and do
+    // not depend on the path as long as it has a fixed length:
+    // - single paths from (0, 0) go along row 0 then up the last column with
+    //   XY, up column 0 then along the last row with YX, and west-first has
+    //   no west hop, so it picks either of the two at each hop.
+    // - in the 2 paths tests, the flows go straight along a row or a column,
+    //   so they take the same path with all three algorithms.
+    // The odd-even adaptive algorithm only runs the saturation tests.
+    bool fixed_paths = (this->top->routing == "xy" || this->top->routing == "yx" ||
+        this->top->routing == "west_first") && this->top->router_nb_vcs == 1;
+
+    if (fixed_paths)
+    {
+        single_path_tests_add(0, 0, this->top->nb_cluster_x, this->top->nb_cluster_y, 0);
+        single_path_tests_add(0, 0, this->top->nb_cluster_x + 1, this->top->nb_cluster_y, 0);
+        single_path_tests_add(0, 0, this->top->nb_cluster_x, 0, 0);
+        single_path_tests_add(0, 0, this->top->nb_cluster_x, this->top->nb_cluster_y + 1, 0);
+        single_path_tests_add(0, 0, 0, this->top->nb_cluster_y, 0);
+        single_path_tests_add(0, 0, this->top->nb_cluster_x, this->top->nb_cluster_y, 1);
+        single_path_tests_add(0, 0, this->top->nb_cluster_x-1, this->top->nb_cluster_y-1, 0x100000 - 8, this->top->nb_cluster_x, this->top->nb_cluster_y - 1);
+    }
 
     if (!this->top->use_memory || this->top->mem_bw == 8)
     {
+        if (fixed_paths)
+        {
+            this->testcases.insert(testcases.end(), {
+                [&] { return this->check_2_paths_through_same_node(); },
+                [&] { return this->check_2_paths_to_same_target(); },
+                [&] { return this->check_prefered_path(); },
+            });
+        }
+
         this->testcases.insert(testcases.end(), {
-            [&] { return this->check_2_paths_through_same_node(); },
-            [&] { return this->check_2_paths_to_same_target(); },
-            [&] { return this->check_prefered_path(); },
+            [&] { return this->check_hotspot(); },
+            [&] { return this->check_transpose(); },
         });
     }
 
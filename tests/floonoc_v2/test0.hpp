@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <vector>
 #include "test.hpp"
 
 class Test0 : public TestCommon
@@ -24,8 +26,23 @@ class Test0 : public TestCommon
 public:
     Test0(Testbench *top);
     void exec_test();
+    void handle_response(vp::IoReq *req) override;
+    void handle_retry() override;
 
 private:
+    // Access done by the collective test through the network interface of a
+    // cluster. Writes send data, reads compare what they get with it, which
+    // must be equal if match is true and different otherwise.
+    struct Access
+    {
+        int x;
+        int y;
+        uint64_t addr;
+        bool is_write;
+        std::vector<uint8_t> data;
+        bool match;
+    };
+
     static void entry(vp::Block *__this, vp::ClockEvent *event);
     bool check_single_path(bool do_write, bool wide, bool narrow, int initiator_bw, int target_bw,
         int size, int expected_cycles, int x0, int y0, int x1, int y1, uint64_t offset,
@@ -33,12 +50,22 @@ private:
     bool check_2_paths_through_same_node();
     bool check_2_paths_to_same_target();
     bool check_prefered_path();
+    bool check_hotspot();
+    bool check_transpose();
+    bool check_collectives();
+    void send_access();
 
     Testbench *top;
     vp::ClockEvent fsm_event;
     int step;
     int testcase;
     int64_t clockstamp;
+    std::chrono::steady_clock::time_point host_start;
     bool status;
     std::vector<std::function<bool()>> testcases;
+    std::vector<Access> accesses;
+    size_t current_access;
+    vp::IoReq access_req;
+    std::vector<uint8_t> access_data;
+    bool access_denied;
 };
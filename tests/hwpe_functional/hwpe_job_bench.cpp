@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * HwpeJobBench — fast mode versus timed job check of the accelerators.
+ *
+ * The same job is programmed through the register file of two accelerators,
+ * the first one timed and the second one in a fast mode (functional NE16 and
+ * Neureka, analytic LightRedmule, RedMulE moving whole lines where the first
+ * one has to move them one bank at a time), each with its own L1 memory
+ * holding the same initial content. The jobs run one after the other, so that
+ * the host time spent in each of them can be measured. Once both end-of-job
+ * interrupts are received, both L1 memories are read back entirely and must be
+ * identical.
+ * The job durations of both modes, in cycles and in host time, are reported,
+ * and the cycles must be the same if same_cycles is set.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <vp/itf/wire.hpp>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+
+#define NB_ACCELS 2
+
+
+class HwpeJobBench : public vp::Component
+{
+public:
+    HwpeJobBench(vp::ComponentConf &config);
+
+    void reset(bool active) override;
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void irq_sync(vp::Block *__this, bool value, int id);
+    uint32_t access(vp::IoMaster *itf, uint64_t addr, uint8_t *data, uint64_t size, bool is_write);
+    void start_job(int id);
+    void check();
+
+    vp::Trace trace;
+    vp::IoMaster config_itf[NB_ACCELS];
+    vp::IoMaster l1_itf[NB_ACCELS];
+    vp::WireSlave<bool> irq_itf[NB_ACCELS];
+    vp::ClockEvent fsm_event;
+    vp::IoReq req;
+
+    // Register read before programming the job, -1 if none
+    int acquire;
+    // Register writes programming and triggering the job, as offset and value
+    std::vector<std::pair<uint64_t, uint32_t>> writes;
+    uint64_t l1_size;
+    bool same_cycles;
+
+    int64_t start_cycles[NB_ACCELS];
+    int64_t end_cycles[NB_ACCELS];
+    std::chrono::steady_clock::time_point start_time[NB_ACCELS];
+    std::chrono::steady_clock::time_point end_time[NB_ACCELS];
+    int nb_done;
+};
+
+
+HwpeJobBench::HwpeJobBench(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &HwpeJobBench::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->acquire = js->get_int("acquire");
+    for (js::Config *write: js->get("writes")->get_elems())
+    {
+        this->writes.push_back({ write->get_elem(0)->get_int(), write->get_elem(1)->get_int() });
+    }
+    this->l1_size = js->get_int("l1_size");
+    this->same_cycles = js->get_child_bool("same_cycles");
+
+    for (int i=0; i<NB_ACCELS; i++)
+    {
+        this->new_master_port("config_" + std::to_string(i), &this->config_itf[i]);
+        this->new_master_port("l1_" + std::to_string(i), &this->l1_itf[i]);
+        this->irq_itf[i].set_sync_meth_muxed(&HwpeJobBench::irq_sync, i);
+        this->new_slave_port("irq_" + std::to_string(i), &this->irq_itf[i]);
+    }
+}
+
+
+void HwpeJobBench::reset(bool active)
+{
+    if (!active)
+    {
+        this->nb_done = 0;
+        this->fsm_event.enqueue();
+    }
+}
+
+
+uint32_t HwpeJobBench::access(vp::IoMaster *itf, uint64_t addr, uint8_t *data, uint64_t size,
+    bool is_write)
+{
+    this->req.init();
+    this->req.set_addr(addr);
+    this->req.set_size(size);
+    this->req.set_data(data);
+    this->req.set_is_write(is_write);
+
+    if (itf->req(&this->req) != vp::IO_REQ_OK)
+    {
+        this->trace.fatal("Unsupported asynchronous reply (addr: 0x%lx)\n", addr);
+    }
+
+    return size == 4 ? *(uint32_t *)data : 0;
+}
+
+
+void HwpeJobBench::start_job(int id)
+{
+    uint32_t value;
+
+    this->start_cycles[id] = this->clock.get_cycles();
+    this->start_time[id] = std::chrono::steady_clock::now();
+
+    if (this->acquire != -1)
+    {
+        int job_id = this->access(&this->config_itf[id], this->acquire, (uint8_t *)&value, 4, false);
+        if (job_id < 0)
+        {
+            this->trace.fatal("Accelerator %d refused the job\n", id);
+        }
+    }
+
+    for (std::pair<uint64_t, uint32_t> &write: this->writes)
+    {
+        value = write.second;
+        this->access(&this->config_itf[id], write.first, (uint8_t *)&value, 4, true);
+    }
+}
+
+
+void HwpeJobBench::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    HwpeJobBench *_this = (HwpeJobBench *)__this;
+
+    _this->start_job(_this->nb_done);
+}
+
+
+void HwpeJobBench::irq_sync(vp::Block *__this, bool value, int id)
+{
+    HwpeJobBench *_this = (HwpeJobBench *)__this;
+
+    if (!value)
+    {
+        return;
+    }
+
+    _this->end_time[id] = std::chrono::steady_clock::now();
+    _this->end_cycles[id] = _this->clock.get_cycles();
+    _this->trace.msg(vp::Trace::LEVEL_INFO, "End of job (accelerator: %d)\n", id);
+    if (++_this->nb_done == NB_ACCELS)
+    {
+        _this->check();
+    }
+    else
+    {
+        // The next job starts once this one is over
+        _this->fsm_event.enqueue();
+    }
+}
+
+
+void HwpeJobBench::check()
+{
+    std::vector<uint8_t> timed(this->l1_size), functional(this->l1_size);
+
+    // One word at a time, as an L1 may refuse wider requests
+    for (uint64_t addr=0; addr<this->l1_size; addr+=4)
+    {
+        this->access(&this->l1_itf[0], addr, &timed[addr], 4, false);
+        this->access(&this->l1_itf[1], addr, &functional[addr], 4, false);
+    }
+
+    int nb_errors = 0;
+    for (uint64_t i=0; i<this->l1_size; i++)
+    {
+        if (timed[i] != functional[i])
+        {
+            if (nb_errors < 10)
+            {
+                printf("Mismatch at 0x%lx (timed: 0x%2.2x, functional: 0x%2.2x)\n", i, timed[i],
+                    functional[i]);
+            }
+            nb_errors++;
+        }
+    }
+
+    int64_t timed_cycles = this->end_cycles[0] - this->start_cycles[0];
+    int64_t fast_cycles = this->end_cycles[1] - this->start_cycles[1];
+    if (this->same_cycles && timed_cycles != fast_cycles)
+    {
+        printf("Job duration mismatch\n");
+        nb_errors++;
+    }
+
+    double timed_us = std::chrono::duration<double, std::micro>(
+        this->end_time[0] - this->start_time[0]).count();
+    double fast_us = std::chrono::duration<double, std::micro>(
+        this->end_time[1] - this->start_time[1]).count();
+
+    printf("[hwpe_functional] timed %ld cycles in %.0f us, fast %ld cycles in %.0f us (x%.1f), "
+        "%d errors\n", timed_cycles, timed_us, fast_cycles, fast_us,
+        fast_us > 0 ? timed_us / fast_us : 0.0, nb_errors);
+
+    this->time.get_engine()->quit(nb_errors != 0);
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new HwpeJobBench(config);
+}
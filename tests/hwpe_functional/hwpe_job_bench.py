@@ -0,0 +1,42 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class HwpeJobBench(gvsoc.systree.Component):
+    """Driver of the HWPE fast mode test.
+
+    Programs the same job on a timed accelerator (port config_0) and then, once
+    it is over, on one in a fast mode (port config_1): the register at offset
+    acquire is read first if it is not -1, then each [offset, value] of writes
+    is written in order, the last one triggering the job. Once both end-of-job
+    interrupts are received, reads back their L1 memories of l1_size bytes one
+    word at a time (ports l1_0 and l1_1) and checks that they are identical, as well as the
+    job durations in cycles if same_cycles is True. The durations of both jobs
+    in cycles and in host time are printed.
+    """
+
+    def __init__(self, parent, name, *, acquire: int, writes: list, l1_size: int,
+            same_cycles: bool):
+        super().__init__(parent, name)
+
+        self.add_sources(['hwpe_job_bench.cpp'])
+
+        self.add_property('acquire', acquire)
+        self.add_property('writes', writes)
+        self.add_property('l1_size', l1_size)
+        self.add_property('same_cycles', same_cycles)
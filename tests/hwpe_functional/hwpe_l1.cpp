@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * HwpeL1 — ideal L1 memory of the HWPE fast mode test.
+ *
+ * Answers io requests synchronously with no latency, and implements the
+ * debug_mem backdoor that the accelerators use in their fast modes. The content
+ * is filled with random bytes drawn from the seed property at reset. Requests
+ * larger than max_req_size are refused, if it is not 0.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <vp/debug_mem.hpp>
+#include <string.h>
+#include <random>
+#include <vector>
+
+
+class HwpeL1 : public vp::Component, public vp::DebugMemIf
+{
+public:
+    HwpeL1(vp::ComponentConf &config);
+
+    void reset(bool active) override;
+
+    vp::DebugMemIf *debug_mem_if() override { return this; }
+    int debug_mem_access(uint64_t addr, uint8_t *data, uint64_t size, bool is_write) override;
+
+private:
+    static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
+
+    vp::Trace trace;
+    vp::IoSlave input_itf;
+
+    int seed;
+    uint64_t max_req_size;
+    std::vector<uint8_t> mem;
+};
+
+
+HwpeL1::HwpeL1(vp::ComponentConf &config)
+    : vp::Component(config)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    this->seed = this->get_js_config()->get_int("seed");
+    this->max_req_size = this->get_js_config()->get_int("max_req_size");
+    this->mem.resize(this->get_js_config()->get_int("size"));
+
+    this->input_itf.set_req_meth(&HwpeL1::req);
+    this->new_slave_port("input", &this->input_itf);
+}
+
+
+void HwpeL1::reset(bool active)
+{
+    if (active)
+    {
+        std::mt19937 rng(this->seed);
+        for (uint8_t &byte: this->mem)
+        {
+            byte = rng();
+        }
+    }
+}
+
+
+int HwpeL1::debug_mem_access(uint64_t addr, uint8_t *data, uint64_t size, bool is_write)
+{
+    if (addr + size > this->mem.size())
+    {
+        return -1;
+    }
+
+    if (is_write)
+    {
+        memcpy(&this->mem[addr], data, size);
+    }
+    else
+    {
+        memcpy(data, &this->mem[addr], size);
+    }
+
+    return 0;
+}
+
+
+vp::IoReqStatus HwpeL1::req(vp::Block *__this, vp::IoReq *req)
+{
+    HwpeL1 *_this = (HwpeL1 *)__this;
+
+    if (_this->max_req_size != 0 && req->get_size() > _this->max_req_size)
+    {
+        return vp::IO_REQ_INVALID;
+    }
+
+    if (_this->debug_mem_access(req->get_addr(), req->get_data(), req->get_size(),
+        req->get_is_write()))
+    {
+        _this->trace.force_warning("Out of bound access (addr: 0x%lx, size: 0x%lx)\n",
+            req->get_addr(), req->get_size());
+        return vp::IO_REQ_INVALID;
+    }
+
+    return vp::IO_REQ_OK;
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new HwpeL1(config);
+}
@@ -0,0 +1,38 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class HwpeL1(gvsoc.systree.Component):
+    """Ideal L1 memory of the HWPE fast mode test.
+
+    Answers io requests synchronously with no latency and exposes the debug_mem
+    backdoor used by the accelerators in their fast modes. Its size bytes are
+    filled with random data drawn from seed, so that two instances with the
+    same seed start with the same content. Requests of more than max_req_size
+    bytes are refused with IO_REQ_INVALID, as by a target only taking one bank
+    at a time, unless max_req_size is 0.
+    """
+
+    def __init__(self, parent, name, *, size: int, seed: int, max_req_size: int=0):
+        super().__init__(parent, name)
+
+        self.add_sources(['hwpe_l1.cpp'])
+
+        self.add_property('size', size)
+        self.add_property('seed', seed)
+        self.add_property('max_req_size', max_req_size)
@@ -0,0 +1,365 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Fast mode versus timed job check of NE16, Neureka and LightRedmule.
+
+The same job runs on a timed accelerator and on one in its fast mode, each
+with its own L1 memory starting with the same random content. Both memories
+must be identical at the end of the jobs.
+
+NE16 and Neureka run a convolution layer in functional mode, as a batched
+layer kernel with a job duration estimated from the layer parameters. With the
+ideal L1 memory, the job must also end at the same cycle as the timed one. The
+layer is one of LAYERS, from a single tile to several tiles with remainders and
+the various modes of the accelerators. Their L1 memories are twice as large as
+the range they can address, so that a functional access going past the end of
+the range instead of wrapping around like the timed one is caught. With wrap,
+the input and output tiles of a single-tile layer are placed across the end of
+the range.
+
+LightRedmule runs an fp16 GEMM of size gemm (M-N-K) in analytic mode. With the
+ideal L1 memory and the default contention, the job must also end at the same
+cycle as the FSM one.
+
+RedMulE runs an fp16 GEMM of size gemm with both accelerators timed. The L1 of
+the first one refuses requests wider than a bank, so that its streamers move
+each line one bank at a time, while the second one gets whole lines. The job
+must end at the same cycle with both.
+"""
+
+import gvsoc.systree
+import gvsoc.runner
+
+import vp.clock_domain
+from gvrun.parameter import TargetParameter
+
+from pulp.ne16.ne16 import Ne16
+from pulp.neureka.neureka import Neureka
+from pulp.light_redmule.light_redmule import LightRedmule
+from pulp.redmule.redmule import RedMule
+from hwpe_l1 import HwpeL1
+from hwpe_job_bench import HwpeJobBench
+
+
+# Geometry of the accelerators with their default parameters
+ACCELS = {
+    'neureka': dict(l1_mask=0x3FFFF, tp_in=32, tp_in_3x3=28, tp_out=32, h_size=6,
+        f_buffer_size=8, weights_d0_3x3=32, weights_d0_1x1=32),
+    'ne16': dict(l1_mask=0x1FFFF, tp_in=16, tp_in_3x3=16, tp_out=32, h_size=3,
+        f_buffer_size=5, weights_d0_3x3=18, weights_d0_1x1=2),
+}
+
+QW = 8
+QUANT_SHIFT = 8
+
+# Register file of NE16 and Neureka
+HWPE_TRIGGER = 0x00
+HWPE_ACQUIRE = 0x04
+HWPE_REGS_BASE = 0x20
+
+# Register file of LightRedmule
+LIGHT_REDMULE_TRIGGER = 0x00
+LIGHT_REDMULE_X_ADDR = 0x40
+LIGHT_REDMULE_W_ADDR = 0x44
+LIGHT_REDMULE_Y_ADDR = 0x48
+LIGHT_REDMULE_MCFG0 = 0x4C
+LIGHT_REDMULE_MCFG1 = 0x50
+LIGHT_REDMULE_MARITH = 0x54
+LIGHT_REDMULE_MARITH_FP16 = 0x480
+
+# Register file of RedMulE, and its array with the default config.h, fp16 data
+REDMULE_TRIGGER = 0x00
+REDMULE_REGS_BASE = 0x40
+REDMULE_ARRAY_WIDTH = 12
+REDMULE_ARRAY_HEIGHT = 4
+REDMULE_TILE = 16
+REDMULE_DEPTH = 4
+
+REDMULE_L1_SIZE = 0x10000
+
+
+# Layers of the NE16 and Neureka jobs, with their sizes in multiples of the tile
+# sizes plus remainders. single is one full tile; tiled has several tiles with
+# remainders in all dimensions, padding and a weight offset; depthwise is a
+# tiled 3x3 depthwise layer; out32 streams out the 32-bit accumulators without
+# quantization; strided runs a 3x3 layer with 2x2 strides, filter masking and,
+# on Neureka, activation prefetch.
+LAYERS = {
+    'single': dict(k_in=(1, 0), k_out=(1, 0), size=(1, 0)),
+    'tiled': dict(k_in=(2, 5), k_out=(1, 7), size=(1, 2), padding=1, weight_offset=-37,
+        signed=True),
+    'depthwise': dict(k_in=(2, 3), k_out=(2, 3), size=(1, 1), depthwise=True),
+    'out32': dict(k_in=(1, 9), k_out=(1, 9), size=(1, 3), out32=True),
+    'strided': dict(k_in=(1, 0), k_out=(1, 0), size=(2, 0), strided=True, filter_mask=True,
+        prefetch=True),
+}
+
+
+def hwpe_tiles(tile: int, size: tuple):
+    """Number of tiles, remainder and total size of a layer dimension of
+    size[0] full tiles plus size[1] elements, a full last tile being its own
+    remainder."""
+    if size[1] == 0:
+        return size[0], tile, size[0] * tile
+    return size[0] + 1, size[1], size[0] * tile + size[1]
+
+
+def hwpe_job(accel: str, filter_size: int, wrap: bool, layer: str):
+    """Register writes of a layer with 8-bit activations and weights."""
+    geom = ACCELS[accel]
+    l1_range = geom['l1_mask'] + 1
+    opts = LAYERS[layer]
+    depthwise = opts.get('depthwise', False)
+    out32 = opts.get('out32', False)
+
+    tp_in = geom['tp_in_3x3'] if filter_size == 3 else geom['tp_in']
+    tp_out = geom['tp_in_3x3'] if depthwise else geom['tp_out']
+    h_size = geom['h_size']
+    weights_d0 = geom['weights_d0_3x3'] if filter_size == 3 else geom['weights_d0_1x1']
+
+    nb_ki, rem_ki, k_in = hwpe_tiles(tp_in, opts['k_in'])
+    nb_ko, rem_ko, k_out = hwpe_tiles(tp_out, opts['k_out'])
+    nb_o, rem_o, h_out = hwpe_tiles(h_size, opts['size'])
+    w_out = h_out
+    h_in = w_in = h_out + filter_size - 1
+    rem_i = rem_o + filter_size - 1
+    out_bytes = 4 if out32 else 1
+    prefetch = opts.get('prefetch', False) and accel == 'neureka'
+    mode = 1 if depthwise else 0 if filter_size == 3 else 2
+
+    if wrap:
+        # Lines of the first pixels of both tiles cross the end of the range
+        infeat = l1_range - 0x40
+        outfeat = l1_range - 0x10
+        base = 0x1000
+    elif layer == 'single':
+        infeat = 0x1000
+        outfeat = 0x3000
+        base = 0x4000
+    else:
+        infeat = 0x1000
+        outfeat = 0x6000
+        base = 0x10000
+    scale = base + nb_ko * tp_out * nb_ki * QW * weights_d0
+
+    config0 = (
+        (int(opts.get('signed', False)) << 26) |    # signed activations, on Neureka
+        (int(not out32) << 25) |                    # load the bias
+        ((2 if out32 else 0) << 21) |               # 32-bit or 8-bit output
+        (QUANT_SHIFT << 16) |                       # quantization right shift
+        (int(prefetch) << 10) |                     # activation prefetch
+        (int(opts.get('strided', False)) << 8) |    # 2x2 strides
+        (mode << 5) |                               # 3x3, depthwise or 1x1 filter
+        (int(not out32) << 4) |                     # quantization
+        (QW - 1)                                    # weight bits
+    )
+
+    padding = opts.get('padding', 0)
+    if opts.get('filter_mask'):
+        filter_mask = 0x0a1 if accel == 'neureka' else (1 << 24) | 1
+    else:
+        filter_mask = 0
+
+    regs = [
+        base,                           # weights
+        infeat,
+        outfeat,
+        scale,                          # scale
+        scale + 0x100,                  # scale shift
+        scale + 0x200,                  # scale bias
+        k_in,                           # infeat strides
+        k_in * w_in,
+        0,
+        32,                             # outfeat strides
+        k_out * out_bytes,
+        k_out * out_bytes * w_out,
+        weights_d0,                     # weights strides
+        weights_d0 * QW * nb_ki,
+        0,
+        (rem_ko << 16) | rem_ki,        # subtile remainders
+        (rem_o << 16) | rem_o,
+        (rem_i << 16) | rem_i,
+        (nb_ko << 16) | nb_ki,          # subtile numbers
+        (nb_o << 16) | nb_o,
+        (padding * 0x1111 << 16) | (0x11 if padding else 0), # padding
+        opts.get('weight_offset', 0) & 0xffffffff,
+        filter_mask,
+        config0,
+    ]
+
+    return [[HWPE_REGS_BASE + i * 4, value] for i, value in enumerate(regs)] + [[HWPE_TRIGGER, 0]]
+
+
+def light_redmule_job(m_size: int, n_size: int, k_size: int):
+    """Register writes of a fp16 GEMM Z = X * W + Y, Z replacing Y."""
+    x_addr = 0
+    w_addr = x_addr + m_size * n_size * 2
+    y_addr = w_addr + n_size * k_size * 2
+    assert y_addr + m_size * k_size * 2 <= REDMULE_L1_SIZE
+
+    return [
+        [LIGHT_REDMULE_X_ADDR, x_addr],
+        [LIGHT_REDMULE_W_ADDR, w_addr],
+        [LIGHT_REDMULE_Y_ADDR, y_addr],
+        [LIGHT_REDMULE_MCFG0, (k_size << 16) | m_size],
+        [LIGHT_REDMULE_MCFG1, n_size],
+        [LIGHT_REDMULE_MARITH, LIGHT_REDMULE_MARITH_FP16],
+        [LIGHT_REDMULE_TRIGGER, 0],
+    ]
+
+
+def redmule_job(m_size: int, n_size: int, k_size: int):
+    """Register writes of a fp16 GEMM Z = X * W + Y, with the values the RedMulE
+    runtime derives from the matrix sizes. The model computes N / 12 - 1 steps
+    per tile, which must be at least 2."""
+    assert n_size >= 3 * REDMULE_ARRAY_WIDTH
+    x_addr = 0
+    w_addr = x_addr + m_size * n_size * 2
+    y_addr = w_addr + n_size * k_size * 2
+    z_addr = y_addr + m_size * k_size * 2
+    assert z_addr + m_size * k_size * 2 <= REDMULE_L1_SIZE
+
+    x_rows_lftovr = m_size % REDMULE_ARRAY_WIDTH
+    x_cols_lftovr = n_size % REDMULE_TILE
+    w_rows_lftovr = n_size % REDMULE_ARRAY_HEIGHT
+    w_cols_lftovr = k_size % REDMULE_TILE
+    x_rows_iter = -(-m_size // REDMULE_ARRAY_WIDTH)
+    x_cols_iter = -(-n_size // REDMULE_TILE)
+    w_rows_iter = n_size + (REDMULE_ARRAY_HEIGHT - w_rows_lftovr if w_rows_lftovr else 0)
+    w_cols_iter = -(-k_size // REDMULE_TILE)
+
+    x_d1_stride = n_size * 2
+    w_d0_stride = k_size * 2
+    tot_stores = x_rows_iter * w_cols_iter
+    sub_matrices = (
+        (int(m_size < REDMULE_ARRAY_WIDTH) << 15) |
+        (int(n_size < REDMULE_ARRAY_HEIGHT) << 14) |
+        (int(k_size < REDMULE_TILE) << 13)
+    )
+
+    regs = [
+        x_addr,
+        w_addr,
+        y_addr,
+        z_addr,
+        (x_rows_iter << 16) | x_cols_iter,
+        (w_rows_iter << 16) | w_cols_iter,
+        (x_rows_lftovr << 24) | (x_cols_lftovr << 16) | (w_rows_lftovr << 8) | w_cols_lftovr,
+        (tot_stores << 16) | sub_matrices,
+        x_d1_stride,
+        w_rows_iter * w_cols_iter * x_rows_iter,            # w total length
+        x_rows_iter * x_cols_iter * w_cols_iter,            # total x reads
+        w_d0_stride,
+        REDMULE_ARRAY_WIDTH * x_rows_iter * w_cols_iter,    # y and z total length
+        w_d0_stride,                                        # y and z strides
+        REDMULE_ARRAY_WIDTH * w_d0_stride,
+        REDMULE_ARRAY_WIDTH * x_d1_stride,                  # x rows offset
+        -(-x_cols_lftovr // REDMULE_DEPTH),                 # x buffer slots
+        REDMULE_ARRAY_WIDTH * x_cols_iter * w_cols_iter * x_rows_iter, # x total length
+        0,                                                  # operation, not modelled
+    ]
+
+    return [[REDMULE_REGS_BASE + i * 4, value] for i, value in enumerate(regs)] + \
+        [[REDMULE_TRIGGER, 0]]
+
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, accel, filter_size, wrap, layer, gemm):
+        super().__init__(parent, name)
+
+        if accel == 'light_redmule':
+            l1_size = REDMULE_L1_SIZE
+            bench = HwpeJobBench(self, 'bench', acquire=-1, writes=light_redmule_job(*gemm),
+                l1_size=l1_size, same_cycles=True)
+        elif accel == 'redmule':
+            l1_size = REDMULE_L1_SIZE
+            bench = HwpeJobBench(self, 'bench', acquire=-1, writes=redmule_job(*gemm),
+                l1_size=l1_size, same_cycles=True)
+        else:
+            l1_size = 2 * (ACCELS[accel]['l1_mask'] + 1)
+            bench = HwpeJobBench(self, 'bench', acquire=HWPE_ACQUIRE,
+                writes=hwpe_job(accel, filter_size, wrap, layer), l1_size=l1_size,
+                same_cycles=True)
+
+        for i, fast in enumerate([False, True]):
+            if accel == 'light_redmule':
+                hwpe = LightRedmule(self, f'hwpe_{i}', tcdm_bank_width=4, tcdm_bank_number=16,
+                    elem_size=2, ce_height=8, ce_width=24, ce_pipe=3, queue_depth=1,
+                    analytic=fast)
+            elif accel == 'redmule':
+                hwpe = RedMule(self, f'hwpe_{i}')
+            elif accel == 'neureka':
+                hwpe = Neureka(self, f'hwpe_{i}', functional=fast)
+            else:
+                hwpe = Ne16(self, f'hwpe_{i}', functional=fast)
+
+            # Only the RedMulE streamers send requests wider than a bank
+            max_req_size = 4 if accel == 'redmule' and not fast else 0
+            l1 = HwpeL1(self, f'l1_{i}', size=l1_size, seed=0, max_req_size=max_req_size)
+
+            self.bind(bench, f'config_{i}', hwpe, 'input')
+            if accel == 'light_redmule':
+                self.bind(hwpe, 'done_irq', bench, f'irq_{i}')
+                self.bind(hwpe, 'tcdm', l1, 'input')
+            else:
+                self.bind(hwpe, 'irq', bench, f'irq_{i}')
+                self.bind(hwpe, 'out', l1, 'input')
+            self.bind(bench, f'l1_{i}', l1, 'input')
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name=None):
+
+        super().__init__(parent, name)
+
+        accel = TargetParameter(
+            self, name='accel', value='neureka',
+            description='Accelerator, neureka, ne16, light_redmule or redmule', cast=str
+        ).get_value()
+
+        filter_size = TargetParameter(
+            self, name='filter_size', value=3, description='Filter size, 3 or 1', cast=int
+        ).get_value()
+
+        wrap = TargetParameter(
+            self, name='wrap', value=False,
+            description='Place the tiles across the end of the L1 range', cast=bool
+        ).get_value()
+
+        layer = TargetParameter(
+            self, name='layer', value='single',
+            description='NE16 and Neureka layer, one of ' + ', '.join(LAYERS), cast=str
+        ).get_value()
+
+        gemm = TargetParameter(
+            self, name='gemm', value='16-24-32',
+            description='LightRedmule and RedMulE GEMM size, as M-N-K',
+            cast=str
+        ).get_value()
+        gemm = [int(size) for size in gemm.split('-')]
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100000000)
+        soc = Testbench(self, 'soc', accel, filter_size, wrap, layer, gemm)
+        clock.o_CLOCK(soc.i_CLOCK())
+
+
+class Target(gvsoc.runner.Target):
+
+    gapy_description = "NE16, Neureka, LightRedmule and RedMulE fast mode test"
+    model = Chip
+    name = "test"
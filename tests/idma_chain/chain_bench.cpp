@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * IDmaChainBench — descriptor chain check of the iDMA register frontend.
+ *
+ * The lower half of the memory is filled with a pattern in the source area and
+ * zeros in the destination area, and the chain descriptors are written to the
+ * upper half. The chain is started and, with reg_transfer, a small transfer is
+ * pushed through the registers right after it. This transfer reaches the
+ * middle-end before the first descriptor is read, so it completes first.
+ *
+ * Each interrupt is followed by a read of the completed ID. All the transfers
+ * up to this ID must have written their whole destination, which catches a
+ * chain being reported as completed before its last descriptor is done. The
+ * test ends once the ID of the last transfer is completed, checking that the
+ * expected number of interrupts was received.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <vp/itf/wire.hpp>
+#include <stdio.h>
+#include <vector>
+
+
+// Register map of the frontend
+#define REG_TRIGGER         0x10
+#define REG_COMPLETED_ID    0x18
+#define REG_DESC_ADDR       0x20
+#define REG_DESC_CONFIG     0x28
+#define REG_DESC_TRIGGER    0x30
+#define REG_DST             0xd0
+#define REG_SRC             0xd8
+#define REG_LENGTH          0xe0
+#define REG_DST_STRIDE      0xe8
+#define REG_SRC_STRIDE      0xf0
+#define REG_REPS            0xf8
+
+// Memory layout, the descriptors go after the destination area
+#define SRC_BASE            0x0000
+#define DST_BASE            0x4000
+#define DATA_SIZE           0x8000
+#define CHAIN_MAX_SIZE      0x2000
+#define REG_SRC_BASE        (SRC_BASE + CHAIN_MAX_SIZE)
+#define REG_DST_BASE        (DST_BASE + CHAIN_MAX_SIZE)
+#define REG_SIZE            0x40
+#define DESC_BASE           DATA_SIZE
+#define DESC_SIZE           64
+#define DESC_END            ((uint64_t)-1)
+
+
+class IDmaChainBench : public vp::Component
+{
+public:
+    IDmaChainBench(vp::ComponentConf &config);
+
+    void reset(bool active) override;
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void irq_sync(vp::Block *__this, bool value);
+    uint32_t access(vp::IoMaster *itf, uint64_t addr, uint8_t *data, uint64_t size, bool is_write);
+    uint32_t reg_write(uint64_t offset, uint32_t value);
+    uint8_t pattern(uint64_t addr) { return (addr * 7 + 3) & 0xff; }
+    void start();
+    int check_copy(uint64_t src, uint64_t dst, uint64_t size);
+    void check();
+
+    vp::Trace trace;
+    vp::IoMaster regs_itf;
+    vp::IoMaster mem_itf;
+    vp::WireSlave<bool> irq_itf;
+    vp::ClockEvent fsm_event;
+    vp::IoReq req;
+
+    int nb_descs;
+    uint64_t desc_size;
+    bool irq_at_end;
+    bool reg_transfer;
+
+    bool started;
+    uint32_t chain_id;
+    uint32_t reg_id;
+    uint32_t last_id;
+    int nb_irqs;
+    int nb_errors;
+};
+
+
+IDmaChainBench::IDmaChainBench(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &IDmaChainBench::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->nb_descs = js->get_int("nb_descs");
+    this->desc_size = js->get_int("desc_size");
+    this->irq_at_end = js->get_child_bool("irq_at_end");
+    this->reg_transfer = js->get_child_bool("reg_transfer");
+
+    if (this->nb_descs * this->desc_size > CHAIN_MAX_SIZE)
+    {
+        this->trace.fatal("Chain does not fit the source area (nb_descs: %d, desc_size: 0x%lx)\n",
+            this->nb_descs, this->desc_size);
+    }
+
+    this->new_master_port("regs", &this->regs_itf);
+    this->new_master_port("mem", &this->mem_itf);
+    this->irq_itf.set_sync_meth(&IDmaChainBench::irq_sync);
+    this->new_slave_port("irq", &this->irq_itf);
+}
+
+
+void IDmaChainBench::reset(bool active)
+{
+    if (!active)
+    {
+        this->started = false;
+        this->nb_irqs = 0;
+        this->nb_errors = 0;
+        this->fsm_event.enqueue();
+    }
+}
+
+
+uint32_t IDmaChainBench::access(vp::IoMaster *itf, uint64_t addr, uint8_t *data, uint64_t size,
+    bool is_write)
+{
+    this->req.init();
+    this->req.set_addr(addr);
+    this->req.set_size(size);
+    this->req.set_data(data);
+    this->req.set_is_write(is_write);
+
+    if (itf->req(&this->req) != vp::IO_REQ_OK)
+    {
+        this->trace.fatal("Unsupported asynchronous reply (addr: 0x%lx)\n", addr);
+    }
+
+    return size == 4 ? *(uint32_t *)data : 0;
+}
+
+
+uint32_t IDmaChainBench::reg_write(uint64_t offset, uint32_t value)
+{
+    // Triggers return the allocated ID in the data of the write
+    return this->access(&this->regs_itf, offset, (uint8_t *)&value, 4, true);
+}
+
+
+void IDmaChainBench::start()
+{
+    std::vector<uint8_t> data(DATA_SIZE, 0);
+    for (uint64_t addr=SRC_BASE; addr<DST_BASE; addr++)
+    {
+        data[addr] = this->pattern(addr);
+    }
+    this->access(&this->mem_itf, 0, data.data(), DATA_SIZE, true);
+
+    for (int i=0; i<this->nb_descs; i++)
+    {
+        uint64_t desc[DESC_SIZE / 8] = {
+            i == this->nb_descs - 1 ? DESC_END : DESC_BASE + (i + 1) * DESC_SIZE,
+            SRC_BASE + i * this->desc_size,
+            DST_BASE + i * this->desc_size,
+            this->desc_size,
+            0, 0, 1, 0
+        };
+        this->access(&this->mem_itf, DESC_BASE + i * DESC_SIZE, (uint8_t *)desc, DESC_SIZE, true);
+    }
+
+    this->reg_write(REG_DESC_ADDR, DESC_BASE);
+    this->reg_write(REG_DESC_CONFIG, this->irq_at_end);
+    this->chain_id = this->reg_write(REG_DESC_TRIGGER, 0);
+    this->last_id = this->chain_id;
+
+    if (this->reg_transfer)
+    {
+        this->reg_write(REG_DST, REG_DST_BASE);
+        this->reg_write(REG_SRC, REG_SRC_BASE);
+        this->reg_write(REG_LENGTH, REG_SIZE);
+        this->reg_write(REG_DST_STRIDE, 0);
+        this->reg_write(REG_SRC_STRIDE, 0);
+        this->reg_write(REG_REPS, 1);
+        this->reg_id = this->reg_write(REG_TRIGGER, 0);
+        this->last_id = this->reg_id;
+    }
+
+    this->started = true;
+}
+
+
+int IDmaChainBench::check_copy(uint64_t src, uint64_t dst, uint64_t size)
+{
+    std::vector<uint8_t> data(size);
+    this->access(&this->mem_itf, dst, data.data(), size, false);
+
+    int nb_errors = 0;
+    for (uint64_t i=0; i<size; i++)
+    {
+        if (data[i] != this->pattern(src + i))
+        {
+            if (nb_errors < 10)
+            {
+                printf("Mismatch at 0x%lx (got: 0x%2.2x, expected: 0x%2.2x)\n", dst + i, data[i],
+                    this->pattern(src + i));
+            }
+            nb_errors++;
+        }
+    }
+
+    return nb_errors;
+}
+
+
+void IDmaChainBench::check()
+{
+    uint32_t completed_id;
+    this->access(&this->regs_itf, REG_COMPLETED_ID, (uint8_t *)&completed_id, 4, false);
+
+    this->trace.msg(vp::Trace::LEVEL_INFO, "Checking completed ID (id: %d, irqs: %d)\n",
+        completed_id, this->nb_irqs);
+
+    // Check only the transfers which are reported as completed
+    if (completed_id >= this->chain_id)
+    {
+        this->nb_errors += this->check_copy(SRC_BASE, DST_BASE, this->nb_descs * this->desc_size);
+    }
+    if (this->reg_transfer && completed_id >= this->reg_id)
+    {
+        this->nb_errors += this->check_copy(REG_SRC_BASE, REG_DST_BASE, REG_SIZE);
+    }
+
+    if (this->nb_errors != 0 || completed_id == this->last_id)
+    {
+        int expected_irqs = (this->irq_at_end ? 1 : this->nb_descs) + this->reg_transfer;
+        if (this->nb_irqs != expected_irqs)
+        {
+            printf("Received %d interrupts, expected %d\n", this->nb_irqs, expected_irqs);
+            this->nb_errors++;
+        }
+
+        printf("[idma_chain] %d descriptors, %ld cycles, %d errors\n", this->nb_descs,
+            this->clock.get_cycles(), this->nb_errors);
+
+        this->time.get_engine()->quit(this->nb_errors != 0);
+    }
+}
+
+
+void IDmaChainBench::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    IDmaChainBench *_this = (IDmaChainBench *)__this;
+
+    if (!_this->started)
+    {
+        _this->start();
+    }
+    else
+    {
+        _this->check();
+    }
+}
+
+
+void IDmaChainBench::irq_sync(vp::Block *__this, bool value)
+{
+    IDmaChainBench *_this = (IDmaChainBench *)__this;
+
+    if (!value)
+    {
+        return;
+    }
+
+    _this->nb_irqs++;
+
+    // The interrupt is raised from the middle of the frontend, the completed ID is read from
+    // the next cycle
+    if (!_this->fsm_event.is_enqueued())
+    {
+        _this->fsm_event.enqueue();
+    }
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new IDmaChainBench(config);
+}
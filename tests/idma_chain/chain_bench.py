@@ -0,0 +1,48 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class IDmaChainBench(gvsoc.systree.Component):
+    """Descriptor chain check of the iDMA register frontend.
+
+    Writes a chain of nb_descs descriptors of desc_size bytes and their source
+    data to the memory, starts the chain and, with reg_transfer, pushes a small
+    transfer through the registers right after. On each interrupt, the completed
+    ID is read and all the transfers it covers must have written their
+    destination.
+    """
+
+    def __init__(self, parent, name, *, nb_descs: int, desc_size: int, irq_at_end: bool,
+            reg_transfer: bool):
+        super().__init__(parent, name)
+
+        self.add_sources(['chain_bench.cpp'])
+
+        self.add_property('nb_descs', nb_descs)
+        self.add_property('desc_size', desc_size)
+        self.add_property('irq_at_end', irq_at_end)
+        self.add_property('reg_transfer', reg_transfer)
+
+    def o_REGS(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('regs', itf, signature='io')
+
+    def o_MEM(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('mem', itf, signature='io')
+
+    def i_IRQ(self) -> gvsoc.systree.SlaveItf:
+        return gvsoc.systree.SlaveItf(self, 'irq', signature='wire<bool>')
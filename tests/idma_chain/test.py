@@ -0,0 +1,96 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Descriptor chain check of the iDMA register frontend (pulp/idma).
+
+The register DMA moves data within a single memory, reached through a router
+by its AXI ports, its descriptor port and the bench. The bench drives the
+registers directly and receives the interrupts.
+"""
+
+import gvsoc.systree
+import gvsoc.runner
+
+import vp.clock_domain
+import memory.memory as memory
+import interco.router as router
+from gvrun.parameter import TargetParameter
+
+from pulp.idma.reg_dma import RegDma
+from pulp.idma.reg_dma_config import RegDmaConfig
+from chain_bench import IDmaChainBench
+
+
+MEM_SIZE = 0x10000
+DESC_SIZE = 0x400
+AXI_WIDTH = 8
+
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, nb_descs, irq_at_end, reg_transfer):
+        super().__init__(parent, name)
+
+        dma = RegDma(self, 'dma', config=RegDmaConfig(transfer_queue_size=4,
+            burst_queue_size=4))
+
+        bench = IDmaChainBench(self, 'bench', nb_descs=nb_descs, desc_size=DESC_SIZE,
+            irq_at_end=irq_at_end, reg_transfer=reg_transfer)
+
+        mem = memory.Memory(self, 'mem', size=MEM_SIZE)
+
+        axi = router.Router(self, 'axi', bandwidth=AXI_WIDTH, latency=1)
+        axi.add_mapping('mem', base=0, size=MEM_SIZE)
+        self.bind(axi, 'mem', mem, 'input')
+
+        bench.o_REGS(dma.i_INPUT())
+        bench.o_MEM(axi.i_INPUT())
+        dma.o_AXI(axi.i_INPUT())
+        dma.o_DESC(axi.i_INPUT())
+        dma.o_IRQ(bench.i_IRQ())
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name=None):
+
+        super().__init__(parent, name)
+
+        nb_descs = TargetParameter(
+            self, name='nb_descs', value=4, description='Number of descriptors of the chain',
+            cast=int
+        ).get_value()
+
+        irq_at_end = TargetParameter(
+            self, name='irq_at_end', value=False,
+            description='Raise a single interrupt at the end of the chain', cast=bool
+        ).get_value()
+
+        reg_transfer = TargetParameter(
+            self, name='reg_transfer', value=False,
+            description='Push a register transfer while the chain is active', cast=bool
+        ).get_value()
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100000000)
+        soc = Testbench(self, 'soc', nb_descs, irq_at_end, reg_transfer)
+        clock.o_CLOCK(soc.i_CLOCK())
+
+
+class Target(gvsoc.runner.Target):
+
+    gapy_description = "iDMA descriptor chain test"
+    model = Chip
+    name = "test"
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone check of the N-dimensional middle-end burst iterator.
+ *
+ * For random transfers of up to 4 dimensions, the bursts are expanded into
+ * byte copies and compared with the nested loops of the hardware order, with
+ * and without merging of the contiguous dimensions. Then the number of bursts
+ * is checked for a few tensor layouts: it must drop when the layout is
+ * contiguous and stay the same when it is not.
+ *
+ * Built and run with "make nd_check".
+ */
+
+#include <stdio.h>
+#include <random>
+#include <utility>
+#include <vector>
+#include "idma_me_nd_iter.hpp"
+
+static constexpr int NB_TRANSFERS = 20000;
+
+typedef std::vector<std::pair<uint64_t, uint64_t>> Copies;
+
+// Byte copies of the transfer, in the order of the hardware nested loops
+static Copies reference_copies(uint64_t src, uint64_t dst, uint64_t size,
+    const IdmaNdIter::Dim *dims, int nb_dims)
+{
+    Copies result;
+    uint64_t count[IDMA_ND_MAX_DIMS] = { 0 };
+
+    for (int i = 0; i < nb_dims; i++)
+    {
+        if (dims[i].reps == 0) return result;
+    }
+
+    while (true)
+    {
+        uint64_t burst_src = src, burst_dst = dst;
+        for (int i = 0; i < nb_dims; i++)
+        {
+            burst_src += count[i] * dims[i].src_stride;
+            burst_dst += count[i] * dims[i].dst_stride;
+        }
+        for (uint64_t b = 0; b < size; b++)
+        {
+            result.push_back({ burst_src + b, burst_dst + b });
+        }
+
+        int i = 0;
+        for (; i < nb_dims; i++)
+        {
+            if (++count[i] < dims[i].reps) break;
+            count[i] = 0;
+        }
+        if (i == nb_dims) return result;
+    }
+}
+
+// Byte copies of the transfer, as given by the iterator
+static Copies iter_copies(IdmaNdIter &iter, uint64_t src, uint64_t dst, uint64_t size,
+    const IdmaNdIter::Dim *dims, int nb_dims, bool merge, uint64_t &nb_bursts)
+{
+    Copies result;
+    nb_bursts = 0;
+
+    if (!iter.init(src, dst, size, dims, nb_dims, merge)) return result;
+
+    bool last;
+    do
+    {
+        uint64_t burst_src, burst_dst;
+        last = iter.next(burst_src, burst_dst);
+        nb_bursts++;
+        for (uint64_t b = 0; b < iter.burst_size(); b++)
+        {
+            result.push_back({ burst_src + b, burst_dst + b });
+        }
+    } while (!last);
+
+    return result;
+}
+
+// Number of bursts of a tensor layout, with or without merging
+static uint64_t layout_bursts(uint64_t size, const IdmaNdIter::Dim *dims, int nb_dims, bool merge)
+{
+    IdmaNdIter iter;
+    uint64_t nb_bursts;
+    Copies copies = iter_copies(iter, 0x1000, 0x100000, size, dims, nb_dims, merge, nb_bursts);
+    if (copies != reference_copies(0x1000, 0x100000, size, dims, nb_dims))
+    {
+        return 0;
+    }
+    if (nb_bursts != iter.nb_bursts())
+    {
+        return 0;
+    }
+    return nb_bursts;
+}
+
+int main()
+{
+    std::mt19937 rng(0);
+    IdmaNdIter iter;
+    int errors = 0;
+
+    for (int t = 0; t < NB_TRANSFERS; t++)
+    {
+        uint64_t size = rng() % 16;
+        int nb_dims = rng() % IDMA_ND_MAX_DIMS;
+        IdmaNdIter::Dim dims[IDMA_ND_MAX_DIMS - 1];
+        uint64_t span = size;
+
+        for (int i = 0; i < nb_dims; i++)
+        {
+            // Make the strides often contiguous so that merging gets exercised
+            uint64_t reps = rng() % 5;
+            uint64_t src_stride = rng() % 3 ? span : rng() % 64;
+            uint64_t dst_stride = rng() % 3 ? span : rng() % 64;
+            dims[i] = { src_stride, dst_stride, reps };
+            span *= reps ? reps : 1;
+        }
+
+        Copies expected = reference_copies(0x100, 0x10000, size, dims, nb_dims);
+
+        for (bool merge: { false, true })
+        {
+            uint64_t nb_bursts;
+            Copies got = iter_copies(iter, 0x100, 0x10000, size, dims, nb_dims, merge, nb_bursts);
+            if (got != expected)
+            {
+                printf("Mismatch on transfer %d (merge: %d, size: %lu, nb_dims: %d)\n", t, merge,
+                    size, nb_dims);
+                errors++;
+            }
+        }
+    }
+
+    // Tensor layouts: HWC tile copies of 4-byte elements, innermost dimension first
+    struct Layout
+    {
+        const char *name;
+        uint64_t size;
+        int nb_dims;
+        IdmaNdIter::Dim dims[IDMA_ND_MAX_DIMS - 1];
+        bool contiguous;
+    };
+
+    static const Layout layouts[] = {
+        { "full tensor 16x8x8", 16*4, 3,
+            { { 16*4, 16*4, 8 }, { 8*16*4, 8*16*4, 8 }, { 0, 0, 1 } }, true },
+        { "full rows of a 16x8x32 tile", 16*4, 3,
+            { { 16*4, 16*4, 8 }, { 32*16*4, 8*16*4, 8 }, { 0, 0, 1 } }, true },
+        { "batch of 2 tiles, inner rows merged", 16*4, 3,
+            { { 16*4, 16*4, 8 }, { 8*16*4, 8*16*4, 8 }, { 0x10000, 0x2000, 2 } }, true },
+        { "channel slice of a 64x8x8 tensor", 16*4, 2,
+            { { 64*4, 16*4, 8 }, { 8*64*4, 8*16*4, 8 } }, false },
+        { "im2col 3x3 patch", 3*16*4, 2,
+            { { 32*16*4, 3*16*4, 3 }, { 0, 0, 1 } }, false },
+    };
+
+    for (const Layout &layout: layouts)
+    {
+        uint64_t unmerged = layout_bursts(layout.size, layout.dims, layout.nb_dims, false);
+        uint64_t merged = layout_bursts(layout.size, layout.dims, layout.nb_dims, true);
+
+        printf("%-40s bursts: %4lu -> %4lu\n", layout.name, unmerged, merged);
+
+        if (unmerged == 0 || merged == 0 ||
+            (layout.contiguous ? merged >= unmerged : merged != unmerged))
+        {
+            printf("Unexpected number of bursts for layout %s\n", layout.name);
+            errors++;
+        }
+    }
+
+    if (errors)
+    {
+        printf("FAILED with %d errors\n", errors);
+        return 1;
+    }
+
+    printf("PASSED\n");
+    return 0;
+}
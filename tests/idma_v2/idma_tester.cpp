@@ -31,6 +31,11 @@
  *
  * All transfer parameters (src/dst/length/strides/reps/config/seed) come from
  * the JSON config built by tests/idma_v2/test.py.
+ *
+ * When desc_count is not 0, the transfer is instead described by a chain of
+ * desc_count descriptors preloaded by the target at desc_addr. Descriptor d
+ * copies the same geometry with src/dst moved by d * desc_src_step /
+ * d * desc_dst_step, and its pattern continues where descriptor d-1 stopped.
  */
 
 #include <vp/vp.hpp>
@@ -42,6 +47,9 @@
 
 // iDMA register offsets (mirror gvsoc/pulp/models/pulp/ips/pulp/idma_v2/fe/idma_fe_reg.cpp).
 static constexpr uint64_t IDMA_REG_TRIGGER     = 0x10;
+static constexpr uint64_t IDMA_REG_DESC_ADDR   = 0x20;
+static constexpr uint64_t IDMA_REG_DESC_CONFIG = 0x28;
+static constexpr uint64_t IDMA_REG_DESC_TRIGGER = 0x30;
 static constexpr uint64_t IDMA_REG_DST         = 0xd0;
 static constexpr uint64_t IDMA_REG_SRC         = 0xd8;
 static constexpr uint64_t IDMA_REG_LENGTH      = 0xe0;
@@ -93,6 +101,8 @@ private:
     void issue_reg_write(uint64_t offset, uint32_t value);
     // Trigger transfer (write to NEXT_ID register, value irrelevant).
     void issue_trigger();
+    // Number of IRQ pulses the iDMA sends for the whole test
+    uint64_t expected_irqs() const;
 
     void fail(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
     void pass();
@@ -115,9 +125,15 @@ private:
     uint64_t config_word;  // 0 for 1D, (1<<1) for 2D
     uint32_t pattern_seed;
     int64_t  quit_after_cycles;
+    uint64_t desc_count;     // 0 for register-programmed transfers
+    uint64_t desc_addr;      // head of the descriptor chain
+    uint64_t desc_src_step;  // src offset between 2 descriptors
+    uint64_t desc_dst_step;  // dst offset between 2 descriptors
+    bool     irq_at_end;     // one IRQ for the whole chain instead of one per descriptor
 
     // Per-step state:
     Phase phase;
+    uint64_t cur_desc;
     uint64_t cur_rep;
     uint64_t cur_byte;     // byte cursor within current rep, advances by 4
     int      program_step; // index into the register-write sequence
@@ -134,6 +150,7 @@ private:
 
     bool waiting_for_resp = false;
     bool got_irq = false;
+    uint64_t nb_irqs = 0;
 
     // Latency / bandwidth measurement points. trigger_cycle is captured the
     // moment we transition into WAIT_IRQ (i.e. one cycle after the trigger
@@ -170,6 +187,11 @@ IDmaTesterV2::IDmaTesterV2(vp::ComponentConf &config)
     this->quit_after_cycles = cfg->get_child_int("quit_after_cycles");
     if (this->quit_after_cycles <= 0)
         this->quit_after_cycles = 1000000;
+    this->desc_count    = (uint64_t)cfg->get_child_int("desc_count");
+    this->desc_addr     = (uint64_t)cfg->get_child_int("desc_addr");
+    this->desc_src_step = (uint64_t)cfg->get_child_int("desc_src_step");
+    this->desc_dst_step = (uint64_t)cfg->get_child_int("desc_dst_step");
+    this->irq_at_end    = cfg->get_child_bool("irq_at_end");
 
     this->mem_req.set_data(this->mem_data);
     this->mem_req.set_size(4);
@@ -186,11 +208,13 @@ void IDmaTesterV2::reset(bool active)
         // straight to PROGRAM. This keeps the iDMA's idma_cycles measurement
         // unaffected by tester-FILL traffic on the shared router.
         this->phase = PHASE_PROGRAM;
+        this->cur_desc = 0;
         this->cur_rep = 0;
         this->cur_byte = 0;
         this->program_step = 0;
         this->waiting_for_resp = false;
         this->got_irq = false;
+        this->nb_irqs = 0;
         printf("[%ld] tester START reps=%lu length=%lu src=0x%lx dst=0x%lx seed=0x%x\n",
             this->clock.get_cycles(), this->reps, this->length, this->src, this->dst,
             this->pattern_seed);
@@ -211,6 +235,7 @@ void IDmaTesterV2::schedule_step(int delay)
 void IDmaTesterV2::start_phase(Phase p)
 {
     this->phase = p;
+    this->cur_desc = 0;
     this->cur_rep = 0;
     this->cur_byte = 0;
     this->program_step = 0;
@@ -336,6 +361,14 @@ void IDmaTesterV2::issue_trigger()
 }
 
 
+uint64_t IDmaTesterV2::expected_irqs() const
+{
+    if (this->desc_count == 0 || this->irq_at_end)
+        return 1;
+    return this->desc_count;
+}
+
+
 void IDmaTesterV2::step()
 {
     if (this->waiting_for_resp) return;
@@ -366,6 +399,22 @@ void IDmaTesterV2::step()
         {
             // Program registers in the order the v1 reg_dma test sequence used.
             // After all are programmed, trigger and move to WAIT_IRQ.
+            if (this->desc_count != 0)
+            {
+                // Descriptor chain: only the head and the config are programmed
+                switch (this->program_step)
+                {
+                    case 0: this->issue_reg_write(IDMA_REG_DESC_ADDR, (uint32_t)this->desc_addr); break;
+                    case 1: this->issue_reg_write(IDMA_REG_DESC_CONFIG, this->irq_at_end ? 1 : 0); break;
+                    case 2:
+                        this->trigger_cycle = this->clock.get_cycles();
+                        this->issue_reg_write(IDMA_REG_DESC_TRIGGER, 0);
+                        break;
+                    default: this->start_phase(PHASE_WAIT_IRQ); return;
+                }
+                this->program_step++;
+                break;
+            }
             switch (this->program_step)
             {
                 case 0: this->issue_reg_write(IDMA_REG_DST,        (uint32_t)this->dst); break;
@@ -383,7 +432,7 @@ void IDmaTesterV2::step()
 
         case PHASE_WAIT_IRQ:
         {
-            if (this->got_irq)
+            if (this->got_irq && this->nb_irqs >= this->expected_irqs())
             {
                 this->got_irq = false;
                 this->start_phase(PHASE_READBACK);
@@ -398,13 +447,16 @@ void IDmaTesterV2::step()
             // Zero-size or zero-rep 2D cases: the iDMA acks the transfer
             // immediately without moving any bytes, so there is nothing to
             // verify on the destination.
-            if (this->cur_rep >= this->reps || this->length == 0)
+            uint64_t nb_descs = this->desc_count != 0 ? this->desc_count : 1;
+            if (this->cur_desc >= nb_descs || this->cur_rep >= this->reps || this->length == 0)
             {
                 this->pass();
                 return;
             }
-            uint64_t addr  = this->dst + this->cur_rep * this->dst_stride + this->cur_byte;
-            uint64_t logoff = this->cur_rep * this->length + this->cur_byte;
+            uint64_t addr  = this->dst + this->cur_desc * this->desc_dst_step
+                + this->cur_rep * this->dst_stride + this->cur_byte;
+            uint64_t logoff = (this->cur_desc * this->reps + this->cur_rep) * this->length
+                + this->cur_byte;
             this->issue_mem_read(addr, logoff);
 
             this->cur_byte += 4;
@@ -412,6 +464,11 @@ void IDmaTesterV2::step()
             {
                 this->cur_byte = 0;
                 this->cur_rep++;
+                if (this->cur_rep >= this->reps)
+                {
+                    this->cur_rep = 0;
+                    this->cur_desc++;
+                }
             }
             break;
         }
@@ -512,6 +569,12 @@ void IDmaTesterV2::irq_sync(vp::Block *__this, bool value)
         _this->irq_cycle = _this->clock.get_cycles();
         printf("[%ld] tester IRQ\n", _this->irq_cycle);
         _this->got_irq = true;
+        _this->nb_irqs++;
+        if (_this->nb_irqs > _this->expected_irqs())
+        {
+            _this->fail("got %lu IRQs, expected %lu", _this->nb_irqs, _this->expected_irqs());
+            return;
+        }
         _this->schedule_step(1);
     }
 }
@@ -549,7 +612,7 @@ void IDmaTesterV2::pass()
 {
     int64_t now = this->clock.get_cycles();
     int64_t idma_cycles = this->irq_cycle - this->trigger_cycle;
-    uint64_t bytes = this->length * this->reps;
+    uint64_t bytes = this->length * this->reps * (this->desc_count != 0 ? this->desc_count : 1);
     // bytes_per_1000_cycles avoids float in C++; checker on the Python side
     // can divide by 1000.0 for a friendlier number.
     int64_t bw_x1000 = idma_cycles > 0
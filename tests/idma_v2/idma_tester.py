@@ -24,6 +24,9 @@ class IDmaTesterV2(gvsoc.systree.Component):
     iDMA registers, waits for the completion IRQ, then reads the destination
     range back and checks each byte against the same pattern. Calls
     engine->quit(0) on success and quit(1) on the first mismatch or timeout.
+
+    With ``desc_count`` set, the iDMA is instead started on a chain of
+    ``desc_count`` descriptors which the target preloads at ``desc_addr``.
     """
 
     def __init__(self, parent, name, *,
@@ -32,7 +35,10 @@ class IDmaTesterV2(gvsoc.systree.Component):
                  src_stride: int = 0, dst_stride: int = 0,
                  reps: int = 1, config: int = 0,
                  pattern_seed: int = 0xa5,
-                 quit_after_cycles: int = 1_000_000):
+                 quit_after_cycles: int = 1_000_000,
+                 desc_count: int = 0, desc_addr: int = 0,
+                 desc_src_step: int = 0, desc_dst_step: int = 0,
+                 irq_at_end: bool = False):
         super().__init__(parent, name)
         self.add_sources(['idma_tester.cpp'])
         self.add_property('regs_addr',         regs_addr)
@@ -45,6 +51,11 @@ class IDmaTesterV2(gvsoc.systree.Component):
         self.add_property('config',            config)
         self.add_property('pattern_seed',      pattern_seed)
         self.add_property('quit_after_cycles', quit_after_cycles)
+        self.add_property('desc_count',        desc_count)
+        self.add_property('desc_addr',         desc_addr)
+        self.add_property('desc_src_step',     desc_src_step)
+        self.add_property('desc_dst_step',     desc_dst_step)
+        self.add_property('irq_at_end',        irq_at_end)
 
     def o_REGS(self, itf: gvsoc.systree.SlaveItf):
         self.itf_bind('regs', itf, signature='io_v2')
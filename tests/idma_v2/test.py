@@ -51,6 +51,10 @@ TCDM_BASE  = 0x30000000
 TCDM_SIZE  = 0x10000
 REGS_BASE  = 0x40000000
 REGS_SIZE  = 0x100
+# Descriptor chains are preloaded in the upper half of the TCDM
+DESC_BASE  = TCDM_BASE + 0x8000
+DESC_SIZE  = 64
+DESC_END   = (1 << 64) - 1
 
 
 def build_case(case_name: str) -> dict:
@@ -67,6 +71,9 @@ def build_case(case_name: str) -> dict:
         router_kind=KIND_BANDWIDTH,
         idma_axi_width=8,
     )
+    # Descriptor chain cases: same geometry for every descriptor, moved by
+    # desc_{src,dst}_step from one descriptor to the next.
+    chain = dict(desc_addr=DESC_BASE, desc_src_step=0x1000, desc_dst_step=0x1000)
     if case_name == '1d_small':
         # 64 byte 1D copy mem_a -> mem_b. Smallest interesting case.
         return {**common,
@@ -212,6 +219,39 @@ def build_case(case_name: str) -> dict:
             'router_kind': KIND_BACKPRESSURE,
         }
 
+    if case_name == 'chain_4':
+        # Chain of 4 descriptors of 1 KiB each, one IRQ per descriptor.
+        return {**common, **chain,
+            'src': MEM_A_BASE, 'dst': MEM_B_BASE,
+            'length': 0x400, 'pattern_seed': 0xc4,
+            'desc_count': 4,
+        }
+    if case_name == 'chain_irq_end':
+        # Chain of 8 small descriptors with a single IRQ at the end of the chain.
+        return {**common, **chain,
+            'src': MEM_A_BASE, 'dst': MEM_B_BASE,
+            'length': 64, 'pattern_seed': 0xce,
+            'desc_count': 8, 'desc_src_step': 0x100, 'desc_dst_step': 0x200,
+            'irq_at_end': True,
+        }
+    if case_name == 'chain_2d':
+        # Chain of 3 2D descriptors, 4 lines x 128 B each.
+        return {**common, **chain,
+            'src': MEM_A_BASE, 'dst': MEM_B_BASE,
+            'length': 128, 'src_stride': 0x200, 'dst_stride': 0x100,
+            'reps': 4, 'config': (1 << 1), 'pattern_seed': 0xc2,
+            'desc_count': 3, 'irq_at_end': True,
+        }
+    if case_name == 'bp_chain':
+        # Chain of 4 descriptors through backpressure. Descriptor reads compete
+        # with the AXI bursts of the previous descriptors and get denied.
+        return {**common, **chain,
+            'src': MEM_A_BASE, 'dst': MEM_B_BASE,
+            'length': 0x400, 'pattern_seed': 0xbc,
+            'desc_count': 4, 'irq_at_end': True,
+            'router_kind': KIND_BACKPRESSURE,
+        }
+
     raise ValueError(f'Unknown case: {case_name!r}')
 
 
@@ -221,6 +261,7 @@ def _src_memory(spec):
     """
     src = spec['src']
     end = spec['src'] + max(1, (spec['reps'] - 1) * spec['src_stride'] + spec['length'])
+    end += max(0, spec.get('desc_count', 0) - 1) * spec.get('desc_src_step', 0)
     for name, base, size in (
         ('mem_a', MEM_A_BASE, MEM_A_SIZE),
         ('mem_b', MEM_B_BASE, MEM_B_SIZE),
@@ -249,14 +290,42 @@ def _stim_bytes_for_source(spec):
     length = spec['length']
     src_stride = spec['src_stride']
     reps = spec['reps']
-    end_off = src_off + max(0, (reps - 1) * src_stride) + length
+    # A register-programmed transfer is handled like a chain of one descriptor
+    descs = max(1, spec.get('desc_count', 0))
+    desc_step = spec.get('desc_src_step', 0)
+    end_off = src_off + (descs - 1) * desc_step + max(0, (reps - 1) * src_stride) + length
     buf = bytearray(end_off)  # zero-filled prefix; iDMA never reads it
-    for r in range(reps):
-        for b in range(length):
-            buf[src_off + r * src_stride + b] = (seed + r * length + b) & 0xff
+    for d in range(descs):
+        for r in range(reps):
+            for b in range(length):
+                buf[src_off + d * desc_step + r * src_stride + b] = \
+                    (seed + (d * reps + r) * length + b) & 0xff
     return name, bytes(buf)
 
 
+def _stim_bytes_for_descriptors(spec):
+    """Build the blob holding the descriptor chain, to be preloaded in the
+    TCDM. Returns (None, None) for register-programmed cases.
+    """
+    count = spec.get('desc_count', 0)
+    if count == 0:
+        return None, None
+    head = spec['desc_addr']
+    off = head - TCDM_BASE
+    buf = bytearray(off + count * DESC_SIZE)
+    for d in range(count):
+        addr = head + d * DESC_SIZE
+        next_addr = addr + DESC_SIZE if d < count - 1 else DESC_END
+        buf[off + d * DESC_SIZE:off + (d + 1) * DESC_SIZE] = struct.pack('<8Q',
+            next_addr,
+            spec['src'] + d * spec['desc_src_step'],
+            spec['dst'] + d * spec['desc_dst_step'],
+            spec['length'], spec['src_stride'], spec['dst_stride'],
+            spec['reps'] if spec['config'] & (1 << 1) else 1,
+            0)
+    return 'tcdm', bytes(buf)
+
+
 def _write_stim(work_dir, name, blob):
     os.makedirs(work_dir, exist_ok=True)
     path = os.path.join(work_dir, f'{name}_stim.bin')
@@ -285,10 +354,12 @@ class Chip(gvsoc.systree.Component):
         # --- Memories (source memory preloaded with the test pattern) ---
         work_dir = os.path.abspath(os.path.join(
             os.path.dirname(__file__), 'build', 'stims'))
-        src_mem_name, blob = _stim_bytes_for_source(spec)
         stim_paths = {}
-        if blob is not None:
-            stim_paths[src_mem_name] = _write_stim(work_dir, f'{case}_{src_mem_name}', blob)
+        for mem_name, blob in (_stim_bytes_for_source(spec),
+                               _stim_bytes_for_descriptors(spec)):
+            if blob is not None:
+                assert mem_name not in stim_paths, 'source and descriptors in the same memory'
+                stim_paths[mem_name] = _write_stim(work_dir, f'{case}_{mem_name}', blob)
 
         mem_a = Memory(self, 'mem_a', config=MemoryV3Config(
             size=MEM_A_SIZE, latency=1, stim_file=stim_paths.get('mem_a', '')))
@@ -362,6 +433,9 @@ class Chip(gvsoc.systree.Component):
         idma.o_AXI_READ (shared_router.i_INPUT(2))
         idma.o_AXI_WRITE(shared_router.i_INPUT(3))
 
+        # Descriptor reads of chained transfers, on their own router input.
+        idma.o_DESC(shared_router.i_INPUT(4))
+
         # IRQ wire (not via router — direct).
         idma.o_IRQ(tester.i_IRQ())
 
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone check of the IMA crossbar MVM.
+ *
+ * Runs random jobs (position, size, crossbar, input vector and ADC bounds)
+ * through ima_v1_mvm and through the previous column-by-column float loop of
+ * ima_v1::exec_job, for several DAC/storage/ADC precisions, and checks that
+ * the sums are bit-exact and that the ADC outputs are the same. Most crossbar
+ * values are 4-bit as written by the plot interface, some are full int8 to
+ * cover the fallback path.
+ *
+ * Built and run with "make mvm_check".
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "ima_v1_mvm.hpp"
+
+static constexpr int XBAR_X = 256;
+static constexpr int XBAR_Y = 256;
+static constexpr int NB_JOBS = 2000;
+
+
+// Reference model, same code as the previous ima_v1::exec_job and ima_v1::adc_clipping
+
+static int8_t adc_clipping(float value, int adc_high, int adc_low, int adc_precision)
+{
+  if(value >= adc_high)
+  {
+    value = adc_high;
+  }
+  else if(value <= -adc_low)
+  {
+    value = -adc_low;
+  }
+
+  value = (float) (value * (((1 << (adc_precision - 1)) - 1))) / ((adc_high + adc_low));
+
+  if(value >= (((1 << (adc_precision - 1)) - 1)))
+  {
+    value = (((1 << (adc_precision - 1)) - 1));
+  }
+  else if(value <= -(((1 << (adc_precision - 1)) - 1)))
+  {
+    value = -(((1 << (adc_precision - 1)) - 1));
+  }
+  /* Round float before casting */
+  if(value >= 0)
+  {
+    return ((value - (int) value >= 0.5f) ? ((int) value + 1) : ((int) value));
+  }
+  else
+  {
+    return ((value - (int) value <= -0.5f) ? ((int) value - 1) : ((int) value));
+  }
+}
+
+static float reference_sum(int8_t **crossbar, const int8_t *buffer_in, int start_x, int start_y,
+  int i, int height, int dac_precision, int stor_dwidth)
+{
+  float sum = 0;
+
+  for(int j=0; j<height; j++)
+  {
+    sum += ((float) buffer_in[start_y + j] / ((1 << (dac_precision - 1)) - 1)) * ((float) crossbar[start_y + j][start_x + i]) / ((1 << (stor_dwidth - 1)) - 1);
+  }
+
+  return sum;
+}
+
+
+int main()
+{
+  static const int precisions[][3] = {
+    /* DAC, STOR, ADC */
+    {8, 4, 8},
+    {8, 4, 6},
+    {4, 4, 4},
+    {8, 8, 8},
+    {6, 3, 7},
+  };
+
+  std::mt19937 rng(0);
+  std::vector<int8_t> storage(XBAR_X * XBAR_Y);
+  std::vector<int8_t *> crossbar(XBAR_Y);
+  std::vector<int8_t> buffer_in(XBAR_Y);
+  std::vector<float> sum(XBAR_X);
+  long nb_sums = 0;
+  int errors = 0;
+
+  for(int k=0; k<XBAR_Y; k++)
+  {
+    crossbar[k] = &storage[k * XBAR_X];
+  }
+
+  for(auto &precision : precisions)
+  {
+    int dac_precision = precision[0];
+    int stor_dwidth = precision[1];
+    int adc_precision = precision[2];
+    int dac_max = (1 << (dac_precision - 1)) - 1;
+    int stor_max = (1 << (stor_dwidth - 1)) - 1;
+
+    for(int job=0; job<NB_JOBS; job++)
+    {
+      int full_int8 = rng() % 8 == 0;
+      for(auto &value : storage)
+      {
+        value = full_int8 && rng() % 16 == 0 ? (int8_t) rng() : (int8_t) (rng() % 16) - 8;
+      }
+      for(auto &value : buffer_in)
+      {
+        value = rng() % 4 == 0 ? (int8_t) (rng() % 3) - 1 : (int8_t) rng();
+      }
+
+      int start_x = rng() % XBAR_X;
+      int start_y = rng() % XBAR_Y;
+      int width = 1 + rng() % (XBAR_X - start_x);
+      int height = 1 + rng() % (XBAR_Y - start_y);
+      int adc_high = 1 + rng() % 8;
+      int adc_low = 1 + rng() % 8;
+
+      ima_v1_mvm(sum.data(), crossbar.data(), buffer_in.data(), start_x, start_y, width, height, dac_max, stor_max);
+
+      for(int i=0; i<width; i++)
+      {
+        float expected = reference_sum(crossbar.data(), buffer_in.data(), start_x, start_y, i, height, dac_precision, stor_dwidth);
+        int8_t expected_out = adc_clipping(expected, adc_high, adc_low, adc_precision);
+        int8_t out = adc_clipping(sum[i], adc_high, adc_low, adc_precision);
+
+        nb_sums++;
+        if(memcmp(&expected, &sum[i], sizeof(float)) != 0 || expected_out != out)
+        {
+          if(errors < 10)
+          {
+            printf("Mismatch (precisions %d/%d/%d, job %d, column %d): sum %a expected %a, out %d expected %d\n",
+              dac_precision, stor_dwidth, adc_precision, job, start_x + i, sum[i], expected, out, expected_out);
+          }
+          errors++;
+        }
+      }
+    }
+  }
+
+  printf("Checked %ld sums (avx2: %d), %d errors\n", nb_sums, ima_v1_mvm_avx2(), errors);
+  printf(errors ? "FAILED\n" : "PASSED\n");
+
+  return errors != 0;
+}
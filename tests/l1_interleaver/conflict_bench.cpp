@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ConflictBench — bank conflict check of the L1 interleaver.
+ *
+ * The accesses of each step are sent in the same cycle, each one from its
+ * master port, and the next step is sent in the next cycle. Once all the steps
+ * are sent, sampling is switched off through the bank_profiler port of the
+ * interleaver, which writes its report synchronously.
+ *
+ * The expected report is computed from the steps: a request is one access per
+ * interleaving granule it touches, at the address of the part of the request
+ * in this granule, and an access to a bank already accessed in the same cycle,
+ * from any master, is a conflict. Apart from the component path, the report
+ * must be exactly the expected one: the accesses and conflicts in total and for
+ * each bank, the number of cycles with a given number of conflicts, and the top
+ * hottest addresses.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <vp/itf/wire.hpp>
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+
+class ConflictBench : public vp::Component
+{
+public:
+    ConflictBench(vp::ComponentConf &config);
+
+    void reset(bool active) override;
+
+private:
+    // Access of a step, from a master
+    struct Access
+    {
+        int master;
+        uint64_t addr;
+        uint64_t size;
+    };
+
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    void send(std::vector<Access> &step);
+    std::string expected_report();
+    void check();
+
+    vp::Trace trace;
+    std::vector<vp::IoMaster *> input_itf;
+    vp::WireMaster<bool> profiler_itf;
+    vp::ClockEvent fsm_event;
+    vp::IoReq req;
+
+    int nb_banks;
+    int interleaving_bits;
+    int top;
+    std::vector<std::vector<Access>> steps;
+    std::string report;
+
+    size_t step;
+    int nb_errors;
+};
+
+
+ConflictBench::ConflictBench(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &ConflictBench::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->nb_banks = js->get_int("nb_banks");
+    this->interleaving_bits = js->get_int("interleaving_bits");
+    this->top = js->get_int("top");
+    this->report = js->get_child_str("report");
+    for (js::Config *step: js->get("steps")->get_elems())
+    {
+        std::vector<Access> accesses;
+        for (js::Config *access: step->get_elems())
+        {
+            accesses.push_back({ (int)access->get_elem(0)->get_int(),
+                (uint64_t)access->get_elem(1)->get_int(), (uint64_t)access->get_elem(2)->get_int() });
+        }
+        this->steps.push_back(accesses);
+    }
+
+    int nb_masters = js->get_int("nb_masters");
+    for (int i=0; i<nb_masters; i++)
+    {
+        vp::IoMaster *itf = new vp::IoMaster();
+        this->input_itf.push_back(itf);
+        this->new_master_port("input_" + std::to_string(i), itf);
+    }
+
+    this->new_master_port("profiler", &this->profiler_itf);
+}
+
+
+void ConflictBench::reset(bool active)
+{
+    if (!active)
+    {
+        this->step = 0;
+        this->nb_errors = 0;
+        this->fsm_event.enqueue();
+    }
+}
+
+
+void ConflictBench::send(std::vector<Access> &step)
+{
+    for (Access &access: step)
+    {
+        std::vector<uint8_t> data(access.size, 0);
+
+        this->trace.msg(vp::Trace::LEVEL_INFO, "Sending request (master: %d, addr: 0x%lx, "
+            "size: 0x%lx)\n", access.master, access.addr, access.size);
+
+        this->req.init();
+        this->req.set_addr(access.addr);
+        this->req.set_size(access.size);
+        this->req.set_data(data.data());
+        this->req.set_is_write(false);
+
+        if (this->input_itf[access.master]->req(&this->req) != vp::IO_REQ_OK)
+        {
+            printf("Failed request (master: %d, addr: 0x%lx, size: 0x%lx)\n", access.master,
+                access.addr, access.size);
+            this->nb_errors++;
+        }
+    }
+}
+
+
+std::string ConflictBench::expected_report()
+{
+    uint64_t granule = 1ULL << this->interleaving_bits;
+    std::vector<uint64_t> bank_accesses(this->nb_banks), bank_conflicts(this->nb_banks);
+    uint64_t nb_accesses = 0, nb_conflicts = 0, nb_active_cycles = 0;
+    std::vector<uint64_t> cycle_histogram;
+    // Bank, accesses and conflicts of each address
+    std::map<uint64_t, std::vector<uint64_t>> addr_stats;
+
+    for (std::vector<Access> &step: this->steps)
+    {
+        std::vector<bool> accessed(this->nb_banks, false);
+        size_t cycle_conflicts = 0;
+
+        for (Access &access: step)
+        {
+            uint64_t addr = access.addr;
+            uint64_t size = access.size;
+            while (size > 0)
+            {
+                int bank = (addr >> this->interleaving_bits) & (this->nb_banks - 1);
+                uint64_t chunk = std::min(granule - (addr & (granule - 1)), size);
+
+                std::vector<uint64_t> &stats = addr_stats.emplace(addr,
+                    std::vector<uint64_t>{ (uint64_t)bank, 0, 0 }).first->second;
+
+                nb_accesses++;
+                bank_accesses[bank]++;
+                stats[1]++;
+                if (accessed[bank])
+                {
+                    nb_conflicts++;
+                    bank_conflicts[bank]++;
+                    stats[2]++;
+                    cycle_conflicts++;
+                }
+                accessed[bank] = true;
+
+                addr += chunk;
+                size -= chunk;
+            }
+        }
+
+        if (!step.empty())
+        {
+            if (cycle_histogram.size() <= cycle_conflicts)
+            {
+                cycle_histogram.resize(cycle_conflicts + 1);
+            }
+            cycle_histogram[cycle_conflicts]++;
+            nb_active_cycles++;
+        }
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "  \"nb_banks\": %d,\n  \"active_cycles\": %lu,\n"
+        "  \"accesses\": %lu,\n  \"conflicts\": %lu,\n  \"banks\": [",
+        this->nb_banks, nb_active_cycles, nb_accesses, nb_conflicts);
+    std::string result = line;
+    for (int i=0; i<this->nb_banks; i++)
+    {
+        snprintf(line, sizeof(line), "%s\n    { \"bank\": %d, \"accesses\": %lu, \"conflicts\": %lu }",
+            i ? "," : "", i, bank_accesses[i], bank_conflicts[i]);
+        result += line;
+    }
+    result += "\n  ],\n  \"conflicts_per_cycle\": [";
+
+    for (size_t i=0; i<cycle_histogram.size(); i++)
+    {
+        snprintf(line, sizeof(line), "%s%lu", i ? ", " : "", cycle_histogram[i]);
+        result += line;
+    }
+    result += "],\n  \"hottest\": [";
+
+    // Most conflicts first, then most accesses, then lowest address
+    std::vector<std::pair<uint64_t, std::vector<uint64_t>>> hottest(addr_stats.begin(),
+        addr_stats.end());
+    std::stable_sort(hottest.begin(), hottest.end(),
+        [](const std::pair<uint64_t, std::vector<uint64_t>> &a,
+            const std::pair<uint64_t, std::vector<uint64_t>> &b) {
+            if (a.second[2] != b.second[2]) return a.second[2] > b.second[2];
+            return a.second[1] > b.second[1];
+        });
+
+    for (size_t i=0; i<std::min(hottest.size(), (size_t)this->top); i++)
+    {
+        snprintf(line, sizeof(line), "%s\n    { \"addr\": \"0x%lx\", \"bank\": %lu, \"accesses\": %lu, "
+            "\"conflicts\": %lu }", i ? "," : "", hottest[i].first, hottest[i].second[0],
+            hottest[i].second[1], hottest[i].second[2]);
+        result += line;
+    }
+
+    return result + "\n  ]\n}\n";
+}
+
+
+void ConflictBench::check()
+{
+    // The report is written while sampling is switched off
+    this->profiler_itf.sync(false);
+
+    std::string content;
+    FILE *file = fopen(this->report.c_str(), "r");
+    if (file == NULL)
+    {
+        printf("Unable to open bank profile report (path: %s)\n", this->report.c_str());
+        this->nb_errors++;
+    }
+    else
+    {
+        char buffer[4096];
+        size_t size;
+        while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            content.append(buffer, size);
+        }
+        fclose(file);
+
+        // Only the component path comes before the expected part
+        std::string expected = this->expected_report();
+        size_t start = content.find("  \"nb_banks\"");
+        if (start == std::string::npos || content.compare(start, std::string::npos, expected) != 0)
+        {
+            printf("Report mismatch, expected:\n%s\ngot:\n%s\n", expected.c_str(), content.c_str());
+            this->nb_errors++;
+        }
+    }
+}
+
+
+void ConflictBench::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    ConflictBench *_this = (ConflictBench *)__this;
+
+    if (_this->step == _this->steps.size())
+    {
+        _this->check();
+        printf("[l1_interleaver] %zu steps, %d errors\n", _this->steps.size(), _this->nb_errors);
+        _this->time.get_engine()->quit(_this->nb_errors != 0);
+        return;
+    }
+
+    _this->send(_this->steps[_this->step++]);
+    _this->fsm_event.enqueue();
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new ConflictBench(config);
+}
@@ -0,0 +1,41 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class ConflictBench(gvsoc.systree.Component):
+    """Bank conflict check of the L1 interleaver.
+
+    Each step of steps, as a list of [master, addr, size], is sent in one cycle,
+    each access from its master port. Sampling is then switched off through the
+    bank_profiler port of the interleaver, which writes its report to report.
+    The bank accesses and conflicts, the conflicts per cycle and the top hottest
+    addresses of the report must be the ones of the steps.
+    """
+
+    def __init__(self, parent, name, *, nb_banks: int, nb_masters: int, interleaving_bits: int,
+            steps: list, report: str, top: int):
+        super().__init__(parent, name)
+
+        self.add_sources(['conflict_bench.cpp'])
+
+        self.add_property('nb_banks', nb_banks)
+        self.add_property('nb_masters', nb_masters)
+        self.add_property('interleaving_bits', interleaving_bits)
+        self.add_property('steps', steps)
+        self.add_property('report', report)
+        self.add_property('top', top)
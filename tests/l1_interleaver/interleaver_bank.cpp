@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * InterleaverBank — memory bank of the L1 interleaver test.
+ *
+ * Accesses to the input port take latency cycles. They are either returned
+ * synchronously with this latency, or with async, answered once it has
+ * elapsed. The data is accessed when the request is received in both cases.
+ * The check port accesses the content synchronously with no latency.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+
+class InterleaverBank : public vp::Component
+{
+public:
+    InterleaverBank(vp::ComponentConf &config);
+
+private:
+    static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
+    static vp::IoReqStatus check_req(vp::Block *__this, vp::IoReq *req);
+    static void resp_handler(vp::Block *__this, vp::ClockEvent *event);
+    bool access(vp::IoReq *req);
+
+    vp::Trace trace;
+    vp::IoSlave input_itf;
+    vp::IoSlave check_itf;
+    vp::ClockEvent resp_event;
+
+    std::vector<uint8_t> mem;
+    int64_t latency;
+    bool is_async;
+    // Requests answered asynchronously, with the cycle of their response, in order
+    std::deque<std::pair<vp::IoReq *, int64_t>> pending;
+};
+
+
+InterleaverBank::InterleaverBank(vp::ComponentConf &config)
+    : vp::Component(config), resp_event(this, &InterleaverBank::resp_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    this->mem.resize(this->get_js_config()->get_int("size"));
+    this->latency = this->get_js_config()->get_int("latency");
+    this->is_async = this->get_js_config()->get_child_bool("async");
+
+    this->input_itf.set_req_meth(&InterleaverBank::req);
+    this->new_slave_port("input", &this->input_itf);
+
+    this->check_itf.set_req_meth(&InterleaverBank::check_req);
+    this->new_slave_port("check", &this->check_itf);
+}
+
+
+bool InterleaverBank::access(vp::IoReq *req)
+{
+    uint64_t addr = req->get_addr();
+    uint64_t size = req->get_size();
+
+    if (addr + size > this->mem.size())
+    {
+        this->trace.force_warning("Out of bound access (addr: 0x%lx, size: 0x%lx)\n", addr, size);
+        return false;
+    }
+
+    if (req->get_is_write())
+    {
+        memcpy(&this->mem[addr], req->get_data(), size);
+    }
+    else
+    {
+        memcpy(req->get_data(), &this->mem[addr], size);
+    }
+
+    return true;
+}
+
+
+vp::IoReqStatus InterleaverBank::req(vp::Block *__this, vp::IoReq *req)
+{
+    InterleaverBank *_this = (InterleaverBank *)__this;
+
+    _this->trace.msg(vp::Trace::LEVEL_TRACE, "Received request (addr: 0x%lx, size: 0x%lx, "
+        "is_write: %d)\n", req->get_addr(), req->get_size(), req->get_is_write());
+
+    if (!_this->access(req))
+    {
+        return vp::IO_REQ_INVALID;
+    }
+
+    if (!_this->is_async)
+    {
+        req->inc_latency(_this->latency);
+        return vp::IO_REQ_OK;
+    }
+
+    int64_t cycles = _this->clock.get_cycles();
+    _this->pending.push_back({ req, cycles + _this->latency });
+    if (!_this->resp_event.is_enqueued())
+    {
+        _this->resp_event.enqueue(_this->latency);
+    }
+
+    return vp::IO_REQ_PENDING;
+}
+
+
+vp::IoReqStatus InterleaverBank::check_req(vp::Block *__this, vp::IoReq *req)
+{
+    InterleaverBank *_this = (InterleaverBank *)__this;
+    return _this->access(req) ? vp::IO_REQ_OK : vp::IO_REQ_INVALID;
+}
+
+
+void InterleaverBank::resp_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    InterleaverBank *_this = (InterleaverBank *)__this;
+    int64_t cycles = _this->clock.get_cycles();
+
+    while (!_this->pending.empty() && _this->pending.front().second <= cycles)
+    {
+        vp::IoReq *req = _this->pending.front().first;
+        _this->pending.pop_front();
+        req->status = vp::IO_REQ_OK;
+        req->get_resp_port()->resp(req);
+    }
+
+    if (!_this->pending.empty())
+    {
+        _this->resp_event.enqueue(_this->pending.front().second - cycles);
+    }
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new InterleaverBank(config);
+}
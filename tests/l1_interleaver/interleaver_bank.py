@@ -0,0 +1,35 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class InterleaverBank(gvsoc.systree.Component):
+    """Memory bank of the L1 interleaver test.
+
+    Accesses to the input port take latency cycles, either returned
+    synchronously or, with async, answered once they have elapsed. The check
+    port gives the bench direct access to the content, with no latency.
+    """
+
+    def __init__(self, parent, name, *, size: int, latency: int, is_async: bool):
+        super().__init__(parent, name)
+
+        self.add_sources(['interleaver_bank.cpp'])
+
+        self.add_property('size', size)
+        self.add_property('latency', latency)
+        self.add_property('async', is_async)
@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * InterleaverBench — granule-crossing request check of the L1 interleaver.
+ *
+ * Each access is first written through the interleaver, and every byte is then
+ * read back from the bank and offset given by the interleaving, through the
+ * check port of the bank. The banks are then filled through their check ports
+ * and the same access is read through the interleaver.
+ *
+ * A request is complete either when it returns synchronously or when its
+ * response is received. Its duration, from the cycle it was sent to the cycle
+ * it completed plus its latency, must be the latency of the slowest bank it
+ * touches, since all the parts of a split request are sent in the same cycle.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+
+class InterleaverBench : public vp::Component
+{
+public:
+    InterleaverBench(vp::ComponentConf &config);
+
+    void reset(bool active) override;
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void resp(vp::Block *__this, vp::IoReq *req);
+    uint8_t pattern(uint64_t addr)
+    {
+        return (addr * 13 + this->index * 7 + this->is_read * 101 + 1) & 0xff;
+    }
+    int get_bank(uint64_t addr) { return (addr >> this->interleaving_bits) & (this->nb_banks - 1); }
+    uint64_t get_bank_offset(uint64_t addr);
+    uint8_t *bank_access(uint64_t addr, uint8_t *data, bool is_write);
+    void send();
+    void done();
+
+    vp::Trace trace;
+    vp::IoMaster input_itf;
+    std::vector<vp::IoMaster *> bank_itf;
+    vp::ClockEvent fsm_event;
+    vp::IoReq req;
+    vp::IoReq check_req;
+
+    int nb_banks;
+    int interleaving_bits;
+    int stage_bits;
+    std::vector<int64_t> latencies;
+    // Accesses to check, as address and size
+    std::vector<std::pair<uint64_t, uint64_t>> accesses;
+
+    // Access being checked, and whether it is read or written
+    size_t index;
+    bool is_read;
+    std::vector<uint8_t> data;
+    int64_t start_cycles;
+    int nb_errors;
+};
+
+
+InterleaverBench::InterleaverBench(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &InterleaverBench::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->nb_banks = js->get_int("nb_banks");
+    this->interleaving_bits = js->get_int("interleaving_bits");
+    this->stage_bits = 0;
+    while ((1 << this->stage_bits) < this->nb_banks)
+    {
+        this->stage_bits++;
+    }
+    for (js::Config *latency: js->get("latencies")->get_elems())
+    {
+        this->latencies.push_back(latency->get_int());
+    }
+    for (js::Config *access: js->get("accesses")->get_elems())
+    {
+        this->accesses.push_back({ access->get_elem(0)->get_int(), access->get_elem(1)->get_int() });
+    }
+
+    this->input_itf.set_resp_meth(&InterleaverBench::resp);
+    this->new_master_port("input", &this->input_itf);
+
+    for (int i=0; i<this->nb_banks; i++)
+    {
+        vp::IoMaster *itf = new vp::IoMaster();
+        this->bank_itf.push_back(itf);
+        this->new_master_port("bank_" + std::to_string(i), itf);
+    }
+}
+
+
+void InterleaverBench::reset(bool active)
+{
+    if (!active)
+    {
+        this->index = 0;
+        this->is_read = false;
+        this->nb_errors = 0;
+        this->fsm_event.enqueue();
+    }
+}
+
+
+uint64_t InterleaverBench::get_bank_offset(uint64_t addr)
+{
+    uint64_t granule_mask = (1ULL << this->interleaving_bits) - 1;
+    return ((addr >> (this->stage_bits + this->interleaving_bits)) << this->interleaving_bits)
+        + (addr & granule_mask);
+}
+
+
+uint8_t *InterleaverBench::bank_access(uint64_t addr, uint8_t *data, bool is_write)
+{
+    this->check_req.init();
+    this->check_req.set_addr(this->get_bank_offset(addr));
+    this->check_req.set_size(1);
+    this->check_req.set_data(data);
+    this->check_req.set_is_write(is_write);
+
+    if (this->bank_itf[this->get_bank(addr)]->req(&this->check_req) != vp::IO_REQ_OK)
+    {
+        this->trace.fatal("Failed bank check access (addr: 0x%lx)\n", addr);
+    }
+
+    return data;
+}
+
+
+void InterleaverBench::send()
+{
+    uint64_t addr = this->accesses[this->index].first;
+    uint64_t size = this->accesses[this->index].second;
+
+    this->data.resize(size);
+    for (uint64_t i=0; i<size; i++)
+    {
+        uint8_t value = this->pattern(addr + i);
+        if (this->is_read)
+        {
+            // The bytes to be read are placed directly in the banks
+            this->bank_access(addr + i, &value, true);
+            this->data[i] = 0;
+        }
+        else
+        {
+            this->data[i] = value;
+        }
+    }
+
+    this->trace.msg(vp::Trace::LEVEL_INFO, "Sending request (addr: 0x%lx, size: 0x%lx, "
+        "is_write: %d)\n", addr, size, !this->is_read);
+
+    this->req.init();
+    this->req.set_addr(addr);
+    this->req.set_size(size);
+    this->req.set_data(this->data.data());
+    this->req.set_is_write(!this->is_read);
+
+    this->start_cycles = this->clock.get_cycles();
+
+    vp::IoReqStatus status = this->input_itf.req(&this->req);
+    if (status == vp::IO_REQ_OK)
+    {
+        this->done();
+    }
+    else if (status == vp::IO_REQ_INVALID)
+    {
+        printf("Invalid request (addr: 0x%lx, size: 0x%lx)\n", addr, size);
+        this->nb_errors++;
+        this->done();
+    }
+    // Otherwise the request is completed by resp
+}
+
+
+void InterleaverBench::done()
+{
+    uint64_t addr = this->accesses[this->index].first;
+    uint64_t size = this->accesses[this->index].second;
+
+    int64_t expected_latency = 0;
+    for (uint64_t i=0; i<size; i++)
+    {
+        uint8_t value;
+        uint8_t expected = this->pattern(addr + i);
+        if (!this->is_read)
+        {
+            this->bank_access(addr + i, &value, false);
+        }
+        else
+        {
+            value = this->data[i];
+        }
+
+        if (value != expected)
+        {
+            printf("Mismatch at 0x%lx (bank: %d, is_write: %d, got: 0x%2.2x, expected: 0x%2.2x)\n",
+                addr + i, this->get_bank(addr + i), !this->is_read, value, expected);
+            this->nb_errors++;
+        }
+
+        expected_latency = std::max(expected_latency, this->latencies[this->get_bank(addr + i)]);
+    }
+
+    int64_t latency = this->clock.get_cycles() - this->start_cycles + this->req.get_latency();
+    if (latency != expected_latency)
+    {
+        printf("Latency mismatch (addr: 0x%lx, size: 0x%lx, is_write: %d, got: %ld, expected: %ld)\n",
+            addr, size, !this->is_read, latency, expected_latency);
+        this->nb_errors++;
+    }
+
+    if (this->is_read)
+    {
+        this->index++;
+    }
+    this->is_read = !this->is_read;
+
+    this->fsm_event.enqueue();
+}
+
+
+void InterleaverBench::resp(vp::Block *__this, vp::IoReq *req)
+{
+    InterleaverBench *_this = (InterleaverBench *)__this;
+
+    if (req->status == vp::IO_REQ_INVALID)
+    {
+        printf("Invalid response (addr: 0x%lx)\n", _this->accesses[_this->index].first);
+        _this->nb_errors++;
+    }
+
+    _this->done();
+}
+
+
+void InterleaverBench::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    InterleaverBench *_this = (InterleaverBench *)__this;
+
+    if (_this->index == _this->accesses.size())
+    {
+        printf("[l1_interleaver] %zu accesses, %d errors\n", _this->accesses.size(),
+            _this->nb_errors);
+        _this->time.get_engine()->quit(_this->nb_errors != 0);
+        return;
+    }
+
+    _this->send();
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new InterleaverBench(config);
+}
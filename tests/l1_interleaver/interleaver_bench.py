@@ -0,0 +1,38 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class InterleaverBench(gvsoc.systree.Component):
+    """Granule-crossing request check of the L1 interleaver.
+
+    Each access of accesses, as [addr, size], is written and then read through
+    the interleaver. The bytes must land in the banks given by the interleaving,
+    as seen through their check ports, and each request must take the latency
+    of the slowest bank it touches.
+    """
+
+    def __init__(self, parent, name, *, nb_banks: int, interleaving_bits: int, latencies: list,
+            accesses: list):
+        super().__init__(parent, name)
+
+        self.add_sources(['interleaver_bench.cpp'])
+
+        self.add_property('nb_banks', nb_banks)
+        self.add_property('interleaving_bits', interleaving_bits)
+        self.add_property('latencies', latencies)
+        self.add_property('accesses', accesses)
@@ -0,0 +1,140 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Granule-crossing request and bank conflict checks of the L1 interleaver.
+
+The interleaver spreads 4-byte granules over 4 banks, each with a different
+latency. Requests crossing granules are split into one part per bank access,
+and must complete with the latency of their slowest part, also when the banks
+answer asynchronously.
+
+With conflicts, two masters access the banks in the same cycles instead, and
+the report of the interleaver bank profiler must match the accesses: bank
+accesses and conflicts, conflicts per cycle and hottest addresses.
+"""
+
+import gvsoc.systree
+import gvsoc.runner
+
+import vp.clock_domain
+from gvrun.parameter import TargetParameter
+
+from pulp.cluster.l1_interleaver import L1_interleaver
+from interleaver_bank import InterleaverBank
+from interleaver_bench import InterleaverBench
+from conflict_bench import ConflictBench
+
+
+NB_BANKS = 4
+INTERLEAVING_BITS = 2
+BANK_SIZE = 0x100
+LATENCIES = [1, 4, 2, 3]
+
+# Accesses as [addr, size]: within a granule, across 2 and 3 banks, wrapping
+# around to the next row of banks, and touching every bank several times
+ACCESSES = [
+    [0x00, 4],
+    [0x21, 2],
+    [0x08, 8],
+    [0x06, 8],
+    [0x1e, 16],
+    [0x40, 64],
+]
+
+# Accesses sent in the same cycle as [master, addr, size], one step per cycle:
+# both masters on one bank, on different banks, a split request meeting the
+# other master, the same address twice, and requests split over the same banks
+CONFLICT_STEPS = [
+    [[0, 0x00, 4], [1, 0x10, 4]],
+    [[0, 0x04, 4], [1, 0x08, 4]],
+    [[0, 0x00, 8], [1, 0x14, 4]],
+    [[0, 0x0c, 4], [1, 0x0c, 4]],
+    [[0, 0x02, 4], [1, 0x10, 16]],
+]
+CONFLICT_REPORT = 'bank_profile.json'
+# Less than the addresses accessed, to check that the report keeps the hottest ones
+CONFLICT_TOP = 3
+
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, is_async, conflicts):
+        super().__init__(parent, name)
+
+        if conflicts:
+            self.build_conflicts()
+            return
+
+        interleaver = L1_interleaver(self, 'interleaver', nb_slaves=NB_BANKS,
+            interleaving_bits=INTERLEAVING_BITS)
+
+        bench = InterleaverBench(self, 'bench', nb_banks=NB_BANKS,
+            interleaving_bits=INTERLEAVING_BITS, latencies=LATENCIES, accesses=ACCESSES)
+
+        self.bind(bench, 'input', interleaver, 'in')
+
+        for i, latency in enumerate(LATENCIES):
+            bank = InterleaverBank(self, f'bank_{i}', size=BANK_SIZE, latency=latency,
+                is_async=is_async)
+            self.bind(interleaver, f'out_{i}', bank, 'input')
+            self.bind(bench, f'bank_{i}', bank, 'check')
+
+    def build_conflicts(self):
+        interleaver = L1_interleaver(self, 'interleaver', nb_slaves=NB_BANKS, nb_masters=2,
+            interleaving_bits=INTERLEAVING_BITS, bank_conflicts=True, bank_profiler=True,
+            bank_profiler_file=CONFLICT_REPORT, bank_profiler_top=CONFLICT_TOP)
+
+        bench = ConflictBench(self, 'bench', nb_banks=NB_BANKS, nb_masters=2,
+            interleaving_bits=INTERLEAVING_BITS, steps=CONFLICT_STEPS, report=CONFLICT_REPORT,
+            top=CONFLICT_TOP)
+
+        for i in range(2):
+            self.bind(bench, f'input_{i}', interleaver, f'in_{i}')
+        self.bind(bench, 'profiler', interleaver, 'bank_profiler')
+
+        for i, latency in enumerate(LATENCIES):
+            bank = InterleaverBank(self, f'bank_{i}', size=BANK_SIZE, latency=latency,
+                is_async=False)
+            self.bind(interleaver, f'out_{i}', bank, 'input')
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name=None):
+
+        super().__init__(parent, name)
+
+        is_async = TargetParameter(
+            self, name='async', value=False,
+            description='Banks answer asynchronously after their latency', cast=bool
+        ).get_value()
+
+        conflicts = TargetParameter(
+            self, name='conflicts', value=False,
+            description='Check the bank conflicts of two masters instead of split requests',
+            cast=bool
+        ).get_value()
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100000000)
+        soc = Testbench(self, 'soc', is_async, conflicts)
+        clock.o_CLOCK(soc.i_CLOCK())
+
+
+class Target(gvsoc.runner.Target):
+
+    gapy_description = "L1 interleaver split request and bank conflict test"
+    model = Chip
+    name = "test"
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * MemPoolDmaBench — transfer issue rate benchmark of the MemPool iDMA.
+ *
+ * Offloads nb_transfers copies of transfer_size bytes from the external
+ * memory to L1, one dmcpy per cycle as long as the DMA grants them, the L1
+ * address moving by stride bytes from one transfer to the next so that all
+ * backends are used in turn. Once all transfers are completed, reports the
+ * number of simulated cycles and the host time per transfer.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/wire.hpp>
+#include <cpu/iss/include/offload.hpp>
+#include <stdio.h>
+#include <chrono>
+
+
+class MemPoolDmaBench : public vp::Component
+{
+public:
+    MemPoolDmaBench(vp::ComponentConf &config);
+
+    void reset(bool active) override;
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void offload_grant_sync(vp::Block *__this, IssOffloadInsnGrant<uint32_t> *grant);
+    uint32_t offload(uint32_t func7, uint32_t arg_a, uint32_t arg_b, bool &granted);
+    void report();
+
+    vp::Trace trace;
+    vp::WireMaster<IssOffloadInsn<uint32_t> *> offload_itf;
+    vp::WireSlave<IssOffloadInsnGrant<uint32_t> *> offload_grant_itf;
+    vp::ClockEvent fsm_event;
+
+    int nb_be;
+    int nb_transfers;
+    int transfer_size;
+    uint64_t stride;
+    uint64_t l1_base;
+    uint64_t l1_size;
+    uint64_t ext_base;
+
+    int issued;
+    bool stalled;
+    int64_t start_cycles;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+
+MemPoolDmaBench::MemPoolDmaBench(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &MemPoolDmaBench::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->nb_be = js->get_int("nb_be");
+    this->nb_transfers = js->get_int("nb_transfers");
+    this->transfer_size = js->get_int("transfer_size");
+    this->stride = js->get_uint("stride");
+    this->l1_base = js->get_uint("l1_base");
+    this->l1_size = js->get_uint("l1_size");
+    this->ext_base = js->get_uint("ext_base");
+
+    this->offload_grant_itf.set_sync_meth(&MemPoolDmaBench::offload_grant_sync);
+    this->new_master_port("offload", &this->offload_itf);
+    this->new_slave_port("offload_grant", &this->offload_grant_itf);
+}
+
+
+void MemPoolDmaBench::reset(bool active)
+{
+    if (!active)
+    {
+        this->issued = 0;
+        this->stalled = false;
+        this->start_cycles = this->clock.get_cycles();
+        this->start_time = std::chrono::steady_clock::now();
+        this->fsm_event.enqueue();
+    }
+}
+
+
+uint32_t MemPoolDmaBench::offload(uint32_t func7, uint32_t arg_a, uint32_t arg_b, bool &granted)
+{
+    IssOffloadInsn<uint32_t> insn;
+    insn.opcode = func7 << 25;
+    insn.arg_a = arg_a;
+    insn.arg_b = arg_b;
+    insn.granted = false;
+    this->offload_itf.sync(&insn);
+    granted = insn.granted;
+    return insn.result;
+}
+
+
+void MemPoolDmaBench::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    MemPoolDmaBench *_this = (MemPoolDmaBench *)__this;
+    bool granted;
+
+    if (_this->issued < _this->nb_transfers)
+    {
+        uint64_t offset = (_this->issued * _this->stride) % _this->l1_size;
+        uint64_t src = _this->ext_base + offset;
+        uint64_t dst = _this->l1_base + offset;
+
+        // dmsrc, dmdst, then dmcpy, which stalls us if the DMA queue is full
+        _this->offload(0b0000000, (uint32_t)src, (uint32_t)(src >> 32), granted);
+        _this->offload(0b0000001, (uint32_t)dst, (uint32_t)(dst >> 32), granted);
+        _this->offload(0b0000010, _this->transfer_size, 0, granted);
+        _this->issued++;
+
+        if (!granted)
+        {
+            _this->stalled = true;
+            return;
+        }
+    }
+    else
+    {
+        // All transfers are issued, wait until they are all completed
+        uint32_t completed = _this->offload(0b0000100, 0, 0, granted);
+        if (completed >= (uint32_t)_this->nb_transfers)
+        {
+            _this->report();
+            _this->time.get_engine()->quit(0);
+            return;
+        }
+    }
+
+    _this->fsm_event.enqueue();
+}
+
+
+void MemPoolDmaBench::offload_grant_sync(vp::Block *__this, IssOffloadInsnGrant<uint32_t> *grant)
+{
+    MemPoolDmaBench *_this = (MemPoolDmaBench *)__this;
+    if (_this->stalled)
+    {
+        _this->stalled = false;
+        _this->fsm_event.enqueue();
+    }
+}
+
+
+void MemPoolDmaBench::report()
+{
+    int64_t cycles = this->clock.get_cycles() - this->start_cycles;
+    double host_s = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - this->start_time).count();
+
+    printf("[dma_bench] nb_be %d transfers %d size %d cycles %ld cycles/transfer %.2f "
+        "host %.1f ns/transfer %.0f transfers/s\n", this->nb_be, this->nb_transfers,
+        this->transfer_size, cycles, (double)cycles / this->nb_transfers,
+        host_s * 1e9 / this->nb_transfers, this->nb_transfers / host_s);
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new MemPoolDmaBench(config);
+}
@@ -0,0 +1,48 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class MemPoolDmaBench(gvsoc.systree.Component):
+    """Transfer issue rate benchmark driver for the MemPool iDMA.
+
+    Offloads nb_transfers copies of transfer_size bytes from ext_base to
+    l1_base, as fast as the DMA accepts them, moving by stride bytes from one
+    transfer to the next, and reports the simulated cycles and host time per
+    transfer once they are all completed.
+    """
+
+    def __init__(self, parent, name, *, nb_be: int, nb_transfers: int, transfer_size: int,
+            stride: int, l1_base: int, l1_size: int, ext_base: int):
+        super().__init__(parent, name)
+
+        self.add_sources(['dma_bench.cpp'])
+
+        self.add_property('nb_be', nb_be)
+        self.add_property('nb_transfers', nb_transfers)
+        self.add_property('transfer_size', transfer_size)
+        self.add_property('stride', stride)
+        self.add_property('l1_base', l1_base)
+        self.add_property('l1_size', l1_size)
+        self.add_property('ext_base', ext_base)
+
+    def o_OFFLOAD(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('offload', itf, signature='wire<IssOffloadInsn<uint32_t>*>')
+
+    def i_OFFLOAD_GRANT(self) -> gvsoc.systree.SlaveItf:
+        return gvsoc.systree.SlaveItf(self, 'offload_grant',
+            signature='wire<IssOffloadInsnGrant<uint32_t>*>')
@@ -0,0 +1,113 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Transfer issue rate benchmark of the MemPool iDMA.
+
+The MemPool DMA (pulp/mempool/idma) is instantiated with nb_groups groups of
+nb_dmas_per_group backends, its TCDM ports going to an L1 memory and its AXI
+ports to an external memory through a router. The benchmark driver offloads
+small transfers which each land on a single backend, so that the cost of
+distributing them over many backends shows up in the host time per transfer.
+"""
+
+import gvsoc.systree
+import gvsoc.runner
+
+import vp.clock_domain
+import memory.memory as memory
+import interco.router as router
+from gvrun.parameter import TargetParameter
+
+from pulp.mempool.idma.mempool_dma import MemPoolDma
+from dma_bench import MemPoolDmaBench
+
+
+L1_BASE = 0x0000_0000
+EXT_BASE = 0x8000_0000
+BE_WIDTH = 1024
+LINE_WIDTH = 64
+
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, nb_groups, nb_dmas_per_group, nb_transfers, transfer_size):
+        super().__init__(parent, name)
+
+        nb_be = nb_groups * nb_dmas_per_group
+        l1_size = nb_be * BE_WIDTH
+
+        dma = MemPoolDma(self, 'dma', loc_base=L1_BASE, loc_size=l1_size, burst_size=LINE_WIDTH,
+            tcdm_width=LINE_WIDTH, nb_groups=nb_groups, nb_dmas_per_group=nb_dmas_per_group,
+            be_width=BE_WIDTH)
+
+        # One backend region per transfer, so that they are all used in turn
+        bench = MemPoolDmaBench(self, 'bench', nb_be=nb_be, nb_transfers=nb_transfers,
+            transfer_size=transfer_size, stride=BE_WIDTH, l1_base=L1_BASE, l1_size=l1_size,
+            ext_base=EXT_BASE)
+
+        l1 = memory.Memory(self, 'l1', size=l1_size)
+        ext = memory.Memory(self, 'ext', size=l1_size)
+
+        axi = router.Router(self, 'axi', bandwidth=LINE_WIDTH, latency=1)
+        axi.add_mapping('ext', base=EXT_BASE, remove_offset=EXT_BASE, size=l1_size)
+        self.bind(axi, 'ext', ext, 'input')
+
+        bench.o_OFFLOAD(dma.i_OFFLOAD())
+        dma.o_OFFLOAD_GRANT(bench.i_OFFLOAD_GRANT())
+
+        for i in range(nb_groups):
+            for j in range(nb_dmas_per_group):
+                self.bind(dma, f'axi_read_{i}_{j}', axi, 'input')
+                self.bind(dma, f'axi_write_{i}_{j}', axi, 'input')
+                self.bind(dma, f'tcdm_read_{i}_{j}', l1, 'input')
+                self.bind(dma, f'tcdm_write_{i}_{j}', l1, 'input')
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name=None):
+
+        super().__init__(parent, name)
+
+        nb_groups = TargetParameter(
+            self, name='nb_groups', value=4, description='Number of DMA groups', cast=int
+        ).get_value()
+
+        nb_dmas_per_group = TargetParameter(
+            self, name='nb_dmas_per_group', value=1, description='Number of backends per group',
+            cast=int
+        ).get_value()
+
+        nb_transfers = TargetParameter(
+            self, name='nb_transfers', value=20000, description='Number of transfers to issue',
+            cast=int
+        ).get_value()
+
+        transfer_size = TargetParameter(
+            self, name='transfer_size', value=64, description='Size in bytes of each transfer',
+            cast=int
+        ).get_value()
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100000000)
+        soc = Testbench(self, 'soc', nb_groups, nb_dmas_per_group, nb_transfers, transfer_size)
+        clock.o_CLOCK(soc.i_CLOCK())
+
+
+class Target(gvsoc.runner.Target):
+
+    gapy_description = "MemPool iDMA transfer issue rate benchmark"
+    model = Chip
+    name = "test"
@@ -0,0 +1,86 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Host speed benchmark of the MemPool crossbar.
+
+A nb_ports x nb_ports MemPool crossbar (pulp/mempool/xbar), in its selector
+mode, is driven by a benchmark component which is also the ideal target of
+each output, so that only the crossbar arbitration is measured. With fewer
+active ports than crossbar ports, the host time per request shows how much the
+idle ports cost.
+"""
+
+import gvsoc.systree
+import gvsoc.runner
+
+import vp.clock_domain
+from gvrun.parameter import TargetParameter
+
+from pulp.mempool.xbar.mempool_xbar import MempoolXbar
+from xbar_bench import MempoolXbarBench
+
+
+BANDWIDTH = 4
+
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, nb_ports, nb_active_ports, nb_requests):
+        super().__init__(parent, name)
+
+        xbar = MempoolXbar(self, 'xbar', latency=1, bandwidth=BANDWIDTH, nb_input_port=nb_ports,
+            nb_output_port=nb_ports, use_selector=True)
+
+        bench = MempoolXbarBench(self, 'bench', nb_ports=nb_ports,
+            nb_active_ports=min(nb_active_ports, nb_ports), nb_requests=nb_requests,
+            req_size=BANDWIDTH)
+
+        for i in range(nb_ports):
+            suffix = '' if i == 0 else f'_{i}'
+            self.bind(bench, f'input_{i}', xbar, f'input{suffix}')
+            self.bind(xbar, f'output{suffix}', bench, f'target_{i}')
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name=None):
+
+        super().__init__(parent, name)
+
+        nb_ports = TargetParameter(
+            self, name='nb_ports', value=16, description='Number of crossbar ports', cast=int
+        ).get_value()
+
+        nb_active_ports = TargetParameter(
+            self, name='nb_active_ports', value=nb_ports,
+            description='Number of ports injecting requests', cast=int
+        ).get_value()
+
+        nb_requests = TargetParameter(
+            self, name='nb_requests', value=200000, description='Number of requests to send',
+            cast=int
+        ).get_value()
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100000000)
+        soc = Testbench(self, 'soc', nb_ports, nb_active_ports, nb_requests)
+        clock.o_CLOCK(soc.i_CLOCK())
+
+
+class Target(gvsoc.runner.Target):
+
+    gapy_description = "MemPool crossbar host speed benchmark"
+    model = Chip
+    name = "test"
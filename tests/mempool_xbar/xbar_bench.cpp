@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * MempoolXbarBench — host speed benchmark of the MemPool crossbar.
+ *
+ * Each of the first nb_active_ports initiator ports keeps one request of
+ * req_size bytes in flight, sent to a random output through the crossbar
+ * selector argument. Each output is bound back to an ideal target of this
+ * component, answering synchronously. Once nb_requests have completed,
+ * reports the number of simulated cycles and the host time per request.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+
+class MempoolXbarBench : public vp::Component
+{
+public:
+    MempoolXbarBench(vp::ComponentConf &config);
+
+    void reset(bool active) override;
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void response(vp::Block *__this, vp::IoReq *req, int port);
+    static void grant(vp::Block *__this, vp::IoReq *req, int port);
+    static vp::IoReqStatus target_req(vp::Block *__this, vp::IoReq *req, int port);
+    void send(int port);
+    void complete(int port);
+    void report();
+
+    vp::Trace trace;
+    std::vector<vp::IoMaster *> inputs;
+    std::vector<vp::IoSlave *> targets;
+    vp::ClockEvent fsm_event;
+
+    int nb_ports;
+    int nb_active_ports;
+    int nb_requests;
+    int req_size;
+    int seed;
+
+    // One request per input port, with its data
+    std::vector<vp::IoReq> reqs;
+    std::vector<uint8_t> data;
+    // Ports which are ready to send a new request
+    std::vector<int> ready_ports;
+    std::mt19937 rng;
+
+    int issued;
+    int completed;
+    int64_t start_cycles;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+
+MempoolXbarBench::MempoolXbarBench(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &MempoolXbarBench::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->nb_ports = js->get_int("nb_ports");
+    this->nb_active_ports = js->get_int("nb_active_ports");
+    this->nb_requests = js->get_int("nb_requests");
+    this->req_size = js->get_int("req_size");
+    this->seed = js->get_int("seed");
+
+    for (int i=0; i<this->nb_ports; i++)
+    {
+        vp::IoMaster *input = new vp::IoMaster();
+        input->set_resp_meth_muxed(&MempoolXbarBench::response, i);
+        input->set_grant_meth_muxed(&MempoolXbarBench::grant, i);
+        this->new_master_port("input_" + std::to_string(i), input);
+        this->inputs.push_back(input);
+
+        vp::IoSlave *target = new vp::IoSlave();
+        target->set_req_meth_muxed(&MempoolXbarBench::target_req, i);
+        this->new_slave_port("target_" + std::to_string(i), target);
+        this->targets.push_back(target);
+    }
+
+    this->reqs.resize(this->nb_ports);
+    this->data.resize(this->nb_ports * this->req_size);
+    for (int i=0; i<this->nb_ports; i++)
+    {
+        this->reqs[i].set_data(&this->data[i * this->req_size]);
+    }
+}
+
+
+void MempoolXbarBench::reset(bool active)
+{
+    if (active)
+    {
+        for (vp::IoReq &req: this->reqs)
+        {
+            req.init();
+        }
+    }
+    else
+    {
+        this->rng.seed(this->seed);
+        this->issued = 0;
+        this->completed = 0;
+        this->ready_ports.clear();
+        for (int i=0; i<this->nb_active_ports; i++)
+        {
+            this->ready_ports.push_back(i);
+        }
+        this->start_cycles = this->clock.get_cycles();
+        this->start_time = std::chrono::steady_clock::now();
+        this->fsm_event.enqueue();
+    }
+}
+
+
+void MempoolXbarBench::send(int port)
+{
+    vp::IoReq *req = &this->reqs[port];
+    int output = this->rng() % this->nb_ports;
+
+    req->prepare();
+    req->set_addr(0);
+    req->set_size(this->req_size);
+    req->set_is_write(this->rng() & 1);
+    // The crossbar takes the output port from the request arguments
+    req->arg_push((void *)(long)output);
+
+    this->issued++;
+
+    vp::IoReqStatus status = this->inputs[port]->req(req);
+    if (status == vp::IO_REQ_OK)
+    {
+        this->complete(port);
+    }
+}
+
+
+void MempoolXbarBench::complete(int port)
+{
+    this->completed++;
+    this->ready_ports.push_back(port);
+    this->fsm_event.enqueue();
+}
+
+
+void MempoolXbarBench::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    MempoolXbarBench *_this = (MempoolXbarBench *)__this;
+
+    if (_this->completed >= _this->nb_requests)
+    {
+        _this->report();
+        _this->time.get_engine()->quit(0);
+        return;
+    }
+
+    // Send one request on every port whose previous one has completed
+    std::vector<int> ports;
+    ports.swap(_this->ready_ports);
+    for (int port: ports)
+    {
+        if (_this->issued < _this->nb_requests)
+        {
+            _this->send(port);
+        }
+    }
+}
+
+
+void MempoolXbarBench::response(vp::Block *__this, vp::IoReq *req, int port)
+{
+    MempoolXbarBench *_this = (MempoolXbarBench *)__this;
+    _this->complete(port);
+}
+
+
+void MempoolXbarBench::grant(vp::Block *__this, vp::IoReq *req, int port)
+{
+    // The request stays in flight until its response comes back
+}
+
+
+vp::IoReqStatus MempoolXbarBench::target_req(vp::Block *__this, vp::IoReq *req, int port)
+{
+    // Ideal target, the benchmark only measures the crossbar
+    return vp::IO_REQ_OK;
+}
+
+
+void MempoolXbarBench::report()
+{
+    int64_t cycles = this->clock.get_cycles() - this->start_cycles;
+    double host_s = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - this->start_time).count();
+
+    printf("[xbar_bench] nb_ports %d active %d requests %d cycles %ld cycles/request %.2f "
+        "host %.1f ns/request %.0f requests/s\n", this->nb_ports, this->nb_active_ports,
+        this->completed, cycles, (double)cycles / this->completed,
+        host_s * 1e9 / this->completed, this->completed / host_s);
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new MempoolXbarBench(config);
+}
@@ -0,0 +1,40 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class MempoolXbarBench(gvsoc.systree.Component):
+    """Host speed benchmark driver for the MemPool crossbar.
+
+    The first nb_active_ports of the nb_ports initiator ports each keep one
+    request of req_size bytes in flight, sent to a random one of the nb_ports
+    ideal targets, until nb_requests have completed. Reports the simulated
+    cycles and the host time per request.
+    """
+
+    def __init__(self, parent, name, *, nb_ports: int, nb_active_ports: int, nb_requests: int,
+            req_size: int, seed: int=0):
+        super().__init__(parent, name)
+
+        self.add_sources(['xbar_bench.cpp'])
+
+        self.add_property('nb_ports', nb_ports)
+        self.add_property('nb_active_ports', nb_active_ports)
+        self.add_property('nb_requests', nb_requests)
+        self.add_property('req_size', req_size)
+        self.add_property('seed', seed)
+
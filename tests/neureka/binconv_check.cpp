@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone check of the fixed-shape NEUREKA BinConv engine.
+ *
+ * Runs random layers through the engine and through the xtensor model of
+ * neureka_matrixvec.cpp (weight transforms, unpacking, BinConv blocks and
+ * array), in 3x3, 1x1 and depthwise modes with the weight offset cycles,
+ * and checks that psum_block, psum_column and the accumulators are
+ * bit-exact after each step.
+ *
+ * Built and run with "make binconv_check".
+ */
+
+#include <stdio.h>
+#include <random>
+#include "xtensor/xarray.hpp"
+#include "xtensor/xview.hpp"
+#include "xtensor/xadapt.hpp"
+#include "neureka_binconv.hpp"
+
+static constexpr int TP_IN = 32;
+static constexpr int TP_OUT = 32;
+static constexpr int COLUMN_SIZE = 9;
+static constexpr int NR_COLUMN = 36;
+
+typedef NeurekaBinConvEngine<TP_IN, COLUMN_SIZE, NR_COLUMN> Engine;
+
+
+// Reference model, same code as neureka_matrixvec.cpp
+
+static xt::xarray<uint8_t> __Weight_transform_1x1(xt::xarray<uint8_t> W)
+{
+    xt::xarray<uint8_t> wout_1x1 = xt::zeros<uint8_t>({32});
+    for (int i=0; i<32; i++)
+    {
+        int index_q8 = i/8;
+        int index_r4 = i%4;
+        int index_q4r2 = (i/4)%2;
+        int index_l = 8*index_r4+index_q8;
+        int index_h = 8*index_r4+index_q8+4;
+        if (index_q4r2==0)
+        {
+            wout_1x1[i] = (W[index_l] & 0x0F) + ((W[index_h] & 0x0F)<<4);
+        }
+        else
+        {
+            wout_1x1[i] = ((W[index_l] & 0xF0)>>4) + 16*((W[index_h] & 0xF0)>>4);
+        }
+    }
+    return wout_1x1;
+}
+
+static xt::xarray<uint8_t> __Weight_transform_28(xt::xarray<uint8_t> W)
+{
+    xt::xarray<uint8_t> wout_3x3 = xt::zeros<uint8_t>({36});
+    for (int i=0; i<32; i++)
+    {
+        int index0 = i % 7;
+        int index1 = i / 7;
+        if (index0==3)
+        {
+            wout_3x3[index1*8+index0] = (W[i] & 0x0F);
+        }
+        else if (index0>3)
+        {
+            wout_3x3[index1*8+index0] = ((W[i-1] & 0xF0) >> 4) + ((W[i] & 0x0F)*16);
+            if (index0==6)
+            {
+                wout_3x3[index1*8+index0+1] = ((W[i] & 0xF0) >> 4);
+            }
+        }
+        else
+        {
+            wout_3x3[index1*8+index0] = W[i];
+        }
+    }
+    return wout_3x3;
+}
+
+static xt::xarray<uint8_t> __WeightUnpack(xt::xarray<uint8_t> w, int size, int TP_IN)
+{
+    w = w.reshape({size,(TP_IN/8),1});
+    xt::xarray<uint8_t> wu = xt::zeros<uint8_t>({size,(TP_IN/8),8});
+    xt::view(wu, xt::all(), xt::all()) = xt::view(w, xt::all(), xt::all());
+    wu = (wu >> xt::linspace(0, 7, 8).reshape({1, 1, 8})) & 0x1;
+    return wu.reshape({size, (TP_IN/8)*8});
+}
+
+static xt::xarray<int64_t> __BinConvBlock(xt::xarray<uint8_t> w, xt::xarray<int8_t> x,
+    xt::xarray<uint8_t> ux, bool signed_activation, int scale=0, int TP_IN=32)
+{
+    if (signed_activation)
+    {
+        return xt::sum(w * x, 0) * scale;
+    }
+    else
+    {
+        return xt::sum(w * ux, 0) * scale;
+    }
+}
+
+class Reference
+{
+public:
+    Reference()
+    {
+        this->psum_block = xt::zeros<int64_t>({NR_COLUMN, COLUMN_SIZE});
+        this->psum_column = xt::zeros<int64_t>({NR_COLUMN});
+        this->accum = xt::zeros<int64_t>({TP_OUT, NR_COLUMN});
+        this->x_array = xt::zeros<int8_t>({NR_COLUMN, COLUMN_SIZE, TP_IN});
+    }
+
+    void binconv_array(xt::xarray<uint8_t>& weight, int scale, int idx, xt::xarray<int32_t> row_enable,
+        xt::xarray<int32_t> mac_enable, bool weight_shift, bool weight_invert, bool use_row_as_scale)
+    {
+        for (int c=0; c<NR_COLUMN; c++)
+        {
+            xt::view(this->psum_column, c) = 0;
+            for (int r=0; r<COLUMN_SIZE; r++)
+            {
+                if (row_enable(r) == 0)
+                {
+                    continue;
+                }
+                auto scale_loc = use_row_as_scale ? 1 << r : scale;
+                auto activ = xt::view(this->x_array, c, r, xt::all());
+                xt::view(this->psum_block, c, r) = __BinConvBlock(xt::view(weight, r) * mac_enable, activ, activ,
+                    this->signed_activation, scale_loc, TP_IN);
+                if (weight_shift && weight_invert)
+                {
+                    xt::view(this->psum_block, c, r) = -xt::view(this->psum_block, c, r);
+                }
+                xt::view(this->psum_column, c) += xt::view(this->psum_block, c, r);
+            }
+
+            if (weight_shift)
+            {
+                xt::view(this->accum, xt::all(), c) += xt::view(this->psum_column, c);
+            }
+            else
+            {
+                xt::view(this->accum, idx, c) += xt::view(this->psum_column, c);
+            }
+        }
+    }
+
+    xt::xarray<int64_t> psum_block;
+    xt::xarray<int64_t> psum_column;
+    xt::xarray<int64_t> accum;
+    xt::xarray<int8_t> x_array;
+    bool signed_activation;
+};
+
+
+class Check
+{
+public:
+    Check(std::mt19937 &rng) : rng(rng)
+    {
+        this->engine = new Engine();
+        this->psum_block = xt::zeros<int64_t>({NR_COLUMN, COLUMN_SIZE});
+        this->psum_column = xt::zeros<int64_t>({NR_COLUMN});
+        this->accum = xt::zeros<int64_t>({TP_OUT, NR_COLUMN});
+    }
+
+    ~Check()
+    {
+        delete this->engine;
+    }
+
+    // Random activations. In 1x1 mode, only the first qw rows are filled, as
+    // load_do_extract does.
+    void load(int fs, int qw)
+    {
+        for (int c=0; c<NR_COLUMN; c++)
+        {
+            for (int r=0; r<COLUMN_SIZE; r++)
+            {
+                for (int i=0; i<TP_IN; i++)
+                {
+                    bool used = fs == 3 || r < qw;
+                    this->ref.x_array(c, r, i) = used ? (int8_t)this->rng() : 0;
+                }
+            }
+        }
+        this->engine->load_activations(this->ref.x_array.data());
+    }
+
+    bool step(const char *name, const uint8_t *weight, int nb_rows, int scale, int idx,
+        xt::xarray<int32_t> &row_enable, xt::xarray<int32_t> &mac_enable, bool weight_shift,
+        bool weight_invert, bool use_row_as_scale)
+    {
+        // The reference reads one weight row per array row, give it null rows
+        // beyond nb_rows as the engine does
+        xt::xarray<uint8_t> packed = xt::zeros<uint8_t>({COLUMN_SIZE * TP_IN/8});
+        for (int i=0; i<nb_rows * TP_IN/8; i++)
+        {
+            packed(i) = weight[i];
+        }
+        xt::xarray<uint8_t> unpacked = __WeightUnpack(packed, COLUMN_SIZE, TP_IN);
+
+        this->ref.binconv_array(unpacked, scale, idx, row_enable, mac_enable, weight_shift, weight_invert,
+            use_row_as_scale);
+
+        uint32_t row_mask = 0;
+        for (int r=0; r<COLUMN_SIZE; r++)
+        {
+            if (row_enable(r) != 0)
+            {
+                row_mask |= 1 << r;
+            }
+        }
+        if (!this->engine->set_mac_enable(mac_enable.data()))
+        {
+            printf("MAC enable rejected (step: %s)\n", name);
+            return false;
+        }
+        this->engine->compute(weight, nb_rows, scale, idx, row_mask, this->ref.signed_activation, weight_shift,
+            weight_invert, use_row_as_scale, TP_OUT, this->psum_block.data(), this->psum_column.data(),
+            this->accum.data());
+
+        if (this->psum_block != this->ref.psum_block || this->psum_column != this->ref.psum_column ||
+            this->accum != this->ref.accum)
+        {
+            printf("Mismatch (step: %s, scale: %d, idx: %d, signed: %d)\n", name, scale, idx,
+                this->ref.signed_activation);
+            return false;
+        }
+        return true;
+    }
+
+    std::mt19937 &rng;
+    Engine *engine;
+    Reference ref;
+    xt::xarray<int64_t> psum_block;
+    xt::xarray<int64_t> psum_column;
+    xt::xarray<int64_t> accum;
+};
+
+
+// One layer, as run by the MATRIX_VECTOR_COMPUTE phase: for each activation
+// load, the weight offset cycle, then one cycle per output channel and weight
+// bit.
+static bool check_layer(std::mt19937 &rng, int fs, bool depthwise)
+{
+    Check check(rng);
+    check.ref.signed_activation = rng() & 1;
+
+    int qw = 1 + rng() % 8;
+    int tp_in_s = 28;
+    int Wmin = (int)rng();
+    if (rng() & 1)
+    {
+        // Realistic offsets, the full range is also covered to check the
+        // wrap-around
+        Wmin = -(int)(rng() % 256);
+    }
+
+    xt::xarray<int32_t> row_enable;
+    if (fs == 3)
+    {
+        row_enable = xt::ones<int32_t>({9});
+        uint32_t filter_mask = rng() % 4 == 0 ? rng() : 0;
+        for (int i=0; i<9; i++)
+        {
+            row_enable(i) = ((filter_mask >> i) & 1) ? 0 : 1;
+        }
+    }
+    else
+    {
+        // A single element, broadcast to all the rows
+        row_enable = xt::ones<int32_t>({1});
+    }
+
+    for (int load=0; load<3; load++)
+    {
+        check.load(fs, qw);
+
+        int nb_k_out = depthwise ? tp_in_s : 4;
+        for (int k_out=0; k_out<nb_k_out; k_out++)
+        {
+            xt::xarray<int32_t> mac_enable = xt::zeros<int32_t>({TP_IN});
+            if (depthwise)
+            {
+                mac_enable(k_out) = 1;
+            }
+            else
+            {
+                for (int i=0; i<TP_IN; i++)
+                {
+                    mac_enable(i) = i < tp_in_s || fs == 1 ? 1 : 0;
+                }
+            }
+
+            // Weight offset
+            uint8_t weight_ofs[COLUMN_SIZE * TP_IN/8] = { 0 };
+            memset(weight_ofs, 0xff, (fs == 3 ? 9 : 1) * TP_IN/8);
+            if (!check.step("weightoffs", weight_ofs, 9, Wmin, depthwise ? k_out : 0, row_enable,
+                mac_enable, !depthwise, false, false))
+            {
+                return false;
+            }
+
+            for (int qw_iter=0; qw_iter<(fs == 3 ? qw : 1); qw_iter++)
+            {
+                xt::xarray<uint8_t> weight_ld = xt::zeros<uint8_t>({32});
+                for (int i=0; i<32; i++)
+                {
+                    weight_ld(i) = rng();
+                }
+
+                // The engine gets the transforms on raw bytes, check them too
+                xt::xarray<uint8_t> transform = fs == 3 ? __Weight_transform_28(weight_ld) :
+                    __Weight_transform_1x1(weight_ld);
+                uint8_t packed[36];
+                if (fs == 3)
+                {
+                    neureka_weight_transform_28(weight_ld.data(), packed);
+                }
+                else
+                {
+                    neureka_weight_transform_1x1(weight_ld.data(), packed);
+                }
+                for (size_t i=0; i<transform.size(); i++)
+                {
+                    if (packed[i] != transform(i))
+                    {
+                        printf("Weight transform mismatch (fs: %d, index: %ld)\n", fs, i);
+                        return false;
+                    }
+                }
+
+                if (!check.step("matrixvec", packed, fs == 3 ? 9 : 8, 1 << qw_iter, k_out, row_enable,
+                    mac_enable, false, false, fs == 1))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // Inverted weight offset, not used by the model but supported by the array
+    xt::xarray<int32_t> mac_enable = xt::ones<int32_t>({TP_IN});
+    uint8_t weight_ofs[COLUMN_SIZE * TP_IN/8];
+    for (int i=0; i<COLUMN_SIZE * TP_IN/8; i++)
+    {
+        weight_ofs[i] = rng();
+    }
+    return check.step("inverted", weight_ofs, 9, Wmin, 0, row_enable, mac_enable, true, true, false);
+}
+
+
+int main()
+{
+    int status = 0;
+    std::mt19937 rng(0);
+
+    for (int layer=0; layer<50; layer++)
+    {
+        int fs = layer % 2 ? 3 : 1;
+        bool depthwise = fs == 3 && layer % 5 == 0;
+        if (!check_layer(rng, fs, depthwise))
+        {
+            printf("Layer %d failed (fs: %d, depthwise: %d)\n", layer, fs, depthwise);
+            status = 1;
+        }
+    }
+
+    printf("%s\n", status ? "FAILED" : "PASSED");
+
+    return status;
+}
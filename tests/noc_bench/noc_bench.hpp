@@ -0,0 +1,708 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Synthetic traffic driver shared by the NoC benchmark components.
+ *
+ * The driver owns everything which does not depend on the interface flavour
+ * of the network under test: traffic patterns, Bernoulli injection, per-node
+ * source queues, the warmup / measure / drain phases of each injection rate
+ * and the CSV reports. The components (noc_bench_v1.cpp for io, noc_bench_v2.cpp
+ * for io_v2) only implement NocBenchPort to push packets into the network and
+ * call NocBenchDriver::complete when a packet is done.
+ *
+ * Latencies are counted from the cycle the packet is generated, so that they
+ * include source queueing, and are given in cycles. Throughputs are given in
+ * bytes per cycle per node.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+class NocBenchPacket
+{
+public:
+    int src;
+    int dest;
+    int64_t gen_cycle;
+    // Generated during the measurement window of the current rate
+    bool measured;
+};
+
+
+/**
+ * Interface implemented by the components for each injecting node.
+ */
+class NocBenchPort
+{
+public:
+    // Tells if the node can take one more packet this cycle
+    virtual bool is_ready() = 0;
+    // Pushes the packet to the network. Returns false if it was refused and
+    // must be sent again later.
+    virtual bool send(NocBenchPacket *packet) = 0;
+};
+
+
+class NocBenchConfig
+{
+public:
+    std::string model;
+    int nb_x;
+    int nb_y;
+    std::vector<std::string> patterns;
+    // Offered loads, as a fraction of the injection link bandwidth
+    std::vector<double> rates;
+    int packet_size;
+    int link_width;
+    int64_t warmup_cycles;
+    int64_t measure_cycles;
+    int64_t drain_cycles;
+    int source_queue_size;
+    double hotspot_fraction;
+    // A rate is saturated once its average latency exceeds this factor times
+    // the zero-load latency
+    double saturation_factor;
+    uint64_t seed;
+    std::string csv_path;
+    std::string summary_path;
+    // Summary of a previous run to compare against, no check if empty
+    std::string reference_path;
+    double tolerance;
+    // Allowed host slowdown against the reference, 0 disables the check
+    double host_tolerance;
+};
+
+
+class NocBenchDriver
+{
+public:
+    static constexpr int PATTERN_UNIFORM = 0;
+    static constexpr int PATTERN_TRANSPOSE = 1;
+    static constexpr int PATTERN_BIT_COMPLEMENT = 2;
+    static constexpr int PATTERN_HOTSPOT = 3;
+    static constexpr int PATTERN_NEIGHBOUR = 4;
+    static constexpr int PATTERN_ALL_TO_ALL = 5;
+
+    static int parse_pattern(std::string name);
+
+    NocBenchDriver(NocBenchConfig &config);
+    ~NocBenchDriver();
+    void set_port(int node, NocBenchPort *port) { this->ports[node] = port; }
+    // Returns an error message if the configuration can't be run
+    std::string check_config();
+    void start(int64_t cycle);
+    // Called every cycle. Returns false once the whole sweep is over.
+    bool tick(int64_t cycle);
+    void complete(NocBenchPacket *packet, int64_t cycle);
+    int get_status() { return this->status; }
+
+private:
+    enum Phase
+    {
+        PHASE_IDLE,
+        PHASE_WARMUP,
+        PHASE_MEASURE,
+        PHASE_DRAIN,
+        PHASE_DONE,
+    };
+
+    class Result
+    {
+    public:
+        std::string pattern;
+        double zero_load_latency = 0;
+        double saturation_throughput = 0;
+        // First saturated rate, 0 if the sweep never saturated
+        double saturation_rate = 0;
+        int64_t sim_cycles = 0;
+        double host_seconds = 0;
+    };
+
+    int get_dest(int src);
+    void generate(int64_t cycle);
+    void start_rate(int64_t cycle);
+    void end_rate(int64_t cycle, bool timeout);
+    void end_pattern(int64_t cycle);
+    void write_summary();
+    void check_reference();
+
+    NocBenchConfig &config;
+    int nb_nodes;
+    std::vector<NocBenchPort *> ports;
+    std::vector<std::deque<NocBenchPacket *>> source_queues;
+    std::vector<NocBenchPacket *> free_packets;
+    std::vector<int> all_to_all_index;
+    std::mt19937_64 rng;
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+    FILE *csv = NULL;
+    int status = 0;
+
+    Phase phase = PHASE_DONE;
+    int pattern_index;
+    int pattern;
+    int rate_index;
+    double inject_prob;
+    int hotspot_node;
+    int64_t phase_start;
+    int64_t rate_start;
+    int64_t measure_start;
+    int64_t measure_end;
+
+    // Packets generated and not completed yet, whether queued or in flight
+    int nb_pending = 0;
+    // Measured packets not completed yet, whether queued or in flight
+    int nb_measured_pending;
+    int64_t nb_generated_bytes;
+    int64_t nb_accepted_bytes;
+    int64_t nb_dropped;
+    std::vector<int64_t> latencies;
+
+    Result result;
+    std::vector<Result> results;
+    int64_t pattern_start_cycle;
+    std::chrono::steady_clock::time_point pattern_start_time;
+    std::chrono::steady_clock::time_point rate_start_time;
+};
+
+
+inline int NocBenchDriver::parse_pattern(std::string name)
+{
+    if (name == "uniform") return PATTERN_UNIFORM;
+    if (name == "transpose") return PATTERN_TRANSPOSE;
+    if (name == "bit_complement") return PATTERN_BIT_COMPLEMENT;
+    if (name == "hotspot") return PATTERN_HOTSPOT;
+    if (name == "neighbour") return PATTERN_NEIGHBOUR;
+    if (name == "all_to_all") return PATTERN_ALL_TO_ALL;
+    return -1;
+}
+
+
+inline NocBenchDriver::NocBenchDriver(NocBenchConfig &config)
+    : config(config)
+{
+    this->nb_nodes = config.nb_x * config.nb_y;
+    this->ports.resize(this->nb_nodes);
+    this->source_queues.resize(this->nb_nodes);
+    this->all_to_all_index.resize(this->nb_nodes);
+    this->hotspot_node = (config.nb_y / 2) * config.nb_x + config.nb_x / 2;
+}
+
+
+inline NocBenchDriver::~NocBenchDriver()
+{
+    for (NocBenchPacket *packet: this->free_packets)
+    {
+        delete packet;
+    }
+}
+
+
+inline std::string NocBenchDriver::check_config()
+{
+    for (std::string &name: this->config.patterns)
+    {
+        int pattern = NocBenchDriver::parse_pattern(name);
+        if (pattern == -1)
+        {
+            return "unknown traffic pattern: " + name;
+        }
+        if (pattern == PATTERN_TRANSPOSE && this->config.nb_x != this->config.nb_y)
+        {
+            return "transpose pattern needs a square mesh";
+        }
+    }
+    if (this->nb_nodes < 2)
+    {
+        return "at least 2 nodes are needed";
+    }
+    if (this->config.rates.size() == 0)
+    {
+        return "no injection rate";
+    }
+    return "";
+}
+
+
+inline void NocBenchDriver::start(int64_t cycle)
+{
+    this->csv = fopen(this->config.csv_path.c_str(), "w");
+    if (this->csv == NULL)
+    {
+        fprintf(stderr, "Failed to open %s\n", this->config.csv_path.c_str());
+        this->status = 1;
+        this->phase = PHASE_DONE;
+        return;
+    }
+
+    fprintf(this->csv, "model,pattern,rate,offered,accepted,avg_latency,p99_latency,max_latency,"
+        "packets,saturated,sim_cycles,host_ms\n");
+
+    this->results.clear();
+    this->pattern_index = -1;
+    this->end_pattern(cycle);
+}
+
+
+inline int NocBenchDriver::get_dest(int src)
+{
+    int x = src % this->config.nb_x;
+    int y = src / this->config.nb_x;
+    int dest;
+
+    switch (this->pattern)
+    {
+        case PATTERN_TRANSPOSE:
+            dest = x * this->config.nb_x + y;
+            break;
+
+        case PATTERN_BIT_COMPLEMENT:
+            // Same as complementing the node index bits when dimensions are
+            // powers of 2, and still a permutation when they are not.
+            dest = (this->config.nb_y - 1 - y) * this->config.nb_x + this->config.nb_x - 1 - x;
+            break;
+
+        case PATTERN_HOTSPOT:
+            if (this->uniform(this->rng) < this->config.hotspot_fraction)
+            {
+                dest = this->hotspot_node;
+                break;
+            }
+            // Fall through to uniform traffic for the rest
+        case PATTERN_UNIFORM:
+            dest = this->rng() % (this->nb_nodes - 1);
+            if (dest >= src)
+            {
+                dest++;
+            }
+            break;
+
+        case PATTERN_NEIGHBOUR:
+        {
+            int neighbours[4];
+            int nb_neighbours = 0;
+            if (x > 0) neighbours[nb_neighbours++] = src - 1;
+            if (x < this->config.nb_x - 1) neighbours[nb_neighbours++] = src + 1;
+            if (y > 0) neighbours[nb_neighbours++] = src - this->config.nb_x;
+            if (y < this->config.nb_y - 1) neighbours[nb_neighbours++] = src + this->config.nb_x;
+            dest = neighbours[this->rng() % nb_neighbours];
+            break;
+        }
+
+        case PATTERN_ALL_TO_ALL:
+        default:
+        {
+            // Each source walks through all other nodes, starting after itself
+            // so that sources are spread over the destinations at any time.
+            int index = this->all_to_all_index[src];
+            this->all_to_all_index[src] = (index + 1) % (this->nb_nodes - 1);
+            dest = (src + 1 + index) % this->nb_nodes;
+            break;
+        }
+    }
+
+    // Nodes mapped on themselves (e.g. transpose diagonal) do not inject
+    return dest == src ? -1 : dest;
+}
+
+
+inline void NocBenchDriver::generate(int64_t cycle)
+{
+    for (int i=0; i<this->nb_nodes; i++)
+    {
+        if (this->uniform(this->rng) >= this->inject_prob)
+        {
+            continue;
+        }
+
+        int dest = this->get_dest(i);
+        if (dest == -1)
+        {
+            continue;
+        }
+
+        bool measured = this->phase == PHASE_MEASURE;
+        if (measured)
+        {
+            this->nb_generated_bytes += this->config.packet_size;
+        }
+
+        if ((int)this->source_queues[i].size() >= this->config.source_queue_size)
+        {
+            // The node can't keep up with the offered load, this rate will be
+            // reported as saturated.
+            this->nb_dropped++;
+            continue;
+        }
+
+        NocBenchPacket *packet;
+        if (this->free_packets.size() > 0)
+        {
+            packet = this->free_packets.back();
+            this->free_packets.pop_back();
+        }
+        else
+        {
+            packet = new NocBenchPacket();
+        }
+
+        packet->src = i;
+        packet->dest = dest;
+        packet->gen_cycle = cycle;
+        packet->measured = measured;
+        if (measured)
+        {
+            this->nb_measured_pending++;
+        }
+
+        this->nb_pending++;
+        this->source_queues[i].push_back(packet);
+    }
+}
+
+
+inline bool NocBenchDriver::tick(int64_t cycle)
+{
+    if (this->phase == PHASE_DONE)
+    {
+        return false;
+    }
+
+    if (this->phase == PHASE_WARMUP || this->phase == PHASE_MEASURE)
+    {
+        this->generate(cycle);
+    }
+
+    // Each node injects at most one packet per cycle
+    for (int i=0; i<this->nb_nodes; i++)
+    {
+        std::deque<NocBenchPacket *> &queue = this->source_queues[i];
+        if (queue.size() > 0 && this->ports[i]->is_ready())
+        {
+            NocBenchPacket *packet = queue.front();
+            if (this->ports[i]->send(packet))
+            {
+                queue.pop_front();
+            }
+        }
+    }
+
+    switch (this->phase)
+    {
+        case PHASE_IDLE:
+            // Wait for the previous rate to be fully drained, so that rates are
+            // independent from each other.
+            if (this->nb_pending == 0)
+            {
+                this->start_rate(cycle);
+            }
+            break;
+
+        case PHASE_WARMUP:
+            if (cycle - this->phase_start >= this->config.warmup_cycles)
+            {
+                this->phase = PHASE_MEASURE;
+                this->phase_start = cycle;
+                this->measure_start = cycle;
+            }
+            break;
+
+        case PHASE_MEASURE:
+            if (cycle - this->phase_start >= this->config.measure_cycles)
+            {
+                this->phase = PHASE_DRAIN;
+                this->phase_start = cycle;
+                this->measure_end = cycle;
+            }
+            break;
+
+        case PHASE_DRAIN:
+            if (this->nb_measured_pending == 0)
+            {
+                this->end_rate(cycle, false);
+            }
+            else if (cycle - this->phase_start >= this->config.drain_cycles)
+            {
+                this->end_rate(cycle, true);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return this->phase != PHASE_DONE;
+}
+
+
+inline void NocBenchDriver::complete(NocBenchPacket *packet, int64_t cycle)
+{
+    this->nb_pending--;
+
+    if (cycle >= this->measure_start && cycle < this->measure_end)
+    {
+        this->nb_accepted_bytes += this->config.packet_size;
+    }
+
+    if (packet->measured)
+    {
+        this->latencies.push_back(cycle - packet->gen_cycle);
+        this->nb_measured_pending--;
+    }
+
+    this->free_packets.push_back(packet);
+}
+
+
+inline void NocBenchDriver::start_rate(int64_t cycle)
+{
+    double rate = this->config.rates[this->rate_index];
+
+    this->inject_prob = std::min(1.0, rate * this->config.link_width / this->config.packet_size);
+    this->phase = PHASE_WARMUP;
+    this->phase_start = cycle;
+    this->rate_start = cycle;
+    // Nothing is accounted before the measurement window is known
+    this->measure_start = INT64_MAX;
+    this->measure_end = INT64_MAX;
+    this->nb_measured_pending = 0;
+    this->nb_generated_bytes = 0;
+    this->nb_accepted_bytes = 0;
+    this->nb_dropped = 0;
+    this->latencies.clear();
+    this->rate_start_time = std::chrono::steady_clock::now();
+}
+
+
+inline void NocBenchDriver::end_rate(int64_t cycle, bool timeout)
+{
+    double rate = this->config.rates[this->rate_index];
+    double window = (double)this->config.measure_cycles * this->nb_nodes;
+    double offered = this->nb_generated_bytes / window;
+    double accepted = this->nb_accepted_bytes / window;
+    double host_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - this->rate_start_time).count();
+
+    double avg_latency = 0;
+    int64_t p99_latency = 0, max_latency = 0;
+    int nb_packets = this->latencies.size();
+    if (nb_packets > 0)
+    {
+        std::sort(this->latencies.begin(), this->latencies.end());
+        int64_t sum = 0;
+        for (int64_t latency: this->latencies)
+        {
+            sum += latency;
+        }
+        avg_latency = (double)sum / nb_packets;
+        p99_latency = this->latencies[(nb_packets - 1) * 99 / 100];
+        max_latency = this->latencies.back();
+    }
+
+    if (this->rate_index == 0)
+    {
+        this->result.zero_load_latency = avg_latency;
+    }
+
+    bool saturated = timeout || this->nb_dropped > 0 ||
+        (this->rate_index > 0 && avg_latency > this->config.saturation_factor * this->result.zero_load_latency);
+
+    if (accepted > this->result.saturation_throughput)
+    {
+        this->result.saturation_throughput = accepted;
+    }
+
+    fprintf(this->csv, "%s,%s,%.3f,%.4f,%.4f,%.2f,%ld,%ld,%d,%d,%ld,%.1f\n",
+        this->config.model.c_str(), this->result.pattern.c_str(), rate, offered, accepted,
+        avg_latency, p99_latency, max_latency, nb_packets, saturated,
+        cycle - this->rate_start, host_ms);
+    fflush(this->csv);
+
+    printf("[noc_bench] %s %-14s rate %.3f offered %.4f accepted %.4f latency avg %.2f p99 %ld max %ld%s\n",
+        this->config.model.c_str(), this->result.pattern.c_str(), rate, offered, accepted, avg_latency,
+        p99_latency, max_latency, saturated ? " (saturated)" : "");
+
+    // Past saturation, latencies only reflect the source queue size, go to the
+    // next pattern.
+    if (saturated)
+    {
+        this->result.saturation_rate = rate;
+    }
+
+    if (saturated || this->rate_index == (int)this->config.rates.size() - 1)
+    {
+        this->result.sim_cycles = cycle - this->pattern_start_cycle;
+        this->result.host_seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - this->pattern_start_time).count();
+        this->results.push_back(this->result);
+        this->end_pattern(cycle);
+    }
+    else
+    {
+        this->rate_index++;
+        this->phase = PHASE_IDLE;
+    }
+
+    // Following rates only account the packets they generate
+    this->measure_start = INT64_MAX;
+    this->measure_end = INT64_MAX;
+}
+
+
+inline void NocBenchDriver::end_pattern(int64_t cycle)
+{
+    this->pattern_index++;
+
+    if (this->pattern_index == (int)this->config.patterns.size())
+    {
+        fclose(this->csv);
+        this->csv = NULL;
+        this->write_summary();
+        this->check_reference();
+        this->phase = PHASE_DONE;
+        return;
+    }
+
+    this->result = Result();
+    this->result.pattern = this->config.patterns[this->pattern_index];
+    this->pattern = NocBenchDriver::parse_pattern(this->result.pattern);
+    this->rate_index = 0;
+    this->rng.seed(this->config.seed);
+    std::fill(this->all_to_all_index.begin(), this->all_to_all_index.end(), 0);
+    this->phase = PHASE_IDLE;
+    this->pattern_start_time = std::chrono::steady_clock::now();
+    this->pattern_start_cycle = cycle;
+}
+
+
+inline void NocBenchDriver::write_summary()
+{
+    FILE *file = fopen(this->config.summary_path.c_str(), "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Failed to open %s\n", this->config.summary_path.c_str());
+        this->status = 1;
+        return;
+    }
+
+    fprintf(file, "model,pattern,zero_load_latency,saturation_throughput,saturation_rate,"
+        "sim_cycles,host_kcycles_per_s\n");
+
+    printf("[noc_bench] %-14s %12s %12s %10s %12s %14s\n", "pattern", "zero-load", "sat. thput",
+        "sat. rate", "cycles", "host kcycles/s");
+
+    for (Result &result: this->results)
+    {
+        double speed = result.host_seconds > 0 ? result.sim_cycles / result.host_seconds / 1000 : 0;
+
+        fprintf(file, "%s,%s,%.2f,%.4f,%.3f,%ld,%.1f\n", this->config.model.c_str(),
+            result.pattern.c_str(), result.zero_load_latency, result.saturation_throughput,
+            result.saturation_rate, result.sim_cycles, speed);
+
+        printf("[noc_bench] %-14s %12.2f %12.4f %10.3f %12ld %14.1f\n", result.pattern.c_str(),
+            result.zero_load_latency, result.saturation_throughput, result.saturation_rate,
+            result.sim_cycles, speed);
+    }
+
+    fclose(file);
+}
+
+
+inline void NocBenchDriver::check_reference()
+{
+    if (this->config.reference_path == "")
+    {
+        return;
+    }
+
+    FILE *file = fopen(this->config.reference_path.c_str(), "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Failed to open reference %s\n", this->config.reference_path.c_str());
+        this->status = 1;
+        return;
+    }
+
+    char line[512];
+    // Skip the header
+    if (fgets(line, sizeof(line), file) == NULL)
+    {
+        line[0] = 0;
+    }
+
+    while (fgets(line, sizeof(line), file))
+    {
+        std::stringstream stream(line);
+        std::string model, pattern, field;
+        double ref_latency, ref_throughput, ref_speed;
+
+        std::getline(stream, model, ',');
+        std::getline(stream, pattern, ',');
+        std::getline(stream, field, ','); ref_latency = atof(field.c_str());
+        std::getline(stream, field, ','); ref_throughput = atof(field.c_str());
+        std::getline(stream, field, ',');
+        std::getline(stream, field, ',');
+        std::getline(stream, field, ','); ref_speed = atof(field.c_str());
+
+        if (model != this->config.model)
+        {
+            continue;
+        }
+
+        for (Result &result: this->results)
+        {
+            if (result.pattern != pattern)
+            {
+                continue;
+            }
+
+            double tolerance = this->config.tolerance;
+            double speed = result.host_seconds > 0 ? result.sim_cycles / result.host_seconds / 1000 : 0;
+
+            if (std::abs(result.zero_load_latency - ref_latency) > tolerance * ref_latency ||
+                std::abs(result.saturation_throughput - ref_throughput) > tolerance * ref_throughput)
+            {
+                printf("[noc_bench] %s: modeled performance changed (zero-load latency %.2f, "
+                    "reference %.2f, saturation throughput %.4f, reference %.4f)\n",
+                    pattern.c_str(), result.zero_load_latency, ref_latency,
+                    result.saturation_throughput, ref_throughput);
+                this->status = 1;
+            }
+
+            if (this->config.host_tolerance > 0 && speed < ref_speed * (1 - this->config.host_tolerance))
+            {
+                printf("[noc_bench] %s: host speed regression (%.1f kcycles/s, reference %.1f)\n",
+                    pattern.c_str(), speed, ref_speed);
+                this->status = 1;
+            }
+        }
+    }
+
+    fclose(file);
+}
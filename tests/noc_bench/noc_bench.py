@@ -0,0 +1,97 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class NocBench(gvsoc.systree.Component):
+    """Synthetic traffic benchmark driver for a nb_x by nb_y mesh of nodes.
+
+    For each traffic pattern, the offered load is swept over the given rates,
+    each node injecting packets of packet_size bytes with a Bernoulli process.
+    A rate is a fraction of the link_width bytes per cycle each node can
+    inject. Each rate is reported as one line of the csv file (offered and
+    accepted throughput, average, p99 and max latency) and each pattern as one
+    line of the summary file (zero-load latency, saturation throughput, host
+    speed). When reference is a summary file from a previous run, the run fails
+    if the modeled numbers move by more than tolerance, or if the host speed
+    drops by more than host_tolerance (0 disables this check).
+    """
+
+    def __init__(self, parent, name, source: str, *, model: str, nb_x: int, nb_y: int,
+            patterns: list, rates: list, packet_size: int, link_width: int,
+            target_base: int=0, target_size: int=0, max_outstanding: int=8,
+            warmup_cycles: int=1000, measure_cycles: int=5000, drain_cycles: int=20000,
+            source_queue_size: int=64, hotspot_fraction: float=0.2,
+            saturation_factor: float=3.0, seed: int=0, csv: str='noc_bench.csv',
+            summary: str='noc_bench_summary.csv', reference: str='', tolerance: float=0.02,
+            host_tolerance: float=0.0):
+        super().__init__(parent, name)
+
+        self.add_sources([source])
+
+        self.add_property('model', model)
+        self.add_property('nb_x', nb_x)
+        self.add_property('nb_y', nb_y)
+        self.add_property('patterns', patterns)
+        self.add_property('rates', [float(rate) for rate in rates])
+        self.add_property('packet_size', packet_size)
+        self.add_property('link_width', link_width)
+        self.add_property('target_base', target_base)
+        self.add_property('target_size', target_size)
+        self.add_property('max_outstanding', max_outstanding)
+        self.add_property('warmup_cycles', warmup_cycles)
+        self.add_property('measure_cycles', measure_cycles)
+        self.add_property('drain_cycles', drain_cycles)
+        self.add_property('source_queue_size', source_queue_size)
+        self.add_property('hotspot_fraction', float(hotspot_fraction))
+        self.add_property('saturation_factor', float(saturation_factor))
+        self.add_property('seed', seed)
+        self.add_property('csv', csv)
+        self.add_property('summary', summary)
+        self.add_property('reference', reference)
+        self.add_property('tolerance', float(tolerance))
+        self.add_property('host_tolerance', float(host_tolerance))
+
+    def o_NODE(self, x: int, y: int, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind(f'node_{x}_{y}', itf, signature=self.signature)
+
+    def i_TARGET(self, x: int, y: int) -> gvsoc.systree.SlaveItf:
+        return gvsoc.systree.SlaveItf(self, f'target_{x}_{y}', signature=self.signature)
+
+
+class NocBenchV2(NocBench):
+    """Benchmark driver for io_v2 networks, targets are address-mapped."""
+
+    signature = 'io_v2'
+
+    def __init__(self, parent, name, **kwargs):
+        super().__init__(parent, name, 'noc_bench_v2.cpp', **kwargs)
+
+
+class NocBenchV1(NocBench):
+    """Benchmark driver for io networks.
+
+    With dest_in_args, destinations are given by the teranoc FlooNoc request
+    arguments instead of being address-mapped.
+    """
+
+    signature = 'io'
+
+    def __init__(self, parent, name, dest_in_args: bool=False, **kwargs):
+        super().__init__(parent, name, 'noc_bench_v1.cpp', **kwargs)
+
+        self.add_property('dest_in_args', dest_in_args)
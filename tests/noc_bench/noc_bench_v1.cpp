@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * NocBenchV1 — synthetic traffic benchmark for io networks.
+ *
+ * Same as NocBenchV2 for the networks using the former io interface. Two
+ * flavours are supported:
+ * - address-mapped networks (pulp/floonoc): node n owns
+ *   [target_base + n * target_size, +target_size), a denied burst is kept by
+ *   the network and granted later, and latency is measured on the round-trip.
+ * - networks routed with request arguments (teranoc l1 FlooNoc): the
+ *   destination is given by the FlooNoc::REQ_DEST_X/Y arguments, a denied
+ *   request is dropped by the network and must be sent again, and there is no
+ *   response path so latency is measured when the request reaches its target.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <pulp/teranoc/l1_interconnect/floonoc.hpp>
+#include "noc_bench.hpp"
+
+
+class NocBenchV1;
+
+
+class NocBenchReqV1 : public vp::IoReq
+{
+public:
+    NocBenchPacket *packet;
+};
+
+
+class NocBenchNodeV1 : public vp::Block, public NocBenchPort
+{
+    friend class NocBenchV1;
+
+public:
+    NocBenchNodeV1(NocBenchV1 *top, int x, int y);
+
+    void reset(bool active) override;
+    bool is_ready() override;
+    bool send(NocBenchPacket *packet) override;
+
+private:
+    static void response(vp::Block *__this, vp::IoReq *req);
+    static void grant(vp::Block *__this, vp::IoReq *req);
+    static vp::IoReqStatus target_req(vp::Block *__this, vp::IoReq *req);
+    void release(NocBenchReqV1 *req, int64_t cycle);
+
+    NocBenchV1 *top;
+    int x;
+    int y;
+    vp::IoMaster output;
+    vp::IoSlave target;
+    std::vector<NocBenchReqV1> reqs;
+    std::vector<uint8_t> data;
+    std::vector<NocBenchReqV1 *> free_reqs;
+    // A burst was denied and queued by the network, wait for the grant
+    bool waiting_grant = false;
+};
+
+
+class NocBenchV1 : public vp::Component
+{
+    friend class NocBenchNodeV1;
+
+public:
+    NocBenchV1(vp::ComponentConf &config);
+    void reset(bool active) override;
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+
+    vp::Trace trace;
+    vp::ClockEvent fsm_event;
+    NocBenchConfig config;
+    NocBenchDriver *driver;
+    std::vector<NocBenchNodeV1 *> nodes;
+    uint64_t target_base;
+    uint64_t target_size;
+    int max_outstanding;
+    // Destination is given by request arguments instead of the address
+    bool dest_in_args;
+};
+
+
+NocBenchNodeV1::NocBenchNodeV1(NocBenchV1 *top, int x, int y)
+    : vp::Block(top, "node_" + std::to_string(x) + "_" + std::to_string(y)), top(top), x(x), y(y)
+{
+    std::string suffix = std::to_string(x) + "_" + std::to_string(y);
+
+    this->output.set_resp_meth(&NocBenchNodeV1::response);
+    this->output.set_grant_meth(&NocBenchNodeV1::grant);
+    top->new_master_port("node_" + suffix, &this->output, this);
+
+    this->target.set_req_meth(&NocBenchNodeV1::target_req);
+    top->new_slave_port("target_" + suffix, &this->target, this);
+
+    this->reqs.resize(top->max_outstanding);
+    this->data.resize(top->max_outstanding * top->config.packet_size);
+    for (int i=0; i<top->max_outstanding; i++)
+    {
+        this->reqs[i].set_data(&this->data[i * top->config.packet_size]);
+    }
+}
+
+
+void NocBenchNodeV1::reset(bool active)
+{
+    if (active)
+    {
+        this->free_reqs.clear();
+        this->waiting_grant = false;
+
+        for (NocBenchReqV1 &req: this->reqs)
+        {
+            req.init();
+            // The address-mapped FlooNoc keeps the burst state in the last 2
+            // arguments of the burst.
+            req.arg_alloc(this->top->dest_in_args ? FlooNoc::REQ_NB_ARGS : 2);
+            this->free_reqs.push_back(&req);
+        }
+    }
+}
+
+
+bool NocBenchNodeV1::is_ready()
+{
+    return !this->waiting_grant && this->free_reqs.size() > 0;
+}
+
+
+bool NocBenchNodeV1::send(NocBenchPacket *packet)
+{
+    NocBenchReqV1 *req = this->free_reqs.back();
+
+    req->prepare();
+    req->set_size(this->top->config.packet_size);
+    req->set_is_write(true);
+    req->packet = packet;
+
+    if (this->top->dest_in_args)
+    {
+        req->set_addr(0);
+        *req->arg_get(FlooNoc::REQ_SRC_X) = (void *)(long)this->x;
+        *req->arg_get(FlooNoc::REQ_SRC_Y) = (void *)(long)this->y;
+        *req->arg_get(FlooNoc::REQ_DEST_X) = (void *)(long)(packet->dest % this->top->config.nb_x);
+        *req->arg_get(FlooNoc::REQ_DEST_Y) = (void *)(long)(packet->dest / this->top->config.nb_x);
+    }
+    else
+    {
+        req->set_addr(this->top->target_base + this->top->target_size * packet->dest);
+    }
+
+    this->free_reqs.pop_back();
+
+    vp::IoReqStatus status = this->output.req(req);
+
+    if (status == vp::IO_REQ_DENIED)
+    {
+        if (this->top->dest_in_args)
+        {
+            // Dropped by the network, the driver sends it again next cycle
+            this->free_reqs.push_back(req);
+            return false;
+        }
+        this->waiting_grant = true;
+    }
+    else if (status == vp::IO_REQ_OK)
+    {
+        this->release(req, this->top->clock.get_cycles() + req->get_latency());
+    }
+
+    return true;
+}
+
+
+void NocBenchNodeV1::release(NocBenchReqV1 *req, int64_t cycle)
+{
+    this->free_reqs.push_back(req);
+    this->top->driver->complete(req->packet, cycle);
+}
+
+
+void NocBenchNodeV1::response(vp::Block *__this, vp::IoReq *req)
+{
+    NocBenchNodeV1 *_this = (NocBenchNodeV1 *)__this;
+    _this->release((NocBenchReqV1 *)req, _this->top->clock.get_cycles());
+}
+
+
+void NocBenchNodeV1::grant(vp::Block *__this, vp::IoReq *req)
+{
+    NocBenchNodeV1 *_this = (NocBenchNodeV1 *)__this;
+    _this->waiting_grant = false;
+}
+
+
+vp::IoReqStatus NocBenchNodeV1::target_req(vp::Block *__this, vp::IoReq *req)
+{
+    NocBenchNodeV1 *_this = (NocBenchNodeV1 *)__this;
+    NocBenchV1 *top = _this->top;
+
+    // Without response path, the request which reached its target is the one
+    // we sent, give it back to its source node.
+    if (top->dest_in_args)
+    {
+        NocBenchReqV1 *bench_req = (NocBenchReqV1 *)req;
+        top->nodes[bench_req->packet->src]->release(bench_req, top->clock.get_cycles());
+    }
+
+    // Ideal target otherwise, the benchmark only measures the network
+    return vp::IO_REQ_OK;
+}
+
+
+NocBenchV1::NocBenchV1(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &NocBenchV1::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->config.model = js->get_child_str("model");
+    this->config.nb_x = js->get_int("nb_x");
+    this->config.nb_y = js->get_int("nb_y");
+    for (js::Config *elem: js->get("patterns")->get_elems())
+    {
+        this->config.patterns.push_back(elem->get_str());
+    }
+    for (js::Config *elem: js->get("rates")->get_elems())
+    {
+        this->config.rates.push_back(elem->get_double());
+    }
+    this->config.packet_size = js->get_int("packet_size");
+    this->config.link_width = js->get_int("link_width");
+    this->config.warmup_cycles = js->get_int("warmup_cycles");
+    this->config.measure_cycles = js->get_int("measure_cycles");
+    this->config.drain_cycles = js->get_int("drain_cycles");
+    this->config.source_queue_size = js->get_int("source_queue_size");
+    this->config.hotspot_fraction = js->get("hotspot_fraction")->get_double();
+    this->config.saturation_factor = js->get("saturation_factor")->get_double();
+    this->config.seed = js->get_uint("seed");
+    this->config.csv_path = js->get_child_str("csv");
+    this->config.summary_path = js->get_child_str("summary");
+    this->config.reference_path = js->get_child_str("reference");
+    this->config.tolerance = js->get("tolerance")->get_double();
+    this->config.host_tolerance = js->get("host_tolerance")->get_double();
+    this->target_base = js->get_uint("target_base");
+    this->target_size = js->get_uint("target_size");
+    this->max_outstanding = js->get_int("max_outstanding");
+    this->dest_in_args = js->get_child_bool("dest_in_args");
+
+    this->driver = new NocBenchDriver(this->config);
+
+    std::string error = this->driver->check_config();
+    if (error != "")
+    {
+        this->trace.fatal("Invalid benchmark configuration: %s\n", error.c_str());
+        return;
+    }
+
+    for (int y=0; y<this->config.nb_y; y++)
+    {
+        for (int x=0; x<this->config.nb_x; x++)
+        {
+            NocBenchNodeV1 *node = new NocBenchNodeV1(this, x, y);
+            this->nodes.push_back(node);
+            this->driver->set_port(y * this->config.nb_x + x, node);
+        }
+    }
+}
+
+
+void NocBenchV1::reset(bool active)
+{
+    if (!active)
+    {
+        this->driver->start(this->clock.get_cycles());
+        this->fsm_event.enqueue();
+    }
+}
+
+
+void NocBenchV1::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    NocBenchV1 *_this = (NocBenchV1 *)__this;
+
+    if (_this->driver->tick(_this->clock.get_cycles()))
+    {
+        _this->fsm_event.enqueue();
+    }
+    else
+    {
+        _this->time.get_engine()->quit(_this->driver->get_status());
+    }
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new NocBenchV1(config);
+}
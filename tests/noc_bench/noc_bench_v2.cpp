@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * NocBenchV2 — synthetic traffic benchmark for io_v2 networks (FlooNocV2).
+ *
+ * Each node has one io_v2 master injecting write bursts and one io_v2 slave
+ * acting as the target of the node. Destinations are address-mapped: node n
+ * owns [target_base + n * target_size, +target_size). Latency is measured on
+ * the round-trip, up to the burst response.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io_v2.hpp>
+#include "noc_bench.hpp"
+
+
+class NocBenchV2;
+
+
+class NocBenchReqV2 : public vp::IoReq
+{
+public:
+    NocBenchPacket *packet;
+};
+
+
+class NocBenchNodeV2 : public vp::Block, public NocBenchPort
+{
+public:
+    NocBenchNodeV2(NocBenchV2 *top, int x, int y);
+
+    bool is_ready() override;
+    bool send(NocBenchPacket *packet) override;
+
+private:
+    static vp::IoRespAck response(vp::Block *__this, vp::IoReq *req);
+    static void retry(vp::Block *__this, vp::IoRetryChannel);
+    static vp::IoReqStatus target_req(vp::Block *__this, vp::IoReq *req);
+    void handle_status(NocBenchReqV2 *req, vp::IoReqStatus status);
+    void release(NocBenchReqV2 *req);
+
+    NocBenchV2 *top;
+    vp::IoMaster output{&NocBenchNodeV2::retry, &NocBenchNodeV2::response};
+    vp::IoSlave target{&NocBenchNodeV2::target_req};
+    std::vector<NocBenchReqV2> reqs;
+    std::vector<uint8_t> data;
+    std::vector<NocBenchReqV2 *> free_reqs;
+    // Request denied by the network, sent again when it calls retry()
+    NocBenchReqV2 *denied_req = NULL;
+};
+
+
+class NocBenchV2 : public vp::Component
+{
+    friend class NocBenchNodeV2;
+
+public:
+    NocBenchV2(vp::ComponentConf &config);
+    void reset(bool active) override;
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+
+    vp::Trace trace;
+    vp::ClockEvent fsm_event;
+    NocBenchConfig config;
+    NocBenchDriver *driver;
+    std::vector<NocBenchNodeV2 *> nodes;
+    uint64_t target_base;
+    uint64_t target_size;
+    int max_outstanding;
+};
+
+
+NocBenchNodeV2::NocBenchNodeV2(NocBenchV2 *top, int x, int y)
+    : vp::Block(top, "node_" + std::to_string(x) + "_" + std::to_string(y)), top(top)
+{
+    std::string suffix = std::to_string(x) + "_" + std::to_string(y);
+    top->new_master_port("node_" + suffix, &this->output, this);
+    top->new_slave_port("target_" + suffix, &this->target, this);
+
+    // Bursts are written from a dummy buffer, each outstanding one gets its own
+    this->reqs.resize(top->max_outstanding);
+    this->data.resize(top->max_outstanding * top->config.packet_size);
+    for (int i=0; i<top->max_outstanding; i++)
+    {
+        this->reqs[i].set_data(&this->data[i * top->config.packet_size]);
+        this->free_reqs.push_back(&this->reqs[i]);
+    }
+}
+
+
+bool NocBenchNodeV2::is_ready()
+{
+    return this->denied_req == NULL && this->free_reqs.size() > 0;
+}
+
+
+bool NocBenchNodeV2::send(NocBenchPacket *packet)
+{
+    NocBenchReqV2 *req = this->free_reqs.back();
+    this->free_reqs.pop_back();
+
+    req->prepare();
+    req->set_addr(this->top->target_base + this->top->target_size * packet->dest);
+    req->set_size(this->top->config.packet_size);
+    req->set_is_write(true);
+    req->is_first = true;
+    req->is_last = true;
+    req->burst_id = -1;
+    req->set_resp_status(vp::IO_RESP_OK);
+    req->packet = packet;
+
+    this->handle_status(req, this->output.req(req));
+
+    // A denied burst stays owned by this node until the retry
+    return true;
+}
+
+
+void NocBenchNodeV2::handle_status(NocBenchReqV2 *req, vp::IoReqStatus status)
+{
+    if (status == vp::IO_REQ_DONE)
+    {
+        this->release(req);
+    }
+    else if (status == vp::IO_REQ_DENIED)
+    {
+        this->denied_req = req;
+    }
+}
+
+
+void NocBenchNodeV2::release(NocBenchReqV2 *req)
+{
+    this->free_reqs.push_back(req);
+    this->top->driver->complete(req->packet, this->top->clock.get_cycles());
+}
+
+
+vp::IoRespAck NocBenchNodeV2::response(vp::Block *__this, vp::IoReq *req)
+{
+    NocBenchNodeV2 *_this = (NocBenchNodeV2 *)__this;
+    _this->release((NocBenchReqV2 *)req);
+    return vp::IO_RESP_ACCEPTED;
+}
+
+
+void NocBenchNodeV2::retry(vp::Block *__this, vp::IoRetryChannel)
+{
+    NocBenchNodeV2 *_this = (NocBenchNodeV2 *)__this;
+    NocBenchReqV2 *req = _this->denied_req;
+    if (req)
+    {
+        _this->denied_req = NULL;
+        _this->handle_status(req, _this->output.req(req));
+    }
+}
+
+
+vp::IoReqStatus NocBenchNodeV2::target_req(vp::Block *__this, vp::IoReq *req)
+{
+    // Ideal target, the benchmark only measures the network
+    req->set_resp_status(vp::IO_RESP_OK);
+    return vp::IO_REQ_DONE;
+}
+
+
+NocBenchV2::NocBenchV2(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &NocBenchV2::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->config.model = js->get_child_str("model");
+    this->config.nb_x = js->get_int("nb_x");
+    this->config.nb_y = js->get_int("nb_y");
+    for (js::Config *elem: js->get("patterns")->get_elems())
+    {
+        this->config.patterns.push_back(elem->get_str());
+    }
+    for (js::Config *elem: js->get("rates")->get_elems())
+    {
+        this->config.rates.push_back(elem->get_double());
+    }
+    this->config.packet_size = js->get_int("packet_size");
+    this->config.link_width = js->get_int("link_width");
+    this->config.warmup_cycles = js->get_int("warmup_cycles");
+    this->config.measure_cycles = js->get_int("measure_cycles");
+    this->config.drain_cycles = js->get_int("drain_cycles");
+    this->config.source_queue_size = js->get_int("source_queue_size");
+    this->config.hotspot_fraction = js->get("hotspot_fraction")->get_double();
+    this->config.saturation_factor = js->get("saturation_factor")->get_double();
+    this->config.seed = js->get_uint("seed");
+    this->config.csv_path = js->get_child_str("csv");
+    this->config.summary_path = js->get_child_str("summary");
+    this->config.reference_path = js->get_child_str("reference");
+    this->config.tolerance = js->get("tolerance")->get_double();
+    this->config.host_tolerance = js->get("host_tolerance")->get_double();
+    this->target_base = js->get_uint("target_base");
+    this->target_size = js->get_uint("target_size");
+    this->max_outstanding = js->get_int("max_outstanding");
+
+    this->driver = new NocBenchDriver(this->config);
+
+    std::string error = this->driver->check_config();
+    if (error != "")
+    {
+        this->trace.fatal("Invalid benchmark configuration: %s\n", error.c_str());
+        return;
+    }
+
+    for (int y=0; y<this->config.nb_y; y++)
+    {
+        for (int x=0; x<this->config.nb_x; x++)
+        {
+            NocBenchNodeV2 *node = new NocBenchNodeV2(this, x, y);
+            this->nodes.push_back(node);
+            this->driver->set_port(y * this->config.nb_x + x, node);
+        }
+    }
+}
+
+
+void NocBenchV2::reset(bool active)
+{
+    if (!active)
+    {
+        this->driver->start(this->clock.get_cycles());
+        this->fsm_event.enqueue();
+    }
+}
+
+
+void NocBenchV2::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    NocBenchV2 *_this = (NocBenchV2 *)__this;
+
+    if (_this->driver->tick(_this->clock.get_cycles()))
+    {
+        _this->fsm_event.enqueue();
+    }
+    else
+    {
+        _this->time.get_engine()->quit(_this->driver->get_status());
+    }
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new NocBenchV2(config);
+}
@@ -0,0 +1,153 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Synthetic traffic benchmark of the FlooNoC models.
+
+The same benchmark driver (see noc_bench.hpp) is bound to one of the FlooNoC
+models, selected with the ``model`` parameter:
+
+- ``floonoc_v2``: pulp/floonoc_v2 cluster grid, io_v2, wide network.
+- ``floonoc``: pulp/floonoc cluster grid, io, wide network.
+- ``teranoc``: pulp/teranoc/l1_interconnect narrow mesh, io, destinations
+  given by request arguments.
+
+Each mesh node gets one injecting port and one ideal target, so that only the
+network is measured.
+"""
+
+import re
+
+import gvsoc.systree
+import gvsoc.runner
+
+import vp.clock_domain
+import pulp.floonoc_v2.floonoc_v2
+import pulp.floonoc.floonoc
+import pulp.teranoc.l1_interconnect.floonoc
+from gvrun.parameter import TargetParameter
+
+from noc_bench import NocBenchV1, NocBenchV2
+
+
+TARGET_BASE = 0x8000_0000
+TARGET_SIZE = 0x10_0000
+
+WIDE_WIDTH = 64
+NARROW_WIDTH = 8
+
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, model, nb_x, nb_y, **bench_args):
+        super().__init__(parent, name)
+
+        if model == 'floonoc_v2':
+            noc = pulp.floonoc_v2.floonoc_v2.FlooNocV2ClusterGridNarrowWide(self, 'noc',
+                WIDE_WIDTH, NARROW_WIDTH, nb_x, nb_y, ni_outstanding_reqs=8)
+            bench = NocBenchV2(self, 'bench', model=model, nb_x=nb_x, nb_y=nb_y,
+                link_width=WIDE_WIDTH, packet_size=4*WIDE_WIDTH, target_base=TARGET_BASE,
+                target_size=TARGET_SIZE, **bench_args)
+
+        elif model == 'floonoc':
+            noc = pulp.floonoc.floonoc.FlooNocClusterGridNarrowWide(self, 'noc',
+                wide_width=WIDE_WIDTH, narrow_width=NARROW_WIDTH, nb_x_clusters=nb_x,
+                nb_y_clusters=nb_y, ni_outstanding_reqs=8)
+            bench = NocBenchV1(self, 'bench', model=model, nb_x=nb_x, nb_y=nb_y,
+                link_width=WIDE_WIDTH, packet_size=4*WIDE_WIDTH, target_base=TARGET_BASE,
+                target_size=TARGET_SIZE, **bench_args)
+
+        elif model == 'teranoc':
+            noc = pulp.teranoc.l1_interconnect.floonoc.FlooNoc2dMeshNarrow(self, 'noc',
+                narrow_width=4, dim_x=nb_x, dim_y=nb_y)
+            # Single-word requests, as sent by the cores to remote L1 banks
+            bench = NocBenchV1(self, 'bench', model=model, nb_x=nb_x, nb_y=nb_y,
+                link_width=4, packet_size=4, dest_in_args=True, **bench_args)
+
+        else:
+            raise RuntimeError(f'Unknown noc model: {model}')
+
+        for x in range(0, nb_x):
+            for y in range(0, nb_y):
+                node_base = TARGET_BASE + TARGET_SIZE * (y * nb_x + x)
+
+                if model == 'floonoc_v2':
+                    bench.o_NODE(x, y, noc.i_CLUSTER_WIDE_INPUT(x, y))
+                    noc.o_MAP(node_base, TARGET_SIZE, x+1, y+1, rm_base=True)
+                    noc.o_WIDE_BIND(bench.i_TARGET(x, y), x+1, y+1)
+
+                elif model == 'floonoc':
+                    bench.o_NODE(x, y, noc.i_WIDE_INPUT(x+1, y+1))
+                    noc.o_MAP(node_base, TARGET_SIZE, x+1, y+1, rm_base=True)
+                    noc.o_WIDE_BIND(bench.i_TARGET(x, y), x+1, y+1)
+
+                else:
+                    bench.o_NODE(x, y, noc.i_NARROW_INPUT(x, y))
+                    noc.o_MAP(bench.i_TARGET(x, y), x, y)
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name=None):
+
+        super().__init__(parent, name)
+
+        model = TargetParameter(
+            self, name='model', value='floonoc_v2',
+            description='Noc model to benchmark (floonoc_v2, floonoc or teranoc)'
+        ).get_value()
+
+        nb_x = TargetParameter(
+            self, name='nb_x', value=4, description='Number of nodes on the X direction', cast=int
+        ).get_value()
+
+        nb_y = TargetParameter(
+            self, name='nb_y', value=4, description='Number of nodes on the Y direction', cast=int
+        ).get_value()
+
+        patterns = TargetParameter(
+            self, name='patterns', value='uniform,transpose,bit_complement,hotspot,neighbour,all_to_all',
+            description='List of traffic patterns, separated by commas or +'
+        ).get_value()
+
+        rates = TargetParameter(
+            self, name='rates', value='0.02,0.1,0.2,0.3,0.4,0.5,0.6,0.7,0.8,0.9,1.0',
+            description='List of offered loads, as fractions of the link bandwidth, separated by commas or +'
+        ).get_value()
+
+        reference = TargetParameter(
+            self, name='reference', value='',
+            description='Summary of a previous run to check the results against'
+        ).get_value()
+
+        host_tolerance = TargetParameter(
+            self, name='host_tolerance', value=0.0,
+            description='Allowed host slowdown against the reference, 0 to disable the check',
+            cast=float
+        ).get_value()
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100000000)
+        soc = Testbench(self, 'soc', model, nb_x, nb_y,
+            patterns=re.split('[,+]', patterns), rates=[float(rate) for rate in re.split('[,+]', rates)],
+            csv=f'noc_bench_{model}.csv', summary=f'noc_bench_{model}_summary.csv',
+            reference=reference, host_tolerance=host_tolerance)
+        clock.o_CLOCK(soc.i_CLOCK())
+
+
+class Target(gvsoc.runner.Target):
+
+    gapy_description = "FlooNoC synthetic traffic benchmark"
+    model = Chip
+    name = "test"
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone check of the RedMulE AVX2 compute_z row kernel.
+ *
+ * Computes random rows with both variants of the kernel and compares them bit
+ * by bit with the scalar loop of RedMule_Buffers::compute_z, with fma() being
+ * std::fma(float) for the single rounding variant and the C fma(double) for
+ * the other one. NaNs only need to be NaNs on both sides.
+ *
+ * Rows use the column count of the model and counts leaving columns to the
+ * scalar tail of the kernel, and read x from an offset wrapping around the x
+ * buffer. With fp16 data, as in the model, the scalar loop must also give the
+ * same result with both fma() and the same fp16 once stored by the streamer,
+ * since the model uses the single rounding kernel for it whichever fma() is
+ * in scope. fp16 data mixes moderate values, values rounding to fp16 halfway
+ * points, values overflowing fp16 or underflowing to subnormals, and infinite
+ * or NaN inputs.
+ *
+ * Built and run with "make compute_z_check".
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "config.h"
+#include "redmule_compute_z.hpp"
+
+static constexpr int MAX_N = 80;
+static constexpr int MAX_COLS = 24;
+static constexpr int NB_ROWS = 2000;
+
+enum DataKind
+{
+    DATA_FLOAT,       // any float bit pattern
+    DATA_FLOAT_MID,   // floats with exponents around 1
+    DATA_FLOAT_TIES,  // first product just below half an ulp of y, rounded up by a double fma
+    DATA_FP16_MID,    // fp16 with exponents around 1
+    DATA_FP16_TIES,   // fp16 products added to fp16 halfway points
+    DATA_FP16_FINITE, // any finite fp16
+    DATA_FP16_SMALL,  // fp16 with tiny exponents, results mostly subnormal
+    DATA_FP16_BITS,   // any fp16 bit pattern, including infinites and NaNs
+};
+
+static float fp16_to_float(uint16_t bits)
+{
+    _Float16 value;
+    memcpy(&value, &bits, sizeof(value));
+    return (float) value;
+}
+
+static uint16_t float_to_fp16(float value)
+{
+    _Float16 value16 = (_Float16) value;
+    uint16_t bits;
+    memcpy(&bits, &value16, sizeof(bits));
+    return bits;
+}
+
+static float random_elem(std::mt19937 &rng, DataKind kind)
+{
+    uint32_t bits = rng();
+
+    switch (kind)
+    {
+        case DATA_FLOAT:
+        {
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        case DATA_FLOAT_MID:
+        case DATA_FLOAT_TIES:
+        {
+            bits = (bits & 0x807FFFFF) | ((120 + (bits >> 23) % 16) << 23);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        case DATA_FP16_MID:
+        case DATA_FP16_TIES:
+            return fp16_to_float((bits & 0x83FF) | ((11 + (bits >> 16) % 8) << 10));
+        case DATA_FP16_FINITE:
+            return fp16_to_float((bits & 0x83FF) | (((bits >> 16) % 31) << 10));
+        case DATA_FP16_SMALL:
+            return fp16_to_float((bits & 0x83FF) | (((bits >> 16) % 6) << 10));
+        default:
+            return fp16_to_float(bits);
+    }
+}
+
+// Sets y and the first product of column j, x being 1 + a with a a few float
+// ulps, so that y + x * w = y + half_ulp * (1 - a^2) is just below the float
+// halfway point above y, y being odd. Rounding it to double gives the halfway
+// point, which is then rounded to even, up, while a float fma rounds down. The
+// other products are zero.
+static void set_float_tie(std::mt19937 &rng, float* y, float x, float** w, int n, int j)
+{
+    uint32_t bits = (rng() & 0x807FFFFF) | 1 | ((120 + rng() % 16) << 23);
+
+    memcpy(&y[j], &bits, sizeof(float));
+    float half_ulp = std::ldexp(1.0f, std::ilogb(y[j]) - 24);
+    w[0][j] = std::copysign(half_ulp * (2.0f - x), y[j]);
+
+    for (int k = 1; k < n; k++) {
+        w[k][j] = 0.0f;
+    }
+}
+
+// Float halfway between two fp16 values
+static float random_tie(std::mt19937 &rng)
+{
+    uint16_t bits = (rng() & 0x83FF) | ((14 + rng() % 4) << 10);
+    float value = fp16_to_float(bits);
+    float next = fp16_to_float(bits + 1);
+    return value + (next - value) / 2;
+}
+
+static bool same_float(float a, float b)
+{
+    return (a != a && b != b) || memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// Scalar loop of compute_z for one row
+template<bool single_rounding>
+static void reference_row(int cols, float* z, const float* y, const float* x_row, int x_offs, int x_len, float** w, int n)
+{
+    for (int j = 0; j < cols; j++) {
+        float tmp_z = y[j];
+
+        for (int k = 0; k < n; k++) {
+            int offs = x_offs + k < x_len ? x_offs + k : x_offs + k - x_len;
+
+            if (single_rounding) {
+                tmp_z = std::fma(x_row[offs], w[k][j], tmp_z);
+            } else {
+                tmp_z = (float) fma((double) x_row[offs], (double) w[k][j], (double) tmp_z);
+            }
+        }
+
+        z[j] = tmp_z;
+    }
+}
+
+typedef void (*RowFn)(float*, const float*, const float*, int, int, float**, int);
+
+template<int cols>
+static int check_cols(std::mt19937 &rng, int &nb_rows)
+{
+    static const DataKind kinds[] = {
+        DATA_FLOAT, DATA_FLOAT_MID, DATA_FLOAT_TIES, DATA_FP16_MID, DATA_FP16_TIES, DATA_FP16_FINITE,
+        DATA_FP16_SMALL, DATA_FP16_BITS
+    };
+    static const RowFn kernels[] = {
+        &compute_z_row_avx2<cols, true>, &compute_z_row_avx2<cols, false>
+    };
+
+    std::vector<float> x(MAX_N * 2), y(MAX_COLS), z(MAX_COLS), z_ref(MAX_COLS), z_other(MAX_COLS);
+    std::vector<std::vector<float>> w_rows(MAX_N, std::vector<float>(MAX_COLS));
+    std::vector<float *> w(MAX_N);
+    int errors = 0;
+
+    for (int k = 0; k < MAX_N; k++) {
+        w[k] = w_rows[k].data();
+    }
+
+    for (int row = 0; row < NB_ROWS; row++) {
+        DataKind kind = kinds[row % (sizeof(kinds) / sizeof(kinds[0]))];
+        bool is_fp16 = kind >= DATA_FP16_MID;
+        int n = 1 + rng() % MAX_N;
+        int x_len = n + rng() % MAX_N;
+        int x_offs = rng() % x_len;
+
+        for (int k = 0; k < x_len; k++) {
+            x[k] = random_elem(rng, kind);
+        }
+        // With ties, w is tiny so that z stays close to the halfway point of y
+        for (int k = 0; k < n; k++) {
+            for (int j = 0; j < cols; j++) {
+                w[k][j] = random_elem(rng, kind == DATA_FP16_TIES ? DATA_FP16_SMALL : kind);
+            }
+        }
+        for (int j = 0; j < cols; j++) {
+            y[j] = kind == DATA_FP16_TIES ? random_tie(rng) : random_elem(rng, kind);
+        }
+        if (kind == DATA_FLOAT_TIES) {
+            x[x_offs] = 1.0f + std::ldexp((float) (1 + rng() % 8), -23);
+            for (int j = 0; j < cols; j++) {
+                set_float_tie(rng, y.data(), x[x_offs], w.data(), n, j);
+            }
+        }
+
+        for (int single = 0; single < 2; single++) {
+            if (single) {
+                reference_row<true>(cols, z_ref.data(), y.data(), x.data(), x_offs, x_len, w.data(), n);
+            } else {
+                reference_row<false>(cols, z_ref.data(), y.data(), x.data(), x_offs, x_len, w.data(), n);
+            }
+
+            memset(z.data(), 0xa5, cols * sizeof(float));
+            kernels[single ? 0 : 1](z.data(), y.data(), x.data(), x_offs, x_len, w.data(), n);
+
+            for (int j = 0; j < cols; j++) {
+                if (!same_float(z[j], z_ref[j])) {
+                    if (errors < 10) {
+                        printf("Mismatch (cols %d, %s rounding, kind %d, n %d, col %d): got %a, expected %a\n",
+                            cols, single ? "single" : "double", kind, n, j, z[j], z_ref[j]);
+                    }
+                    errors++;
+                }
+            }
+        }
+
+        if (is_fp16) {
+            reference_row<true>(cols, z_ref.data(), y.data(), x.data(), x_offs, x_len, w.data(), n);
+            reference_row<false>(cols, z_other.data(), y.data(), x.data(), x_offs, x_len, w.data(), n);
+
+            for (int j = 0; j < cols; j++) {
+                uint16_t z16 = float_to_fp16(z_ref[j]);
+                uint16_t z16_other = float_to_fp16(z_other[j]);
+                bool is_nan = (z16 & 0x7FFF) > 0x7C00 && (z16_other & 0x7FFF) > 0x7C00;
+
+                if (!same_float(z_ref[j], z_other[j]) || (z16 != z16_other && !is_nan)) {
+                    if (errors < 10) {
+                        printf("fma() mismatch on fp16 data (cols %d, kind %d, n %d, col %d): float %a, double %a\n",
+                            cols, kind, n, j, z_ref[j], z_other[j]);
+                    }
+                    errors++;
+                }
+            }
+        }
+
+        nb_rows++;
+    }
+
+    return errors;
+}
+
+int main()
+{
+    if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) {
+        printf("No AVX2/FMA on this host, the model uses the scalar loop\n");
+        printf("PASSED\n");
+        return 0;
+    }
+
+    std::mt19937 rng(0);
+    int nb_rows = 0;
+    int errors = 0;
+
+    // The model columns, and counts leaving columns to the scalar tail
+    errors += check_cols<(PIPE_REGS + 1) * ARRAY_HEIGHT>(rng, nb_rows);
+    errors += check_cols<12>(rng, nb_rows);
+    errors += check_cols<13>(rng, nb_rows);
+    errors += check_cols<MAX_COLS>(rng, nb_rows);
+
+    printf("Checked %d rows, %d errors\n", nb_rows, errors);
+    printf(errors ? "FAILED\n" : "PASSED\n");
+
+    return errors != 0;
+}
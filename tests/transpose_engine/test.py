@@ -0,0 +1,89 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Result and cycle check of the SoftHier TransposeEngine.
+
+The engine transposes M x N matrices of 8, 16 and 32-bit elements, whose
+dimensions are not multiples of the tile, through a bench which is also its
+TCDM, with latencies depending on the address. The small queue depth makes
+the engine wait for responses with its queue full. The completion cycles must
+be the ones of a reference model stepped every cycle, with up to nb_ports rows
+sent per cycle.
+"""
+
+import gvsoc.systree
+import gvsoc.runner
+
+import vp.clock_domain
+from gvrun.parameter import TargetParameter
+
+from pulp.chips.soft_hier_old.transpose_engine import TransposeEngine
+from transpose_bench import TransposeBench
+
+
+QUEUE_DEPTH = 2
+BUFFER_DIM = 32
+LATENCIES = [1, 4, 9, 2, 6, 3, 12]
+ELEM_SIZES = [1, 2, 4]
+# Shapes as [M, N]: single elements, rows and columns, smaller than a tile,
+# and several tiles with partial ones at the end of the rows and columns
+SHAPES = [
+    [1, 1],
+    [1, 37],
+    [29, 1],
+    [5, 3],
+    [33, 31],
+    [40, 70],
+    [64, 9],
+    [17, 100],
+]
+
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, nb_ports):
+        super().__init__(parent, name)
+
+        engine = TransposeEngine(self, 'engine', tcdm_bank_width=4, tcdm_bank_number=8,
+            queue_depth=QUEUE_DEPTH, buffer_dim=BUFFER_DIM, nb_ports=nb_ports)
+
+        bench = TransposeBench(self, 'bench', nb_ports=nb_ports, queue_depth=QUEUE_DEPTH,
+            buffer_dim=BUFFER_DIM, latencies=LATENCIES, elem_sizes=ELEM_SIZES, shapes=SHAPES)
+
+        self.bind(bench, 'engine', engine, 'input')
+        self.bind(engine, 'tcdm', bench, 'tcdm')
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name=None):
+
+        super().__init__(parent, name)
+
+        nb_ports = TargetParameter(
+            self, name='nb_ports', value=1, description='Number of engine TCDM ports', cast=int
+        ).get_value()
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100000000)
+        soc = Testbench(self, 'soc', nb_ports)
+        clock.o_CLOCK(soc.i_CLOCK())
+
+
+class Target(gvsoc.runner.Target):
+
+    gapy_description = "SoftHier TransposeEngine result and cycle test"
+    model = Chip
+    name = "test"
@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2026 ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * TransposeBench — result and cycle check of the SoftHier TransposeEngine.
+ *
+ * For each element size and each M x N shape, the bench fills X with random
+ * data, programs the engine registers, triggers it and sends the wait query,
+ * which the engine answers once Y holds the transpose of X. The bench is also
+ * the TCDM of the engine, and gives each row request a latency which depends
+ * on its address.
+ *
+ * The cycle at which the query is answered must be the one of a reference
+ * model of the engine protocol, stepped every cycle: the rows of a tile are
+ * sent, up to nb_ports per cycle, while the pending queue has room, and the
+ * next phase starts the cycle after the last response of the current one has
+ * arrived. With one port this is the model before multi-port support.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <vector>
+
+
+class TransposeBench : public vp::Component
+{
+public:
+    TransposeBench(vp::ComponentConf &config);
+
+    void reset(bool active) override;
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void resp(vp::Block *__this, vp::IoReq *req);
+    static vp::IoReqStatus tcdm_req(vp::Block *__this, vp::IoReq *req);
+    void write_reg(uint64_t offset, uint32_t value);
+    void start();
+    void check();
+    int64_t get_latency(uint64_t addr) { return this->latencies[(addr >> 2) % this->latencies.size()]; }
+    int64_t model_phase(int64_t cycles, int nb_rows, uint64_t base, uint64_t stride);
+    int64_t model_cycles(int64_t cycles);
+
+    vp::Trace trace;
+    vp::IoMaster engine_itf;
+    vp::IoSlave tcdm_itf;
+    vp::ClockEvent fsm_event;
+    vp::IoReq req;
+    vp::IoReq query_req;
+
+    int nb_ports;
+    int queue_depth;
+    int buffer_dim;
+    std::vector<int64_t> latencies;
+    std::vector<int> elem_sizes;
+    // Shapes to transpose, as M and N
+    std::vector<std::pair<int, int>> shapes;
+    std::mt19937 rng;
+
+    // Element size and shape being checked
+    size_t elem_index;
+    size_t shape_index;
+    int elem_size;
+    int m_size;
+    int n_size;
+    uint64_t x_addr;
+    uint64_t y_addr;
+    // TCDM content, and a copy of X to check it is not modified
+    std::vector<uint8_t> mem;
+    std::vector<uint8_t> x_data;
+    uint8_t reg_data[4];
+    int64_t expected_cycles;
+    int nb_checks;
+    int nb_errors;
+};
+
+
+TransposeBench::TransposeBench(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &TransposeBench::fsm_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    js::Config *js = this->get_js_config();
+    this->nb_ports = js->get_int("nb_ports");
+    this->queue_depth = js->get_int("queue_depth");
+    this->buffer_dim = js->get_int("buffer_dim");
+    for (js::Config *latency: js->get("latencies")->get_elems())
+    {
+        this->latencies.push_back(latency->get_int());
+    }
+    for (js::Config *elem_size: js->get("elem_sizes")->get_elems())
+    {
+        this->elem_sizes.push_back(elem_size->get_int());
+    }
+    for (js::Config *shape: js->get("shapes")->get_elems())
+    {
+        this->shapes.push_back({ shape->get_elem(0)->get_int(), shape->get_elem(1)->get_int() });
+    }
+    this->rng.seed(js->get_int("seed"));
+
+    this->engine_itf.set_resp_meth(&TransposeBench::resp);
+    this->new_master_port("engine", &this->engine_itf);
+
+    this->tcdm_itf.set_req_meth(&TransposeBench::tcdm_req);
+    this->new_slave_port("tcdm", &this->tcdm_itf);
+}
+
+
+void TransposeBench::reset(bool active)
+{
+    if (!active)
+    {
+        this->elem_index = 0;
+        this->shape_index = 0;
+        this->nb_checks = 0;
+        this->nb_errors = 0;
+        this->fsm_event.enqueue();
+    }
+}
+
+
+void TransposeBench::write_reg(uint64_t offset, uint32_t value)
+{
+    memcpy(this->reg_data, &value, sizeof(value));
+
+    this->req.init();
+    this->req.set_addr(offset);
+    this->req.set_size(sizeof(value));
+    this->req.set_data(this->reg_data);
+    this->req.set_is_write(true);
+
+    if (this->engine_itf.req(&this->req) != vp::IO_REQ_OK)
+    {
+        this->trace.fatal("Failed register write (offset: 0x%lx)\n", offset);
+    }
+}
+
+
+// Runs one phase of a tile, whose first event is the cycle after cycles,
+// sending the row requests as the engine does, and returns the cycle of its
+// last event
+int64_t TransposeBench::model_phase(int64_t cycles, int nb_rows, uint64_t base, uint64_t stride)
+{
+    std::queue<int64_t> pending;
+    int sent = 0;
+
+    do
+    {
+        cycles++;
+
+        for (int port=0; port<this->nb_ports; port++)
+        {
+            if (sent >= nb_rows || (int)pending.size() > this->queue_depth)
+            {
+                break;
+            }
+            pending.push(cycles + this->get_latency(base + sent * stride));
+            sent++;
+        }
+
+        while (!pending.empty() && pending.front() <= cycles)
+        {
+            pending.pop();
+        }
+    }
+    while (sent < nb_rows || !pending.empty());
+
+    return cycles;
+}
+
+
+// Cycle at which the engine triggered at cycles should answer the wait query
+int64_t TransposeBench::model_cycles(int64_t cycles)
+{
+    int tile_dim = this->buffer_dim / this->elem_size;
+    int m = this->m_size;
+    int n = this->n_size;
+    int es = this->elem_size;
+
+    // The START state is run in the cycle after the trigger
+    cycles++;
+
+    for (int row_iter=0; row_iter*tile_dim < m; row_iter++)
+    {
+        for (int col_iter=0; col_iter*tile_dim < n; col_iter++)
+        {
+            int nb_rows = std::min(tile_dim, m - row_iter*tile_dim);
+            int nb_cols = std::min(tile_dim, n - col_iter*tile_dim);
+
+            cycles = this->model_phase(cycles, nb_rows,
+                this->x_addr + (row_iter*tile_dim*n + col_iter*tile_dim) * es, n * es);
+            cycles = this->model_phase(cycles, nb_cols,
+                this->y_addr + (col_iter*tile_dim*m + row_iter*tile_dim) * es, m * es);
+        }
+    }
+
+    // The FINISHED state is run in the next cycle and the query answered in
+    // the one after
+    return cycles + 2;
+}
+
+
+void TransposeBench::start()
+{
+    this->elem_size = this->elem_sizes[this->elem_index];
+    this->m_size = this->shapes[this->shape_index].first;
+    this->n_size = this->shapes[this->shape_index].second;
+
+    uint64_t size = this->m_size * this->n_size * this->elem_size;
+    this->x_addr = 0;
+    this->y_addr = size;
+    this->mem.resize(size * 2);
+    for (uint64_t i=0; i<size; i++)
+    {
+        this->mem[i] = this->rng();
+    }
+    memset(&this->mem[size], 0xa5, size);
+    this->x_data.assign(this->mem.begin(), this->mem.begin() + size);
+
+    this->write_reg(0, this->m_size);
+    this->write_reg(4, this->n_size);
+    this->write_reg(8, this->x_addr);
+    this->write_reg(12, this->y_addr);
+    this->write_reg(16, this->elem_size);
+
+    this->trace.msg(vp::Trace::LEVEL_INFO, "Starting transpose (elem_size: %d, M: %d, N: %d)\n",
+        this->elem_size, this->m_size, this->n_size);
+
+    // Trigger
+    this->req.init();
+    this->req.set_addr(20);
+    this->req.set_size(4);
+    this->req.set_data(this->reg_data);
+    this->req.set_is_write(false);
+    if (this->engine_itf.req(&this->req) != vp::IO_REQ_OK)
+    {
+        this->trace.fatal("Failed to trigger the engine\n");
+    }
+
+    this->expected_cycles = this->model_cycles(this->clock.get_cycles());
+
+    // Wait query, answered by resp when the engine is done
+    this->query_req.init();
+    this->query_req.set_addr(24);
+    this->query_req.set_size(4);
+    this->query_req.set_data(this->reg_data);
+    this->query_req.set_is_write(false);
+    if (this->engine_itf.req(&this->query_req) != vp::IO_REQ_PENDING)
+    {
+        printf("Wait query not pending (elem_size: %d, M: %d, N: %d)\n", this->elem_size,
+            this->m_size, this->n_size);
+        this->nb_errors++;
+        this->check();
+    }
+}
+
+
+void TransposeBench::check()
+{
+    int m = this->m_size;
+    int n = this->n_size;
+    int es = this->elem_size;
+    int nb_errors = 0;
+
+    for (int i=0; i<m; i++)
+    {
+        for (int j=0; j<n; j++)
+        {
+            if (memcmp(&this->mem[this->y_addr + (j*m + i)*es],
+                &this->mem[this->x_addr + (i*n + j)*es], es) != 0)
+            {
+                if (nb_errors < 10)
+                {
+                    printf("Mismatch at Y[%d][%d] (elem_size: %d, M: %d, N: %d)\n", j, i, es,
+                        m, n);
+                }
+                nb_errors++;
+            }
+        }
+    }
+
+    if (memcmp(this->mem.data(), this->x_data.data(), this->x_data.size()) != 0)
+    {
+        printf("X modified (elem_size: %d, M: %d, N: %d)\n", es, m, n);
+        nb_errors++;
+    }
+
+    int64_t cycles = this->clock.get_cycles();
+    if (cycles != this->expected_cycles)
+    {
+        printf("Cycle mismatch (elem_size: %d, M: %d, N: %d, got: %ld, expected: %ld)\n", es,
+            m, n, cycles, this->expected_cycles);
+        nb_errors++;
+    }
+
+    this->nb_errors += nb_errors;
+    this->nb_checks++;
+
+    this->shape_index++;
+    if (this->shape_index == this->shapes.size())
+    {
+        this->shape_index = 0;
+        this->elem_index++;
+    }
+
+    this->fsm_event.enqueue();
+}
+
+
+void TransposeBench::resp(vp::Block *__this, vp::IoReq *req)
+{
+    TransposeBench *_this = (TransposeBench *)__this;
+    _this->check();
+}
+
+
+vp::IoReqStatus TransposeBench::tcdm_req(vp::Block *__this, vp::IoReq *req)
+{
+    TransposeBench *_this = (TransposeBench *)__this;
+    uint64_t addr = req->get_addr();
+    uint64_t size = req->get_size();
+
+    if (addr + size > _this->mem.size())
+    {
+        printf("Out of bound TCDM access (addr: 0x%lx, size: 0x%lx)\n", addr, size);
+        _this->nb_errors++;
+        return vp::IO_REQ_INVALID;
+    }
+
+    if (req->get_is_write())
+    {
+        memcpy(&_this->mem[addr], req->get_data(), size);
+    }
+    else
+    {
+        memcpy(req->get_data(), &_this->mem[addr], size);
+    }
+
+    req->inc_latency(_this->get_latency(addr));
+
+    return vp::IO_REQ_OK;
+}
+
+
+void TransposeBench::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    TransposeBench *_this = (TransposeBench *)__this;
+
+    if (_this->elem_index == _this->elem_sizes.size())
+    {
+        printf("[transpose_engine] nb_ports %d, %d transposes, %d errors\n", _this->nb_ports,
+            _this->nb_checks, _this->nb_errors);
+        _this->time.get_engine()->quit(_this->nb_errors != 0);
+        return;
+    }
+
+    _this->start();
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new TransposeBench(config);
+}
@@ -0,0 +1,43 @@
+#
+# Copyright (C) 2026 ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import gvsoc.systree
+
+
+class TransposeBench(gvsoc.systree.Component):
+    """Result and cycle check of the SoftHier TransposeEngine.
+
+    Each shape of shapes, as [M, N], is transposed for each element size of
+    elem_sizes. The bench is also the TCDM of the engine, answering each row
+    request with latencies[(addr >> 2) % len(latencies)] cycles. Y must be the
+    transpose of X, and the wait query must be answered at the cycle given by
+    a reference model of an engine with nb_ports ports, queue_depth and
+    buffer_dim.
+    """
+
+    def __init__(self, parent, name, *, nb_ports: int, queue_depth: int, buffer_dim: int,
+            latencies: list, elem_sizes: list, shapes: list, seed: int=0):
+        super().__init__(parent, name)
+
+        self.add_sources(['transpose_bench.cpp'])
+
+        self.add_property('nb_ports', nb_ports)
+        self.add_property('queue_depth', queue_depth)
+        self.add_property('buffer_dim', buffer_dim)
+        self.add_property('latencies', latencies)
+        self.add_property('elem_sizes', elem_sizes)
+        self.add_property('shapes', shapes)
+        self.add_property('seed', seed)